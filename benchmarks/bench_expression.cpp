@@ -0,0 +1,121 @@
+#include "bench_expression.h"
+#include "benchinputs.h"
+#include <QtTest/QTest>
+#include <expression.h>
+#include <expressiontranslator.h>
+
+bench_expression::bench_expression(QObject *parent)
+    : QObject{parent}
+{}
+
+void bench_expression::splitExpression()
+{
+    QFETCH(int, size);
+    const QString expression = BenchInputs::expression(size);
+
+    QStringList tokens;
+    QBENCHMARK {
+        tokens = Expression::splitExpression(expression);
+    }
+    QCOMPARE(tokens.size(), 2 * size - 1);
+}
+
+void bench_expression::splitExpression_data()
+{
+    BenchInputs::addScaleRows();
+}
+
+void bench_expression::getEntityTypeByStr()
+{
+    QFETCH(int, operands);
+    Expression expression(BenchInputs::schema(operands), BenchInputs::expression(operands));
+    const QStringList tokens = Expression::splitExpression(*expression.getExpression());
+
+    int variables = 0;
+    QBENCHMARK {
+        variables = 0;
+        for (const QString& token : tokens) {
+            if (expression.getEntityTypeByStr(token) == EntityType::Variable) variables++;
+        }
+    }
+    QCOMPARE(variables, operands);
+}
+
+void bench_expression::getEntityTypeByStr_data()
+{
+    BenchInputs::addSizeRows();
+}
+
+void bench_expression::expressionToNodes()
+{
+    QFETCH(int, operands);
+    Expression expression(BenchInputs::schema(operands), BenchInputs::expression(operands));
+
+    // Деревья освобождаются после замера, чтобы не учитывать освобождение
+    QList<ExpressionNode*> trees;
+    QBENCHMARK {
+        trees.append(expression.expressionToNodes());
+    }
+    QVERIFY(!trees.isEmpty() && trees.last() != nullptr);
+    qDeleteAll(trees);
+}
+
+void bench_expression::expressionToNodes_data()
+{
+    BenchInputs::addSizeRows();
+}
+
+void bench_expression::toExplanation()
+{
+    QFETCH(int, operands);
+    Expression expression(BenchInputs::schema(operands), BenchInputs::expression(operands));
+    ExpressionNode* tree = expression.expressionToNodes();
+
+    QString explanation;
+    QBENCHMARK {
+        QString intermediateDescription;
+        explanation = expression.ToExplanation(tree, intermediateDescription);
+    }
+    delete tree;
+    QVERIFY(explanation.contains("value number 0"));
+}
+
+void bench_expression::toExplanation_data()
+{
+    BenchInputs::addSizeRows();
+}
+
+void bench_expression::getExplanation()
+{
+    QFETCH(int, size);
+    const QString description = BenchInputs::translatorTemplate(size);
+    const QStringList arguments = BenchInputs::translatorArguments(size);
+
+    QString explanation;
+    QBENCHMARK {
+        explanation = ExpressionTranslator::getExplanation(description, arguments);
+    }
+    QVERIFY(!explanation.contains('{'));
+}
+
+void bench_expression::getExplanation_data()
+{
+    BenchInputs::addScaleRows();
+}
+
+void bench_expression::removeConsecutiveDuplicates()
+{
+    QFETCH(int, size);
+    const QString explanation = BenchInputs::repeatedWords(size);
+
+    QString result;
+    QBENCHMARK {
+        result = Expression::removeConsecutiveDuplicates(explanation);
+    }
+    QVERIFY(result.size() <= explanation.size());
+}
+
+void bench_expression::removeConsecutiveDuplicates_data()
+{
+    BenchInputs::addScaleRows();
+}
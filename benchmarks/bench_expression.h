@@ -0,0 +1,27 @@
+#ifndef BENCH_EXPRESSION_H
+#define BENCH_EXPRESSION_H
+
+#include <QObject>
+
+class bench_expression : public QObject
+{
+    Q_OBJECT
+public:
+    explicit bench_expression(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void splitExpression(); // static QStringList Expression::splitExpression(const QString& str)
+    void splitExpression_data();
+    void getEntityTypeByStr(); // EntityType Expression::getEntityTypeByStr(const QString& str)
+    void getEntityTypeByStr_data();
+    void expressionToNodes(); // ExpressionNode* Expression::expressionToNodes(QSet<QString>* usedElements)
+    void expressionToNodes_data();
+    void toExplanation(); // QString Expression::ToExplanation(const ExpressionNode* node, ...) const
+    void toExplanation_data();
+    void getExplanation(); // static QString ExpressionTranslator::getExplanation(const QString& description, const QList<QString>& arguments)
+    void getExplanation_data();
+    void removeConsecutiveDuplicates(); // static QString Expression::removeConsecutiveDuplicates(const QString& str)
+    void removeConsecutiveDuplicates_data();
+};
+
+#endif // BENCH_EXPRESSION_H
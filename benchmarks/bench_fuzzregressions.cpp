@@ -0,0 +1,63 @@
+#include "bench_fuzzregressions.h"
+#include <QtTest/QTest>
+#include <QDir>
+#include <QFile>
+#include <fuzztargets.h>
+
+#ifndef FUZZ_REGRESSIONS_DIR
+#define FUZZ_REGRESSIONS_DIR "regressions"
+#endif
+
+bench_fuzzRegressions::bench_fuzzRegressions(QObject *parent)
+    : QObject{parent}
+{}
+
+// Строка данных на каждый найденный вход цели; имя строки — имя файла
+static void addRegressionRows(const QString& target) {
+    QTest::addColumn<QByteArray>("input");
+
+    const QDir dir(QDir(FUZZ_REGRESSIONS_DIR).filePath(target));
+    const QStringList names = dir.entryList(QStringList{"*.in"}, QDir::Files, QDir::Name);
+    for (const QString& name : names) {
+        QFile file(dir.filePath(name));
+        if (file.open(QIODevice::ReadOnly)) QTest::newRow(qPrintable(name)) << file.readAll();
+    }
+}
+
+// Замер функции цели на входе текущей строки данных
+static void benchmarkTarget(const QString& target) {
+    QFETCH(QByteArray, input);
+    QBENCHMARK {
+        FuzzTargets::run(target, input);
+    }
+}
+
+void bench_fuzzRegressions::xmlParser()
+{
+    benchmarkTarget("xmlparser");
+}
+
+void bench_fuzzRegressions::xmlParser_data()
+{
+    addRegressionRows("xmlparser");
+}
+
+void bench_fuzzRegressions::expression()
+{
+    benchmarkTarget("expression");
+}
+
+void bench_fuzzRegressions::expression_data()
+{
+    addRegressionRows("expression");
+}
+
+void bench_fuzzRegressions::translator()
+{
+    benchmarkTarget("translator");
+}
+
+void bench_fuzzRegressions::translator_data()
+{
+    addRegressionRows("translator");
+}
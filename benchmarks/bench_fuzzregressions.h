@@ -0,0 +1,21 @@
+#ifndef BENCH_FUZZREGRESSIONS_H
+#define BENCH_FUZZREGRESSIONS_H
+
+#include <QObject>
+
+class bench_fuzzRegressions : public QObject
+{
+    Q_OBJECT
+public:
+    explicit bench_fuzzRegressions(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void xmlParser(); // static void FuzzTargets::parseDocument(const QByteArray& input)
+    void xmlParser_data();
+    void expression(); // static void FuzzTargets::buildTree(const QByteArray& input)
+    void expression_data();
+    void translator(); // static void FuzzTargets::translate(const QByteArray& input)
+    void translator_data();
+};
+
+#endif // BENCH_FUZZREGRESSIONS_H
@@ -0,0 +1,77 @@
+#include "bench_xmlparser.h"
+#include "benchinputs.h"
+#include <QtTest/QTest>
+#include <QTemporaryFile>
+#include <expressiondocument.h>
+#include <expressionxmlparser.h>
+
+bench_xmlParser::bench_xmlParser(QObject *parent)
+    : QObject{parent}
+{}
+
+// Временный файл с XML-документом из заданного количества выражений
+static bool writeDocument(QTemporaryFile& file, int expressions) {
+    if (!file.open()) return false;
+    file.write(BenchInputs::documentXml(expressions).toUtf8());
+    file.close();
+    return true;
+}
+
+void bench_xmlParser::fixXmlFlags()
+{
+    QFETCH(int, size);
+    const QString xml = BenchInputs::documentXml(size);
+
+    QString fixed;
+    QBENCHMARK {
+        fixed = ExpressionXmlParser::fixXmlFlags(xml);
+    }
+    QVERIFY(fixed.contains("&lt;range&gt; &amp; limits"));
+}
+
+void bench_xmlParser::fixXmlFlags_data()
+{
+    BenchInputs::addScaleRows();
+}
+
+void bench_xmlParser::readXML()
+{
+    QFETCH(int, size);
+    QTemporaryFile file;
+    QVERIFY(writeDocument(file, size));
+
+    QList<TEException> errors;
+    QDomDocument doc;
+    QBENCHMARK {
+        errors.clear();
+        doc = ExpressionXmlParser::readXML(file.fileName(), errors);
+    }
+    QVERIFY(errors.isEmpty());
+    QVERIFY(!doc.isNull());
+}
+
+void bench_xmlParser::readXML_data()
+{
+    BenchInputs::addScaleRows();
+}
+
+void bench_xmlParser::parseQDomDocument()
+{
+    QFETCH(int, size);
+    QTemporaryFile file;
+    QVERIFY(writeDocument(file, size));
+    QList<TEException> errors;
+    const QDomDocument doc = ExpressionXmlParser::readXML(file.fileName(), errors);
+    QVERIFY(errors.isEmpty());
+
+    QBENCHMARK {
+        ExpressionDocument document;
+        ExpressionXmlParser::parseQDomDocument(doc, document, errors);
+    }
+    QVERIFY(errors.isEmpty());
+}
+
+void bench_xmlParser::parseQDomDocument_data()
+{
+    BenchInputs::addScaleRows();
+}
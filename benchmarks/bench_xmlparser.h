@@ -0,0 +1,21 @@
+#ifndef BENCH_XMLPARSER_H
+#define BENCH_XMLPARSER_H
+
+#include <QObject>
+
+class bench_xmlParser : public QObject
+{
+    Q_OBJECT
+public:
+    explicit bench_xmlParser(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void fixXmlFlags(); // static QString ExpressionXmlParser::fixXmlFlags(const QString& xmlString)
+    void fixXmlFlags_data();
+    void readXML(); // static QDomDocument ExpressionXmlParser::readXML(const QString& filePath, QList<TEException>& errors)
+    void readXML_data();
+    void parseQDomDocument(); // static void ExpressionXmlParser::parseQDomDocument(const QDomDocument& doc, ExpressionDocument& document, ...)
+    void parseQDomDocument_data();
+};
+
+#endif // BENCH_XMLPARSER_H
@@ -0,0 +1,93 @@
+#include "benchinputs.h"
+
+#include <QTest>
+
+void BenchInputs::addSizeRows()
+{
+    QTest::addColumn<int>("operands");
+
+    QTest::newRow("small") << 3;
+    QTest::newRow("medium") << 11;
+    QTest::newRow("huge") << 21;
+}
+
+void BenchInputs::addScaleRows()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("small") << 10;
+    QTest::newRow("medium") << 1000;
+    QTest::newRow("huge") << 10000;
+}
+
+int BenchInputs::variableCount(int operands)
+{
+    return qMin(operands, 20);
+}
+
+// Поддерево над операндами [first, last): уровни чередуют сложение и умножение
+static void appendSubtree(QString& output, int first, int last, int level, int variables) {
+    if (last - first == 1) {
+        output += "v" + QString::number(first % variables) + " ";
+        return;
+    }
+    const int middle = first + (last - first) / 2;
+    appendSubtree(output, first, middle, level + 1, variables);
+    appendSubtree(output, middle, last, level + 1, variables);
+    output += level % 2 == 0 ? "+ " : "* ";
+}
+
+QString BenchInputs::expression(int operands)
+{
+    QString output;
+    appendSubtree(output, 0, operands, 0, variableCount(operands));
+    return output.trimmed();
+}
+
+QSharedPointer<const CompiledSchema> BenchInputs::schema(int operands)
+{
+    QHash<QString, Variable> variables;
+    for (int i = 0; i < variableCount(operands); i++) {
+        QString name = "v" + QString::number(i);
+        variables.insert(name, Variable(name, "int", "value number " + QString::number(i)));
+    }
+    return CompiledSchema::create(variables);
+}
+
+QString BenchInputs::documentXml(int expressions)
+{
+    const int operands = 21;
+    const QString body = expression(operands);
+    QString xml = "<root><expressions>";
+    for (int i = 0; i < expressions; i++) {
+        xml += "<expression id=\"e" + QString::number(i + 1) + "\">" + body + "</expression>";
+    }
+    xml += "</expressions><variables>";
+    for (int i = 0; i < variableCount(operands); i++) {
+        xml += "<variable name=\"v" + QString::number(i) + "\" type=\"int\"><description>value number "
+               + QString::number(i) + " of <range> & limits</description></variable>";
+    }
+    xml += "</variables><functions/><unions/><structures/><classes/><enums/></root>";
+    return xml;
+}
+
+QString BenchInputs::translatorTemplate(int placeholders)
+{
+    QStringList parts;
+    for (int i = 1; i <= placeholders; i++) parts.append("{" + QString::number(i) + "}");
+    return "sum of " + parts.join(", ");
+}
+
+QStringList BenchInputs::translatorArguments(int count)
+{
+    QStringList arguments;
+    for (int i = 0; i < count; i++) arguments.append("value number " + QString::number(i));
+    return arguments;
+}
+
+QString BenchInputs::repeatedWords(int words)
+{
+    QStringList output;
+    for (int i = 0; i < words; i++) output.append(i % 3 == 0 ? "of" : "value" + QString::number(i / 2));
+    return output.join(' ');
+}
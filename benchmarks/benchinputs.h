@@ -0,0 +1,85 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса BenchInputs — входных данных замеров производительности
+ */
+
+#ifndef BENCHINPUTS_H
+#define BENCHINPUTS_H
+
+#include "compiledschema.h"
+
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Входные данные замеров производительности
+ *
+ * Выражение — сбалансированное дерево сложений и умножений переменных схемы. Размеры small, medium и huge
+ * задаются отдельно для двух групп замеров:
+ * - построение и объяснение дерева (addSizeRows) — количество операндов выражения; размер huge предельный
+ *   для программы: 20 операций в выражении (Expression) и 20 переменных в схеме (ExpressionXmlParser);
+ * - функции без этих пределов (addScaleRows) — количество лексем выражения, подстановок в шаблон,
+ *   слов объяснения или выражений XML-документа.
+ */
+class BenchInputs
+{
+public:
+    /*!
+     * \brief Добавление строк small, medium и huge замеров дерева выражения (столбец "operands": 3, 11 и 21)
+     */
+    static void addSizeRows();
+
+    /*!
+     * \brief Добавление строк small, medium и huge остальных замеров (столбец "size": 10, 1000 и 10000)
+     */
+    static void addScaleRows();
+
+    /*!
+     * \brief Получение количества переменных схемы: по переменной на операнд, но не больше предела схемы
+     * \param[in] operands Количество операндов
+     */
+    static int variableCount(int operands);
+
+    /*!
+     * \brief Построение выражения в обратной польской записи
+     * \param[in] operands Количество операндов
+     * \return Выражение над переменными v0..v(variableCount-1); каждая переменная используется
+     */
+    static QString expression(int operands);
+
+    /*!
+     * \brief Построение схемы с переменными выражения
+     * \param[in] operands Количество операндов
+     */
+    static QSharedPointer<const CompiledSchema> schema(int operands);
+
+    /*!
+     * \brief Построение XML-документа с выражениями (<expressions>) над схемой из 20 переменных
+     *
+     * Каждое выражение предельного размера (21 операнд); описания переменных содержат символы,
+     * которые экранирует ExpressionXmlParser::fixXmlFlags.
+     * \param[in] expressions Количество выражений
+     */
+    static QString documentXml(int expressions);
+
+    /*!
+     * \brief Построение шаблона объяснения с подстановками {1}..{N}
+     * \param[in] placeholders Количество подстановок
+     */
+    static QString translatorTemplate(int placeholders);
+
+    /*!
+     * \brief Построение аргументов шаблона объяснения
+     * \param[in] count Количество аргументов
+     */
+    static QStringList translatorArguments(int count);
+
+    /*!
+     * \brief Построение объяснения с повторяющимися подряд словами
+     * \param[in] words Количество слов
+     */
+    static QString repeatedWords(int words);
+};
+
+#endif // BENCHINPUTS_H
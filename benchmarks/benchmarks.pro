@@ -0,0 +1,28 @@
+include(../textExplanationsOnEng/textExplanationsOnEng.pri)
+
+QT = core \
+    testlib \
+    xml
+
+# Замеры имеют смысл только в оптимизированной сборке, независимо от конфигурации проекта
+CONFIG -= debug debug_and_release
+CONFIG += release
+
+# Входные данные, найденные фаззерами сложности, замеряются теми же функциями, что и в фаззерах
+INCLUDEPATH += ../fuzz
+DEFINES += FUZZ_REGRESSIONS_DIR=\\\"$$PWD/../fuzz/regressions\\\"
+
+SOURCES += \
+    main.cpp \
+    benchinputs.cpp \
+    bench_expression.cpp \
+    bench_fuzzregressions.cpp \
+    bench_xmlparser.cpp \
+    ../fuzz/fuzztargets.cpp
+
+HEADERS += \
+    benchinputs.h \
+    bench_expression.h \
+    bench_fuzzregressions.h \
+    bench_xmlparser.h \
+    ../fuzz/fuzztargets.h
@@ -0,0 +1,126 @@
+/*!
+* \file
+* \brief Данный файл содержит главную функцию замеров производительности textExplanationsOnEng.
+*
+* Замеры выполняются средствами QtTest (QBENCHMARK) для входных данных размеров small, medium и huge,
+* а также для входных данных, найденных фаззерами сложности (fuzz/regressions).
+* Результаты выводятся в консоль и сохраняются в JSON-файл (параметр --json, по умолчанию benchmarks.json),
+* чтобы запуски можно было сравнивать. Остальные параметры передаются QtTest, например:
+* \code
+./benchmarks --json before.json
+./benchmarks --json after.json -tickcounter
+./benchmarks -minimumvalue 50 -iterations 1000
+* \endcode
+*/
+
+#include "bench_expression.h"
+#include "bench_fuzzregressions.h"
+#include "bench_xmlparser.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTextStream>
+#include <QXmlStreamReader>
+
+/*!
+ * \brief Добавление результатов замеров из XML-отчёта QtTest
+ * \param[in] xmlReport Отчёт QtTest в формате xml
+ * \param[in] testCase Имя класса замеров
+ * \param[out] results Результаты замеров
+ */
+static void appendResults(const QByteArray& xmlReport, const QString& testCase, QJsonArray& results)
+{
+    QXmlStreamReader reader(xmlReport);
+    QString function;
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) continue;
+        if (reader.name() == QLatin1String("TestFunction")) {
+            function = reader.attributes().value("name").toString();
+        }
+        else if (reader.name() == QLatin1String("BenchmarkResult")) {
+            const QXmlStreamAttributes attributes = reader.attributes();
+            results.append(QJsonObject{
+                {"benchmark", testCase + "::" + function},
+                {"size", attributes.value("tag").toString()},
+                {"metric", attributes.value("metric").toString()},
+                {"value", attributes.value("value").toDouble()},
+                {"iterations", attributes.value("iterations").toInt()}});
+        }
+    }
+}
+
+/*!
+ * \brief Запуск замеров одного класса
+ * \param[in] object Класс замеров
+ * \param[in] arguments Параметры QtTest
+ * \param[in] reportPath Путь к временному XML-отчёту
+ * \param[out] results Результаты замеров
+ * \return Код возврата QtTest
+ */
+static int runBenchmark(QObject* object, const QStringList& arguments, const QString& reportPath, QJsonArray& results)
+{
+    // Результаты выводятся в консоль и в XML-отчёт, из которого собирается JSON
+    QStringList testArguments = arguments;
+    testArguments << "-o" << reportPath + ",xml" << "-o" << "-,txt";
+    int result = QTest::qExec(object, testArguments);
+
+    QFile report(reportPath);
+    if (report.open(QIODevice::ReadOnly)) {
+        appendResults(report.readAll(), object->metaObject()->className(), results);
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream cerr(stderr);
+
+    QStringList arguments = QCoreApplication::arguments();
+    QString jsonPath = "benchmarks.json";
+    qsizetype jsonIndex = arguments.indexOf("--json");
+    if (jsonIndex > 0) {
+        jsonPath = arguments.value(jsonIndex + 1);
+        arguments.remove(jsonIndex, qMin<qsizetype>(2, arguments.size() - jsonIndex));
+    }
+    if (jsonPath.isEmpty()) {
+        cerr << "--json requires a file name\n";
+        return 1;
+    }
+
+    QTemporaryDir reportDir;
+    if (!reportDir.isValid()) {
+        cerr << "Cannot create a temporary directory: " << reportDir.errorString() << "\n";
+        return 1;
+    }
+
+    int result = 0;
+    QJsonArray results;
+
+    bench_expression expression;
+    result |= runBenchmark(&expression, arguments, reportDir.filePath("expression.xml"), results);
+
+    bench_xmlParser xmlParser;
+    result |= runBenchmark(&xmlParser, arguments, reportDir.filePath("xmlparser.xml"), results);
+
+    bench_fuzzRegressions fuzzRegressions;
+    result |= runBenchmark(&fuzzRegressions, arguments, reportDir.filePath("fuzzregressions.xml"), results);
+
+    QJsonObject root{
+        {"qt_version", QString(qVersion())},
+        {"cpu_architecture", QSysInfo::currentCpuArchitecture()},
+        {"kernel", QSysInfo::kernelType() + " " + QSysInfo::kernelVersion()},
+        {"results", results}};
+    QFile json(jsonPath);
+    if (!json.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        cerr << "Cannot write " << jsonPath << ": " << json.errorString() << "\n";
+        return 1;
+    }
+    json.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return result;
+}
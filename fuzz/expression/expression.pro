@@ -0,0 +1,6 @@
+include(../fuzz.pri)
+
+TARGET = fuzz_expression
+
+SOURCES += \
+    fuzz_expression.cpp
@@ -0,0 +1,18 @@
+include(../textExplanationsOnEng/textExplanationsOnEng.pri)
+
+QT = core \
+    xml
+
+# Фаззеры собираются только clang: qmake -spec linux-clang (libFuzzer предоставляет main)
+QMAKE_CXXFLAGS += -fsanitize=fuzzer,address -g -fno-omit-frame-pointer
+QMAKE_LFLAGS += -fsanitize=fuzzer,address
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/fuzzcost.cpp \
+    $$PWD/fuzztargets.cpp
+
+HEADERS += \
+    $$PWD/fuzzcost.h \
+    $$PWD/fuzztargets.h
@@ -0,0 +1,9 @@
+# Фаззеры сложности: сборка только clang с libFuzzer, поэтому в общий проект не входят
+#   qmake -spec linux-clang fuzz.pro && make
+#   TE_FUZZ_FINDINGS=findings xmlparser/fuzz_xmlparser -max_len=4096 -use_value_profile=1 corpus regressions/xmlparser
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    expression \
+    translator \
+    xmlparser
@@ -0,0 +1,94 @@
+#include "fuzzcost.h"
+#include "allocationtracker.h"
+#include "perfcounters.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <cmath>
+#include <cstdlib>
+
+// Дополнительные счётчики libFuzzer: фаззер обнуляет их перед каждым входом и считает новым покрытием
+// каждое ненулевое значение, которого ещё не видел
+#ifdef Q_OS_LINUX
+__attribute__((used, section("__libfuzzer_extra_counters")))
+#endif
+static unsigned char extraCounters[FuzzCost::bucketCount];
+
+static bool useInstructions = false;    // Стоимость — инструкции, иначе выделения памяти (malloc)
+static qint64 emptyInputCost = 0;       // Стоимость пустого входа
+static double bestCostPerByte = 0;      // Наибольшая записанная стоимость байта
+static QString findingsDir;             // Каталог найденных входов цели (пустой — не записывать)
+
+void FuzzCost::initialize(const QString &target, void (*run)(const QByteArray &))
+{
+    QString perfError;
+    useInstructions = PerfCounters::enable(&perfError);
+    QTextStream err(stderr);
+    if (!useInstructions) {
+        // Стоимость без учёта malloc не видит буферы QString, QList и QByteArray — фаззер работал бы вслепую
+        AllocationTracker::enable();
+        const qint64 allocationsBefore = AllocationTracker::threadTotals().count;
+        const QByteArray probe(1024, '\0');
+        if (probe.isEmpty() || AllocationTracker::threadTotals().count == allocationsBefore) {
+            err << "fuzz cost: no usable metric: hardware counters unavailable (" << perfError
+                << ") and allocation tracking does not see malloc in this build" << Qt::endl;
+            std::exit(1);
+        }
+    }
+    err << "fuzz cost: metric " << metricName() << Qt::endl;
+
+    const QString findingsRoot = qEnvironmentVariable("TE_FUZZ_FINDINGS");
+    if (!findingsRoot.isEmpty()) {
+        findingsDir = QDir(findingsRoot).filePath(target);
+        QDir().mkpath(findingsDir);
+    }
+
+    // Первый вызов заполняет статические таблицы; постоянные затраты — наименьшая из нескольких попыток
+    run(QByteArray());
+    for (int attempt = 0; attempt < 5; attempt++) {
+        const qint64 before = measure();
+        run(QByteArray());
+        const qint64 cost = measure() - before;
+        emptyInputCost = attempt == 0 ? cost : qMin(emptyInputCost, cost);
+    }
+}
+
+qint64 FuzzCost::measure()
+{
+    if (!useInstructions) return AllocationTracker::threadTotals().count;
+    HardwareCounterValues values;
+    if (!PerfCounters::read(values)) {
+        // Подмена метрики посреди работы сделала бы стоимости входов несравнимыми
+        QTextStream(stderr) << "fuzz cost: hardware counters cannot be read" << Qt::endl;
+        std::exit(1);
+    }
+    return values[int(HardwareCounter::Instructions)];
+}
+
+void FuzzCost::report(const QByteArray &input, qint64 cost)
+{
+    if (input.size() < minInputBytes) return;
+    const double costPerByte = double(qMax<qint64>(0, cost - emptyInputCost)) / input.size();
+    extraCounters[bucket(costPerByte)] = 1;
+
+    if (findingsDir.isEmpty() || costPerByte <= bestCostPerByte * 1.1) return;
+    bestCostPerByte = costPerByte;
+    const QString name = QString("%1-%2.in")
+                             .arg(qint64(costPerByte), 8, 10, QChar('0'))
+                             .arg(QString(QCryptographicHash::hash(input, QCryptographicHash::Sha1).toHex().left(12)));
+    QFile file(QDir(findingsDir).filePath(name));
+    if (file.open(QIODevice::WriteOnly)) file.write(input);
+}
+
+int FuzzCost::bucket(double costPerByte)
+{
+    if (!(costPerByte >= 1)) return 0;
+    return qMin(bucketCount - 1, 1 + int(std::log2(costPerByte) * 4));
+}
+
+QString FuzzCost::metricName()
+{
+    return useInstructions ? "instructions" : "allocations";
+}
@@ -0,0 +1,71 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса FuzzCost — обратной связи фаззера по стоимости обработки входных данных
+ */
+
+#ifndef FUZZCOST_H
+#define FUZZCOST_H
+
+#include <QByteArray>
+#include <QString>
+
+/*!
+ * \brief Обратная связь фаззера по стоимости обработки одного байта входных данных
+ *
+ * Стоимость — количество выполненных инструкций (PerfCounters), а если аппаратные счётчики недоступны —
+ * количество выделений памяти на уровне malloc (AllocationTracker; под ASan — через обработчики санитайзера).
+ * Если недоступны обе метрики, фаззер завершается с сообщением об ошибке, а не работает без обратной связи.
+ * Выбранная метрика выводится в stderr при запуске. Из стоимости вычитается стоимость пустого входа,
+ * остаток делится на размер входа. Стоимость байта переводится в номер корзины (четверть октавы) и
+ * отмечается в дополнительных счётчиках libFuzzer: каждая новая корзина для фаззера — новое покрытие,
+ * поэтому входы, на которых байт обходится дороже, сохраняются в корпусе и служат основой следующих мутаций.
+ * Так фаззер наращивает работу на байт и находит сверхлинейное поведение.
+ *
+ * Если задана переменная окружения TE_FUZZ_FINDINGS, каждый вход, превысивший наибольшую стоимость байта
+ * больше чем на 10%, записывается в каталог $TE_FUZZ_FINDINGS/<цель>; файлы из этого каталога переносятся
+ * в fuzz/regressions/<цель> и становятся замерами bench_fuzzRegressions.
+ */
+class FuzzCost
+{
+public:
+    static constexpr int bucketCount = 64;      ///< Количество корзин стоимости байта
+    static constexpr int minInputBytes = 16;    ///< Меньшие входы не учитываются: у них стоимость байта определяется постоянными затратами
+
+    /*!
+     * \brief Выбор метрики и замер стоимости пустого входа
+     *
+     * Если аппаратные счётчики недоступны и учёт выделений не видит malloc (пробное выделение QByteArray
+     * не учтено), программа завершается с кодом 1.
+     * \param[in] target Имя цели (подкаталог для найденных входов)
+     * \param[in] run Функция цели
+     */
+    static void initialize(const QString& target, void (*run)(const QByteArray&));
+
+    /*!
+     * \brief Получение накопленной стоимости текущего потока
+     *
+     * Если выбранные при инициализации аппаратные счётчики перестали читаться, программа завершается с кодом 1.
+     */
+    static qint64 measure();
+
+    /*!
+     * \brief Учёт стоимости обработки входа: отметка корзины и запись нового наибольшего значения
+     * \param[in] input Входные байты
+     * \param[in] cost Стоимость обработки (разность двух measure())
+     */
+    static void report(const QByteArray& input, qint64 cost);
+
+    /*!
+     * \brief Получение номера корзины стоимости байта
+     * \param[in] costPerByte Стоимость одного байта
+     * \return 0 для стоимости меньше 1, иначе 1 + 4 * log2(costPerByte), но не больше bucketCount - 1
+     */
+    static int bucket(double costPerByte);
+
+    /*!
+     * \brief Получение названия метрики стоимости (instructions или allocations)
+     */
+    static QString metricName();
+};
+
+#endif // FUZZCOST_H
@@ -0,0 +1,59 @@
+#include "fuzztargets.h"
+#include "compiledschema.h"
+#include "expression.h"
+#include "expressiondocument.h"
+#include "expressiontranslator.h"
+#include "expressionxmlparser.h"
+
+/*!
+ * \brief Получение постоянной схемы цели expression
+ */
+static const QSharedPointer<const CompiledSchema>& treeSchema()
+{
+    static const QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")},
+         {"b", Variable("b", "int", "second value")},
+         {"arr", Variable("arr", "int[]", "values")},
+         {"p", Variable("p", "Point", "point")}},
+        {{"f", Function("f", "int", 2, "function f")}},
+        {},
+        {{"Point", Structure("Point", {{"x", Variable("x", "int", "coordinate")}})}},
+        {},
+        {{"Color", Enum("Color", {{"Red", "red color"}})}});
+    return schema;
+}
+
+void FuzzTargets::parseDocument(const QByteArray &input)
+{
+    ExpressionDocument document;
+    ExpressionXmlParser::tryReadDocumentFromXMLContent(QString::fromUtf8(input), document, "fuzz");
+}
+
+void FuzzTargets::buildTree(const QByteArray &input)
+{
+    Expression expression(treeSchema(), QString::fromUtf8(input));
+    // Использованные элементы собираются, чтобы неиспользованные элементы схемы не были ошибкой
+    QSet<QString> usedElements;
+    TEResult<ExpressionNode*> tree = expression.tryExpressionToNodes(&usedElements);
+    if (tree.isOk()) delete tree.value();
+}
+
+void FuzzTargets::translate(const QByteArray &input)
+{
+    const QStringList lines = QString::fromUtf8(input).split('\n');
+    ExpressionTranslator::tryGetExplanation(lines.first(), lines.mid(1));
+}
+
+QStringList FuzzTargets::targetNames()
+{
+    return {"xmlparser", "expression", "translator"};
+}
+
+bool FuzzTargets::run(const QString &target, const QByteArray &input)
+{
+    if (target == "xmlparser") parseDocument(input);
+    else if (target == "expression") buildTree(input);
+    else if (target == "translator") translate(input);
+    else return false;
+    return true;
+}
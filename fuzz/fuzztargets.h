@@ -0,0 +1,58 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса FuzzTargets — функций, проверяемых фаззингом на сложность
+ */
+
+#ifndef FUZZTARGETS_H
+#define FUZZTARGETS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Функции, проверяемые фаззингом на сверхлинейную сложность
+ *
+ * Каждая функция получает произвольные байты, преобразует их во входные данные одного этапа обработки
+ * и выполняет этот этап. Одни и те же функции вызываются фаззерами (fuzz) и замерами найденных
+ * фаззерами входных данных (benchmarks), поэтому замер воспроизводит ровно ту работу, которую нашёл фаззер.
+ */
+class FuzzTargets
+{
+public:
+    /*!
+     * \brief Разбор XML-документа из памяти (ExpressionXmlParser::tryReadDocumentFromXMLContent)
+     * \param[in] input Текст документа в UTF-8
+     */
+    static void parseDocument(const QByteArray& input);
+
+    /*!
+     * \brief Построение дерева выражения (Expression::tryExpressionToNodes) над постоянной схемой
+     *
+     * Схема содержит переменные a, b (int), arr (int[]) и p (структура Point с полем x),
+     * функцию f с двумя параметрами и перечисление Color со значением Red.
+     * \param[in] input Выражение в постфиксной записи в UTF-8
+     */
+    static void buildTree(const QByteArray& input);
+
+    /*!
+     * \brief Подстановка аргументов в шаблон объяснения (ExpressionTranslator::tryGetExplanation)
+     * \param[in] input Строки в UTF-8: первая — шаблон, остальные — аргументы
+     */
+    static void translate(const QByteArray& input);
+
+    /*!
+     * \brief Получение имён целей фаззинга: имена подкаталогов fuzz и fuzz/regressions
+     */
+    static QStringList targetNames();
+
+    /*!
+     * \brief Выполнение функции цели по имени
+     * \param[in] target Имя цели (xmlparser, expression или translator)
+     * \param[in] input Входные байты
+     * \return false, если цели с таким именем нет
+     */
+    static bool run(const QString& target, const QByteArray& input);
+};
+
+#endif // FUZZTARGETS_H
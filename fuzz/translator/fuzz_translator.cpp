@@ -0,0 +1,22 @@
+/*!
+* \file
+* \brief Данный файл содержит точки входа libFuzzer для поиска сверхлинейных входных данных: подстановка аргументов в шаблон объяснения.
+*/
+
+#include "fuzzcost.h"
+#include "fuzztargets.h"
+
+extern "C" int LLVMFuzzerInitialize(int*, char***)
+{
+    FuzzCost::initialize("translator", &FuzzTargets::translate);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    const QByteArray input = QByteArray::fromRawData(reinterpret_cast<const char*>(data), qsizetype(size));
+    const qint64 before = FuzzCost::measure();
+    FuzzTargets::translate(input);
+    FuzzCost::report(input, FuzzCost::measure() - before);
+    return 0;
+}
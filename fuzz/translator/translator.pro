@@ -0,0 +1,6 @@
+include(../fuzz.pri)
+
+TARGET = fuzz_translator
+
+SOURCES += \
+    fuzz_translator.cpp
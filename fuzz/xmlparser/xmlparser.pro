@@ -0,0 +1,6 @@
+include(../fuzz.pri)
+
+TARGET = fuzz_xmlparser
+
+SOURCES += \
+    fuzz_xmlparser.cpp
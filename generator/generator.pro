@@ -0,0 +1,11 @@
+include(../textExplanationsOnEng/textExplanationsOnEng.pri)
+
+QT = core \
+    xml
+
+SOURCES += \
+    main.cpp \
+    workloadgenerator.cpp
+
+HEADERS += \
+    workloadgenerator.h
@@ -0,0 +1,168 @@
+/*!
+* \file
+* \brief Данный файл содержит главную функцию генератора синтетических входных документов textExplanationsOnEng.
+*
+* Генератор записывает в каталог --out-dir заданное количество корректных документов (document_0001.xml, ...)
+* или, с параметром --invalid, по одному некорректному документу на каждый тип ошибки (invalid_<ErrorType>.xml).
+* Каждый документ перед записью проверяется программой. Одинаковые параметры и --seed дают одинаковые документы:
+* \code
+./generator --seed 7 --count 100 --out-dir corpus
+./generator --seed 7 --variables 10 --functions 5 --max-params 5 --operations 20 --depth 8 --expressions 20 --out-dir large
+./generator --seed 7 --invalid --out-dir invalid
+* \endcode
+*/
+
+#include "workloadgenerator.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+
+/*!
+ * \brief Печать справки генератора
+ * \param[in,out] out Поток вывода
+ */
+static void printHelp(QTextStream& out)
+{
+    out << "Usage: generator [options] --out-dir <dir>\n"
+           "  --seed <n>          seed of the random generator (default 1)\n"
+           "  --count <n>         number of valid documents (default 1)\n"
+           "  --invalid           write one invalid document per error type instead of valid documents\n"
+           "  --variables <n>     variables of basic types (default 6)\n"
+           "  --functions <n>     functions (default 3)\n"
+           "  --max-params <n>    maximum parameters of a function, up to 5 (default 3)\n"
+           "  --unions <n>        unions (default 1)\n"
+           "  --structures <n>    structures (default 1)\n"
+           "  --classes <n>       classes (default 1)\n"
+           "  --fields <n>        fields of a custom type (default 2)\n"
+           "  --methods <n>       methods of a custom type (default 1)\n"
+           "  --enums <n>         enums (default 1)\n"
+           "  --values <n>        values of an enum (default 3)\n"
+           "  --operations <n>    operations of a random expression, up to 20 (default 10)\n"
+           "  --depth <n>         maximum depth of a random expression (default 6)\n"
+           "  --expressions <n>   random expressions of a document (default 4)\n";
+}
+
+/*!
+ * \brief Запись документа в файл
+ * \param[in] path Путь к файлу
+ * \param[in] xml Текст документа
+ * \param[in,out] err Поток ошибок
+ * \return Успешность записи
+ */
+static bool writeDocument(const QString& path, const QString& xml, QTextStream& err)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err << "Cannot write " << path << ": " << file.errorString() << "\n";
+        return false;
+    }
+    file.write(xml.toUtf8());
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    GeneratorOptions options;
+    int count = 1;
+    bool invalid = false;
+    QString outputDir;
+    const QHash<QString, int*> counts{
+        {"--count", &count}, {"--variables", &options.variables}, {"--functions", &options.functions},
+        {"--max-params", &options.maxParams}, {"--unions", &options.unions}, {"--structures", &options.structures},
+        {"--classes", &options.classes}, {"--fields", &options.fields}, {"--methods", &options.methods},
+        {"--enums", &options.enums}, {"--values", &options.values}, {"--operations", &options.operations},
+        {"--depth", &options.depth}, {"--expressions", &options.expressions}};
+
+    const QStringList args = QCoreApplication::arguments().mid(1);
+    for (qsizetype i = 0; i < args.size(); i++) {
+        bool isNumber = true;
+        if (args[i] == "-help" || args[i] == "--help") {
+            printHelp(out);
+            return 0;
+        }
+        else if (args[i] == "--invalid")
+            invalid = true;
+        else if (i + 1 >= args.size()) {
+            err << "Option " << args[i] << " requires a value\n";
+            return 1;
+        }
+        else if (args[i] == "--out-dir")
+            outputDir = args[++i];
+        else if (args[i] == "--seed")
+            options.seed = args[++i].toUInt(&isNumber);
+        else if (counts.contains(args[i])) {
+            int* value = counts.value(args[i]);
+            *value = args[++i].toInt(&isNumber);
+        }
+        else {
+            err << "Unknown option " << args[i] << "\n";
+            printHelp(err);
+            return 1;
+        }
+        if (!isNumber) {
+            err << "Option " << args[i - 1] << " requires a number\n";
+            return 1;
+        }
+    }
+
+    const QString optionsError = WorkloadGenerator::checkOptions(options);
+    if (outputDir.isEmpty() || count < 1 || !optionsError.isEmpty()) {
+        err << (optionsError.isEmpty() ? QString("--out-dir and a positive --count are required") : optionsError) << "\n";
+        return 1;
+    }
+    if (!QDir().mkpath(outputDir)) {
+        err << "Cannot create " << outputDir << "\n";
+        return 1;
+    }
+
+    WorkloadGenerator generator(options);
+    const QDir dir(outputDir);
+    int written = 0;
+
+    if (invalid) {
+        for (const InvalidDocument& document : generator.generateInvalidDocuments()) {
+            const QString name = TEException::ErrorTypeNames.value(document.errorType);
+            // Документ пригоден, только если программа действительно находит в нём ожидаемую ошибку
+            bool found = false;
+            for (const TEException& error : WorkloadGenerator::collectErrors(document.xml)) {
+                found = found || error.getErrorType() == document.errorType;
+            }
+            if (!found) {
+                err << "Generated document does not produce " << name << "\n";
+                return 1;
+            }
+            if (!writeDocument(dir.filePath("invalid_" + name + ".xml"), document.xml, err)) return 1;
+            written++;
+        }
+        QStringList skipped;
+        for (ErrorType errorType : WorkloadGenerator::ungeneratableErrorTypes()) {
+            skipped.append(TEException::ErrorTypeNames.value(errorType));
+        }
+        err << "Not produced by document content: " << skipped.join(", ") << "\n";
+    }
+    else {
+        for (int i = 1; i <= count; i++) {
+            const QString xml = generator.generateDocument();
+            const QList<TEException> errors = WorkloadGenerator::collectErrors(xml);
+            if (!errors.isEmpty()) {
+                err << "Generated document " << i << " is invalid:\n";
+                for (const TEException& error : errors) err << error.what() << "\n";
+                return 1;
+            }
+            if (!writeDocument(dir.filePath(QString("document_%1.xml").arg(i, 4, 10, QChar('0'))), xml, err)) return 1;
+            written++;
+        }
+        const QStringList uncovered = generator.uncoveredOperators();
+        if (!uncovered.isEmpty())
+            err << "Operators not used by the generated expressions: " << uncovered.join(" ") << "\n";
+    }
+
+    out << written << " documents written to " << QDir::toNativeSeparators(dir.absolutePath()) << "\n";
+    return 0;
+}
@@ -0,0 +1,700 @@
+#include "workloadgenerator.h"
+#include "expression.h"
+#include "expressiondocument.h"
+#include "expressionxmlparser.h"
+
+#include <algorithm>
+
+// Слова для имён и описаний; списки имён переменных, полей и типов не пересекаются,
+// чтобы имя поля или значения перечисления не совпало с именем переменной схемы
+static const QStringList variableNouns = {"count", "total", "speed", "price", "score", "level", "limit", "offset"};
+static const QStringList fieldNouns = {"width", "height", "amount", "weight", "ratio", "title", "label", "ready"};
+static const QStringList typeNouns = {"Point", "Order", "Sensor", "Account", "Vector", "Packet", "Window", "Engine"};
+static const QStringList enumNouns = {"Color", "Mode", "State", "Direction", "Priority", "Stage"};
+static const QStringList valueNouns = {"LOW", "HIGH", "IDLE", "BUSY", "OPEN", "CLOSED", "READY", "DONE"};
+static const QStringList functionVerbs = {"compute", "measure", "convert", "estimate", "combine", "normalize"};
+static const QStringList adjectives = {"current", "maximum", "minimum", "average", "initial", "final", "next", "previous"};
+static const QStringList descriptionNouns = {"speed", "price", "distance", "weight", "temperature", "balance", "height", "volume"};
+static const QStringList textWords = {"alpha", "beta", "gamma", "delta", "omega"};
+
+// Типы полей и переменных базовых типов; числовые типы встречаются чаще
+static const QStringList scalarTypes = {"int", "int", "float", "double", "bool", "char", "string"};
+static const QStringList functionTypes = {"int", "double", "bool", "string"};
+
+// Количество попыток построить выражение, для которого программа получает объяснение
+static const int expressionAttempts = 50;
+
+WorkloadGenerator::WorkloadGenerator(const GeneratorOptions& options)
+    : options(options)
+    , random(options.seed)
+    , operators(OperationMap.keys())
+{
+    // Порядок ключей QHash меняется от запуска к запуску, поэтому выбор идёт по отсортированному списку
+    operators.sort();
+}
+
+QString WorkloadGenerator::checkOptions(const GeneratorOptions& options)
+{
+    const int limit = 20;
+    const int customTypeCount = options.unions + options.structures + options.classes;
+    const QList<int> counts{options.variables, options.functions, options.maxParams, options.unions, options.structures, options.classes,
+                            options.fields, options.methods, options.enums, options.values, options.operations, options.depth, options.expressions};
+    for (int count : counts) {
+        if (count < 0) return "Counts must not be negative";
+    }
+    // Экземпляры пользовательских типов и переменные перечислений записываются в раздел <variables>
+    if (options.variables + customTypeCount + options.enums > limit)
+        return QString("Variables, custom types and enums together exceed %1 variables of the schema").arg(limit);
+    if (options.functions > limit || options.unions > limit || options.structures > limit || options.classes > limit || options.enums > limit)
+        return QString("A schema section cannot contain more than %1 elements").arg(limit);
+    if (options.fields + options.methods > limit)
+        return QString("A custom type cannot contain more than %1 fields and methods").arg(limit);
+    if (options.values > limit)
+        return QString("An enum cannot contain more than %1 values").arg(limit);
+    if (options.enums > 0 && options.values == 0)
+        return "An enum must contain at least one value";
+    if (options.maxParams > 5)
+        return "A function cannot have more than 5 parameters";
+    if (options.operations > limit)
+        return QString("An expression cannot contain more than %1 operations").arg(limit);
+    if (options.depth == 0 || options.expressions == 0)
+        return "Depth and expressions count must be positive";
+    return QString();
+}
+
+// Базовый тип без признаков массива и указателя, как в Expression::sanitizeDataType
+static QString baseType(const QString& type)
+{
+    if (type.contains('[')) return type.left(type.indexOf('['));
+    if (type.contains('*')) return type.left(type.indexOf('*'));
+    return type;
+}
+
+template<typename T>
+const T& WorkloadGenerator::pick(const QList<T>& list)
+{
+    return list.at(random.bounded(int(list.size())));
+}
+
+WorkloadGenerator::ValueKind WorkloadGenerator::kindOfType(const QString& type)
+{
+    const QString dataType = baseType(type);
+    if (dataType == "bool") return ValueKind::Bool;
+    if (dataType == "char" || dataType == "string") return ValueKind::Text;
+    if (dataType == "int" || dataType == "float" || dataType == "double") return ValueKind::Number;
+    return ValueKind::Enum;
+}
+
+// Перечисление плейсхолдеров: "{1}", "{1} and {2}", "{1}, {2} and {3}"
+static QString placeholders(int count)
+{
+    QStringList parts;
+    for (int i = 1; i <= count; i++) parts.append("{" + QString::number(i) + "}");
+    if (parts.size() < 2) return parts.join("");
+    const QString last = parts.takeLast();
+    return parts.join(", ") + " and " + last;
+}
+
+void WorkloadGenerator::generateSchema()
+{
+    variables.clear();
+    functions.clear();
+    customTypes.clear();
+    enums.clear();
+
+    // Случайные слова выбираются отдельными операторами: порядок вычисления операндов "+" не определён,
+    // а последовательность чисел генератора должна быть одинаковой при любом компиляторе
+    auto describe = [this](const QString& type) {
+        const QString adjective = pick(adjectives);
+        const QString noun = pick(descriptionNouns);
+        switch (kindOfType(type)) {
+        case ValueKind::Bool: return "whether the " + noun + " is " + adjective;
+        case ValueKind::Text: return "name of the " + adjective + " " + noun;
+        default: return "the " + adjective + " " + noun;
+        }
+    };
+
+    for (int i = 0; i < options.variables; i++) {
+        // Первая переменная целая, чтобы у числовых операций всегда была переменная-операнд;
+        // последние переменные — массив для [] и указатель для *_ и &
+        QString type = i == 0 ? "int" : pick(scalarTypes);
+        if (options.variables >= 3 && i == options.variables - 1) type = "int[16]";
+        else if (options.variables >= 4 && i == options.variables - 2) type = "int*";
+        const QString name = pick(variableNouns) + QString::number(i);
+        variables.append(Variable(name, type, describe(type)));
+    }
+
+    for (int i = 0; i < options.functions; i++) {
+        const QString name = pick(functionVerbs) + QString::number(i);
+        const QString type = pick(functionTypes);
+        const int params = random.bounded(options.maxParams + 1);
+        const QString description = params == 0 ? describe("int") : "the " + pick(descriptionNouns) + " computed from " + placeholders(params);
+        functions.append(Function(name, type, params, description));
+    }
+
+    const QList<QPair<QString, int>> kinds{{"union", options.unions}, {"structure", options.structures}, {"class", options.classes}};
+    for (const QPair<QString, int>& kind : kinds) {
+        for (int i = 0; i < kind.second; i++) {
+            CustomType customType;
+            customType.kind = kind.first;
+            customType.name = pick(typeNouns) + QString::number(customTypes.size());
+            const QString owner = customType.name.toLower();
+            for (int k = 0; k < options.fields; k++) {
+                const QString noun = pick(fieldNouns);
+                const QString type = pick(scalarTypes);
+                customType.fields.append(Variable(noun + QString::number(k), type, noun + " of the " + owner));
+            }
+            for (int k = 0; k < options.methods; k++) {
+                const QString noun = pick(fieldNouns);
+                const QString type = pick(functionTypes);
+                customType.methods.append(Function("get" + noun.left(1).toUpper() + noun.mid(1) + QString::number(k), type, 0,
+                                                   "the computed " + noun + " of the " + owner));
+            }
+            // Экземпляры через один объявлены указателями: к полям обращаются и через ., и через ->
+            customType.instance = "my" + customType.name;
+            const QString instanceType = customTypes.size() % 2 == 0 ? customType.name : customType.name + "*";
+            variables.append(Variable(customType.instance, instanceType, "the " + pick(adjectives) + " " + owner));
+            customTypes.append(customType);
+        }
+    }
+
+    for (int i = 0; i < options.enums; i++) {
+        EnumType enumType;
+        enumType.name = pick(enumNouns) + QString::number(i);
+        for (int k = 0; k < options.values; k++) {
+            const QString value = pick(valueNouns);
+            enumType.values.append(value + "_" + QString::number(k));
+            enumType.descriptions.append(value.toLower() + " " + enumType.name.toLower());
+        }
+        enumType.variable = "current" + enumType.name;
+        variables.append(Variable(enumType.variable, enumType.name, "the current " + enumType.name.toLower()));
+        enums.append(enumType);
+    }
+
+    QHash<QString, Variable> schemaVariables;
+    for (const Variable& variable : std::as_const(variables)) schemaVariables.insert(variable.name, variable);
+    QHash<QString, Function> schemaFunctions;
+    for (const Function& function : std::as_const(functions)) schemaFunctions.insert(function.name, function);
+    QHash<QString, Union> schemaUnions;
+    QHash<QString, Structure> schemaStructures;
+    QHash<QString, Class> schemaClasses;
+    for (const CustomType& customType : std::as_const(customTypes)) {
+        QHash<QString, Variable> fields;
+        for (const Variable& field : customType.fields) fields.insert(field.name, field);
+        QHash<QString, Function> methods;
+        for (const Function& method : customType.methods) methods.insert(method.name, method);
+        if (customType.kind == "union") schemaUnions.insert(customType.name, Union(customType.name, fields, methods));
+        else if (customType.kind == "structure") schemaStructures.insert(customType.name, Structure(customType.name, fields, methods));
+        else schemaClasses.insert(customType.name, Class(customType.name, fields, methods));
+    }
+    QHash<QString, Enum> schemaEnums;
+    for (const EnumType& enumType : std::as_const(enums)) {
+        QHash<QString, QString> values;
+        for (qsizetype k = 0; k < enumType.values.size(); k++) values.insert(enumType.values[k], enumType.descriptions[k]);
+        schemaEnums.insert(enumType.name, Enum(enumType.name, values));
+    }
+    schema = CompiledSchema::create(schemaVariables, schemaFunctions, schemaUnions, schemaStructures, schemaClasses, schemaEnums);
+}
+
+QStringList WorkloadGenerator::variablesOfKind(ValueKind kind) const
+{
+    QStringList result;
+    for (const Variable& variable : variables) {
+        if (!variable.type.contains('[') && DataTypes.contains(baseType(variable.type)) && kindOfType(variable.type) == kind)
+            result.append(variable.name);
+    }
+    return result;
+}
+
+QList<Function> WorkloadGenerator::functionsOfKind(ValueKind kind) const
+{
+    QList<Function> result;
+    for (const Function& function : functions) {
+        if (kindOfType(function.type) == kind) result.append(function);
+    }
+    return result;
+}
+
+QList<QStringList> WorkloadGenerator::membersOfKind(ValueKind kind) const
+{
+    QList<QStringList> result;
+    for (const CustomType& customType : customTypes) {
+        for (const Variable& field : customType.fields) {
+            if (kindOfType(field.type) == kind) result.append(QStringList{customType.instance, field.name});
+        }
+        for (const Function& method : customType.methods) {
+            if (kindOfType(method.type) == kind) result.append(QStringList{customType.instance, method.name + "(0)"});
+        }
+    }
+    return result;
+}
+
+QString WorkloadGenerator::arrayVariable() const
+{
+    for (const Variable& variable : variables) {
+        if (variable.type.contains('[')) return variable.name;
+    }
+    return QString();
+}
+
+QString WorkloadGenerator::pointerVariable() const
+{
+    for (const Variable& variable : variables) {
+        if (variable.type.endsWith('*') && DataTypes.contains(baseType(variable.type))) return variable.name;
+    }
+    return QString();
+}
+
+QStringList WorkloadGenerator::generateOperand(ValueKind kind)
+{
+    if (kind == ValueKind::Enum) return QStringList{pick(enums).variable};
+
+    const QStringList kindVariables = variablesOfKind(kind);
+    QList<Function> constantFunctions;
+    for (const Function& function : functionsOfKind(kind)) {
+        if (function.paramsCount == 0) constantFunctions.append(function);
+    }
+
+    const int choice = random.bounded(3);
+    if (choice == 0 && !kindVariables.isEmpty()) return QStringList{pick(kindVariables)};
+    if (choice == 1 && !constantFunctions.isEmpty()) return QStringList{pick(constantFunctions).name + "(0)"};
+
+    // Ноль не считается константой, поэтому числа начинаются с единицы
+    if (kind == ValueKind::Bool) return QStringList{random.bounded(2) == 0 ? "true" : "false"};
+    if (kind == ValueKind::Text) return QStringList{"\"" + pick(textWords) + "\""};
+    const QString number = QString::number(random.bounded(1, 100));
+    return QStringList{random.bounded(4) == 0 ? number + ".5" : number};
+}
+
+QStringList WorkloadGenerator::generateCall(const Function& function, int operations, int depth, int stackDepth)
+{
+    // Операции делятся между аргументами; каждый аргумент кладётся на стек поверх предыдущих
+    QStringList tokens;
+    for (int k = 0; k < function.paramsCount; k++) {
+        const int argumentOperations = k == function.paramsCount - 1 ? operations : random.bounded(operations + 1);
+        operations -= argumentOperations;
+        tokens += generateNode(ValueKind::Number, argumentOperations, depth + 1, stackDepth + k);
+    }
+    tokens.append(function.name + "(" + QString::number(function.paramsCount) + ")");
+    return tokens;
+}
+
+QStringList WorkloadGenerator::applicableOperators(ValueKind kind, int operations) const
+{
+    static const QSet<QString> arithmetic{"*", "/", "%", "-"};
+    static const QSet<QString> comparisons{"<", ">", "<=", ">="};
+    static const QSet<QString> incrementsDecrements{"++_", "--_", "_++", "_--"};
+    static const QSet<QString> numberAssignments{"-=", "*=", "/=", "%="};
+
+    const bool hasNumberVariable = !variablesOfKind(ValueKind::Number).isEmpty();
+    QStringList result;
+    for (const QString& op : operators) {
+        bool applicable = false;
+        if (op == "." || op == "->")
+            applicable = operations == 1 && !membersOfKind(kind).isEmpty();
+        else if (op == "=")
+            applicable = kind != ValueKind::Enum && !variablesOfKind(kind).isEmpty();
+        else if (op == "+")
+            applicable = kind == ValueKind::Number || kind == ValueKind::Text;
+        else if (op == "+=")
+            applicable = (kind == ValueKind::Number || kind == ValueKind::Text) && !variablesOfKind(kind).isEmpty();
+        else if (kind == ValueKind::Number) {
+            if (arithmetic.contains(op)) applicable = true;
+            else if (incrementsDecrements.contains(op) || op == "*_") applicable = operations == 1 && hasNumberVariable;
+            else if (numberAssignments.contains(op)) applicable = hasNumberVariable;
+            else if (op == "[]") applicable = !arrayVariable().isEmpty();
+        }
+        else if (kind == ValueKind::Bool) {
+            if (comparisons.contains(op) || op == "==" || op == "!=" || op == "&&" || op == "||" || op == "!") applicable = true;
+            // Сравнение переменной перечисления со значением: "::" и "=="
+            else if (op == "::") applicable = operations == 2 && !enums.isEmpty();
+            // Сравнение указателя с адресом переменной: "&" и "=="
+            else if (op == "&") applicable = operations == 2 && !pointerVariable().isEmpty() && hasNumberVariable;
+        }
+        if (applicable) result.append(op);
+    }
+    return result;
+}
+
+QString WorkloadGenerator::pickOperator(const QStringList& candidates)
+{
+    QStringList uncovered;
+    for (const QString& op : candidates) {
+        if (!coveredOperators.contains(op)) uncovered.append(op);
+    }
+    if (!uncovered.isEmpty()) return pick(uncovered);
+    return pick(candidates);
+}
+
+QStringList WorkloadGenerator::generateNode(ValueKind kind, int operations, int depth, int stackDepth)
+{
+    if (depth >= options.depth) operations = 0;
+
+    // Вызов функции не считается операцией, поэтому функция без параметров выбирается только для листа
+    QList<Function> calls;
+    for (const Function& function : functionsOfKind(kind)) {
+        if (operations == 0 || function.paramsCount > 0) calls.append(function);
+    }
+    if (!calls.isEmpty() && depth + 1 < options.depth && random.bounded(5) == 0)
+        return generateCall(pick(calls), operations, depth, stackDepth);
+
+    const QStringList candidates = operations > 0 ? applicableOperators(kind, operations) : QStringList();
+    if (candidates.isEmpty()) return generateOperand(kind);
+
+    const QString op = pickOperator(candidates);
+    const int rest = operations - 1;
+    QStringList tokens;
+
+    if (op == "." || op == "->") {
+        tokens = pick(membersOfKind(kind));
+    }
+    else if (op == "++_" || op == "--_" || op == "_++" || op == "_--") {
+        tokens.append(pick(variablesOfKind(ValueKind::Number)));
+    }
+    else if (op == "*_") {
+        tokens.append(pointerVariable().isEmpty() ? pick(variablesOfKind(ValueKind::Number)) : pointerVariable());
+    }
+    else if (op == "::") {
+        const EnumType& enumType = pick(enums);
+        tokens << enumType.variable << enumType.name << pick(enumType.values) << op << (random.bounded(2) == 0 ? "==" : "!=");
+        return tokens;
+    }
+    else if (op == "&") {
+        tokens << pointerVariable() << pick(variablesOfKind(ValueKind::Number)) << op << "==";
+        return tokens;
+    }
+    else if (op == "!") {
+        tokens = generateNode(ValueKind::Bool, rest, depth + 1, stackDepth);
+    }
+    else if (op == "-" && stackDepth == 0 && random.bounded(3) == 0) {
+        // Унарный минус распознаётся, только если на стеке единственный операнд
+        tokens = generateNode(ValueKind::Number, rest, depth + 1, stackDepth);
+    }
+    else if (op == "[]") {
+        tokens.append(arrayVariable());
+        tokens += generateNode(ValueKind::Number, rest, depth + 1, stackDepth + 1);
+    }
+    else if (op.endsWith('=') && op != "==" && op != "!=" && op != "<=" && op != ">=") {
+        // Слева от присваивания — переменная того же вида, что и значение справа
+        const ValueKind assignedKind = op == "=" ? kind : (op == "+=" ? kind : ValueKind::Number);
+        tokens.append(pick(variablesOfKind(assignedKind)));
+        tokens += generateNode(assignedKind, rest, depth + 1, stackDepth + 1);
+    }
+    else {
+        ValueKind operandKind = kind;
+        if (op == "&&" || op == "||") operandKind = ValueKind::Bool;
+        else if (op == "<" || op == ">" || op == "<=" || op == ">=") operandKind = ValueKind::Number;
+        else if (op == "==" || op == "!=") operandKind = random.bounded(3) == 0 ? ValueKind::Text : ValueKind::Number;
+        const int left = random.bounded(rest + 1);
+        tokens += generateNode(operandKind, left, depth + 1, stackDepth);
+        tokens += generateNode(operandKind, rest - left, depth + 1, stackDepth + 1);
+    }
+    tokens.append(op);
+    return tokens;
+}
+
+// Учёт операций выражения в покрытии OperationMap
+static void addOperators(const QString& expression, QSet<QString>& coveredOperators)
+{
+    for (const QString& token : Expression::splitExpression(expression)) {
+        if (OperationMap.contains(token)) coveredOperators.insert(token);
+    }
+}
+
+QString WorkloadGenerator::generateExpression(QSet<QString>& usedElements)
+{
+    static const QList<ValueKind> rootKinds{ValueKind::Number, ValueKind::Number, ValueKind::Bool, ValueKind::Text};
+    for (int attempt = 0; attempt < expressionAttempts; attempt++) {
+        const QString text = generateNode(pick(rootKinds), options.operations, 0, 0).join(' ');
+        QSet<QString> expressionElements;
+        if (!Expression(schema, text).tryGetExplanationInEn(&expressionElements).isOk()) continue;
+
+        usedElements.unite(expressionElements);
+        addOperators(text, coveredOperators);
+        return text;
+    }
+    return QString();
+}
+
+QStringList WorkloadGenerator::generateCoverageExpressions(QSet<QString>& usedElements)
+{
+    // Элементы проверяются в порядке схемы, чтобы выражения не зависели от порядка обхода QSet.
+    // Обращение к полю использует и экземпляр, поэтому переменные проверяются после членов типов
+    QList<QPair<QString, QString>> candidates;
+    for (const CustomType& customType : std::as_const(customTypes)) {
+        for (const Variable& field : customType.fields)
+            candidates.append({customType.name + "." + field.name, customType.instance + " " + field.name + " ."});
+        for (const Function& method : customType.methods)
+            candidates.append({customType.name + "." + method.name, customType.instance + " " + method.name + "(0) ."});
+    }
+    for (const EnumType& enumType : std::as_const(enums)) {
+        for (const QString& value : enumType.values)
+            candidates.append({enumType.name + "." + value, enumType.variable + " " + enumType.name + " " + value + " :: =="});
+    }
+    for (const Variable& variable : std::as_const(variables)) {
+        candidates.append({variable.name, variable.name});
+    }
+    for (const Function& function : std::as_const(functions)) {
+        QStringList tokens;
+        for (int k = 1; k <= function.paramsCount; k++) tokens.append(QString::number(k));
+        tokens.append(function.name + "(" + QString::number(function.paramsCount) + ")");
+        candidates.append({function.name, tokens.join(' ')});
+    }
+
+    QStringList result;
+    for (const QPair<QString, QString>& candidate : std::as_const(candidates)) {
+        // Элемент мог быть использован выражением, добавленным раньше
+        if (usedElements.contains(candidate.first)) continue;
+
+        const QString& text = candidate.second;
+        QSet<QString> expressionElements;
+        if (!Expression(schema, text).tryGetExplanationInEn(&expressionElements).isOk()) continue;
+        usedElements.unite(expressionElements);
+        addOperators(text, coveredOperators);
+        result.append(text);
+    }
+    return result;
+}
+
+// Запись переменных и функций раздела с заданным отступом
+static QString variablesXml(const QList<Variable>& variables, const QString& indent)
+{
+    if (variables.isEmpty()) return indent + "<variables/>\n";
+    QString xml = indent + "<variables>\n";
+    for (const Variable& variable : variables) {
+        xml += indent + "    <variable name=\"" + variable.name + "\" type=\"" + variable.type + "\">\n"
+               + indent + "        <description>" + variable.description + "</description>\n"
+               + indent + "    </variable>\n";
+    }
+    return xml + indent + "</variables>\n";
+}
+
+static QString functionsXml(const QList<Function>& functions, const QString& indent)
+{
+    if (functions.isEmpty()) return indent + "<functions/>\n";
+    QString xml = indent + "<functions>\n";
+    for (const Function& function : functions) {
+        xml += indent + "    <function name=\"" + function.name + "\" type=\"" + function.type
+               + "\" paramsCount=\"" + QString::number(function.paramsCount) + "\">\n"
+               + indent + "        <description>" + function.description + "</description>\n"
+               + indent + "    </function>\n";
+    }
+    return xml + indent + "</functions>\n";
+}
+
+QString WorkloadGenerator::toXml(const QStringList& expressions) const
+{
+    // Выражения записываются как есть: специальные символы в <expression> экранирует программа
+    QString xml = "<root>\n";
+    if (expressions.size() == 1) {
+        xml += "    <expression>" + expressions.first() + "</expression>\n";
+    }
+    else {
+        xml += "    <expressions>\n";
+        for (qsizetype i = 0; i < expressions.size(); i++) {
+            xml += "        <expression id=\"e" + QString::number(i + 1) + "\">" + expressions[i] + "</expression>\n";
+        }
+        xml += "    </expressions>\n";
+    }
+    xml += variablesXml(variables, "    ");
+    xml += functionsXml(functions, "    ");
+
+    for (const QString& kind : QStringList{"union", "structure", "class"}) {
+        const QString section = kind == "class" ? "classes" : kind + "s";
+        QString body;
+        for (const CustomType& customType : customTypes) {
+            if (customType.kind != kind) continue;
+            body += "        <" + kind + " name=\"" + customType.name + "\">\n"
+                    + variablesXml(customType.fields, "            ")
+                    + functionsXml(customType.methods, "            ")
+                    + "        </" + kind + ">\n";
+        }
+        xml += body.isEmpty() ? "    <" + section + "/>\n" : "    <" + section + ">\n" + body + "    </" + section + ">\n";
+    }
+
+    if (enums.isEmpty()) {
+        xml += "    <enums/>\n";
+    }
+    else {
+        xml += "    <enums>\n";
+        for (const EnumType& enumType : enums) {
+            xml += "        <enum name=\"" + enumType.name + "\">\n";
+            for (qsizetype k = 0; k < enumType.values.size(); k++) {
+                xml += "            <value name=\"" + enumType.values[k] + "\">\n"
+                       "                <description>" + enumType.descriptions[k] + "</description>\n"
+                       "            </value>\n";
+            }
+            xml += "        </enum>\n";
+        }
+        xml += "    </enums>\n";
+    }
+    return xml + "</root>\n";
+}
+
+QString WorkloadGenerator::generateDocument()
+{
+    generateSchema();
+
+    QSet<QString> usedElements;
+    QStringList expressions;
+    for (int i = 0; i < options.expressions; i++) {
+        const QString expression = generateExpression(usedElements);
+        if (!expression.isEmpty()) expressions.append(expression);
+    }
+    // Документ корректен, только если каждый элемент схемы использован хотя бы одним выражением
+    expressions += generateCoverageExpressions(usedElements);
+    if (expressions.isEmpty()) expressions.append(generateOperand(ValueKind::Number).join(' '));
+
+    return toXml(expressions);
+}
+
+QStringList WorkloadGenerator::uncoveredOperators() const
+{
+    QStringList result;
+    for (const QString& op : operators) {
+        if (!coveredOperators.contains(op)) result.append(op);
+    }
+    return result;
+}
+
+QList<ErrorType> WorkloadGenerator::ungeneratableErrorTypes()
+{
+    return QList<ErrorType>{ErrorType::InputFileNotFound, ErrorType::InputCopyFileCannotBeCreated, ErrorType::OutputFileCannotBeCreated,
+                            ErrorType::DuplicateAttribute, ErrorType::ParamsCountDescriptionDifference, ErrorType::InputFileTooLarge,
+                            ErrorType::Cancelled};
+}
+
+// Замена первого вхождения подстроки
+static QString replaceFirst(const QString& text, const QString& before, const QString& after)
+{
+    QString result = text;
+    const qsizetype position = result.indexOf(before);
+    if (position >= 0) result.replace(position, before.size(), after);
+    return result;
+}
+
+// Удаление раздела корня вместе с содержимым
+static QString removeSection(const QString& xml, const QString& section)
+{
+    const QString emptySection = "    <" + section + "/>\n";
+    if (xml.contains(emptySection)) return replaceFirst(xml, emptySection, "");
+    const QString closeTag = "    </" + section + ">\n";
+    const qsizetype start = xml.indexOf("    <" + section + ">\n");
+    const qsizetype end = xml.indexOf(closeTag, start);
+    QString result = xml;
+    return result.remove(start, end + closeTag.size() - start);
+}
+
+// Замена содержимого выражения e1
+static QString replaceFirstExpression(const QString& xml, const QString& expression)
+{
+    const QString openTag = "<expression id=\"e1\">";
+    const qsizetype start = xml.indexOf(openTag) + openTag.size();
+    const qsizetype end = xml.indexOf("</expression>", start);
+    QString result = xml;
+    return result.replace(start, end - start, expression);
+}
+
+QList<InvalidDocument> WorkloadGenerator::generateInvalidDocuments()
+{
+    // Основа — корректный документ с несколькими выражениями, хотя бы одной переменной и одной функцией
+    GeneratorOptions baseOptions = options;
+    baseOptions.seed = random.generate();
+    baseOptions.variables = qMax(baseOptions.variables, 1);
+    baseOptions.functions = qMax(baseOptions.functions, 1);
+    baseOptions.expressions = qMax(baseOptions.expressions, 2);
+    if (!checkOptions(baseOptions).isEmpty()) {
+        const quint32 seed = baseOptions.seed;
+        baseOptions = GeneratorOptions();
+        baseOptions.seed = seed;
+    }
+    WorkloadGenerator base(baseOptions);
+    const QString xml = base.generateDocument();
+
+    const Variable& variable = base.variables.first();
+    const Function& function = base.functions.first();
+    const QString variableTag = "<variable name=\"" + variable.name + "\"";
+    const QString functionTag = "<function name=\"" + function.name + "\"";
+    const ParserLimits& limits = ExpressionXmlParser::getLimits();
+
+    QList<InvalidDocument> documents;
+    auto add = [&documents](ErrorType errorType, const QString& document) { documents.append(InvalidDocument{errorType, document}); };
+    auto withVariable = [&xml](const QString& name, const QString& type) {
+        return replaceFirst(xml, "<variables>\n", "<variables>\n        <variable name=\"" + name + "\" type=\"" + type
+                                                  + "\">\n            <description>an extra value</description>\n        </variable>\n");
+    };
+
+    add(ErrorType::Parsing, replaceFirst(xml, "</root>", ""));
+    add(ErrorType::MissingRootElemnt, replaceFirst(replaceFirst(xml, "<root>", "<document>"), "</root>", "</document>"));
+    add(ErrorType::UnexpectedElement, replaceFirst(xml, "<root>\n", "<root>\n    <comment>generated</comment>\n"));
+    add(ErrorType::UnexpectedAttribute, replaceFirst(xml, variableTag, variableTag + " unit=\"meters\""));
+    add(ErrorType::MissingRequiredChildElement, removeSection(xml, "enums"));
+    add(ErrorType::MissingRequiredAttribute, replaceFirst(xml, variableTag + " type=\"" + variable.type + "\"", variableTag));
+    add(ErrorType::DuplicateElement, replaceFirst(xml, "<root>\n", "<root>\n    <functions/>\n"));
+    add(ErrorType::EmptyElementValue, replaceFirst(xml, "<description>" + variable.description + "</description>", "<description></description>"));
+    add(ErrorType::EmptyAttributeName, replaceFirst(xml, variableTag, "<variable name=\"\""));
+    add(ErrorType::ParamsCountFunctionMissmatch,
+        replaceFirstExpression(xml, "1 " + function.name + "(" + QString::number(function.paramsCount + 1) + ")"));
+    add(ErrorType::InputSizeExceeded, replaceFirst(xml, "<description>" + variable.description + "</description>",
+                                                   "<description>" + QString("long ").repeated(60) + "</description>"));
+    {
+        // Сумма полей и методов объединения больше 20 при допустимом количестве каждого
+        QList<Variable> fields;
+        for (int k = 0; k < 11; k++) fields.append(Variable("part" + QString::number(k), "int", "a part of the value"));
+        QList<Function> methods;
+        for (int k = 0; k < 10; k++) methods.append(Function("getPart" + QString::number(k), "int", 0, "a part of the value"));
+        const QString oversized = "        <union name=\"Oversized\">\n" + variablesXml(fields, "            ")
+                                  + functionsXml(methods, "            ") + "        </union>\n";
+        add(ErrorType::InputElementsExceeded, xml.contains("<unions/>") ? replaceFirst(xml, "<unions/>", "<unions>\n" + oversized + "    </unions>")
+                                                                         : replaceFirst(xml, "<unions>\n", "<unions>\n" + oversized));
+    }
+    add(ErrorType::UndefinedId, replaceFirstExpression(xml, "undefinedValue 1 +"));
+    add(ErrorType::InvalidSymbol, replaceFirstExpression(xml, "1 $value +"));
+    add(ErrorType::InputDataExprSizeExceeded, replaceFirstExpression(xml, "1" + QString(" 1 +").repeated(21)));
+    add(ErrorType::MissingOperand, replaceFirstExpression(xml, variable.name + " +"));
+    add(ErrorType::MissingOperations, replaceFirstExpression(xml, variable.name + " " + variable.name));
+    add(ErrorType::MultipleIncrementDecrement, replaceFirstExpression(xml, variable.name + " _++ ++_"));
+    add(ErrorType::NeverUsedElement, withVariable("unusedValue", "int"));
+    add(ErrorType::NonUniqueName, replaceFirst(xml, "<expression id=\"e2\">", "<expression id=\"e1\">"));
+    add(ErrorType::InvalidName, replaceFirst(xml, variableTag, "<variable name=\"1" + variable.name + "\""));
+    add(ErrorType::UnidentifedType, replaceFirstExpression(withVariable("mysteryValue", "Mystery"), "mysteryValue"));
+    add(ErrorType::InvalidType, replaceFirst(xml, functionTag + " type=\"", functionTag + " type=\"1"));
+    add(ErrorType::InvalidParamsCount, replaceFirst(xml, functionTag + " type=\"" + function.type + "\" paramsCount=\"" + QString::number(function.paramsCount) + "\"",
+                                                    functionTag + " type=\"" + function.type + "\" paramsCount=\"many\""));
+    add(ErrorType::MissingReplacementArguments,
+        replaceFirstExpression(replaceFirst(xml, "<functions>\n", "<functions>\n        <function name=\"describeValue\" type=\"int\" paramsCount=\"1\">\n"
+                                                                  "            <description>{1} compared with {2}</description>\n        </function>\n"),
+                               "1 describeValue(1)"));
+    add(ErrorType::VariableWithVoidType, replaceFirstExpression(withVariable("nothingValue", "void"), "nothingValue"));
+    {
+        QString nested;
+        for (int level = 0; level < limits.maxNestingDepth; level++) nested += "<level>";
+        for (int level = 0; level < limits.maxNestingDepth; level++) nested += "</level>";
+        add(ErrorType::NestingDepthExceeded, replaceFirst(xml, "<root>\n", "<root>\n    " + nested + "\n"));
+    }
+    {
+        QString attributes;
+        for (int k = 0; k < limits.maxAttributesPerElement; k++) attributes += " extra" + QString::number(k) + "=\"" + QString::number(k) + "\"";
+        add(ErrorType::AttributesCountExceeded, replaceFirst(xml, variableTag, variableTag + attributes));
+    }
+    add(ErrorType::ErrorLimitExceeded, replaceFirst(xml, "<root>\n", "<root>\n" + QString("    <comment/>\n").repeated(limits.maxErrors + 1)));
+
+    std::sort(documents.begin(), documents.end(),
+              [](const InvalidDocument& left, const InvalidDocument& right) { return left.errorType < right.errorType; });
+    return documents;
+}
+
+QList<TEException> WorkloadGenerator::collectErrors(const QString& xml)
+{
+    ExpressionDocument document;
+    TEResult<void> read = ExpressionXmlParser::tryReadDocumentFromXMLContent(xml, document, "generated");
+    if (!read.isOk()) return read.getErrors();
+
+    QList<TEException> documentErrors;
+    QList<TEException> errors;
+    for (const ExplanationResult& result : document.explainAll(documentErrors, 1)) {
+        errors.append(result.errors);
+    }
+    errors.append(documentErrors);
+    return errors;
+}
@@ -0,0 +1,227 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса WorkloadGenerator — генератора синтетических входных документов
+ */
+
+#ifndef WORKLOADGENERATOR_H
+#define WORKLOADGENERATOR_H
+
+#include "codeentity.h"
+#include "compiledschema.h"
+#include "teexception.h"
+
+#include <QList>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Параметры генерации документов
+ *
+ * Количества ограничены пределами программы: не больше 20 элементов в каждом разделе схемы
+ * (переменные вместе с экземплярами пользовательских типов и переменными перечислений),
+ * не больше 20 полей и методов у пользовательского типа, не больше 5 параметров функции
+ * и не больше 20 операций в выражении.
+ */
+struct GeneratorOptions {
+    quint32 seed = 1;           /*!< Начальное значение генератора случайных чисел */
+    int variables = 6;          /*!< Количество переменных базовых типов */
+    int functions = 3;          /*!< Количество функций */
+    int maxParams = 3;          /*!< Наибольшее количество параметров функции */
+    int unions = 1;             /*!< Количество объединений */
+    int structures = 1;         /*!< Количество структур */
+    int classes = 1;            /*!< Количество классов */
+    int fields = 2;             /*!< Количество полей пользовательского типа */
+    int methods = 1;            /*!< Количество методов пользовательского типа */
+    int enums = 1;              /*!< Количество перечислений */
+    int values = 3;             /*!< Количество значений перечисления */
+    int operations = 10;        /*!< Количество операций в случайном выражении */
+    int depth = 6;              /*!< Наибольшая глубина дерева случайного выражения */
+    int expressions = 4;        /*!< Количество случайных выражений в документе */
+};
+
+/*!
+ * \brief Некорректный документ, порождающий ошибку заданного типа
+ */
+struct InvalidDocument {
+    ErrorType errorType;        /*!< Ожидаемый тип ошибки */
+    QString xml;                /*!< Текст документа */
+};
+
+/*!
+ * \brief Генератор синтетических входных документов
+ *
+ * Строит случайную схему (переменные, функции с плейсхолдерами {1}..{N} в описании, объединения,
+ * структуры, классы и перечисления) и случайные выражения в обратной польской записи над ней.
+ * Операнды выражения согласованы по виду значения (число, логическое значение, текст), а операторы
+ * выбираются с предпочтением ещё не использованных, чтобы документы покрывали все операции OperationMap.
+ * Каждое выражение проверяется программой и строится заново, если объяснение не получено, а документ
+ * дополняется выражениями, использующими оставшиеся элементы схемы, поэтому документ корректен целиком.
+ *
+ * Генерация детерминирована: одинаковые параметры и начальное значение дают одинаковые документы.
+ */
+class WorkloadGenerator
+{
+public:
+    /*!
+     * \brief Конструктор генератора
+     * \param[in] options Параметры генерации (должны пройти checkOptions)
+     */
+    explicit WorkloadGenerator(const GeneratorOptions& options);
+
+    /*!
+     * \brief Проверка параметров генерации на пределы программы
+     * \param[in] options Параметры генерации
+     * \return Описание нарушенного предела или пустая строка, если параметры допустимы
+     */
+    static QString checkOptions(const GeneratorOptions& options);
+
+    /*!
+     * \brief Генерация очередного корректного документа
+     * \return Текст XML-документа; документ с одним выражением записывается в формате <expression>,
+     *         с несколькими — в формате <expressions>
+     */
+    QString generateDocument();
+
+    /*!
+     * \brief Генерация некорректных документов — по одному на каждый тип ошибки, достижимый из содержимого документа
+     * \return Документы в порядке ErrorType
+     */
+    QList<InvalidDocument> generateInvalidDocuments();
+
+    /*!
+     * \brief Получение типов ошибок, которые не порождаются содержимым документа
+     *
+     * Ошибки файлов и отмены зависят от окружения, InputFileTooLarge требует документа больше
+     * ParserLimits::maxInputBytes, а DuplicateAttribute и ParamsCountDescriptionDifference программа не выдаёт.
+     */
+    static QList<ErrorType> ungeneratableErrorTypes();
+
+    /*!
+     * \brief Получение всех ошибок документа так, как их находит программа
+     * \param[in] xml Текст XML-документа
+     * \return Ошибки уровня документа и ошибки всех его выражений
+     */
+    static QList<TEException> collectErrors(const QString& xml);
+
+    /*!
+     * \brief Получение операций OperationMap, ещё не использованных в сгенерированных выражениях
+     */
+    QStringList uncoveredOperators() const;
+
+private:
+    /*! \brief Вид значения операнда */
+    enum class ValueKind { Number, Bool, Text, Enum };
+
+    /*! \brief Пользовательский тип со своим экземпляром */
+    struct CustomType {
+        QString kind;               /*!< Вид типа: union, structure или class */
+        QString name;               /*!< Имя типа */
+        QList<Variable> fields;     /*!< Поля */
+        QList<Function> methods;    /*!< Методы (без параметров) */
+        QString instance;           /*!< Переменная этого типа */
+    };
+
+    /*! \brief Перечисление со своей переменной */
+    struct EnumType {
+        QString name;               /*!< Имя перечисления */
+        QStringList values;         /*!< Значения */
+        QStringList descriptions;   /*!< Описания значений */
+        QString variable;           /*!< Переменная этого типа */
+    };
+
+    GeneratorOptions options;           ///< Параметры генерации
+    QRandomGenerator random;            ///< Генератор случайных чисел
+    QStringList operators;              ///< Операции OperationMap в порядке сортировки
+    QSet<QString> coveredOperators;     ///< Операции, использованные в принятых выражениях
+
+    QList<Variable> variables;          ///< Переменные текущей схемы, включая экземпляры типов и переменные перечислений
+    QList<Function> functions;          ///< Функции текущей схемы
+    QList<CustomType> customTypes;      ///< Пользовательские типы текущей схемы
+    QList<EnumType> enums;              ///< Перечисления текущей схемы
+    QSharedPointer<const CompiledSchema> schema; ///< Текущая схема для проверки выражений
+
+    /*! \brief Построение новой случайной схемы */
+    void generateSchema();
+
+    /*!
+     * \brief Построение выражения, для которого программа получает объяснение
+     * \param[in,out] usedElements Использованные элементы схемы
+     * \return Выражение; пустая строка, если подходящее выражение не найдено
+     */
+    QString generateExpression(QSet<QString>& usedElements);
+
+    /*!
+     * \brief Построение поддерева выражения
+     * \param[in] kind Вид значения поддерева
+     * \param[in] operations Количество операций в поддереве
+     * \param[in] depth Глубина поддерева в дереве выражения
+     * \param[in] stackDepth Количество операндов на стеке перед поддеревом
+     * \return Лексемы поддерева
+     */
+    QStringList generateNode(ValueKind kind, int operations, int depth, int stackDepth);
+
+    /*!
+     * \brief Построение операнда без операций
+     * \param[in] kind Вид значения операнда
+     * \return Лексемы операнда
+     */
+    QStringList generateOperand(ValueKind kind);
+
+    /*!
+     * \brief Построение вызова функции
+     * \param[in] function Функция
+     * \param[in] operations Количество операций в аргументах
+     * \param[in] depth Глубина вызова в дереве выражения
+     * \param[in] stackDepth Количество операндов на стеке перед вызовом
+     * \return Лексемы вызова
+     */
+    QStringList generateCall(const Function& function, int operations, int depth, int stackDepth);
+
+    /*!
+     * \brief Получение операций, применимых к поддереву
+     * \param[in] kind Вид значения поддерева
+     * \param[in] operations Количество операций в поддереве
+     * \return Операции в порядке сортировки
+     */
+    QStringList applicableOperators(ValueKind kind, int operations) const;
+
+    /*!
+     * \brief Выбор операции: пока среди применимых есть не использованные операции, выбирается одна из них
+     * \param[in] candidates Применимые операции
+     */
+    QString pickOperator(const QStringList& candidates);
+
+    /*!
+     * \brief Построение выражений, использующих оставшиеся элементы схемы
+     * \param[in,out] usedElements Использованные элементы схемы
+     * \return Выражения в порядке имён элементов
+     */
+    QStringList generateCoverageExpressions(QSet<QString>& usedElements);
+
+    /*!
+     * \brief Запись текущей схемы и выражений в XML
+     * \param[in] expressions Выражения документа
+     */
+    QString toXml(const QStringList& expressions) const;
+
+    /*! \brief Переменные базовых типов заданного вида (без массивов) */
+    QStringList variablesOfKind(ValueKind kind) const;
+    /*! \brief Функции с возвращаемым типом заданного вида */
+    QList<Function> functionsOfKind(ValueKind kind) const;
+    /*! \brief Обращения к полям и методам вида "экземпляр член" с типом заданного вида */
+    QList<QStringList> membersOfKind(ValueKind kind) const;
+    /*! \brief Имя переменной-массива или пустая строка */
+    QString arrayVariable() const;
+    /*! \brief Имя переменной-указателя или пустая строка */
+    QString pointerVariable() const;
+
+    /*! \brief Вид значения для типа данных схемы */
+    static ValueKind kindOfType(const QString& type);
+    /*! \brief Случайный элемент непустого списка */
+    template<typename T> const T& pick(const QList<T>& list);
+};
+
+#endif // WORKLOADGENERATOR_H
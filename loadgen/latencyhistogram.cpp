@@ -0,0 +1,123 @@
+#include "latencyhistogram.h"
+
+#include <QtAlgorithms>
+
+LatencyHistogram::LatencyHistogram()
+    : counts(countsLength(), 0),
+      totalCount(0),
+      minValue(0),
+      maxValue(0),
+      sum(0)
+{}
+
+void LatencyHistogram::record(qint64 value, qint64 count)
+{
+    if (count <= 0) return;
+    value = qBound<qint64>(0, value, highestTrackableValue);
+    counts[countsIndex(value)] += count;
+    minValue = totalCount == 0 ? value : qMin(minValue, value);
+    maxValue = totalCount == 0 ? value : qMax(maxValue, value);
+    totalCount += count;
+    sum += double(value) * count;
+}
+
+void LatencyHistogram::recordCorrected(qint64 value, qint64 expectedInterval, qint64 count)
+{
+    record(value, count);
+    if (expectedInterval <= 0 || value <= expectedInterval) return;
+    // Запросы, не отправленные за время ожидания ответа, ждали бы на interval, 2 * interval, ... меньше
+    for (qint64 missed = value - expectedInterval; missed >= expectedInterval; missed -= expectedInterval)
+        record(missed, count);
+}
+
+LatencyHistogram LatencyHistogram::copyCorrectedForCoordinatedOmission(qint64 expectedInterval) const
+{
+    LatencyHistogram corrected;
+    for (int index = 0; index < counts.size(); index++) {
+        if (counts[index] == 0) continue;
+        const qint64 value = qMin(highestEquivalentValue(valueFromIndex(index)), maxValue);
+        corrected.recordCorrected(value, expectedInterval, counts[index]);
+    }
+    return corrected;
+}
+
+void LatencyHistogram::add(const LatencyHistogram &other)
+{
+    if (other.totalCount == 0) return;
+    for (int index = 0; index < counts.size(); index++) counts[index] += other.counts[index];
+    minValue = totalCount == 0 ? other.minValue : qMin(minValue, other.minValue);
+    maxValue = totalCount == 0 ? other.maxValue : qMax(maxValue, other.maxValue);
+    totalCount += other.totalCount;
+    sum += other.sum;
+}
+
+qint64 LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (totalCount == 0) return 0;
+    percentile = qBound(0.0, percentile, 100.0);
+    // Ранг процентиля округляется до ближайшего целого, но не меньше первого значения
+    const qint64 rank = qMax<qint64>(1, qint64(percentile / 100 * totalCount + 0.5));
+    qint64 accumulated = 0;
+    for (int index = 0; index < counts.size(); index++) {
+        accumulated += counts[index];
+        if (accumulated >= rank) return qMin(highestEquivalentValue(valueFromIndex(index)), maxValue);
+    }
+    return maxValue;
+}
+
+qint64 LatencyHistogram::getTotalCount() const
+{
+    return totalCount;
+}
+
+qint64 LatencyHistogram::getMin() const
+{
+    return minValue;
+}
+
+qint64 LatencyHistogram::getMax() const
+{
+    return maxValue;
+}
+
+double LatencyHistogram::getMean() const
+{
+    return totalCount == 0 ? 0 : sum / totalCount;
+}
+
+qint64 LatencyHistogram::highestEquivalentValue(qint64 value)
+{
+    const int bucket = bucketIndex(value);
+    return ((value >> bucket) << bucket) + (qint64(1) << bucket) - 1;
+}
+
+int LatencyHistogram::bucketIndex(qint64 value)
+{
+    // Значения меньше subBucketCount попадают в корзину 0, каждая следующая корзина вдвое шире
+    const int pow2Ceiling = 64 - qCountLeadingZeroBits(quint64(value | subBucketMask));
+    return pow2Ceiling - (subBucketHalfCountMagnitude + 1);
+}
+
+int LatencyHistogram::countsIndex(qint64 value)
+{
+    const int bucket = bucketIndex(value);
+    const qint64 subBucket = value >> bucket;
+    // Нижняя половина частей корзины (кроме корзины 0) совпадает с верхней половиной предыдущей и не хранится
+    return int(((bucket + 1) << subBucketHalfCountMagnitude) + (subBucket - subBucketHalfCount));
+}
+
+qint64 LatencyHistogram::valueFromIndex(int index)
+{
+    int bucket = (index >> subBucketHalfCountMagnitude) - 1;
+    qint64 subBucket = (index & (subBucketHalfCount - 1)) + subBucketHalfCount;
+    if (bucket < 0) {
+        subBucket -= subBucketHalfCount;
+        bucket = 0;
+    }
+    return subBucket << bucket;
+}
+
+int LatencyHistogram::countsLength()
+{
+    return countsIndex(highestTrackableValue) + 1;
+}
@@ -0,0 +1,128 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса LatencyHistogram — гистограммы задержек с логарифмическими корзинами
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QList>
+#include <QtGlobal>
+
+/*!
+ * \brief Гистограмма задержек в микросекундах по схеме HdrHistogram
+ *
+ * Значения от 1 мкс до highestTrackableValue хранятся с точностью в три значащие цифры:
+ * каждая корзина вдвое шире предыдущей и делится на 2048 равных частей, поэтому относительная
+ * погрешность любого процентиля не превышает 0,1%. Значения больше highestTrackableValue
+ * учитываются как highestTrackableValue. Запись не выделяет память; гистограммы разных потоков
+ * объединяются методом add().
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr qint64 highestTrackableValue = 3600LL * 1000 * 1000; ///< Наибольшее различимое значение: один час
+
+    LatencyHistogram();
+
+    /*!
+     * \brief Запись значения
+     * \param[in] value Задержка в микросекундах
+     * \param[in] count Количество одинаковых значений
+     */
+    void record(qint64 value, qint64 count = 1);
+
+    /*!
+     * \brief Запись значения с поправкой на скоординированное умалчивание (coordinated omission)
+     *
+     * Если задержка превышает ожидаемый интервал между запросами, то запросы, которые должны были быть
+     * отправлены за время ожидания, но не были, записываются с задержками value - interval,
+     * value - 2 * interval, ... пока задержка не меньше interval.
+     * \param[in] value Задержка в микросекундах
+     * \param[in] expectedInterval Ожидаемый интервал между запросами в микросекундах (0 — без поправки)
+     * \param[in] count Количество одинаковых значений
+     */
+    void recordCorrected(qint64 value, qint64 expectedInterval, qint64 count = 1);
+
+    /*!
+     * \brief Получение копии гистограммы с поправкой на скоординированное умалчивание
+     *
+     * Каждое записанное значение переносится в копию так же, как при recordCorrected().
+     * \param[in] expectedInterval Ожидаемый интервал между запросами в микросекундах (0 — без поправки)
+     */
+    LatencyHistogram copyCorrectedForCoordinatedOmission(qint64 expectedInterval) const;
+
+    /*!
+     * \brief Добавление всех значений другой гистограммы
+     */
+    void add(const LatencyHistogram& other);
+
+    /*!
+     * \brief Получение значения процентиля
+     *
+     * Возвращается наибольшее значение, неотличимое от значения процентиля при точности гистограммы,
+     * но не больше наибольшего записанного значения.
+     * \param[in] percentile Процентиль от 0 до 100
+     * \return Значение в микросекундах; 0 для пустой гистограммы
+     */
+    qint64 valueAtPercentile(double percentile) const;
+
+    /*!
+     * \brief Получение количества записанных значений
+     */
+    qint64 getTotalCount() const;
+
+    /*!
+     * \brief Получение наименьшего записанного значения (0 для пустой гистограммы)
+     */
+    qint64 getMin() const;
+
+    /*!
+     * \brief Получение наибольшего записанного значения (0 для пустой гистограммы)
+     */
+    qint64 getMax() const;
+
+    /*!
+     * \brief Получение среднего записанных значений (0 для пустой гистограммы)
+     */
+    double getMean() const;
+
+    /*!
+     * \brief Получение наибольшего значения, неотличимого от value при точности гистограммы
+     */
+    static qint64 highestEquivalentValue(qint64 value);
+
+private:
+    static constexpr int subBucketHalfCountMagnitude = 10; ///< Степень двойки половины корзины
+    static constexpr qint64 subBucketHalfCount = 1 << subBucketHalfCountMagnitude; ///< Половина количества частей корзины
+    static constexpr qint64 subBucketCount = 2 * subBucketHalfCount; ///< Количество частей корзины: 2048 дают три значащие цифры
+    static constexpr qint64 subBucketMask = subBucketCount - 1; ///< Маска значений первой корзины
+
+    /*!
+     * \brief Получение номера корзины значения
+     */
+    static int bucketIndex(qint64 value);
+
+    /*!
+     * \brief Получение индекса счётчика значения
+     */
+    static int countsIndex(qint64 value);
+
+    /*!
+     * \brief Получение наименьшего значения, учитываемого счётчиком с индексом index
+     */
+    static qint64 valueFromIndex(int index);
+
+    /*!
+     * \brief Получение количества счётчиков, достаточного для highestTrackableValue
+     */
+    static int countsLength();
+
+    QList<qint64> counts; ///< Счётчики значений
+    qint64 totalCount; ///< Количество записанных значений
+    qint64 minValue; ///< Наименьшее записанное значение
+    qint64 maxValue; ///< Наибольшее записанное значение
+    double sum; ///< Сумма записанных значений для среднего
+};
+
+#endif // LATENCYHISTOGRAM_H
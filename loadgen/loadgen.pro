@@ -0,0 +1,20 @@
+include(../textExplanationsOnEng/textExplanationsOnEng.pri)
+
+QT = core \
+    xml
+
+# Замеры выполняются только в release-сборке
+CONFIG -= debug debug_and_release
+CONFIG += release
+
+# Корпус по умолчанию — корпус замера пропускной способности
+DEFINES += LOADGEN_CORPUS_DIR=\\\"$$PWD/../pipelinebench/corpus\\\"
+
+SOURCES += \
+    latencyhistogram.cpp \
+    loadgenerator.cpp \
+    main.cpp
+
+HEADERS += \
+    latencyhistogram.h \
+    loadgenerator.h
@@ -0,0 +1,142 @@
+#include "loadgenerator.h"
+#include "batchprocessor.h"
+#include "explanationclient.h"
+#include "workstealingpool.h"
+
+#include <QFile>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/*!
+ * \brief Результат нагрузки одного соединения
+ */
+struct ConnectionResult {
+    LatencyHistogram latency;           /*!< Задержки от запланированного момента отправки (открытый цикл), мкс */
+    LatencyHistogram serviceLatency;    /*!< Задержки от фактической отправки, мкс */
+    qint64 completed = 0;               /*!< Учтённых ответов */
+    qint64 errorResponses = 0;          /*!< Учтённых ответов со статусом, отличным от Ok */
+    qint64 lastCompletionNs = 0;        /*!< Момент последнего учтённого ответа от начала нагрузки, нс */
+    QString failureMessage;             /*!< Описание ошибки, прервавшей соединение */
+};
+
+/*!
+ * \brief Получение времени от начала нагрузки в наносекундах
+ */
+static qint64 elapsedNs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+QList<ServerRequest> LoadGenerator::loadCorpus(const QString &dir)
+{
+    QList<ServerRequest> corpus;
+    for (const QString& path : BatchProcessor::collectCorpusFiles(dir)) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) continue;
+        corpus.append(ServerRequest{RequestType::Document, {QString::fromUtf8(file.readAll())}});
+    }
+    return corpus;
+}
+
+LoadReport LoadGenerator::run(const LoadOptions &options, const QList<ServerRequest> &corpus)
+{
+    const bool open = options.mode == LoadMode::Open;
+    const qint64 warmupNs = qint64(options.warmupSeconds * 1e9);
+    const qint64 endNs = warmupNs + qint64(options.durationSeconds * 1e9);
+    const double intervalNs = open ? 1e9 / options.rate : 0;
+
+    // Каждое соединение пишет только свой элемент
+    QList<ConnectionResult> results(options.connections);
+    ConnectionResult* resultData = results.data();
+    std::atomic<qint64> nextRequest(0);
+
+    // Задач столько же, сколько потоков, поэтому каждое соединение работает в своём потоке всё время нагрузки
+    WorkStealingPool pool(options.connections);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    pool.run(options.connections, [&](int connection) {
+        ConnectionResult& result = resultData[connection];
+        ExplanationClient client;
+        if (!client.connectTo(options.socketPath)) {
+            result.failureMessage = "cannot connect to " + options.socketPath;
+            return;
+        }
+
+        qint64 closedRequest = connection;
+        for (;;) {
+            qint64 request;
+            qint64 intendedNs;
+            if (open) {
+                // Номер запроса определяет момент его отправки; занятое соединение отправит свой запрос с опозданием
+                request = nextRequest.fetch_add(1);
+                intendedNs = qint64(request * intervalNs);
+                if (intendedNs >= endNs) break;
+                std::this_thread::sleep_until(start + std::chrono::nanoseconds(intendedNs));
+            }
+            else {
+                request = closedRequest;
+                closedRequest += options.connections;
+                intendedNs = elapsedNs(start);
+                if (intendedNs >= endNs) break;
+            }
+
+            ServerResponse response;
+            const qint64 sentNs = elapsedNs(start);
+            if (!client.request(corpus[request % corpus.size()], response)) {
+                result.failureMessage = "connection closed by the server";
+                return;
+            }
+            const qint64 receivedNs = elapsedNs(start);
+            if (intendedNs < warmupNs) continue;
+
+            result.completed++;
+            if (response.status != ResponseStatus::Ok) result.errorResponses++;
+            result.lastCompletionNs = receivedNs;
+            result.serviceLatency.record((receivedNs - sentNs) / 1000);
+            if (open) result.latency.record((receivedNs - intendedNs) / 1000);
+        }
+    });
+
+    LoadReport report;
+    qint64 lastCompletionNs = warmupNs;
+    for (const ConnectionResult& result : results) {
+        report.completed += result.completed;
+        report.errorResponses += result.errorResponses;
+        report.latency.add(result.latency);
+        report.serviceLatency.add(result.serviceLatency);
+        lastCompletionNs = qMax(lastCompletionNs, result.lastCompletionNs);
+        if (!result.failureMessage.isEmpty()) {
+            if (report.failures == 0) report.failureMessage = result.failureMessage;
+            report.failures++;
+        }
+    }
+
+    if (open) {
+        report.expectedIntervalUs = qint64(intervalNs / 1000);
+    }
+    else {
+        // Соединение закрытого цикла отправляет запросы одни за другим, поэтому ожидаемый интервал — обычная задержка ответа
+        report.expectedIntervalUs = options.expectedIntervalUs > 0 ? options.expectedIntervalUs
+                                                                   : report.serviceLatency.valueAtPercentile(50);
+        report.latency = report.serviceLatency.copyCorrectedForCoordinatedOmission(report.expectedIntervalUs);
+    }
+
+    // Ответы на запросы, отправленные к концу измерения, приходят позже, поэтому измерение длится до последнего ответа
+    report.seconds = (lastCompletionNs - warmupNs) / 1e9;
+    if (report.seconds > 0) report.throughput = report.completed / report.seconds;
+    return report;
+}
+
+QJsonObject LoadGenerator::toJson(const LatencyHistogram &histogram)
+{
+    return QJsonObject{
+        {"count", histogram.getTotalCount()},
+        {"min_ms", histogram.getMin() / 1000.0},
+        {"mean_ms", histogram.getMean() / 1000.0},
+        {"p50_ms", histogram.valueAtPercentile(50) / 1000.0},
+        {"p90_ms", histogram.valueAtPercentile(90) / 1000.0},
+        {"p99_ms", histogram.valueAtPercentile(99) / 1000.0},
+        {"p99_9_ms", histogram.valueAtPercentile(99.9) / 1000.0},
+        {"max_ms", histogram.getMax() / 1000.0}};
+}
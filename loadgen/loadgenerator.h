@@ -0,0 +1,86 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса LoadGenerator — генератора нагрузки на сервер объяснений
+ */
+
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include "latencyhistogram.h"
+#include "serverprotocol.h"
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+/*! \brief Способ подачи нагрузки */
+enum class LoadMode {
+    Open,   //!< Открытый цикл: запросы отправляются с постоянной частотой независимо от ответов
+    Closed  //!< Закрытый цикл: каждое соединение отправляет следующий запрос сразу после ответа на предыдущий
+};
+
+/*!
+ * \brief Параметры нагрузки
+ */
+struct LoadOptions {
+    QString socketPath;                 /*!< Путь к сокету сервера */
+    LoadMode mode = LoadMode::Closed;   /*!< Способ подачи нагрузки */
+    double rate = 1000;                 /*!< Запросов в секунду (открытый цикл) */
+    int connections = 8;                /*!< Количество соединений */
+    double durationSeconds = 10;        /*!< Длительность измерения в секундах */
+    double warmupSeconds = 1;           /*!< Длительность прогрева в секундах; ответы прогрева не учитываются */
+    qint64 expectedIntervalUs = 0;      /*!< Ожидаемый интервал между запросами соединения для поправки
+                                             закрытого цикла, мкс (0 — медиана задержки) */
+};
+
+/*!
+ * \brief Результат нагрузки
+ */
+struct LoadReport {
+    qint64 completed = 0;               /*!< Учтённых ответов */
+    qint64 errorResponses = 0;          /*!< Учтённых ответов со статусом, отличным от Ok */
+    qint64 failures = 0;                /*!< Соединений, прерванных ошибкой подключения, записи или чтения */
+    QString failureMessage;             /*!< Описание первой ошибки соединения */
+    double seconds = 0;                 /*!< Длительность измерения в секундах */
+    double throughput = 0;              /*!< Учтённых ответов в секунду */
+    qint64 expectedIntervalUs = 0;      /*!< Интервал, использованный для поправки на скоординированное умалчивание, мкс */
+    LatencyHistogram latency;           /*!< Задержки с поправкой на скоординированное умалчивание, мкс */
+    LatencyHistogram serviceLatency;    /*!< Задержки от отправки запроса до получения ответа без поправки, мкс */
+};
+
+/*!
+ * \brief Генератор нагрузки на сервер объяснений
+ *
+ * Запросы корпуса отправляются по кругу через заданное количество соединений, а задержки ответов
+ * записываются в гистограммы. В открытом цикле i-й запрос должен быть отправлен в момент i / rate;
+ * задержка считается от этого момента, а не от фактической отправки, поэтому ожидание свободного
+ * соединения у перегруженного сервера входит в задержку. В закрытом цикле момент отправки определяется
+ * предыдущим ответом, и медленные ответы уменьшают количество запросов; гистограмма задержек дополняется
+ * запросами, которые были бы отправлены за время ожидания (LatencyHistogram::copyCorrectedForCoordinatedOmission).
+ * Доступен только на Unix-системах.
+ */
+class LoadGenerator
+{
+public:
+    /*!
+     * \brief Сбор корпуса запросов: запрос Document для каждого файла *.xml каталога и его подкаталогов в порядке путей
+     * \param[in] dir Каталог корпуса
+     * \return Запросы корпуса
+     */
+    static QList<ServerRequest> loadCorpus(const QString& dir);
+
+    /*!
+     * \brief Подача нагрузки
+     * \param[in] options Параметры нагрузки
+     * \param[in] corpus Запросы корпуса (не пустой)
+     * \return Результат нагрузки
+     */
+    static LoadReport run(const LoadOptions& options, const QList<ServerRequest>& corpus);
+
+    /*!
+     * \brief Преобразование гистограммы задержек в JSON: количество и процентили в миллисекундах
+     */
+    static QJsonObject toJson(const LatencyHistogram& histogram);
+};
+
+#endif // LOADGENERATOR_H
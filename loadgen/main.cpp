@@ -0,0 +1,254 @@
+/*!
+* \file
+* \brief Данный файл содержит главную функцию генератора нагрузки на сервер объяснений textExplanationsOnEng.
+*
+* Запросы корпуса (по умолчанию pipelinebench/corpus) отправляются серверу по кругу через Unix domain socket
+* в открытом цикле (--mode open: --rate запросов в секунду независимо от ответов) или в закрытом цикле
+* (--mode closed: каждое из --connections соединений отправляет следующий запрос сразу после ответа).
+* Задержки записываются в гистограммы с точностью в три значащие цифры; выводятся пропускная способность
+* и p50/p90/p99/p99.9 задержки с поправкой на скоординированное умалчивание (coordinated omission) и без неё.
+*
+* Сервер либо уже запущен (--socket), либо запускается генератором на время нагрузки (--server):
+* \code
+./loadgen --server ./textExplanationsOnEng --mode closed --connections 16 --duration 30
+./loadgen --server ./textExplanationsOnEng --server-jobs 4 --mode open --rate 2000 --json open2000.json
+./textExplanationsOnEng --serve /tmp/te.sock &
+./loadgen --socket /tmp/te.sock --mode open --rate 500
+* \endcode
+* Всё выполняется локально; доступен только на Unix-системах.
+*/
+
+#include "explanationclient.h"
+#include "loadgenerator.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#ifndef LOADGEN_CORPUS_DIR
+#define LOADGEN_CORPUS_DIR "corpus"
+#endif
+
+/*!
+ * \brief Печать справки генератора нагрузки
+ * \param[in,out] out Поток вывода
+ */
+static void printHelp(QTextStream& out)
+{
+    out << "Usage: loadgen (--socket <path> | --server <program>) [options]\n"
+           "  --socket <path>            socket of a running server\n"
+           "  --server <program>         start <program> --serve for the duration of the run\n"
+           "  --server-jobs <n>          --jobs of the started server (default: CPU cores)\n"
+           "  --mode open|closed         fixed request rate or fixed concurrency (default closed)\n"
+           "  --rate <n>                 requests per second in open mode (default 1000)\n"
+           "  --connections <n>          connections to the server (default 8)\n"
+           "  --duration <sec>           measured time (default 10)\n"
+           "  --warmup <sec>             unmeasured time before the measurement (default 1)\n"
+           "  --expected-interval-us <n> expected interval between requests of a connection for the closed-mode\n"
+           "                             coordinated omission correction (default: median latency)\n"
+           "  --corpus <dir>             directory with <name>.xml documents (default: pipelinebench corpus)\n"
+           "  --json <file>              results file (default loadgen.json)\n";
+}
+
+/*!
+ * \brief Печать строки таблицы задержек
+ * \param[in,out] out Поток вывода
+ * \param[in] name Название гистограммы
+ * \param[in] histogram Гистограмма задержек в микросекундах
+ */
+static void printLatencies(QTextStream& out, const QString& name, const LatencyHistogram& histogram)
+{
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg(name, -12)
+               .arg(histogram.valueAtPercentile(50) / 1000.0, 10, 'f', 3)
+               .arg(histogram.valueAtPercentile(90) / 1000.0, 10, 'f', 3)
+               .arg(histogram.valueAtPercentile(99) / 1000.0, 10, 'f', 3)
+               .arg(histogram.valueAtPercentile(99.9) / 1000.0, 10, 'f', 3)
+               .arg(histogram.getMax() / 1000.0, 10, 'f', 3);
+}
+
+/*!
+ * \brief Ожидание готовности запущенного сервера
+ * \param[in] server Процесс сервера
+ * \param[in] socketPath Путь к сокету сервера
+ * \return true, если к серверу удалось подключиться в течение 10 секунд
+ */
+static bool waitForServer(QProcess& server, const QString& socketPath)
+{
+    if (!server.waitForStarted()) return false;
+    ExplanationClient client;
+    for (int attempt = 0; attempt < 1000; attempt++) {
+        if (client.connectTo(socketPath)) return true;
+        // Состояние процесса обновляется только при ожидании
+        if (server.waitForFinished(10) || server.state() == QProcess::NotRunning) return false;
+    }
+    return false;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    LoadOptions options;
+    QString serverProgram;
+    QString corpusDir = LOADGEN_CORPUS_DIR;
+    QString jsonPath = "loadgen.json";
+    QString mode = "closed";
+    int serverJobs = 0;
+
+    const QStringList args = QCoreApplication::arguments().mid(1);
+    for (qsizetype i = 0; i < args.size(); i++) {
+        bool isNumber = true;
+        if (args[i] == "-help" || args[i] == "--help") {
+            printHelp(out);
+            return 0;
+        }
+        else if (i + 1 >= args.size()) {
+            err << "Option " << args[i] << " requires a value\n";
+            return 1;
+        }
+        else if (args[i] == "--socket")
+            options.socketPath = args[++i];
+        else if (args[i] == "--server")
+            serverProgram = args[++i];
+        else if (args[i] == "--mode")
+            mode = args[++i];
+        else if (args[i] == "--corpus")
+            corpusDir = args[++i];
+        else if (args[i] == "--json")
+            jsonPath = args[++i];
+        else if (args[i] == "--server-jobs")
+            serverJobs = args[++i].toInt(&isNumber);
+        else if (args[i] == "--rate")
+            options.rate = args[++i].toDouble(&isNumber);
+        else if (args[i] == "--connections")
+            options.connections = args[++i].toInt(&isNumber);
+        else if (args[i] == "--duration")
+            options.durationSeconds = args[++i].toDouble(&isNumber);
+        else if (args[i] == "--warmup")
+            options.warmupSeconds = args[++i].toDouble(&isNumber);
+        else if (args[i] == "--expected-interval-us")
+            options.expectedIntervalUs = args[++i].toLongLong(&isNumber);
+        else {
+            err << "Unknown option " << args[i] << "\n";
+            printHelp(err);
+            return 1;
+        }
+        if (!isNumber) {
+            err << "Option " << args[i - 1] << " requires a number\n";
+            return 1;
+        }
+    }
+    if (options.socketPath.isEmpty() == serverProgram.isEmpty()) {
+        err << "Exactly one of --socket and --server is required\n";
+        return 1;
+    }
+    if (mode != "open" && mode != "closed") {
+        err << "--mode must be open or closed\n";
+        return 1;
+    }
+    options.mode = mode == "open" ? LoadMode::Open : LoadMode::Closed;
+    if (options.rate <= 0 || options.connections < 1 || options.durationSeconds <= 0 || options.warmupSeconds < 0
+        || options.expectedIntervalUs < 0 || serverJobs < 0) {
+        err << "--rate, --connections and --duration must be positive, other numbers must not be negative\n";
+        return 1;
+    }
+
+    const QList<ServerRequest> corpus = LoadGenerator::loadCorpus(corpusDir);
+    if (corpus.isEmpty()) {
+        err << "No *.xml files in " << corpusDir << "\n";
+        return 1;
+    }
+
+    QTemporaryDir socketDir;
+    QProcess server;
+    if (!serverProgram.isEmpty()) {
+        if (!socketDir.isValid()) {
+            err << "Cannot create a temporary directory: " << socketDir.errorString() << "\n";
+            return 1;
+        }
+        options.socketPath = socketDir.filePath("loadgen.sock");
+        server.setProgram(serverProgram);
+        server.setArguments({"--serve", options.socketPath, "--jobs", QString::number(serverJobs)});
+        server.setStandardOutputFile(QProcess::nullDevice());
+        server.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        server.start();
+        if (!waitForServer(server, options.socketPath)) {
+            err << serverProgram << " did not start serving " << options.socketPath << ": " << server.errorString() << "\n";
+            server.kill();
+            server.waitForFinished();
+            return 1;
+        }
+    }
+
+    if (options.mode == LoadMode::Open)
+        out << "open loop: " << options.rate << " requests/sec";
+    else
+        out << "closed loop";
+    out << ", " << options.connections << " connections, " << corpus.size() << " documents, "
+        << options.warmupSeconds << " s warmup, " << options.durationSeconds << " s measured\n";
+    out.flush();
+
+    const LoadReport report = LoadGenerator::run(options, corpus);
+
+    if (!serverProgram.isEmpty()) {
+        // Сервер завершает работу по SIGTERM после обработки полученных запросов
+        server.terminate();
+        if (!server.waitForFinished(10000)) {
+            server.kill();
+            server.waitForFinished();
+        }
+    }
+
+    out << report.completed << " responses in " << QString::number(report.seconds, 'f', 3) << " s: "
+        << QString::number(report.throughput, 'f', 1) << " responses/sec";
+    if (report.errorResponses > 0) out << ", " << report.errorResponses << " error responses";
+    out << "\n";
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg(QString("latency ms"), -12)
+               .arg(QString("p50"), 10)
+               .arg(QString("p90"), 10)
+               .arg(QString("p99"), 10)
+               .arg(QString("p99.9"), 10)
+               .arg(QString("max"), 10);
+    printLatencies(out, "corrected", report.latency);
+    printLatencies(out, "service", report.serviceLatency);
+    out << "coordinated omission correction interval: " << QString::number(report.expectedIntervalUs / 1000.0, 'f', 3) << " ms\n";
+    out.flush();
+
+    QJsonObject root{
+        {"qt_version", QString(qVersion())},
+        {"cpu_architecture", QSysInfo::currentCpuArchitecture()},
+        {"kernel", QSysInfo::kernelType() + " " + QSysInfo::kernelVersion()},
+        {"mode", mode},
+        {"rate", options.mode == LoadMode::Open ? options.rate : 0},
+        {"connections", options.connections},
+        {"duration_seconds", options.durationSeconds},
+        {"corpus_files", int(corpus.size())},
+        {"completed", report.completed},
+        {"error_responses", report.errorResponses},
+        {"failures", report.failures},
+        {"seconds", report.seconds},
+        {"throughput", report.throughput},
+        {"expected_interval_us", report.expectedIntervalUs},
+        {"latency", LoadGenerator::toJson(report.latency)},
+        {"service_latency", LoadGenerator::toJson(report.serviceLatency)}};
+    QFile json(jsonPath);
+    if (!json.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err << "Cannot write " << jsonPath << ": " << json.errorString() << "\n";
+        return 1;
+    }
+    json.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+
+    // Ошибки соединений искажают задержки, поэтому такой замер считается неудавшимся
+    if (report.failures > 0) {
+        err << report.failures << " connections failed: " << report.failureMessage << "\n";
+        return 1;
+    }
+    return 0;
+}
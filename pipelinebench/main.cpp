@@ -0,0 +1,237 @@
+/*!
+* \file
+* \brief Данный файл содержит главную функцию замера пропускной способности textExplanationsOnEng на корпусе файлов.
+*
+* Каждый файл корпуса (по умолчанию pipelinebench/corpus) обрабатывается полным циклом программы: чтение файла,
+* разбор, объяснение и запись выходного файла. Замер выполняется при 1, 2, 4, ... потоках до --threads включительно;
+* для каждого количества потоков выводятся files/sec, MB/sec и p50/p99 времени обработки одного файла.
+*
+* Перед замером вывод программы для каждого файла сравнивается с эталоном <имя>.txt рядом с <имя>.xml;
+* при расхождении замер не выполняется. Результаты сохраняются в JSON (--json, по умолчанию pipelinebench.json)
+* и сравниваются с базовым запуском (--baseline): ухудшение больше --threshold процентов (по умолчанию 10)
+* считается регрессией, и код возврата равен 1.
+*
+* В репозитории хранится только корпус tests, построенный по строкам тестов test_getExplanationInEn и test_explainAll.
+* Сгенерированный корпус и базовый запуск не хранятся: эталоны должны быть записаны реальным запуском программы,
+* а время зависит от машины. Перед сравнением версий они создаются на одной машине из одного зерна генератора:
+* \code
+./generator --seed 46 --count 50 --out-dir ../pipelinebench/corpus/generated
+./pipelinebench --record-golden
+./pipelinebench --threads 8 --json baseline.json
+./pipelinebench --threads 8 --baseline baseline.json --threshold 5
+* \endcode
+* Намеренное изменение текста объяснений принимается параметром --update-golden, который перезаписывает все эталоны.
+*/
+
+#include "pipelinebench.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+
+#ifndef PIPELINEBENCH_CORPUS_DIR
+#define PIPELINEBENCH_CORPUS_DIR "corpus"
+#endif
+
+/*!
+ * \brief Печать справки замера
+ * \param[in,out] out Поток вывода
+ */
+static void printHelp(QTextStream& out)
+{
+    out << "Usage: pipelinebench [options]\n"
+           "  --corpus <dir>      corpus directory with <name>.xml inputs and <name>.txt golden explanations\n"
+           "  --threads <n>       largest thread count; runs use 1, 2, 4, ... and <n> threads (default: CPU cores)\n"
+           "  --repeats <n>       passes over the corpus per run (default 20)\n"
+           "  --json <file>       results file (default pipelinebench.json)\n"
+           "  --baseline <file>   results of an earlier run to compare with\n"
+           "  --threshold <pct>   allowed slowdown against the baseline in percent (default 10)\n"
+           "  --record-golden     write golden explanations that are missing and exit\n"
+           "  --update-golden     rewrite all golden explanations and exit\n";
+}
+
+/*!
+ * \brief Чтение JSON-файла с результатами
+ * \param[in] path Путь к файлу
+ * \param[out] root Содержимое файла
+ * \return Успешность чтения
+ */
+static bool readResults(const QString& path, QJsonObject& root)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    root = document.object();
+    return document.isObject();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QString corpusDir = PIPELINEBENCH_CORPUS_DIR;
+    QString jsonPath = "pipelinebench.json";
+    QString baselinePath;
+    int maxThreads = QThread::idealThreadCount();
+    int repeats = 20;
+    double threshold = 10;
+    bool recordGolden = false;
+    bool updateGolden = false;
+
+    const QStringList args = QCoreApplication::arguments().mid(1);
+    for (qsizetype i = 0; i < args.size(); i++) {
+        bool isNumber = true;
+        if (args[i] == "-help" || args[i] == "--help") {
+            printHelp(out);
+            return 0;
+        }
+        else if (args[i] == "--record-golden")
+            recordGolden = true;
+        else if (args[i] == "--update-golden")
+            updateGolden = true;
+        else if (i + 1 >= args.size()) {
+            err << "Option " << args[i] << " requires a value\n";
+            return 1;
+        }
+        else if (args[i] == "--corpus")
+            corpusDir = args[++i];
+        else if (args[i] == "--json")
+            jsonPath = args[++i];
+        else if (args[i] == "--baseline")
+            baselinePath = args[++i];
+        else if (args[i] == "--threads")
+            maxThreads = args[++i].toInt(&isNumber);
+        else if (args[i] == "--repeats")
+            repeats = args[++i].toInt(&isNumber);
+        else if (args[i] == "--threshold")
+            threshold = args[++i].toDouble(&isNumber);
+        else {
+            err << "Unknown option " << args[i] << "\n";
+            printHelp(err);
+            return 1;
+        }
+        if (!isNumber) {
+            err << "Option " << args[i - 1] << " requires a number\n";
+            return 1;
+        }
+    }
+    if (maxThreads < 1 || repeats < 1 || threshold < 0) {
+        err << "--threads and --repeats must be positive, --threshold must not be negative\n";
+        return 1;
+    }
+
+    const QList<CorpusFile> corpus = PipelineBench::loadCorpus(corpusDir);
+    if (corpus.isEmpty()) {
+        err << "No *.xml files in " << corpusDir << "\n";
+        return 1;
+    }
+    QTemporaryDir outputDir;
+    if (!outputDir.isValid()) {
+        err << "Cannot create a temporary directory: " << outputDir.errorString() << "\n";
+        return 1;
+    }
+
+    if (recordGolden || updateGolden) {
+        QStringList written;
+        const bool ok = PipelineBench::updateGolden(corpus, outputDir.path(), !updateGolden, written);
+        for (const QString& path : written) out << path << "\n";
+        out << written.size() << " golden explanations written\n";
+        if (!ok) {
+            err << "Cannot write golden explanations to " << corpusDir << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    qint64 corpusBytes = 0;
+    QStringList missing;
+    for (const CorpusFile& file : corpus) {
+        corpusBytes += file.size;
+        if (!file.hasGolden) missing.append(file.goldenFile);
+    }
+    if (!missing.isEmpty()) {
+        err << "Golden explanations are missing (record them with --record-golden):\n  " << missing.join("\n  ") << "\n";
+        return 1;
+    }
+
+    // Замер имеет смысл, только если объяснения не изменились
+    const PipelineRun check = PipelineBench::run(corpus, 1, 1, outputDir.path());
+    if (!check.mismatches.isEmpty()) {
+        err << "Output differs from the golden explanation:\n  " << check.mismatches.join("\n  ") << "\n";
+        return 1;
+    }
+
+    QList<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.append(threads);
+    threadCounts.append(maxThreads);
+
+    out << corpus.size() << " files, " << corpusBytes << " bytes, " << repeats << " repeats\n";
+    out << QString("%1 %2 %3 %4 %5\n")
+               .arg(QString("threads"), 7)
+               .arg(QString("files/sec"), 12)
+               .arg(QString("MB/sec"), 10)
+               .arg(QString("p50 ms"), 10)
+               .arg(QString("p99 ms"), 10);
+    out.flush();
+
+    QJsonArray results;
+    QStringList mismatches;
+    for (int threads : threadCounts) {
+        const PipelineRun run = PipelineBench::run(corpus, threads, repeats, outputDir.path());
+        out << QString("%1 %2 %3 %4 %5\n")
+                   .arg(run.threads, 7)
+                   .arg(run.filesPerSecond, 12, 'f', 1)
+                   .arg(run.megabytesPerSecond, 10, 'f', 3)
+                   .arg(run.p50Ms, 10, 'f', 3)
+                   .arg(run.p99Ms, 10, 'f', 3);
+        out.flush();
+        results.append(PipelineBench::toJson(run));
+        for (const QString& inputFile : run.mismatches) {
+            if (!mismatches.contains(inputFile)) mismatches.append(inputFile);
+        }
+    }
+
+    QJsonObject root{
+        {"qt_version", QString(qVersion())},
+        {"cpu_architecture", QSysInfo::currentCpuArchitecture()},
+        {"kernel", QSysInfo::kernelType() + " " + QSysInfo::kernelVersion()},
+        {"corpus_files", int(corpus.size())},
+        {"corpus_bytes", corpusBytes},
+        {"repeats", repeats},
+        {"results", results}};
+    QFile json(jsonPath);
+    if (!json.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err << "Cannot write " << jsonPath << ": " << json.errorString() << "\n";
+        return 1;
+    }
+    json.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    json.close();
+
+    int result = 0;
+    // Параллельная обработка не должна менять объяснения
+    if (!mismatches.isEmpty()) {
+        err << "Output differs from the golden explanation under load:\n  " << mismatches.join("\n  ") << "\n";
+        result = 1;
+    }
+
+    if (!baselinePath.isEmpty()) {
+        QJsonObject baseline;
+        if (!readResults(baselinePath, baseline)) {
+            err << "Cannot read " << baselinePath << "\n";
+            return 1;
+        }
+        if (baseline.value("corpus_bytes").toInteger() != corpusBytes || baseline.value("corpus_files").toInt() != corpus.size())
+            err << "Warning: the baseline was measured on a different corpus\n";
+
+        const QStringList regressions = PipelineBench::findRegressions(baseline.value("results").toArray(), results, threshold);
+        for (const QString& regression : regressions) err << "Regression: " << regression << "\n";
+        if (!regressions.isEmpty()) result = 1;
+        else out << "No regressions above " << threshold << "% against " << baselinePath << "\n";
+    }
+    return result;
+}
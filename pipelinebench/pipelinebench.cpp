@@ -0,0 +1,143 @@
+#include "pipelinebench.h"
+#include "batchprocessor.h"
+#include "pipelinestats.h"
+#include "workstealingpool.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+
+QList<CorpusFile> PipelineBench::loadCorpus(const QString &dir)
+{
+    QList<CorpusFile> corpus;
+    for (const QString& path : BatchProcessor::collectCorpusFiles(dir)) {
+        CorpusFile file;
+        file.inputFile = path;
+        file.goldenFile = path.chopped(4) + ".txt";
+        file.size = QFileInfo(path).size();
+        QFile golden(file.goldenFile);
+        if (golden.open(QIODevice::ReadOnly)) {
+            file.golden = QString::fromUtf8(golden.readAll());
+            file.hasGolden = true;
+        }
+        corpus.append(file);
+    }
+    return corpus;
+}
+
+QString PipelineBench::explainFile(const QString &inputFile, const QString &outputFile)
+{
+    // Потоки замера заняты файлами корпуса — документ с несколькими выражениями обрабатывается в одном потоке
+    return BatchProcessor::processFile(inputFile, outputFile, 1);
+}
+
+PipelineRun PipelineBench::run(const QList<CorpusFile> &corpus, int threads, int repeats, const QString &outputDir)
+{
+    PipelineRun result;
+    result.threads = threads;
+    result.files = corpus.size() * repeats;
+
+    qint64 bytes = 0;
+    for (const CorpusFile& file : corpus) bytes += file.size;
+    bytes *= repeats;
+
+    // Каждая задача пишет только свой элемент
+    QList<qint64> latencies(result.files);
+    QList<char> matches(result.files);
+    qint64* latencyData = latencies.data();
+    char* matchData = matches.data();
+
+    // Путь к каталогу программы кэшируется при первом обращении — получить его до запуска потоков
+    QCoreApplication::applicationDirPath();
+
+    WorkStealingPool pool(threads);
+    QElapsedTimer wall;
+    wall.start();
+    pool.run(result.files, [&corpus, &outputDir, latencyData, matchData](int task) {
+        const CorpusFile& file = corpus[task % corpus.size()];
+        // Одновременно обрабатываемые повторы одного файла пишут в разные выходные файлы
+        const QString outputFile = outputDir + "/" + QString::number(task) + ".txt";
+        QElapsedTimer timer;
+        timer.start();
+        const QString text = explainFile(file.inputFile, outputFile);
+        latencyData[task] = timer.nsecsElapsed();
+        matchData[task] = file.hasGolden && text == file.golden;
+    });
+    result.seconds = wall.nsecsElapsed() / 1e9;
+
+    if (result.seconds > 0) {
+        result.filesPerSecond = result.files / result.seconds;
+        result.megabytesPerSecond = bytes / (1024.0 * 1024.0) / result.seconds;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    result.p50Ms = StatsAggregate::percentile(latencies, 50) / 1e6;
+    result.p99Ms = StatsAggregate::percentile(latencies, 99) / 1e6;
+
+    for (int task = 0; task < result.files; task++) {
+        const QString& inputFile = corpus[task % corpus.size()].inputFile;
+        if (!matches[task] && !result.mismatches.contains(inputFile)) result.mismatches.append(inputFile);
+    }
+    return result;
+}
+
+bool PipelineBench::updateGolden(const QList<CorpusFile> &corpus, const QString &outputDir, bool missingOnly, QStringList &written)
+{
+    for (const CorpusFile& file : corpus) {
+        if (missingOnly && file.hasGolden) continue;
+        const QString text = explainFile(file.inputFile, outputDir + "/golden.txt");
+        QFile golden(file.goldenFile);
+        if (!golden.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+        golden.write(text.toUtf8());
+        written.append(file.goldenFile);
+    }
+    return true;
+}
+
+QJsonObject PipelineBench::toJson(const PipelineRun &run)
+{
+    return QJsonObject{
+        {"threads", run.threads},
+        {"files", run.files},
+        {"seconds", run.seconds},
+        {"files_per_second", run.filesPerSecond},
+        {"megabytes_per_second", run.megabytesPerSecond},
+        {"p50_ms", run.p50Ms},
+        {"p99_ms", run.p99Ms}};
+}
+
+QStringList PipelineBench::findRegressions(const QJsonArray &baseline, const QJsonArray &current, double threshold)
+{
+    // Для пропускной способности лучше большее значение, для задержки — меньшее
+    const QList<QPair<QString, bool>> metrics{
+        {"files_per_second", true}, {"megabytes_per_second", true}, {"p50_ms", false}, {"p99_ms", false}};
+
+    QStringList regressions;
+    for (const QJsonValue& currentValue : current) {
+        const QJsonObject run = currentValue.toObject();
+        const int threads = run.value("threads").toInt();
+
+        QJsonObject base;
+        for (const QJsonValue& baseValue : baseline) {
+            if (baseValue.toObject().value("threads").toInt() == threads) base = baseValue.toObject();
+        }
+        if (base.isEmpty()) continue;
+
+        for (const QPair<QString, bool>& metric : metrics) {
+            const double before = base.value(metric.first).toDouble();
+            const double after = run.value(metric.first).toDouble();
+            if (before <= 0) continue;
+            const double worse = (metric.second ? before - after : after - before) / before * 100;
+            if (worse > threshold) {
+                regressions.append(QString("%1 threads: %2 %3 -> %4 (%5% worse)")
+                                       .arg(threads)
+                                       .arg(metric.first)
+                                       .arg(before, 0, 'f', 2)
+                                       .arg(after, 0, 'f', 2)
+                                       .arg(worse, 0, 'f', 1));
+            }
+        }
+    }
+    return regressions;
+}
@@ -0,0 +1,106 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса PipelineBench — замера пропускной способности полного цикла обработки файлов
+ */
+
+#ifndef PIPELINEBENCH_H
+#define PIPELINEBENCH_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Файл корпуса с эталонным объяснением
+ */
+struct CorpusFile {
+    QString inputFile;      /*!< Путь к входному XML-файлу */
+    QString goldenFile;     /*!< Путь к эталонному объяснению: <имя входного файла без .xml>.txt */
+    QString golden;         /*!< Эталонное объяснение */
+    bool hasGolden = false; /*!< Эталонное объяснение записано */
+    qint64 size = 0;        /*!< Размер входного файла в байтах */
+};
+
+/*!
+ * \brief Результат прогона корпуса при заданном количестве потоков
+ */
+struct PipelineRun {
+    int threads = 0;                /*!< Количество потоков */
+    int files = 0;                  /*!< Обработано файлов (корпус, умноженный на количество повторов) */
+    double seconds = 0;             /*!< Время прогона в секундах */
+    double filesPerSecond = 0;      /*!< Файлов в секунду */
+    double megabytesPerSecond = 0;  /*!< Мегабайт (2^20 байт) входных файлов в секунду */
+    double p50Ms = 0;               /*!< Медиана времени обработки одного файла в миллисекундах */
+    double p99Ms = 0;               /*!< 99-й процентиль времени обработки одного файла в миллисекундах */
+    QStringList mismatches;         /*!< Входные файлы, объяснение которых не совпало с эталоном */
+};
+
+/*!
+ * \brief Замер пропускной способности полного цикла обработки файлов
+ *
+ * Каждый файл корпуса обрабатывается так же, как при запуске программы для одного файла
+ * (BatchProcessor::processFile): чтение файла, разбор, объяснение и запись выходного файла.
+ * Выведенный текст сравнивается с эталоном, поэтому оптимизация не может незаметно изменить объяснения.
+ * Результаты прогонов сохраняются в JSON и сравниваются с результатами предыдущего запуска.
+ */
+class PipelineBench
+{
+public:
+    /*!
+     * \brief Сбор корпуса: все файлы *.xml каталога и его подкаталогов в порядке путей
+     * \param[in] dir Каталог корпуса
+     * \return Файлы корпуса с эталонами, если они записаны
+     */
+    static QList<CorpusFile> loadCorpus(const QString& dir);
+
+    /*!
+     * \brief Обработка одного файла корпуса
+     * \param[in] inputFile Путь к входному файлу
+     * \param[in] outputFile Путь к выходному файлу
+     * \return Текст, который программа выводит в консоль
+     */
+    static QString explainFile(const QString& inputFile, const QString& outputFile);
+
+    /*!
+     * \brief Прогон корпуса
+     *
+     * Файлы распределяются по потокам пула; каждый файл обрабатывается в одном потоке.
+     * \param[in] corpus Файлы корпуса
+     * \param[in] threads Количество потоков
+     * \param[in] repeats Количество повторов корпуса
+     * \param[in] outputDir Каталог выходных файлов
+     * \return Результат прогона
+     */
+    static PipelineRun run(const QList<CorpusFile>& corpus, int threads, int repeats, const QString& outputDir);
+
+    /*!
+     * \brief Запись эталонных объяснений по текущему выводу программы
+     * \param[in] corpus Файлы корпуса
+     * \param[in] outputDir Каталог выходных файлов
+     * \param[in] missingOnly Записывать только отсутствующие эталоны
+     * \param[out] written Пути записанных эталонов
+     * \return Успешность записи; после первой ошибки запись прекращается
+     */
+    static bool updateGolden(const QList<CorpusFile>& corpus, const QString& outputDir, bool missingOnly, QStringList& written);
+
+    /*!
+     * \brief Преобразование результата прогона в JSON
+     */
+    static QJsonObject toJson(const PipelineRun& run);
+
+    /*!
+     * \brief Поиск ухудшений относительно базового запуска
+     *
+     * Сравниваются прогоны с одинаковым количеством потоков: ухудшением считается падение files/sec
+     * или MB/sec либо рост p50 или p99 больше чем на threshold процентов.
+     * \param[in] baseline Результаты базового запуска (массив results)
+     * \param[in] current Результаты текущего запуска (массив results)
+     * \param[in] threshold Допустимое ухудшение в процентах
+     * \return Описания ухудшений; пустой список — ухудшений нет
+     */
+    static QStringList findRegressions(const QJsonArray& baseline, const QJsonArray& current, double threshold);
+};
+
+#endif // PIPELINEBENCH_H
@@ -0,0 +1,18 @@
+include(../textExplanationsOnEng/textExplanationsOnEng.pri)
+
+QT = core \
+    xml
+
+# Замеры выполняются только в release-сборке
+CONFIG -= debug debug_and_release
+CONFIG += release
+
+# Корпус по умолчанию — каталог corpus рядом с исходными файлами замера
+DEFINES += PIPELINEBENCH_CORPUS_DIR=\\\"$$PWD/corpus\\\"
+
+SOURCES += \
+    main.cpp \
+    pipelinebench.cpp
+
+HEADERS += \
+    pipelinebench.h
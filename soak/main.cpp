@@ -0,0 +1,185 @@
+/*!
+* \file
+* \brief Данный файл содержит главную функцию длительной проверки роста памяти textExplanationsOnEng.
+*
+* Файлы корпуса (по умолчанию pipelinebench/corpus) и их ошибочные копии обрабатываются по кругу полным циклом
+* программы --iterations раз. После --warmup обработок и далее через равные промежутки замеряются резидентная память
+* процесса и занятая память распределителя; если к концу проверки одна из них выросла больше допустимого,
+* код возврата равен 1. Замеры сохраняются в JSON (--json, по умолчанию soak.json).
+*
+* Сборка под LeakSanitizer (qmake CONFIG+=lsan) дополнительно выводит при завершении стеки выделений,
+* которые не были освобождены; для неё достаточно небольшого количества обработок:
+* \code
+./soak --iterations 2000000
+./soak --iterations 500000 --samples 50 --rss-tolerance-kb 2048
+qmake CONFIG+=lsan && make && ./soak --iterations 20000
+* \endcode
+*/
+
+#include "soaktest.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#ifndef SOAK_CORPUS_DIR
+#define SOAK_CORPUS_DIR "corpus"
+#endif
+
+/*!
+ * \brief Печать справки проверки
+ * \param[in,out] out Поток вывода
+ */
+static void printHelp(QTextStream& out)
+{
+    out << "Usage: soak [options]\n"
+           "  --corpus <dir>            directory with valid <name>.xml documents (default: pipelinebench corpus)\n"
+           "  --iterations <n>          files processed after the warmup (default 1000000)\n"
+           "  --warmup <n>              files processed before the first sample (default 10000)\n"
+           "  --samples <n>             memory samples after the warmup (default 20)\n"
+           "  --rss-tolerance-kb <n>    allowed resident memory growth (default 4096)\n"
+           "  --heap-tolerance-kb <n>   allowed malloc heap growth (default 512)\n"
+           "  --json <file>             results file (default soak.json)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QString corpusDir = SOAK_CORPUS_DIR;
+    QString jsonPath = "soak.json";
+    qint64 iterations = 1000000;
+    qint64 warmup = 10000;
+    int samples = 20;
+    qint64 rssToleranceKb = 4096;
+    qint64 heapToleranceKb = 512;
+
+    const QStringList args = QCoreApplication::arguments().mid(1);
+    for (qsizetype i = 0; i < args.size(); i++) {
+        bool isNumber = true;
+        if (args[i] == "-help" || args[i] == "--help") {
+            printHelp(out);
+            return 0;
+        }
+        else if (i + 1 >= args.size()) {
+            err << "Option " << args[i] << " requires a value\n";
+            return 1;
+        }
+        else if (args[i] == "--corpus")
+            corpusDir = args[++i];
+        else if (args[i] == "--json")
+            jsonPath = args[++i];
+        else if (args[i] == "--iterations")
+            iterations = args[++i].toLongLong(&isNumber);
+        else if (args[i] == "--warmup")
+            warmup = args[++i].toLongLong(&isNumber);
+        else if (args[i] == "--samples")
+            samples = args[++i].toInt(&isNumber);
+        else if (args[i] == "--rss-tolerance-kb")
+            rssToleranceKb = args[++i].toLongLong(&isNumber);
+        else if (args[i] == "--heap-tolerance-kb")
+            heapToleranceKb = args[++i].toLongLong(&isNumber);
+        else {
+            err << "Unknown option " << args[i] << "\n";
+            printHelp(err);
+            return 1;
+        }
+        if (!isNumber) {
+            err << "Option " << args[i - 1] << " requires a number\n";
+            return 1;
+        }
+    }
+    if (iterations < 1 || samples < 1 || warmup < 0 || rssToleranceKb < 0 || heapToleranceKb < 0) {
+        err << "--iterations and --samples must be positive, other numbers must not be negative\n";
+        return 1;
+    }
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        err << "Cannot create a temporary directory: " << workDir.errorString() << "\n";
+        return 1;
+    }
+    const QStringList inputs = SoakTest::prepareInputs(corpusDir, workDir.path());
+    if (inputs.isEmpty()) {
+        err << "No *.xml files in " << corpusDir << " or cannot write invalid copies to " << workDir.path() << "\n";
+        return 1;
+    }
+    const QString outputFile = workDir.filePath("output.txt");
+
+    out << inputs.size() << " inputs, " << warmup << " warmup and " << iterations << " measured iterations\n";
+    out << QString("%1 %2 %3 %4\n")
+               .arg(QString("iteration"), 12)
+               .arg(QString("RSS KB"), 12)
+               .arg(QString("heap KB"), 12)
+               .arg(QString("files/sec"), 12);
+    out.flush();
+
+    // Первый замер после прогрева — точка отсчёта: кэши и статические таблицы к этому моменту заполнены
+    QElapsedTimer timer;
+    SoakTest::run(inputs, 0, warmup, outputFile);
+    QList<MemorySample> memory{SoakTest::sample(warmup)};
+    qint64 done = 0;
+    for (int s = 1; s <= samples; s++) {
+        const qint64 count = iterations * s / samples - done;
+        timer.start();
+        SoakTest::run(inputs, warmup + done, count, outputFile);
+        const double seconds = timer.nsecsElapsed() / 1e9;
+        done += count;
+        memory.append(SoakTest::sample(warmup + done));
+        out << QString("%1 %2 %3 %4\n")
+                   .arg(memory.last().iteration, 12)
+                   .arg(memory.last().residentBytes / 1024, 12)
+                   .arg(memory.last().heapBytes / 1024, 12)
+                   .arg(seconds > 0 ? count / seconds : 0.0, 12, 'f', 1);
+        out.flush();
+    }
+
+    QList<qint64> resident;
+    QList<qint64> heap;
+    QJsonArray jsonSamples;
+    for (const MemorySample& m : memory) {
+        resident.append(m.residentBytes);
+        heap.append(m.heapBytes);
+        jsonSamples.append(QJsonObject{{"iteration", m.iteration}, {"rss_bytes", m.residentBytes}, {"heap_bytes", m.heapBytes}});
+    }
+    // Недоступный на платформе замер равен -1 во всех точках, и его рост нулевой
+    const qint64 residentGrowth = SoakTest::growth(resident);
+    const qint64 heapGrowth = SoakTest::growth(heap);
+    out << "RSS growth " << residentGrowth / 1024 << " KB (tolerance " << rssToleranceKb << " KB), heap growth "
+        << heapGrowth / 1024 << " KB (tolerance " << heapToleranceKb << " KB)\n";
+
+    QJsonObject root{
+        {"qt_version", QString(qVersion())},
+        {"cpu_architecture", QSysInfo::currentCpuArchitecture()},
+        {"kernel", QSysInfo::kernelType() + " " + QSysInfo::kernelVersion()},
+        {"inputs", int(inputs.size())},
+        {"warmup", warmup},
+        {"iterations", iterations},
+        {"rss_growth_bytes", residentGrowth},
+        {"heap_growth_bytes", heapGrowth},
+        {"samples", jsonSamples}};
+    QFile json(jsonPath);
+    if (!json.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err << "Cannot write " << jsonPath << ": " << json.errorString() << "\n";
+        return 1;
+    }
+    json.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+
+    int result = 0;
+    if (residentGrowth > rssToleranceKb * 1024) {
+        err << "Resident memory grew by " << residentGrowth / 1024 << " KB after the warmup\n";
+        result = 1;
+    }
+    if (heapGrowth > heapToleranceKb * 1024) {
+        err << "Heap grew by " << heapGrowth / 1024 << " KB after the warmup\n";
+        result = 1;
+    }
+    return result;
+}
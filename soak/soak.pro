@@ -0,0 +1,22 @@
+include(../textExplanationsOnEng/textExplanationsOnEng.pri)
+
+QT = core \
+    xml
+
+# Корпус по умолчанию — корпус замера пропускной способности
+DEFINES += SOAK_CORPUS_DIR=\\\"$$PWD/../pipelinebench/corpus\\\"
+
+# Сборка под LeakSanitizer: qmake CONFIG+=lsan (неосвобождённые блоки выводятся при завершении программы)
+# TE_SANITIZER: учёт выделений через обработчики санитайзера вместо замены malloc (LeakSanitizer не определяет макрос)
+lsan {
+    DEFINES += TE_SANITIZER
+    QMAKE_CXXFLAGS += -fsanitize=leak -g -fno-omit-frame-pointer
+    QMAKE_LFLAGS += -fsanitize=leak
+}
+
+SOURCES += \
+    main.cpp \
+    soaktest.cpp
+
+HEADERS += \
+    soaktest.h
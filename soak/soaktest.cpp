@@ -0,0 +1,88 @@
+#include "soaktest.h"
+#include "batchprocessor.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+/*!
+ * \brief Запись файла целиком
+ * \return Успешность записи
+ */
+static bool writeFile(const QString& path, const QByteArray& content)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(content) == content.size();
+}
+
+QStringList SoakTest::prepareInputs(const QString &corpusDir, const QString &workDir)
+{
+    const QStringList corpus = BatchProcessor::collectCorpusFiles(corpusDir);
+    if (corpus.isEmpty()) return {};
+
+    QStringList invalid;
+    QDir dir(workDir);
+    for (qsizetype i = 0; i < corpus.size(); i++) {
+        QFile file(corpus[i]);
+        if (!file.open(QIODevice::ReadOnly)) return {};
+        const QByteArray content = file.readAll();
+
+        const QString truncated = dir.filePath(QString("%1-truncated.xml").arg(i));
+        QByteArray extraOperator = content;
+        extraOperator.replace("</expression>", " +</expression>");
+        const QString missingOperand = dir.filePath(QString("%1-missing-operand.xml").arg(i));
+        if (!writeFile(truncated, content.left(content.size() / 2)) || !writeFile(missingOperand, extraOperator))
+            return {};
+        invalid << truncated << missingOperand;
+    }
+    invalid.append(dir.filePath("missing.xml"));
+    return corpus + invalid;
+}
+
+void SoakTest::run(const QStringList &inputs, qint64 firstIteration, qint64 count, const QString &outputFile)
+{
+    for (qint64 iteration = firstIteration; iteration < firstIteration + count; iteration++) {
+        // Документ с несколькими выражениями обрабатывается в вызывающем потоке
+        BatchProcessor::processFile(inputs[iteration % inputs.size()], outputFile, 1);
+    }
+}
+
+MemorySample SoakTest::sample(qint64 iteration)
+{
+    MemorySample result;
+    result.iteration = iteration;
+#ifdef Q_OS_LINUX
+    // Второе поле statm — резидентные страницы
+    QFile statm("/proc/self/statm");
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) result.residentBytes = fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+    }
+#endif
+#if defined(__GLIBC__)
+    // Блоки всех арен и отдельно отображённые большие блоки
+#if __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info = mallinfo2();
+    result.heapBytes = qint64(info.uordblks) + qint64(info.hblkhd);
+#else
+    const struct mallinfo info = mallinfo();
+    result.heapBytes = qint64(info.uordblks) + qint64(info.hblkhd);
+#endif
+#endif
+    return result;
+}
+
+qint64 SoakTest::growth(const QList<qint64> &values)
+{
+    if (values.size() < 2) return 0;
+    const qsizetype tail = qMax<qsizetype>(1, values.size() / 4);
+    return *std::min_element(values.end() - tail, values.end()) - values.first();
+}
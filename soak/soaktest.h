@@ -0,0 +1,72 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса SoakTest — длительной проверки роста памяти при обработке файлов
+ */
+
+#ifndef SOAKTEST_H
+#define SOAKTEST_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Замер памяти процесса
+ */
+struct MemorySample {
+    qint64 iteration = 0;       /*!< Обработано файлов к моменту замера */
+    qint64 residentBytes = -1;  /*!< Резидентная память процесса в байтах (-1 — недоступна на этой платформе) */
+    qint64 heapBytes = -1;      /*!< Занятая память распределителя (malloc) в байтах (-1 — недоступна на этой платформе) */
+};
+
+/*!
+ * \brief Длительная проверка роста памяти при обработке файлов
+ *
+ * Корректные и ошибочные входные файлы обрабатываются по кругу полным циклом программы
+ * (BatchProcessor::processFile), как в пакетном режиме и в режиме сервера. Ошибочные файлы проходят
+ * пути ошибок разбора и построения дерева, на которых освобождение памяти легче всего пропустить.
+ * После прогрева память не должна расти: утечка даже в несколько байтов на файл за миллионы файлов
+ * становится заметной на фоне колебаний распределителя памяти.
+ */
+class SoakTest
+{
+public:
+    /*!
+     * \brief Подготовка входных файлов
+     *
+     * Для каждого файла *.xml корпуса в рабочий каталог записываются две ошибочные копии: обрезанная
+     * наполовину (ошибка разбора XML) и с лишним оператором в конце каждого выражения (ошибка построения дерева).
+     * Добавляется также путь к несуществующему файлу.
+     * \param[in] corpusDir Каталог корпуса
+     * \param[in] workDir Рабочий каталог для ошибочных копий
+     * \return Пути входных файлов: сначала файлы корпуса, затем ошибочные; пустой список, если корпус пуст или копии не записаны
+     */
+    static QStringList prepareInputs(const QString& corpusDir, const QString& workDir);
+
+    /*!
+     * \brief Обработка файлов по кругу
+     * \param[in] inputs Пути входных файлов
+     * \param[in] firstIteration Номер первой обработки; файл выбирается по номеру обработки
+     * \param[in] count Количество обработок
+     * \param[in] outputFile Путь к выходному файлу (перезаписывается каждой обработкой)
+     */
+    static void run(const QStringList& inputs, qint64 firstIteration, qint64 count, const QString& outputFile);
+
+    /*!
+     * \brief Замер памяти процесса
+     * \param[in] iteration Обработано файлов к моменту замера
+     */
+    static MemorySample sample(qint64 iteration);
+
+    /*!
+     * \brief Получение роста памяти после прогрева
+     *
+     * Рост — наименьшее значение последней четверти замеров минус первый замер: постоянная утечка
+     * растёт от замера к замеру, а единичный всплеск (например, перевыделение буфера) не влияет на минимум.
+     * \param[in] values Замеры после прогрева в порядке времени
+     * \return Рост в тех же единицах; 0, если замеров меньше двух
+     */
+    static qint64 growth(const QList<qint64>& values);
+};
+
+#endif // SOAKTEST_H
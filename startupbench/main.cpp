@@ -0,0 +1,235 @@
+/*!
+* \file
+* \brief Данный файл содержит главную функцию замера времени запуска textExplanationsOnEng.
+*
+* Программа запускается как отдельный процесс для одного файла ("input output"), так же как её запускают
+* инструменты, обрабатывающие файлы по одному. Для каждого запуска измеряется время от запуска процесса
+* до первого байта вывода и до завершения процесса; выводятся минимум, p50 и p99 по всем запускам.
+* Если указано несколько программ (например, сборки до и после изменения), для каждой следующей выводится
+* изменение p50 относительно первой, а вывод всех программ должен совпадать:
+* \code
+./startupbench --program ./textExplanationsOnEng --runs 200
+./startupbench --program old/textExplanationsOnEng --program new/textExplanationsOnEng --json startup.json
+* \endcode
+*/
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+
+#ifndef STARTUPBENCH_INPUT
+#define STARTUPBENCH_INPUT "trivial.xml"
+#endif
+
+/*!
+ * \brief Времена запусков одной программы
+ */
+struct StartupTimes {
+    QList<double> firstByteMs;  /*!< От запуска процесса до первого байта вывода, мс */
+    QList<double> exitMs;       /*!< От запуска процесса до его завершения, мс */
+    QByteArray output;          /*!< Вывод программы */
+};
+
+/*!
+ * \brief Печать справки замера
+ * \param[in,out] out Поток вывода
+ */
+static void printHelp(QTextStream& out)
+{
+    out << "Usage: startupbench --program <path> [--program <path> ...] [options]\n"
+           "  --program <path>    program to start; repeat to compare builds against the first one\n"
+           "  --input <file>      input file (default: a trivial expression)\n"
+           "  --runs <n>          measured starts per program (default 100)\n"
+           "  --warmup <n>        unmeasured starts per program (default 5)\n"
+           "  --json <file>       results file (default startupbench.json)\n";
+}
+
+/*!
+ * \brief Получение процентиля по методу ближайшего ранга
+ * \param[in] values Значения
+ * \param[in] fraction Доля от 0 до 1 (0.5 — медиана)
+ */
+static double percentile(QList<double> values, double fraction)
+{
+    if (values.isEmpty()) return 0;
+    std::sort(values.begin(), values.end());
+    const qsizetype rank = qsizetype(std::ceil(fraction * values.size()));
+    return values[qBound<qsizetype>(0, rank - 1, values.size() - 1)];
+}
+
+/*!
+ * \brief Один запуск программы
+ * \param[in] program Путь к программе
+ * \param[in] arguments Аргументы командной строки
+ * \param[out] times Времена запусков; измеренный запуск добавляет по значению в каждый список
+ * \param[in] measured Запуск учитывается в результатах
+ * \param[out] errorMessage Описание ошибки
+ * \return Успешность запуска
+ */
+static bool startOnce(const QString& program, const QStringList& arguments, StartupTimes& times, bool measured, QString& errorMessage)
+{
+    QProcess process;
+    process.setProgram(program);
+    process.setArguments(arguments);
+    process.setProcessChannelMode(QProcess::SeparateChannels);
+
+    QElapsedTimer timer;
+    timer.start();
+    process.start(QIODevice::ReadOnly);
+    if (!process.waitForStarted(-1)) {
+        errorMessage = program + ": " + process.errorString();
+        return false;
+    }
+    // Программа, завершившаяся без вывода, не даёт времени до первого байта
+    if (!process.waitForReadyRead(-1)) {
+        errorMessage = program + " produced no output";
+        process.waitForFinished(-1);
+        return false;
+    }
+    const double firstByteMs = timer.nsecsElapsed() / 1e6;
+    process.waitForFinished(-1);
+    const double exitMs = timer.nsecsElapsed() / 1e6;
+
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        errorMessage = program + " exited with code " + QString::number(process.exitCode());
+        return false;
+    }
+    times.output = process.readAllStandardOutput();
+    if (measured) {
+        times.firstByteMs.append(firstByteMs);
+        times.exitMs.append(exitMs);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QStringList programs;
+    QString input = STARTUPBENCH_INPUT;
+    QString jsonPath = "startupbench.json";
+    int runs = 100;
+    int warmup = 5;
+
+    const QStringList args = QCoreApplication::arguments().mid(1);
+    for (qsizetype i = 0; i < args.size(); i++) {
+        bool isNumber = true;
+        if (args[i] == "-help" || args[i] == "--help") {
+            printHelp(out);
+            return 0;
+        }
+        else if (i + 1 >= args.size()) {
+            err << "Option " << args[i] << " requires a value\n";
+            return 1;
+        }
+        else if (args[i] == "--program")
+            programs.append(args[++i]);
+        else if (args[i] == "--input")
+            input = args[++i];
+        else if (args[i] == "--json")
+            jsonPath = args[++i];
+        else if (args[i] == "--runs")
+            runs = args[++i].toInt(&isNumber);
+        else if (args[i] == "--warmup")
+            warmup = args[++i].toInt(&isNumber);
+        else {
+            err << "Unknown option " << args[i] << "\n";
+            printHelp(err);
+            return 1;
+        }
+        if (!isNumber) {
+            err << "Option " << args[i - 1] << " requires a number\n";
+            return 1;
+        }
+    }
+    if (programs.isEmpty() || runs < 1 || warmup < 0) {
+        err << "At least one --program and a positive --runs are required\n";
+        return 1;
+    }
+
+    QTemporaryDir outputDir;
+    if (!outputDir.isValid()) {
+        err << "Cannot create a temporary directory: " << outputDir.errorString() << "\n";
+        return 1;
+    }
+    const QStringList arguments{input, outputDir.filePath("output.txt")};
+
+    QList<StartupTimes> results(programs.size());
+    // Запуски программ чередуются, чтобы нагрузка машины одинаково сказывалась на всех программах
+    for (int run = 0; run < warmup + runs; run++) {
+        for (qsizetype p = 0; p < programs.size(); p++) {
+            QString errorMessage;
+            if (!startOnce(programs[p], arguments, results[p], run >= warmup, errorMessage)) {
+                err << errorMessage << "\n";
+                return 1;
+            }
+        }
+    }
+
+    out << QString("%1 %2 %3 %4 %5  %6\n")
+               .arg(QString("first byte min"), 15)
+               .arg(QString("first byte p50"), 15)
+               .arg(QString("first byte p99"), 15)
+               .arg(QString("exit p50"), 15)
+               .arg(QString("exit p99"), 15)
+               .arg(QString("program (times in ms)"));
+
+    int result = 0;
+    QJsonArray jsonResults;
+    const double baseFirstByte = percentile(results[0].firstByteMs, 0.5);
+    for (qsizetype p = 0; p < programs.size(); p++) {
+        const StartupTimes& times = results[p];
+        const double firstByteP50 = percentile(times.firstByteMs, 0.5);
+        out << QString("%1 %2 %3 %4 %5  %6")
+                   .arg(*std::min_element(times.firstByteMs.begin(), times.firstByteMs.end()), 15, 'f', 3)
+                   .arg(firstByteP50, 15, 'f', 3)
+                   .arg(percentile(times.firstByteMs, 0.99), 15, 'f', 3)
+                   .arg(percentile(times.exitMs, 0.5), 15, 'f', 3)
+                   .arg(percentile(times.exitMs, 0.99), 15, 'f', 3)
+                   .arg(programs[p]);
+        if (p > 0 && baseFirstByte > 0)
+            out << QString(" (%1%)").arg((firstByteP50 - baseFirstByte) / baseFirstByte * 100, 0, 'f', 1);
+        out << "\n";
+
+        // Сравнение времени имеет смысл, только если программы выводят одно и то же
+        if (times.output != results[0].output) {
+            err << programs[p] << " output differs from " << programs[0] << "\n";
+            result = 1;
+        }
+
+        jsonResults.append(QJsonObject{
+            {"program", programs[p]},
+            {"runs", runs},
+            {"first_byte_min_ms", *std::min_element(times.firstByteMs.begin(), times.firstByteMs.end())},
+            {"first_byte_p50_ms", firstByteP50},
+            {"first_byte_p99_ms", percentile(times.firstByteMs, 0.99)},
+            {"exit_p50_ms", percentile(times.exitMs, 0.5)},
+            {"exit_p99_ms", percentile(times.exitMs, 0.99)}});
+    }
+
+    QJsonObject root{
+        {"qt_version", QString(qVersion())},
+        {"cpu_architecture", QSysInfo::currentCpuArchitecture()},
+        {"kernel", QSysInfo::kernelType() + " " + QSysInfo::kernelVersion()},
+        {"input", input},
+        {"results", jsonResults}};
+    QFile json(jsonPath);
+    if (!json.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err << "Cannot write " << jsonPath << ": " << json.errorString() << "\n";
+        return 1;
+    }
+    json.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return result;
+}
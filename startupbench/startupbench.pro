@@ -0,0 +1,14 @@
+# Замер запускает собранную программу как отдельный процесс и не компонуется с её исходными файлами
+QT = core
+
+CONFIG += c++17 console
+
+# Замеры выполняются только в release-сборке
+CONFIG -= debug debug_and_release
+CONFIG += release
+
+# Входной файл по умолчанию — тривиальное выражение рядом с исходными файлами замера
+DEFINES += STARTUPBENCH_INPUT=\\\"$$PWD/trivial.xml\\\"
+
+SOURCES += \
+    main.cpp
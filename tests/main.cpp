@@ -9,6 +9,25 @@
 #include "test_removeconsecutiveduplicates.h"
 #include "test_toexplanation.h"
 #include "test_isreducibleunaryselfinverse.h"
+#include "test_stringpool.h"
+#include "test_compiledschema.h"
+#include "test_explainall.h"
+#include "test_workstealingpool.h"
+#include "test_explanationserver.h"
+#include "test_explanationcache.h"
+#include "test_diskcache.h"
+#include "test_cancellationtoken.h"
+#include "test_parserlimits.h"
+#include "test_teresult.h"
+#include "test_validate.h"
+#include "test_pipelinestats.h"
+#include "test_tracelog.h"
+#include "test_treeprofiler.h"
+#include "test_workloadgenerator.h"
+#include "test_pipelinebench.h"
+#include "test_loadgenerator.h"
+#include "test_soaktest.h"
+#include "test_fuzzcost.h"
 
 int runTest(int argc, char *argv[]) //-- Нужно, чтобы парсер тестов нашёл этот тест, поэтому запускаем мы его из main
 {
@@ -60,6 +79,101 @@ int runTest(int argc, char *argv[]) //-- Нужно, чтобы парсер т
         result |= QTest::qExec(&isReducibleUnarySelfInverse, argc, argv);
     } catch (...) {}
 
+    try {
+        test_stringPool stringPool;
+        result |= QTest::qExec(&stringPool, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_compiledSchema compiledSchema;
+        result |= QTest::qExec(&compiledSchema, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_explainAll explainAll;
+        result |= QTest::qExec(&explainAll, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_workStealingPool workStealingPool;
+        result |= QTest::qExec(&workStealingPool, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_explanationServer explanationServer;
+        result |= QTest::qExec(&explanationServer, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_explanationCache explanationCache;
+        result |= QTest::qExec(&explanationCache, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_diskCache diskCache;
+        result |= QTest::qExec(&diskCache, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_cancellationToken cancellationToken;
+        result |= QTest::qExec(&cancellationToken, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_parserLimits parserLimits;
+        result |= QTest::qExec(&parserLimits, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_teResult teResult;
+        result |= QTest::qExec(&teResult, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_validate validate;
+        result |= QTest::qExec(&validate, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_pipelineStats pipelineStats;
+        result |= QTest::qExec(&pipelineStats, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_traceLog traceLog;
+        result |= QTest::qExec(&traceLog, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_treeProfiler treeProfiler;
+        result |= QTest::qExec(&treeProfiler, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_workloadGenerator workloadGenerator;
+        result |= QTest::qExec(&workloadGenerator, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_pipelineBench pipelineBench;
+        result |= QTest::qExec(&pipelineBench, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_loadGenerator loadGenerator;
+        result |= QTest::qExec(&loadGenerator, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_soakTest soakTest;
+        result |= QTest::qExec(&soakTest, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_fuzzCost fuzzCost;
+        result |= QTest::qExec(&fuzzCost, argc, argv);
+    } catch (...) {}
+
     return result;
 }
 
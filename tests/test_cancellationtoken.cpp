@@ -0,0 +1,97 @@
+#include "test_cancellationtoken.h"
+#include <QtTest/QTest>
+#include <cancellationtoken.h>
+#include <expressiondocument.h>
+#include <expressionxmlparser.h>
+
+test_cancellationToken::test_cancellationToken(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_cancellationToken::isCancelled()
+{
+    QFETCH(qint64, timeoutMs);
+    QFETCH(bool, cancel);
+    QFETCH(bool, expected);
+
+    CancellationToken token(timeoutMs);
+    if (cancel) token.cancel();
+
+    QCOMPARE(token.isCancelled(), expected);
+}
+
+void test_cancellationToken::isCancelled_data()
+{
+    QTest::addColumn<qint64>("timeoutMs");
+    QTest::addColumn<bool>("cancel");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("1. Without deadline") << qint64(-1) << false << false;
+    QTest::newRow("2. Deadline not reached") << qint64(60000) << false << false;
+    QTest::newRow("3. Deadline expired") << qint64(0) << false << true;
+    QTest::newRow("4. Cancelled explicitly") << qint64(-1) << true << true;
+}
+
+void test_cancellationToken::expressionCancelled()
+{
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")},
+         {"b", Variable("b", "int", "second value")}});
+    Expression expression(schema, "a b + a *");
+
+    CancellationToken expired(0);
+    expression.setCancellationToken(&expired);
+    try {
+        expression.getExplanationInEn();
+        QFAIL("Expected cancellation");
+    } catch (const TEException& error) {
+        QCOMPARE(error.getErrorType(), ErrorType::Cancelled);
+    }
+
+    // Без отмены то же выражение объясняется
+    CancellationToken unlimited;
+    expression.setCancellationToken(&unlimited);
+    QVERIFY(!expression.getExplanationInEn().isEmpty());
+}
+
+void test_cancellationToken::parserCancelled()
+{
+    // Документ с ошибкой: при отмене сообщается только об отмене
+    QString xml = "<root><expression>a +</expression><variables><variable name=\"a\" type=\"int\">"
+                  "<description>value</description></variable></variables><functions/><unions/>"
+                  "<structures/><classes/><enums/><unexpected/></root>";
+
+    CancellationToken cancelled;
+    cancelled.cancel();
+    ExpressionDocument document;
+    try {
+        ExpressionXmlParser::readDocumentFromXMLContent(xml, document, "request", &cancelled);
+        QFAIL("Expected cancellation");
+    } catch (const QList<TEException>& errors) {
+        QCOMPARE(errors.size(), 1);
+        QCOMPARE(errors.first().getErrorType(), ErrorType::Cancelled);
+    }
+}
+
+void test_cancellationToken::cancelledNotCached()
+{
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")}});
+    ExplanationCache cache;
+    ExpressionDocument document(schema, {ExpressionEntry{"", "a 1 +", 1, {}}});
+    document.setExplanationCache(&cache);
+
+    CancellationToken expired(0);
+    document.setCancellationToken(&expired);
+    try {
+        document.getExplanation(1);
+        QFAIL("Expected cancellation");
+    } catch (const TEException& error) {
+        QCOMPARE(error.getErrorType(), ErrorType::Cancelled);
+    }
+
+    // Прерванное объяснение не попало в кэш и вычисляется заново
+    document.setCancellationToken(nullptr);
+    QVERIFY(!document.getExplanation(1).isEmpty());
+    QCOMPARE(int(cache.getHitCount()), 0);
+}
@@ -0,0 +1,20 @@
+#ifndef TEST_CANCELLATIONTOKEN_H
+#define TEST_CANCELLATIONTOKEN_H
+
+#include <QObject>
+
+class test_cancellationToken : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_cancellationToken(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void isCancelled(); // bool CancellationToken::isCancelled() const
+    void isCancelled_data();
+    void expressionCancelled(); // QString Expression::getExplanationInEn(QSet<QString>* usedElements) с истёкшим сроком
+    void parserCancelled(); // void ExpressionXmlParser::readDocumentFromXMLContent(...) с отменой
+    void cancelledNotCached(); // CachedExplanation ExplanationCache::findOrCompute(...) для прерванного объяснения
+};
+
+#endif // TEST_CANCELLATIONTOKEN_H
@@ -0,0 +1,84 @@
+#include "test_compiledschema.h"
+#include <QtTest/QTest>
+#include <expression.h>
+#include <compiledschema.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+test_compiledSchema::test_compiledSchema(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_compiledSchema::concurrentExplanations()
+{
+    QFETCH(QStringList, expressions);
+    QFETCH(QStringList, results);
+    QFETCH(int, threadCount);
+    QFETCH(int, iterations);
+
+    // Одна схема на все потоки
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"warnings", Variable("warnings", "int", "program warnings")},
+         {"errors", Variable("errors", "int", "his errors")}});
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < iterations; i++) {
+                // Каждый поток обходит выражения со своим сдвигом, чтобы потоки работали с разными выражениями одновременно
+                int index = (i + t) % expressions.size();
+                Expression expression(schema, expressions[index]);
+                QString actualResult;
+                try {
+                    actualResult = expression.getExplanationInEn();
+                } catch (const TEException& e) {
+                    actualResult = TEException::ErrorTypeNames.value(e.getErrorType());
+                }
+                if (actualResult != results[index]) mismatches++;
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Схема не должна измениться после параллельной работы
+    QCOMPARE(int(schema->getVariables().size()), 2);
+    QCOMPARE(mismatches.load(), 0);
+}
+
+void test_compiledSchema::concurrentExplanations_data()
+{
+    QTest::addColumn<QStringList>("expressions");
+    QTest::addColumn<QStringList>("results");
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("iterations");
+
+    QStringList expressions = {
+        "warnings errors +",
+        "warnings errors -",
+        "warnings errors <",
+        "warnings errors * warnings +",
+        "warnings 1 +"
+    };
+    QStringList results = {
+        "sum of program warnings and his errors",
+        "difference of program warnings and his errors",
+        "program warnings is less than his errors",
+        "sum of product of program warnings and his errors and program warnings",
+        "NeverUsedElement"
+    };
+
+    // Test 1: Один поток — эталон для сравнения
+    QTest::newRow("single-thread")
+        << expressions << results << 1 << 200;
+
+    // Test 2: Много потоков над одной схемой
+    QTest::newRow("many-threads-one-schema")
+        << expressions << results << 16 << 2000;
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_COMPILEDSCHEMA_H
+#define TEST_COMPILEDSCHEMA_H
+
+#include <QObject>
+
+class test_compiledSchema : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_compiledSchema(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void concurrentExplanations(); // Одна схема, много потоков (собирать с CONFIG+=tsan)
+    void concurrentExplanations_data();
+};
+
+#endif // TEST_COMPILEDSCHEMA_H
@@ -0,0 +1,134 @@
+#include "test_diskcache.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <diskcache.h>
+
+test_diskCache::test_diskCache(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_diskCache::makeKey()
+{
+    QFETCH(QByteArray, first);
+    QFETCH(QByteArray, second);
+    QFETCH(bool, expectedEqual);
+
+    QCOMPARE(DiskCache::makeKey(first).size(), 32);
+    QCOMPARE(DiskCache::makeKey(first) == DiskCache::makeKey(second), expectedEqual);
+}
+
+void test_diskCache::makeKey_data()
+{
+    QTest::addColumn<QByteArray>("first");
+    QTest::addColumn<QByteArray>("second");
+    QTest::addColumn<bool>("expectedEqual");
+
+    QTest::newRow("1. Same content") << QByteArray("<root/>\n") << QByteArray("<root/>\n") << true;
+    QTest::newRow("2. CRLF line endings") << QByteArray("<root>\n</root>\n") << QByteArray("<root>\r\n</root>\r\n") << true;
+    QTest::newRow("3. Different content") << QByteArray("<root>a</root>") << QByteArray("<root>b</root>") << false;
+    QTest::newRow("4. Extra line changes error line numbers") << QByteArray("<root/>") << QByteArray("\n<root/>") << false;
+}
+
+void test_diskCache::persistence()
+{
+    QTemporaryDir dir;
+    QByteArray key = DiskCache::makeKey("document");
+    {
+        DiskCache cache(dir.path());
+        QVERIFY(cache.open());
+        cache.insert(key, DiskCacheRecord{true, "explanation"});
+    }
+
+    // Результат доступен в следующем запуске
+    DiskCache cache(dir.path());
+    QVERIFY(cache.open());
+    DiskCacheRecord record;
+    QVERIFY(cache.find(key, record));
+    QVERIFY(record.successful);
+    QCOMPARE(record.text, QString("explanation"));
+    QVERIFY(!cache.find(DiskCache::makeKey("other document"), record));
+    QCOMPARE(cache.getHitCount(), 1);
+    QCOMPARE(cache.getMissCount(), 1);
+
+    // Каталог кэша занят этим процессом
+    DiskCache second(dir.path());
+    QVERIFY(!second.open());
+}
+
+void test_diskCache::tornTail()
+{
+    QTemporaryDir dir;
+    QByteArray key = DiskCache::makeKey("document");
+    {
+        DiskCache cache(dir.path());
+        QVERIFY(cache.open());
+        cache.insert(key, DiskCacheRecord{false, "errors"});
+    }
+
+    // Запись, прерванная сбоем
+    QFile segment(QDir(dir.path()).filePath("segment-00000001.dat"));
+    QVERIFY(segment.open(QIODevice::Append));
+    qint64 committed = segment.size();
+    segment.write("TERC\x10\x00\x00", 7);
+    segment.close();
+
+    DiskCache cache(dir.path());
+    QVERIFY(cache.open());
+    QCOMPARE(QFileInfo(segment.fileName()).size(), committed);
+
+    DiskCacheRecord record;
+    QVERIFY(cache.find(key, record));
+    QVERIFY(!record.successful);
+    QCOMPARE(record.text, QString("errors"));
+
+    // Новые записи дописываются после целой части сегмента
+    QByteArray otherKey = DiskCache::makeKey("other document");
+    cache.insert(otherKey, DiskCacheRecord{true, "other explanation"});
+    QVERIFY(cache.find(otherKey, record));
+    QCOMPARE(record.text, QString("other explanation"));
+    QVERIFY(cache.find(key, record));
+}
+
+void test_diskCache::versionStamp()
+{
+    QTemporaryDir dir;
+    QByteArray key = DiskCache::makeKey("document");
+    {
+        DiskCache cache(dir.path(), DiskCache::defaultMaxSize, 1);
+        QVERIFY(cache.open());
+        cache.insert(key, DiskCacheRecord{true, "explanation"});
+    }
+
+    // Шаблоны объяснения изменились — прежние результаты недействительны
+    DiskCache cache(dir.path(), DiskCache::defaultMaxSize, 2);
+    QVERIFY(cache.open());
+    DiskCacheRecord record;
+    QVERIFY(!cache.find(key, record));
+    QCOMPARE(cache.count(), 0);
+    QCOMPARE(cache.getSize(), 0);
+}
+
+void test_diskCache::compaction()
+{
+    QTemporaryDir dir;
+    const qint64 maxSize = 2 * 1024 * 1024;
+    DiskCache cache(dir.path(), maxSize);
+    QVERIFY(cache.open());
+
+    QString text(100 * 1024, QChar('x'));
+    QByteArray usedKey = DiskCache::makeKey("document 0");
+    cache.insert(usedKey, DiskCacheRecord{true, text});
+
+    DiskCacheRecord record;
+    for (int i = 1; i <= 60; i++) {
+        cache.insert(DiskCache::makeKey("document " + QByteArray::number(i)), DiskCacheRecord{true, text});
+        QVERIFY(cache.getSize() <= maxSize);
+        // Используемая запись не удаляется вместе со старым сегментом
+        QVERIFY(cache.find(usedKey, record));
+    }
+
+    QVERIFY(!cache.find(DiskCache::makeKey("document 1"), record));
+    QVERIFY(cache.find(DiskCache::makeKey("document 60"), record));
+    QCOMPARE(record.text, text);
+    QVERIFY(cache.count() < 61);
+}
@@ -0,0 +1,21 @@
+#ifndef TEST_DISKCACHE_H
+#define TEST_DISKCACHE_H
+
+#include <QObject>
+
+class test_diskCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_diskCache(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void makeKey(); // static QByteArray DiskCache::makeKey(const QByteArray& documentContent)
+    void makeKey_data();
+    void persistence(); // bool DiskCache::find(...) после повторного открытия кэша
+    void tornTail(); // bool DiskCache::open(QString* errorMessage) с недописанной записью в конце сегмента
+    void versionStamp(); // bool DiskCache::open(QString* errorMessage) с другой меткой версии
+    void compaction(); // void DiskCache::insert(const QByteArray& key, const DiskCacheRecord& record) сверх размера кэша
+};
+
+#endif // TEST_DISKCACHE_H
@@ -0,0 +1,80 @@
+#include "test_explainall.h"
+#include <QtTest/QTest>
+#include <expressiondocument.h>
+
+test_explainAll::test_explainAll(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_explainAll::explainAll()
+{
+    QFETCH(QStringList, expressions);
+    QFETCH(int, threadCount);
+    QFETCH(QString, expectedOutput);
+
+    // Общая схема для всех выражений документа
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"warnings", Variable("warnings", "int", "program warnings")},
+         {"errors", Variable("errors", "int", "his errors")}});
+
+    QList<ExpressionEntry> entries;
+    for (int i = 0; i < expressions.size(); i++) {
+        ExpressionEntry entry;
+        entry.id = "e" + QString::number(i + 1);
+        entry.expression = expressions[i];
+        entries.append(entry);
+    }
+
+    ExpressionDocument document(schema, entries, true);
+    QList<TEException> documentErrors;
+    QList<ExplanationResult> results = document.explainAll(documentErrors, threadCount);
+    QString actualOutput = ExpressionDocument::formatResults(results, documentErrors);
+
+    if (actualOutput != expectedOutput) {
+        qDebug().noquote() << "Actual output:\n" << actualOutput;
+        qDebug().noquote() << "Expected output:\n" << expectedOutput;
+        QFAIL("Outputs do not match.");
+    }
+}
+
+void test_explainAll::explainAll_data()
+{
+    QTest::addColumn<QStringList>("expressions");
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<QString>("expectedOutput");
+
+    // Test 1: Выражения по отдельности используют не все элементы схемы, но документ — все
+    QTest::newRow("schema-used-by-document-as-a-whole")
+        << QStringList{"warnings 1 +", "errors 2 *"}
+        << 1
+        << QString("[e1]\nsum of program warnings and 1\n"
+                   "[e2]\nproduct of his errors and 2\n");
+
+    // Test 2: Порядок результатов совпадает с порядком выражений при параллельной обработке
+    QStringList manyExpressions;
+    QString manyOutput;
+    for (int i = 1; i <= 50; i++) {
+        manyExpressions << "warnings errors " + QString(i % 2 ? "+" : "-");
+        manyOutput += "[e" + QString::number(i) + "]\n" + QString(i % 2 ? "sum" : "difference") + " of program warnings and his errors\n";
+    }
+    QTest::newRow("parallel-results-in-document-order")
+        << manyExpressions
+        << 8
+        << manyOutput;
+
+    // Test 3: Ошибка одного выражения не влияет на остальные
+    QTest::newRow("error-in-one-expression")
+        << QStringList{"warnings errors +", "warnings +", "errors warnings <"}
+        << 4
+        << QString("[e1]\nsum of program warnings and his errors\n"
+                   "[e2]\n" + TEException(ErrorType::MissingOperand, QList<QString>{"+"}).what() + "\n"
+                   "[e3]\nhis errors is less than program warnings\n");
+
+    // Test 4: Элемент схемы не использован ни одним выражением
+    QTest::newRow("element-unused-by-document")
+        << QStringList{"warnings 1 +", "warnings 2 +"}
+        << 2
+        << QString("[e1]\nsum of program warnings and 1\n"
+                   "[e2]\nsum of program warnings and 2\n"
+                   + TEException(ErrorType::NeverUsedElement, QList<QString>{"errors"}).what() + "\n");
+}
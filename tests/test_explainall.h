@@ -0,0 +1,17 @@
+#ifndef TEST_EXPLAINALL_H
+#define TEST_EXPLAINALL_H
+
+#include <QObject>
+
+class test_explainAll : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_explainAll(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void explainAll(); // QList<ExplanationResult> ExpressionDocument::explainAll(...)
+    void explainAll_data();
+};
+
+#endif // TEST_EXPLAINALL_H
@@ -0,0 +1,145 @@
+#include "test_explanationcache.h"
+#include <QtTest/QTest>
+#include <expressiondocument.h>
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QThread>
+
+test_explanationCache::test_explanationCache(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_explanationCache::makeKey()
+{
+    QFETCH(QString, first);
+    QFETCH(QString, second);
+    QFETCH(bool, sameCheckMode);
+    QFETCH(bool, expectedEqual);
+
+    QByteArray schemaHash = CompiledSchema::empty()->getContentHash();
+    QString firstKey = ExplanationCache::makeKey(schemaHash, first, true);
+    QString secondKey = ExplanationCache::makeKey(schemaHash, second, sameCheckMode);
+
+    QCOMPARE(firstKey == secondKey, expectedEqual);
+}
+
+void test_explanationCache::makeKey_data()
+{
+    QTest::addColumn<QString>("first");
+    QTest::addColumn<QString>("second");
+    QTest::addColumn<bool>("sameCheckMode");
+    QTest::addColumn<bool>("expectedEqual");
+
+    QTest::newRow("1. Same expression") << "a b +" << "a b +" << true << true;
+    QTest::newRow("2. Extra whitespace between tokens") << "a b +" << "  a \t b   +\n" << true << true;
+    QTest::newRow("3. Whitespace inside a string literal") << "\"a b\" c +" << "\"a  b\" c +" << true << false;
+    QTest::newRow("4. Different expression") << "a b +" << "a b -" << true << false;
+    QTest::newRow("5. Different unused-element check") << "a b +" << "a b +" << false << false;
+    QTest::newRow("6. Whitespace-only is not empty") << "" << "   " << true << false;
+}
+
+void test_explanationCache::cachedExplainAll()
+{
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"warnings", Variable("warnings", "int", "program warnings")},
+         {"errors", Variable("errors", "int", "his errors")}});
+
+    // Повторяющиеся выражения, в том числе с ошибкой
+    QStringList expressions{"warnings errors +", "warnings +", "warnings  errors +", "warnings +", "errors 2 *"};
+    QList<ExpressionEntry> entries;
+    for (int i = 0; i < expressions.size(); i++) {
+        ExpressionEntry entry;
+        entry.id = "e" + QString::number(i + 1);
+        entry.expression = expressions[i];
+        entry.line = i + 1;
+        entries.append(entry);
+    }
+
+    ExpressionDocument document(schema, entries, true);
+    QList<TEException> expectedErrors;
+    QString expectedOutput = ExpressionDocument::formatResults(document.explainAll(expectedErrors, 1), expectedErrors);
+
+    // Два прохода с кэшем: результаты совпадают с результатами без кэша
+    ExplanationCache cache;
+    document.setExplanationCache(&cache);
+    for (int pass = 0; pass < 2; pass++) {
+        QList<TEException> documentErrors;
+        QString actualOutput = ExpressionDocument::formatResults(document.explainAll(documentErrors, 1), documentErrors);
+        QCOMPARE(actualOutput, expectedOutput);
+    }
+
+    // 3 различных выражения: промахи только на первом проходе
+    QCOMPARE(int(cache.getMissCount()), 3);
+    QCOMPARE(int(cache.getHitCount()), 7);
+    QCOMPARE(int(cache.getEvictionCount()), 0);
+}
+
+void test_explanationCache::eviction()
+{
+    // Один сегмент, в который помещается несколько записей
+    ExplanationCache cache(4096, 1);
+    CachedExplanation value;
+    value.explanation = QString(100, 'x');
+
+    for (int i = 0; i < 100; i++) {
+        cache.insert("key" + QString::number(i), value);
+    }
+
+    QVERIFY(cache.getEvictionCount() > 0);
+    QVERIFY(cache.getMemoryUsage() <= 4096);
+
+    // Давно не использовавшиеся записи вытеснены, последняя — на месте
+    CachedExplanation found;
+    QVERIFY(!cache.find("key0", found));
+    QVERIFY(cache.find("key99", found));
+    QCOMPARE(found.explanation, value.explanation);
+}
+
+void test_explanationCache::coalescing()
+{
+    ExplanationCache cache;
+    const int threadCount = 8;
+    QAtomicInt computeCount;
+    QList<CachedExplanation> results(threadCount);
+
+    // Вычисление не заканчивается, пока остальные потоки не встанут в ожидание его результата
+    auto compute = [&cache, &computeCount, threadCount]() {
+        computeCount.fetchAndAddRelaxed(1);
+        QElapsedTimer timer;
+        timer.start();
+        while (cache.getCoalescedCount() < threadCount - 1 && timer.elapsed() < 5000) {
+            QThread::msleep(1);
+        }
+        CachedExplanation value;
+        value.explanation = "shared explanation";
+        value.errors.append(TEException(ErrorType::MissingOperand, QList<QString>{"+"}));
+        return value;
+    };
+
+    CachedExplanation* output = results.data();
+    QList<QThread*> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.append(QThread::create([&cache, output, &compute, i]() {
+            output[i] = cache.findOrCompute("key", compute);
+        }));
+        threads.last()->start();
+    }
+    for (QThread* thread : std::as_const(threads)) {
+        thread->wait();
+    }
+    qDeleteAll(threads);
+
+    // Результат и ошибки вычислены один раз и получены всеми потоками
+    QCOMPARE(int(computeCount), 1);
+    QCOMPARE(int(cache.getCoalescedCount()), threadCount - 1);
+    for (const CachedExplanation& result : std::as_const(results)) {
+        QCOMPARE(result.explanation, QString("shared explanation"));
+        QCOMPARE(result.errors.size(), 1);
+        QCOMPARE(result.errors.first().getErrorType(), ErrorType::MissingOperand);
+    }
+
+    // Следующий запрос берёт результат из кэша
+    CachedExplanation found;
+    QVERIFY(cache.find("key", found));
+}
@@ -0,0 +1,20 @@
+#ifndef TEST_EXPLANATIONCACHE_H
+#define TEST_EXPLANATIONCACHE_H
+
+#include <QObject>
+
+class test_explanationCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_explanationCache(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void makeKey(); // static QString ExplanationCache::makeKey(const QByteArray& schemaHash, const QString& expression, bool checkUnusedElements)
+    void makeKey_data();
+    void cachedExplainAll(); // QList<ExplanationResult> ExpressionDocument::explainAll(...) с кэшем
+    void eviction(); // void ExplanationCache::insert(const QString& key, const CachedExplanation& value)
+    void coalescing(); // CachedExplanation ExplanationCache::findOrCompute(const QString& key, ...)
+};
+
+#endif // TEST_EXPLANATIONCACHE_H
@@ -0,0 +1,252 @@
+#include "test_explanationserver.h"
+#include "explanationclient.h"
+#include <QtTest/QTest>
+#include <explanationserver.h>
+#include <teexception.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+
+Q_DECLARE_METATYPE(ServerRequest)
+Q_DECLARE_METATYPE(ResponseStatus)
+
+// Документ с одним выражением (или без выражения) над схемой из двух переменных
+static QString documentXml(const QString& expression, const QString& secondDescription = "second value") {
+    return "<root>\n"
+           + (expression.isNull() ? QString() : "<expression>" + expression + "</expression>\n") +
+           "<variables>\n"
+           "<variable name=\"a\" type=\"int\"><description>first value</description></variable>\n"
+           "<variable name=\"b\" type=\"int\"><description>" + secondDescription + "</description></variable>\n"
+           "</variables>\n"
+           "<functions></functions>\n"
+           "<unions></unions>\n"
+           "<structures></structures>\n"
+           "<classes></classes>\n"
+           "<enums></enums>\n"
+           "</root>\n";
+}
+
+test_explanationServer::test_explanationServer(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_explanationServer::request()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Server mode is available on Unix systems only");
+#endif
+    QFETCH(ServerRequest, request);
+    QFETCH(ResponseStatus, expectedStatus);
+    QFETCH(QStringList, expectedTexts);
+
+    QTemporaryDir dir;
+    QString socketPath = dir.filePath("server.sock");
+    ExplanationServer server(socketPath, 2);
+    QVERIFY(server.listen());
+    QThread* serverThread = QThread::create([&server]() { server.exec(); });
+    serverThread->start();
+
+    ExplanationClient client;
+    ServerResponse response;
+    QVERIFY(client.connectTo(socketPath));
+    QVERIFY(client.request(request, response));
+    client.close();
+
+    server.stop();
+    serverThread->wait();
+    delete serverThread;
+
+    QCOMPARE(response.status, expectedStatus);
+    QCOMPARE(response.texts, expectedTexts);
+}
+
+void test_explanationServer::request_data()
+{
+    QTest::addColumn<ServerRequest>("request");
+    QTest::addColumn<ResponseStatus>("expectedStatus");
+    QTest::addColumn<QStringList>("expectedTexts");
+
+    QTest::newRow("1. Document is explained")
+        << ServerRequest{RequestType::Document, {documentXml("a b +")}}
+        << ResponseStatus::Ok
+        << QStringList{"sum of first value and second value"};
+
+    QTest::newRow("2. Expression error is returned as TEException list")
+        << ServerRequest{RequestType::Document, {documentXml("a +")}}
+        << ResponseStatus::Errors
+        << QStringList{TEException(ErrorType::MissingOperand, QList<QString>{"+"}).what()};
+
+    QTest::newRow("3. Request without document")
+        << ServerRequest{RequestType::Document, {}}
+        << ResponseStatus::BadRequest
+        << QStringList{"unknown request type or wrong number of fields"};
+}
+
+void test_explanationServer::gracefulShutdown()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Server mode is available on Unix systems only");
+#endif
+    QTemporaryDir dir;
+    QString socketPath = dir.filePath("server.sock");
+    ExplanationServer server(socketPath, 2);
+    QVERIFY(server.listen());
+    QThread* serverThread = QThread::create([&server]() { server.exec(); });
+    serverThread->start();
+
+    ServerRequest request{RequestType::Document, {documentXml("a b +")}};
+    ServerResponse response;
+    ExplanationClient client;
+    QVERIFY(client.connectTo(socketPath));
+    // Первый ответ гарантирует, что соединение уже принято сервером
+    QVERIFY(client.request(request, response));
+
+    // Запрос, отправленный до остановки, обрабатывается, после чего сервер завершает работу
+    QVERIFY(client.send(request));
+    server.stop();
+    QVERIFY(client.receive(response));
+    QCOMPARE(response.status, ResponseStatus::Ok);
+    QCOMPARE(response.texts, QStringList{"sum of first value and second value"});
+
+    QVERIFY(serverThread->wait(10000));
+    delete serverThread;
+    QVERIFY(!QFile::exists(socketPath));
+    QVERIFY(!client.receive(response));
+}
+
+void test_explanationServer::idleConnections()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Server mode is available on Unix systems only");
+#endif
+    QTemporaryDir dir;
+    QString socketPath = dir.filePath("server.sock");
+    // Один поток обработки и больше соединений, чем потоков
+    ExplanationServer server(socketPath, 1);
+    QVERIFY(server.listen());
+    QThread* serverThread = QThread::create([&server]() { server.exec(); });
+    serverThread->start();
+
+    ServerRequest request{RequestType::Document, {documentXml("a b +")}};
+    ExplanationClient clients[3];
+    for (ExplanationClient& client : clients) {
+        QVERIFY(client.connectTo(socketPath));
+    }
+
+    // Простаивающие соединения не занимают поток: запросы обслуживаются в любом порядке соединений
+    for (int i = 2; i >= 0; i--) {
+        ServerResponse response;
+        QVERIFY(clients[i].request(request, response));
+        QCOMPARE(response.texts, QStringList{"sum of first value and second value"});
+    }
+    ServerResponse response;
+    QVERIFY(clients[0].request(request, response));
+    QCOMPARE(response.status, ResponseStatus::Ok);
+
+    for (ExplanationClient& client : clients) {
+        client.close();
+    }
+    server.stop();
+    QVERIFY(serverThread->wait(10000));
+    delete serverThread;
+}
+
+void test_explanationServer::registeredSchema()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Server mode is available on Unix systems only");
+#endif
+    QTemporaryDir dir;
+    QString socketPath = dir.filePath("server.sock");
+    // Бюджет реестра вмещает только одну схему
+    ExplanationServer server(socketPath, 2, 1);
+    QVERIFY(server.listen());
+    QThread* serverThread = QThread::create([&server]() { server.exec(); });
+    serverThread->start();
+
+    ExplanationClient client;
+    QVERIFY(client.connectTo(socketPath));
+
+    // Регистрация схемы: повторная регистрация возвращает тот же дескриптор
+    ServerResponse registered;
+    QVERIFY(client.request(ServerRequest{RequestType::Schema, {documentXml(QString())}}, registered));
+    QCOMPARE(registered.status, ResponseStatus::Ok);
+    QCOMPARE(registered.texts.size(), 1);
+    QString handle = registered.texts[0];
+    ServerResponse registeredAgain;
+    QVERIFY(client.request(ServerRequest{RequestType::Schema, {documentXml("a b +")}}, registeredAgain));
+    QCOMPARE(registeredAgain.texts, QStringList{handle});
+
+    // Пакет выражений над схемой: ответ на каждое выражение, неиспользованные элементы не проверяются
+    QList<ServerResponse> responses(3);
+    QVERIFY(client.send(ServerRequest{RequestType::Expressions, {handle, "a b +", "a +", "b 2 *"}}));
+    for (ServerResponse& response : responses) {
+        QVERIFY(client.receive(response));
+    }
+    QCOMPARE(responses[0].status, ResponseStatus::Ok);
+    QCOMPARE(responses[0].texts, QStringList{"sum of first value and second value"});
+    QCOMPARE(responses[1].status, ResponseStatus::Errors);
+    QCOMPARE(responses[1].texts, QStringList{TEException(ErrorType::MissingOperand, QList<QString>{"+"}).what()});
+    QCOMPARE(responses[2].status, ResponseStatus::Ok);
+    QCOMPARE(responses[2].texts, QStringList{"product of second value and 2"});
+
+    // Другая схема вытесняет первую — клиент узнаёт об этом по статусу
+    ServerResponse other;
+    QVERIFY(client.request(ServerRequest{RequestType::Schema, {documentXml(QString(), "other value")}}, other));
+    QVERIFY(other.texts != QStringList{handle});
+    ServerResponse unknown;
+    QVERIFY(client.request(ServerRequest{RequestType::Expressions, {handle, "a b +"}}, unknown));
+    QCOMPARE(unknown.status, ResponseStatus::UnknownHandle);
+    QCOMPARE(unknown.texts, QStringList{handle});
+    QCOMPARE(int(server.getSchemaRegistry().getEvictionCount()), 1);
+
+    client.close();
+    server.stop();
+    serverThread->wait();
+    delete serverThread;
+}
+
+void test_explanationServer::whitespaceExpression()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Server mode is available on Unix systems only");
+#endif
+    QTemporaryDir dir;
+    QString socketPath = dir.filePath("server.sock");
+    ExplanationServer server(socketPath, 2);
+    QVERIFY(server.listen());
+    QThread* serverThread = QThread::create([&server]() { server.exec(); });
+    serverThread->start();
+
+    ExplanationClient client;
+    QVERIFY(client.connectTo(socketPath));
+    ServerResponse registered;
+    QVERIFY(client.request(ServerRequest{RequestType::Schema, {documentXml(QString())}}, registered));
+    QCOMPARE(registered.status, ResponseStatus::Ok);
+    QString handle = registered.texts[0];
+
+    // Выражение без лексем — ошибка запроса, а не падение сервера
+    QList<ServerResponse> responses(3);
+    QVERIFY(client.send(ServerRequest{RequestType::Expressions, {handle, " ", "\n", "a b +"}}));
+    for (ServerResponse& response : responses) {
+        QVERIFY(client.receive(response));
+    }
+    const QString emptyError = TEException(ErrorType::EmptyElementValue, QList<QString>{"expression"}).what();
+    QCOMPARE(responses[0].status, ResponseStatus::Errors);
+    QCOMPARE(responses[0].texts, QStringList{emptyError});
+    QCOMPARE(responses[1].status, ResponseStatus::Errors);
+    QCOMPARE(responses[1].texts, QStringList{emptyError});
+    QCOMPARE(responses[2].status, ResponseStatus::Ok);
+
+    // Сервер продолжает обслуживать запросы
+    ServerResponse response;
+    QVERIFY(client.request(ServerRequest{RequestType::Expressions, {handle, "b 2 *"}}, response));
+    QCOMPARE(response.status, ResponseStatus::Ok);
+    QCOMPARE(response.texts, QStringList{"product of second value and 2"});
+
+    client.close();
+    server.stop();
+    QVERIFY(serverThread->wait(10000));
+    delete serverThread;
+}
@@ -0,0 +1,21 @@
+#ifndef TEST_EXPLANATIONSERVER_H
+#define TEST_EXPLANATIONSERVER_H
+
+#include <QObject>
+
+class test_explanationServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_explanationServer(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void request(); // ServerResponse ExplanationServer::handleRequest(const ServerRequest& request) через сокет
+    void request_data();
+    void gracefulShutdown(); // void ExplanationServer::stop()
+    void idleConnections(); // void ExplanationServer::exec()
+    void registeredSchema(); // QList<ServerResponse> ExplanationServer::explainExpressions(const QString& handle, const QStringList& expressions)
+    void whitespaceExpression(); // QList<ServerResponse> ExplanationServer::explainExpressions(const QString& handle, const QStringList& expressions)
+};
+
+#endif // TEST_EXPLANATIONSERVER_H
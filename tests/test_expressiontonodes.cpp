@@ -1,5 +1,6 @@
 #include "test_expressiontonodes.h"
 #include <QtTest/QTest>
+#include <allocationtracker.h>
 #include <expression.h>
 #include <expressionnode.h>
 #include <teexception.h>
@@ -997,4 +998,63 @@ void test_expressionToNodes::expressionToNodes_data()
             << false
             << root;
     }
+
+    // Тест 59: Строка состоит только из пробелов "   "
+    {
+        QString exprString = "   ";
+        Expression expression(exprString, {});
+
+        QTest::newRow("whitespace-only")
+            << exprString
+            << expression
+            << true
+            << static_cast<ExpressionNode*>(nullptr)
+            << ErrorType::EmptyElementValue;
+    }
+}
+
+void test_expressionToNodes::deleteFreesTree()
+{
+#ifdef TE_DISABLE_STATS
+    QSKIP("Allocation tracking is disabled by TE_DISABLE_STATS");
+#endif
+    QFETCH(QString, expressionString);
+    QFETCH(bool, isValid);
+
+    Expression expression(expressionString, {{"a", Variable("a", "int")}, {"b", Variable("b", "int")}},
+                          {{"max", Function("max", "int", 2)}});
+    // Первое построение заполняет статические таблицы разбора
+    {
+        QSet<QString> usedElements;
+        TEResult<ExpressionNode*> tree = expression.tryExpressionToNodes(&usedElements);
+        if (tree.isOk()) delete tree.value();
+    }
+
+    AllocationTracker::enable();
+    const qint64 liveBefore = AllocationTracker::threadLiveBytes();
+    bool built;
+    {
+        QSet<QString> usedElements;
+        TEResult<ExpressionNode*> tree = expression.tryExpressionToNodes(&usedElements);
+        built = tree.isOk();
+        if (built) delete tree.value();
+    }
+    const qint64 liveAfter = AllocationTracker::threadLiveBytes();
+    AllocationTracker::disable();
+
+    QCOMPARE(built, isValid);
+    // Удаление корня освобождает все узлы и списки аргументов; при ошибке освобождаются уже построенные поддеревья
+    QCOMPARE(liveAfter, liveBefore);
+}
+
+void test_expressionToNodes::deleteFreesTree_data()
+{
+    QTest::addColumn<QString>("expressionString");
+    QTest::addColumn<bool>("isValid");
+
+    QTest::newRow("1. Nested operations") << "a b + a * b -" << true;
+    QTest::newRow("2. Function arguments") << "a b max(2) 1 +" << true;
+    QTest::newRow("3. Function inside function") << "a b max(2) b max(2)" << true;
+    QTest::newRow("4. Missing operand after built subtrees") << "a b + b max(2) +" << false;
+    QTest::newRow("5. Undefined identifier after built subtrees") << "a b max(2) c +" << false;
 }
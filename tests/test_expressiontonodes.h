@@ -12,6 +12,8 @@ public:
 private slots: // должны быть приватными
     void expressionToNodes(); // expressionToNodes...
     void expressionToNodes_data(); // expressionToNodes...
+    void deleteFreesTree(); // ExpressionNode::~ExpressionNode()
+    void deleteFreesTree_data();
 };
 
 #endif // TEST_EXPRESSIONTONODES_H
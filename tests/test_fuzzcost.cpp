@@ -0,0 +1,51 @@
+#include "test_fuzzcost.h"
+#include <QtTest/QTest>
+#include <QDir>
+#include <QFile>
+#include <fuzzcost.h>
+#include <fuzztargets.h>
+
+test_fuzzCost::test_fuzzCost(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_fuzzCost::bucket()
+{
+    QFETCH(double, costPerByte);
+    QFETCH(int, expected);
+
+    QCOMPARE(FuzzCost::bucket(costPerByte), expected);
+}
+
+void test_fuzzCost::bucket_data()
+{
+    QTest::addColumn<double>("costPerByte");
+    QTest::addColumn<int>("expected");
+
+    QTest::newRow("1. No extra cost") << 0.0 << 0;
+    QTest::newRow("2. Less than one per byte") << 0.99 << 0;
+    QTest::newRow("3. One per byte") << 1.0 << 1;
+    QTest::newRow("4. Quarter of an octave") << 1.15 << 1;
+    QTest::newRow("5. Next quarter of an octave") << 1.2 << 2;
+    QTest::newRow("6. Two per byte") << 2.0 << 5;
+    QTest::newRow("7. Thousand per byte") << 1000.0 << 40;
+    QTest::newRow("8. Last bucket") << 1e30 << FuzzCost::bucketCount - 1;
+    QTest::newRow("9. Not a number") << qQNaN() << 0;
+}
+
+void test_fuzzCost::regressions()
+{
+    // Найденные фаззерами входы лежат в подкаталогах целей и обрабатываются без сбоев
+    int inputs = 0;
+    for (const QString& target : FuzzTargets::targetNames()) {
+        const QDir dir(QDir(FUZZ_REGRESSIONS_DIR).filePath(target));
+        for (const QString& name : dir.entryList(QStringList{"*.in"}, QDir::Files, QDir::Name)) {
+            QFile file(dir.filePath(name));
+            QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(file.fileName()));
+            QVERIFY2(FuzzTargets::run(target, file.readAll()), qPrintable(file.fileName()));
+            inputs++;
+        }
+    }
+    QVERIFY(inputs > 0);
+    QVERIFY(!FuzzTargets::run("unknown", QByteArray()));
+}
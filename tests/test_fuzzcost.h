@@ -0,0 +1,18 @@
+#ifndef TEST_FUZZCOST_H
+#define TEST_FUZZCOST_H
+
+#include <QObject>
+
+class test_fuzzCost : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_fuzzCost(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void bucket(); // static int FuzzCost::bucket(double costPerByte)
+    void bucket_data();
+    void regressions(); // static bool FuzzTargets::run(const QString& target, const QByteArray& input)
+};
+
+#endif // TEST_FUZZCOST_H
@@ -13,8 +13,9 @@ void test_isReducibleUnarySelfInverse::isReducibleUnarySelfInverse()
     QFETCH(OperationType, leftOperType);
     QFETCH(bool, result);
 
-    ExpressionNode leftNode(EntityType::Operation, "", nullptr, nullptr, "", leftOperType);
-    ExpressionNode thisNode(EntityType::Operation, "", &leftNode, nullptr, "", thisOperType);
+    // Узел владеет потомком и освобождает его
+    ExpressionNode thisNode(EntityType::Operation, "", new ExpressionNode(EntityType::Operation, "", nullptr, nullptr, "", leftOperType),
+                            nullptr, "", thisOperType);
 
     QCOMPARE(thisNode.isReducibleUnarySelfInverse(), result);
 }
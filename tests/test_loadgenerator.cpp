@@ -0,0 +1,139 @@
+#include "test_loadgenerator.h"
+#include <QtTest/QTest>
+#include <explanationserver.h>
+#include <loadgenerator.h>
+
+#include <QTemporaryDir>
+#include <QThread>
+
+Q_DECLARE_METATYPE(LoadMode)
+
+test_loadGenerator::test_loadGenerator(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_loadGenerator::valueAtPercentile()
+{
+    QFETCH(QList<qint64>, values);
+    QFETCH(double, percentile);
+    QFETCH(qint64, expected);
+
+    LatencyHistogram histogram;
+    for (qint64 value : values) histogram.record(value);
+    QCOMPARE(histogram.valueAtPercentile(percentile), expected);
+}
+
+void test_loadGenerator::valueAtPercentile_data()
+{
+    QTest::addColumn<QList<qint64>>("values");
+    QTest::addColumn<double>("percentile");
+    QTest::addColumn<qint64>("expected");
+
+    QList<qint64> thousand;
+    for (qint64 value = 1000; value >= 1; value--) thousand.append(value);
+    QList<qint64> tenThousand;
+    for (qint64 value = 1; value <= 10000; value++) tenThousand.append(value);
+
+    QTest::newRow("1. Empty histogram") << QList<qint64>{} << 50.0 << qint64(0);
+    QTest::newRow("2. Single value") << QList<qint64>{1500} << 50.0 << qint64(1500);
+    QTest::newRow("3. Values below 2048 are exact") << thousand << 50.0 << qint64(500);
+    QTest::newRow("4. p99.9 of 1000 values") << thousand << 99.9 << qint64(999);
+    QTest::newRow("5. Three significant digits above 2048") << tenThousand << 99.0 << qint64(9903);
+    QTest::newRow("6. p100 is the maximum") << tenThousand << 100.0 << qint64(10000);
+    QTest::newRow("7. Value above the trackable range is clamped")
+        << QList<qint64>{2 * LatencyHistogram::highestTrackableValue} << 50.0 << LatencyHistogram::highestTrackableValue;
+}
+
+void test_loadGenerator::recordCorrected()
+{
+    QFETCH(qint64, value);
+    QFETCH(qint64, expectedInterval);
+    QFETCH(qint64, expectedCount);
+    QFETCH(qint64, expectedMin);
+
+    LatencyHistogram histogram;
+    histogram.recordCorrected(value, expectedInterval);
+    QCOMPARE(histogram.getTotalCount(), expectedCount);
+    QCOMPARE(histogram.getMin(), expectedMin);
+    QCOMPARE(histogram.getMax(), value);
+}
+
+void test_loadGenerator::recordCorrected_data()
+{
+    QTest::addColumn<qint64>("value");
+    QTest::addColumn<qint64>("expectedInterval");
+    QTest::addColumn<qint64>("expectedCount");
+    QTest::addColumn<qint64>("expectedMin");
+
+    QTest::newRow("1. No correction without interval") << qint64(100000) << qint64(0) << qint64(1) << qint64(100000);
+    QTest::newRow("2. Latency within the interval") << qint64(5000) << qint64(10000) << qint64(1) << qint64(5000);
+    QTest::newRow("3. Missed requests are added down to the interval") << qint64(100000) << qint64(10000) << qint64(10) << qint64(10000);
+    QTest::newRow("4. Remainder below the interval is not added") << qint64(25000) << qint64(10000) << qint64(2) << qint64(15000);
+}
+
+void test_loadGenerator::copyCorrected()
+{
+    // 99 быстрых ответов и один ответ, за время которого закрытый цикл не отправил 99 запросов
+    LatencyHistogram histogram;
+    histogram.record(1000, 99);
+    histogram.record(100000);
+
+    const LatencyHistogram corrected = histogram.copyCorrectedForCoordinatedOmission(1000);
+    QCOMPARE(corrected.getTotalCount(), qint64(199));
+    QCOMPARE(corrected.getMax(), qint64(100000));
+    QCOMPARE(histogram.valueAtPercentile(99), qint64(1000));
+    // Без поправки p99 скрывает задержку, которую увидели бы пропущенные запросы
+    QVERIFY(corrected.valueAtPercentile(99) > 90000);
+
+    const LatencyHistogram uncorrected = histogram.copyCorrectedForCoordinatedOmission(0);
+    QCOMPARE(uncorrected.getTotalCount(), histogram.getTotalCount());
+    QCOMPARE(uncorrected.valueAtPercentile(99), histogram.valueAtPercentile(99));
+}
+
+void test_loadGenerator::run()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Server mode is available on Unix systems only");
+#endif
+    QFETCH(LoadMode, mode);
+
+    const QList<ServerRequest> corpus = LoadGenerator::loadCorpus(PIPELINEBENCH_CORPUS_DIR);
+    QVERIFY(!corpus.isEmpty());
+
+    QTemporaryDir dir;
+    QString socketPath = dir.filePath("server.sock");
+    ExplanationServer server(socketPath, 2);
+    QVERIFY(server.listen());
+    QThread* serverThread = QThread::create([&server]() { server.exec(); });
+    serverThread->start();
+
+    LoadOptions options;
+    options.socketPath = socketPath;
+    options.mode = mode;
+    options.rate = 200;
+    options.connections = 2;
+    options.durationSeconds = 0.3;
+    options.warmupSeconds = 0.1;
+    const LoadReport report = LoadGenerator::run(options, corpus);
+
+    server.stop();
+    serverThread->wait();
+    delete serverThread;
+
+    QCOMPARE(report.failures, qint64(0));
+    QCOMPARE(report.errorResponses, qint64(0));
+    QVERIFY(report.completed > 0);
+    QVERIFY(report.throughput > 0);
+    QCOMPARE(report.serviceLatency.getTotalCount(), report.completed);
+    // Задержка с поправкой учитывает не меньше ответов и не меньше худшей задержки обработки
+    QVERIFY(report.latency.getTotalCount() >= report.completed);
+    QVERIFY(report.latency.getMax() >= report.serviceLatency.getMax());
+}
+
+void test_loadGenerator::run_data()
+{
+    QTest::addColumn<LoadMode>("mode");
+
+    QTest::newRow("1. Open loop") << LoadMode::Open;
+    QTest::newRow("2. Closed loop") << LoadMode::Closed;
+}
@@ -0,0 +1,22 @@
+#ifndef TEST_LOADGENERATOR_H
+#define TEST_LOADGENERATOR_H
+
+#include <QObject>
+
+class test_loadGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_loadGenerator(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void valueAtPercentile(); // qint64 LatencyHistogram::valueAtPercentile(double percentile) const
+    void valueAtPercentile_data();
+    void recordCorrected(); // void LatencyHistogram::recordCorrected(qint64 value, qint64 expectedInterval, qint64 count)
+    void recordCorrected_data();
+    void copyCorrected(); // LatencyHistogram LatencyHistogram::copyCorrectedForCoordinatedOmission(qint64 expectedInterval) const
+    void run(); // static LoadReport LoadGenerator::run(const LoadOptions& options, const QList<ServerRequest>& corpus)
+    void run_data();
+};
+
+#endif // TEST_LOADGENERATOR_H
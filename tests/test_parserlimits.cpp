@@ -0,0 +1,127 @@
+#include "test_parserlimits.h"
+#include <QtTest/QTest>
+#include <QTemporaryFile>
+#include <expressionxmlparser.h>
+
+test_parserLimits::test_parserLimits(QObject *parent)
+    : QObject{parent}
+{}
+
+// Документ с одним выражением и дополнительным содержимым внутри <variables>
+static QString documentXml(const QString& extraVariables = QString())
+{
+    return "<root><expression>a 1 +</expression><variables>"
+           "<variable name=\"a\" type=\"int\"><description>value</description></variable>" + extraVariables +
+           "</variables><functions/><unions/><structures/><classes/><enums/></root>";
+}
+
+void test_parserLimits::readDocumentFromXMLContent()
+{
+    QFETCH(QString, xml);
+    QFETCH(int, maxNestingDepth);
+    QFETCH(int, maxAttributesPerElement);
+    QFETCH(int, maxErrors);
+    QFETCH(QStringList, expectedErrors);
+
+    ParserLimits limits;
+    limits.maxNestingDepth = maxNestingDepth;
+    limits.maxAttributesPerElement = maxAttributesPerElement;
+    limits.maxErrors = maxErrors;
+    ExpressionXmlParser::setLimits(limits);
+
+    QStringList actualErrors;
+    try {
+        ExpressionDocument document;
+        ExpressionXmlParser::readDocumentFromXMLContent(xml, document, "request");
+    } catch (const QList<TEException>& errors) {
+        for (const TEException& error : errors) {
+            actualErrors.append(TEException::ErrorTypeNames.value(error.getErrorType()));
+        }
+    }
+
+    QCOMPARE(actualErrors, expectedErrors);
+}
+
+void test_parserLimits::readDocumentFromXMLContent_data()
+{
+    QTest::addColumn<QString>("xml");
+    QTest::addColumn<int>("maxNestingDepth");
+    QTest::addColumn<int>("maxAttributesPerElement");
+    QTest::addColumn<int>("maxErrors");
+    QTest::addColumn<QStringList>("expectedErrors");
+
+    QString deep = "<a><a><a><a><a><a></a></a></a></a></a></a>";
+    QString manyAttributes = "<variable name=\"b\" type=\"int\" x1=\"1\" x2=\"2\" x3=\"3\"><description>b</description></variable>";
+    QString unexpected;
+    for (int i = 0; i < 50; i++) unexpected += "<unexpected/>";
+
+    QTest::newRow("1. Within limits") << documentXml() << 16 << 8 << 100 << QStringList{};
+    QTest::newRow("2. Nesting too deep") << documentXml(deep) << 6 << 8 << 100 << QStringList{"NestingDepthExceeded"};
+    QTest::newRow("3. Too many attributes") << documentXml(manyAttributes) << 16 << 4 << 100 << QStringList{"AttributesCountExceeded"};
+    QTest::newRow("4. Attributes within limit report each unexpected one") << documentXml(manyAttributes) << 16 << 8 << 100
+        << QStringList{"UnexpectedAttribute", "UnexpectedAttribute", "UnexpectedAttribute"};
+
+    QStringList truncated{"UnexpectedElement", "UnexpectedElement", "UnexpectedElement", "ErrorLimitExceeded"};
+    QTest::newRow("5. Stop after the error limit") << documentXml(unexpected) << 16 << 8 << 3 << truncated;
+}
+
+void test_parserLimits::inputFileTooLarge()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(documentXml().toUtf8());
+    file.close();
+
+    ParserLimits limits;
+    limits.maxInputBytes = 16;
+    ExpressionXmlParser::setLimits(limits);
+
+    try {
+        ExpressionDocument document;
+        ExpressionXmlParser::readDocumentFromXML(file.fileName(), document);
+        QFAIL("Expected InputFileTooLarge");
+    } catch (const QList<TEException>& errors) {
+        QCOMPARE(errors.size(), 1);
+        QCOMPARE(errors.first().getErrorType(), ErrorType::InputFileTooLarge);
+    }
+}
+
+void test_parserLimits::inputCopy()
+{
+    QFETCH(bool, copyEnabled);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(documentXml().toUtf8());
+    file.close();
+
+    ExpressionXmlParser::setInputCopyEnabled(copyEnabled);
+
+    // Файл читается одинаково с копией и без неё
+    ExpressionDocument document;
+    TEResult<void> read = ExpressionXmlParser::tryReadDocumentFromXML(file.fileName(), document);
+    QVERIFY(read.isOk());
+    QCOMPARE(document.getExpressions().size(), 1);
+    QCOMPARE(document.getExpressions().first().expression, QString("a 1 +"));
+
+    // Отсутствующий файл — та же ошибка
+    ExpressionDocument missing;
+    read = ExpressionXmlParser::tryReadDocumentFromXML(file.fileName() + ".missing", missing);
+    QVERIFY(!read.isOk());
+    QCOMPARE(read.getErrors().size(), 1);
+    QCOMPARE(read.getErrors().first().getErrorType(), ErrorType::InputFileNotFound);
+}
+
+void test_parserLimits::inputCopy_data()
+{
+    QTest::addColumn<bool>("copyEnabled");
+
+    QTest::newRow("1. Through a temporary copy") << true;
+    QTest::newRow("2. Direct read") << false;
+}
+
+void test_parserLimits::cleanup()
+{
+    ExpressionXmlParser::setLimits(ParserLimits());
+    ExpressionXmlParser::setInputCopyEnabled(true);
+}
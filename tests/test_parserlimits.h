@@ -0,0 +1,21 @@
+#ifndef TEST_PARSERLIMITS_H
+#define TEST_PARSERLIMITS_H
+
+#include <QObject>
+
+class test_parserLimits : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_parserLimits(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void readDocumentFromXMLContent(); // void ExpressionXmlParser::readDocumentFromXMLContent(...) с ограничениями разбора
+    void readDocumentFromXMLContent_data();
+    void inputFileTooLarge(); // void ExpressionXmlParser::readDocumentFromXML(...) для файла больше допустимого размера
+    void inputCopy(); // void ExpressionXmlParser::readDocumentFromXML(...) с временной копией входного файла и без неё
+    void inputCopy_data();
+    void cleanup();
+};
+
+#endif // TEST_PARSERLIMITS_H
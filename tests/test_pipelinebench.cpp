@@ -0,0 +1,67 @@
+#include "test_pipelinebench.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <pipelinebench.h>
+
+test_pipelineBench::test_pipelineBench(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_pipelineBench::corpusMatchesGolden()
+{
+    const QList<CorpusFile> corpus = PipelineBench::loadCorpus(PIPELINEBENCH_CORPUS_DIR);
+    QVERIFY(!corpus.isEmpty());
+
+    QStringList missing;
+    for (const CorpusFile& file : corpus) {
+        if (!file.hasGolden) missing.append(file.goldenFile);
+    }
+    QCOMPARE(missing, QStringList());
+
+    QTemporaryDir outputDir;
+    QVERIFY(outputDir.isValid());
+    // Объяснения при параллельной обработке совпадают с эталонами
+    const PipelineRun run = PipelineBench::run(corpus, 4, 2, outputDir.path());
+    QCOMPARE(run.files, int(corpus.size()) * 2);
+    QCOMPARE(run.mismatches, QStringList());
+    QVERIFY(run.p50Ms <= run.p99Ms);
+}
+
+void test_pipelineBench::findRegressions()
+{
+    QFETCH(QJsonArray, baseline);
+    QFETCH(QJsonArray, current);
+    QFETCH(int, expectedCount);
+
+    const QStringList regressions = PipelineBench::findRegressions(baseline, current, 10);
+    if (regressions.size() != expectedCount) qDebug() << regressions;
+    QCOMPARE(regressions.size(), expectedCount);
+}
+
+void test_pipelineBench::findRegressions_data()
+{
+    QTest::addColumn<QJsonArray>("baseline");
+    QTest::addColumn<QJsonArray>("current");
+    QTest::addColumn<int>("expectedCount");
+
+    auto run = [](int threads, double filesPerSecond, double megabytesPerSecond, double p50, double p99) {
+        return QJsonObject{{"threads", threads}, {"files_per_second", filesPerSecond},
+                           {"megabytes_per_second", megabytesPerSecond}, {"p50_ms", p50}, {"p99_ms", p99}};
+    };
+
+    QTest::newRow("1. Same results")
+        << QJsonArray{run(1, 1000, 2, 0.5, 1.0)} << QJsonArray{run(1, 1000, 2, 0.5, 1.0)} << 0;
+    QTest::newRow("2. Changes within the threshold")
+        << QJsonArray{run(1, 1000, 2, 0.5, 1.0)} << QJsonArray{run(1, 920, 1.9, 0.54, 1.09)} << 0;
+    QTest::newRow("3. Faster run is not a regression")
+        << QJsonArray{run(1, 1000, 2, 0.5, 1.0)} << QJsonArray{run(1, 2000, 4, 0.25, 0.5)} << 0;
+    QTest::newRow("4. Throughput drop")
+        << QJsonArray{run(1, 1000, 2, 0.5, 1.0)} << QJsonArray{run(1, 800, 1.6, 0.5, 1.0)} << 2;
+    QTest::newRow("5. Tail latency growth")
+        << QJsonArray{run(1, 1000, 2, 0.5, 1.0)} << QJsonArray{run(1, 1000, 2, 0.5, 1.5)} << 1;
+    QTest::newRow("6. Runs are matched by thread count")
+        << QJsonArray{run(1, 1000, 2, 0.5, 1.0), run(4, 3000, 6, 0.6, 1.2)}
+        << QJsonArray{run(4, 3000, 6, 0.6, 1.2), run(1, 500, 1, 1.0, 2.0)} << 4;
+    QTest::newRow("7. Thread count missing from the baseline")
+        << QJsonArray{run(1, 1000, 2, 0.5, 1.0)} << QJsonArray{run(8, 100, 0.2, 5.0, 10.0)} << 0;
+}
@@ -0,0 +1,18 @@
+#ifndef TEST_PIPELINEBENCH_H
+#define TEST_PIPELINEBENCH_H
+
+#include <QObject>
+
+class test_pipelineBench : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_pipelineBench(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void corpusMatchesGolden(); // static PipelineRun PipelineBench::run(const QList<CorpusFile>& corpus, int threads, int repeats, const QString& outputDir)
+    void findRegressions(); // static QStringList PipelineBench::findRegressions(const QJsonArray& baseline, const QJsonArray& current, double threshold)
+    void findRegressions_data();
+};
+
+#endif // TEST_PIPELINEBENCH_H
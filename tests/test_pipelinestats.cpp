@@ -0,0 +1,196 @@
+#include "test_pipelinestats.h"
+#include <QtTest/QTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <allocationtracker.h>
+#include <expression.h>
+#include <perfcounters.h>
+#include <pipelinestats.h>
+
+test_pipelineStats::test_pipelineStats(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_pipelineStats::countersOfExpression()
+{
+    QFETCH(QString, expression);
+    QFETCH(qint64, expectedTokens);
+    QFETCH(qint64, expectedNodes);
+
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")},
+         {"b", Variable("b", "int", "second value")}});
+
+    // Без установленного накопителя ничего не считается
+    StatsRecorder unused;
+    Expression(schema, expression).tryGetExplanationInEn();
+    QCOMPARE(unused.sample().counters[int(PipelineCounter::Tokens)], qint64(0));
+
+    StatsRecorder recorder;
+    {
+        StatsScope scope(&recorder);
+        QVERIFY(Expression(schema, expression).tryGetExplanationInEn().isOk());
+    }
+    QVERIFY(StatsRecorder::current() == nullptr);
+
+    StatsSample sample = recorder.sample();
+#ifndef TE_DISABLE_STATS
+    QCOMPARE(sample.counters[int(PipelineCounter::Tokens)], expectedTokens);
+    QCOMPARE(sample.counters[int(PipelineCounter::Nodes)], expectedNodes);
+    QVERIFY(sample.counters[int(PipelineCounter::TemplateApplications)] > 0);
+    QVERIFY(sample.stageNs[int(PipelineStage::BuildTree)] > 0);
+    QVERIFY(sample.stageNs[int(PipelineStage::Render)] > 0);
+#else
+    Q_UNUSED(expectedTokens);
+    Q_UNUSED(expectedNodes);
+    QCOMPARE(sample.counters[int(PipelineCounter::Tokens)], qint64(0));
+#endif
+}
+
+void test_pipelineStats::countersOfExpression_data()
+{
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<qint64>("expectedTokens");
+    QTest::addColumn<qint64>("expectedNodes");
+
+    QTest::newRow("1. Binary operation") << "a b +" << qint64(3) << qint64(3);
+    QTest::newRow("2. Nested operations") << "a b + b *" << qint64(5) << qint64(5);
+}
+
+void test_pipelineStats::percentile()
+{
+    QFETCH(QList<qint64>, sorted);
+    QFETCH(int, percent);
+    QFETCH(qint64, expected);
+
+    QCOMPARE(StatsAggregate::percentile(sorted, percent), expected);
+}
+
+void test_pipelineStats::percentile_data()
+{
+    QTest::addColumn<QList<qint64>>("sorted");
+    QTest::addColumn<int>("percent");
+    QTest::addColumn<qint64>("expected");
+
+    QList<qint64> hundred;
+    for (int i = 1; i <= 100; i++) hundred.append(i);
+
+    QTest::newRow("1. Empty list") << QList<qint64>{} << 50 << qint64(0);
+    QTest::newRow("2. Single value") << QList<qint64>{7} << 99 << qint64(7);
+    QTest::newRow("3. Median of odd count") << QList<qint64>{1, 2, 3, 4, 5} << 50 << qint64(3);
+    QTest::newRow("4. Median of even count") << QList<qint64>{1, 2, 3, 4} << 50 << qint64(2);
+    QTest::newRow("5. p99 of 100 values") << hundred << 99 << qint64(99);
+    QTest::newRow("6. p99 of 10 values is the maximum") << QList<qint64>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10} << 99 << qint64(10);
+}
+
+void test_pipelineStats::percentiles()
+{
+    // Полное время запросов: 1..100 нс
+    StatsAggregate aggregate;
+    for (int i = 100; i >= 1; i--) {
+        StatsSample sample;
+        sample.totalNs = i;
+        sample.counters[int(PipelineCounter::Tokens)] = 2;
+        aggregate.add(sample);
+    }
+
+    QJsonObject root = QJsonDocument::fromJson(aggregate.formatJson().toUtf8()).object();
+    QCOMPARE(root.value("processed").toInteger(), qint64(100));
+
+    QJsonObject total = root.value("stages").toObject().value("total").toObject();
+    QCOMPARE(total.value("total_ns").toInteger(), qint64(5050));
+    QCOMPARE(total.value("p50_ns").toInteger(), qint64(50));
+    QCOMPARE(total.value("p95_ns").toInteger(), qint64(95));
+    QCOMPARE(total.value("p99_ns").toInteger(), qint64(99));
+    QCOMPARE(total.value("max_ns").toInteger(), qint64(100));
+
+    QCOMPARE(root.value("counters").toObject().value("tokens").toInteger(), qint64(200));
+}
+
+void test_pipelineStats::hardwareCounters()
+{
+    QString reason;
+    bool available = PerfCounters::enable(&reason);
+    HardwareCounterValues values{};
+
+    // В контейнере счётчики могут быть запрещены — тогда статистика выводится без них
+    if (!available) {
+        QVERIFY(!reason.isEmpty());
+        QVERIFY(!PerfCounters::read(values));
+
+        StatsAggregate aggregate;
+        aggregate.setHardwareCountersUnavailable(reason);
+        aggregate.add(StatsSample());
+        QVERIFY(aggregate.formatTable().contains("hardware counters: unavailable"));
+        return;
+    }
+
+    StatsRecorder recorder;
+    {
+        StatsScope scope(&recorder);
+        QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+            {{"a", Variable("a", "int", "first value")},
+             {"b", Variable("b", "int", "second value")}});
+        QVERIFY(Expression(schema, "a b +").tryGetExplanationInEn().isOk());
+    }
+    PerfCounters::disable();
+
+#ifndef TE_DISABLE_STATS
+    StatsSample sample = recorder.sample();
+    QVERIFY(sample.hardware[int(PipelineStage::BuildTree)][int(HardwareCounter::Instructions)] > 0);
+#endif
+}
+
+void test_pipelineStats::allocations()
+{
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")},
+         {"b", Variable("b", "int", "second value")}});
+
+    StatsRecorder recorder;
+    AllocationTracker::enable();
+    {
+        StatsScope scope(&recorder);
+        QVERIFY(Expression(schema, "a b + b *").tryGetExplanationInEn().isOk());
+    }
+    AllocationTracker::disable();
+
+    StatsSample sample = recorder.sample();
+#ifndef TE_DISABLE_STATS
+    QVERIFY(sample.counters[int(PipelineCounter::Allocations)] > 0);
+    QVERIFY(sample.counters[int(PipelineCounter::AllocatedBytes)] > 0);
+    QVERIFY(sample.allocations[int(PipelineStage::BuildTree)].count > 0);
+    QVERIFY(sample.allocations[int(PipelineStage::Render)].count > 0);
+    QVERIFY(sample.peakLiveBytes > 0);
+
+    StatsAggregate aggregate;
+    aggregate.add(sample);
+    QJsonObject root = QJsonDocument::fromJson(aggregate.formatJson().toUtf8()).object();
+    QCOMPARE(root.value("peak_live_bytes").toObject().value("max").toInteger(), sample.peakLiveBytes);
+    QVERIFY(root.value("stages").toObject().value("render").toObject().contains("allocations"));
+#else
+    QCOMPARE(sample.counters[int(PipelineCounter::Allocations)], qint64(0));
+#endif
+}
+
+void test_pipelineStats::qtContainerAllocations()
+{
+#if defined(TE_DISABLE_STATS) || !defined(__GLIBC__)
+    QSKIP("Qt containers are tracked only where malloc can be replaced (glibc)");
+#endif
+    QString text;
+    QList<int> numbers;
+    AllocationTracker::enable();
+    const AllocationValues before = AllocationTracker::threadTotals();
+    // Буферы QString и QList выделяются и растут через malloc/realloc, а не через operator new
+    for (int i = 0; i < 1000; i++) {
+        text.append(QLatin1String("0123456789"));
+        numbers.append(i);
+    }
+    const AllocationValues after = AllocationTracker::threadTotals();
+    AllocationTracker::disable();
+
+    QCOMPARE(text.size(), 10000);
+    QVERIFY(after.count - before.count >= 2);
+    QVERIFY(after.bytes - before.bytes >= qint64(text.size() * sizeof(QChar) + numbers.size() * sizeof(int)));
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_PIPELINESTATS_H
+#define TEST_PIPELINESTATS_H
+
+#include <QObject>
+
+class test_pipelineStats : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_pipelineStats(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void countersOfExpression(); // StatsRecorder, StageTimer и countStat при объяснении выражения
+    void countersOfExpression_data();
+    void percentile(); // static qint64 StatsAggregate::percentile(const QList<qint64>& sorted, int percent)
+    void percentile_data();
+    void percentiles(); // QString StatsAggregate::formatJson() const
+    void hardwareCounters(); // bool PerfCounters::enable(QString* errorMessage)
+    void allocations(); // void AllocationTracker::onAllocate(qint64 size)
+    void qtContainerAllocations(); // void AllocationTracker::onAllocate(qint64 size) из malloc/realloc
+};
+
+#endif // TEST_PIPELINESTATS_H
@@ -0,0 +1,55 @@
+#include "test_soaktest.h"
+#include <QtTest/QTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <batchprocessor.h>
+#include <soaktest.h>
+
+test_soakTest::test_soakTest(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_soakTest::prepareInputs()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    const QStringList inputs = SoakTest::prepareInputs(PIPELINEBENCH_CORPUS_DIR, workDir.path());
+
+    // Файлы корпуса, по две ошибочные копии каждого и несуществующий файл
+    QVERIFY(inputs.size() > 1);
+    QCOMPARE((inputs.size() - 1) % 3, 0);
+    const qsizetype corpusSize = (inputs.size() - 1) / 3;
+    QVERIFY(!QFile::exists(inputs.last()));
+
+    // Ошибочные копии обрабатываются с ошибками, а не с объяснением исходного файла
+    const QString outputFile = workDir.filePath("output.txt");
+    for (qsizetype i = 0; i < corpusSize; i++) {
+        const QString explanation = BatchProcessor::processFile(inputs[i], outputFile, 1);
+        QVERIFY2(BatchProcessor::processFile(inputs[corpusSize + 2 * i], outputFile, 1) != explanation, qPrintable(inputs[i]));
+        QVERIFY2(BatchProcessor::processFile(inputs[corpusSize + 2 * i + 1], outputFile, 1) != explanation, qPrintable(inputs[i]));
+    }
+
+    QCOMPARE(SoakTest::prepareInputs(workDir.filePath("empty"), workDir.path()), QStringList());
+}
+
+void test_soakTest::growth()
+{
+    QFETCH(QList<qint64>, values);
+    QFETCH(qint64, expected);
+
+    QCOMPARE(SoakTest::growth(values), expected);
+}
+
+void test_soakTest::growth_data()
+{
+    QTest::addColumn<QList<qint64>>("values");
+    QTest::addColumn<qint64>("expected");
+
+    QTest::newRow("1. No samples") << QList<qint64>{} << qint64(0);
+    QTest::newRow("2. Single sample") << QList<qint64>{100} << qint64(0);
+    QTest::newRow("3. Flat memory") << QList<qint64>{100, 100, 100, 100, 100} << qint64(0);
+    QTest::newRow("4. Steady leak") << QList<qint64>{100, 110, 120, 130, 140, 150, 160, 170, 180} << qint64(70);
+    QTest::newRow("5. Single spike is ignored") << QList<qint64>{100, 100, 100, 100, 100, 100, 100, 500, 100} << qint64(0);
+    QTest::newRow("6. Memory returned to the system") << QList<qint64>{100, 90, 80, 80} << qint64(-20);
+    QTest::newRow("7. Unavailable measurement") << QList<qint64>{-1, -1, -1} << qint64(0);
+}
@@ -0,0 +1,18 @@
+#ifndef TEST_SOAKTEST_H
+#define TEST_SOAKTEST_H
+
+#include <QObject>
+
+class test_soakTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_soakTest(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void prepareInputs(); // static QStringList SoakTest::prepareInputs(const QString& corpusDir, const QString& workDir)
+    void growth(); // static qint64 SoakTest::growth(const QList<qint64>& values)
+    void growth_data();
+};
+
+#endif // TEST_SOAKTEST_H
@@ -0,0 +1,62 @@
+#include "test_stringpool.h"
+#include <QtTest/QTest>
+#include <stringpool.h>
+
+test_stringPool::test_stringPool(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_stringPool::intern()
+{
+    QFETCH(QStringList, strings);
+    QFETCH(int, expectedChunkCount);
+
+    StringPool pool;
+    QList<QString> views;
+
+    // Размещаем все строки в пуле
+    for (const QString& str : strings) {
+        views.append(pool.intern(str));
+    }
+
+    // Представления должны оставаться корректными после размещения всех строк
+    for (int i = 0; i < strings.size(); i++) {
+        if (views[i] != strings[i]) {
+            qDebug() << "Actual string:  " << views[i];
+            qDebug() << "Expected string:" << strings[i];
+            QFAIL("Interned string was corrupted.");
+        }
+    }
+
+    QCOMPARE(int(pool.chunkCount()), expectedChunkCount);
+}
+
+void test_stringPool::intern_data()
+{
+    QTest::addColumn<QStringList>("strings");
+    QTest::addColumn<int>("expectedChunkCount");
+
+    // Test 1: Короткие строки помещаются в один блок
+    QTest::newRow("short-strings-in-one-chunk")
+        << QStringList{"appleCount", "int", "apple count"}
+        << 1;
+
+    // Test 2: Пустая строка не занимает место в пуле
+    QTest::newRow("empty-string")
+        << QStringList{"", "a", ""}
+        << 1;
+
+    // Test 3: Строки не помещаются в один блок
+    QStringList manyStrings;
+    for (int i = 0; i < 300; i++) {
+        manyStrings << QString("description number %1").arg(i);
+    }
+    QTest::newRow("strings-overflow-chunk")
+        << manyStrings
+        << 2;
+
+    // Test 4: Строка больше блока размещается в отдельном блоке
+    QTest::newRow("oversized-string")
+        << QStringList{"name", QString(5000, 'x'), "type"}
+        << 2;
+}
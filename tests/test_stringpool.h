@@ -0,0 +1,17 @@
+#ifndef TEST_STRINGPOOL_H
+#define TEST_STRINGPOOL_H
+
+#include <QObject>
+
+class test_stringPool : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_stringPool(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void intern(); // QString intern(QStringView text)
+    void intern_data();
+};
+
+#endif // TEST_STRINGPOOL_H
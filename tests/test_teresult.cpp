@@ -0,0 +1,76 @@
+#include "test_teresult.h"
+#include <QtTest/QTest>
+#include <expression.h>
+#include <expressiondocument.h>
+#include <expressionxmlparser.h>
+
+test_teResult::test_teResult(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_teResult::tryGetExplanationInEn()
+{
+    QFETCH(QString, expression);
+    QFETCH(QString, expectedError);
+
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")},
+         {"b", Variable("b", "int", "second value")}});
+    Expression tree(schema, expression);
+
+    TEResult<QString> result = tree.tryGetExplanationInEn();
+    QString actualError = result.isOk() ? QString() : TEException::ErrorTypeNames.value(result.getErrors().first().getErrorType());
+    QCOMPARE(actualError, expectedError);
+
+    // Интерфейс с исключениями сообщает о той же ошибке
+    try {
+        QString explanation = tree.getExplanationInEn();
+        QVERIFY(result.isOk());
+        QCOMPARE(explanation, result.value());
+    } catch (const TEException& error) {
+        QCOMPARE(TEException::ErrorTypeNames.value(error.getErrorType()), expectedError);
+    }
+}
+
+void test_teResult::tryGetExplanationInEn_data()
+{
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<QString>("expectedError");
+
+    QTest::newRow("1. Valid expression") << "a b +" << "";
+    QTest::newRow("2. Invalid symbol") << "a $b +" << "InvalidSymbol";
+    QTest::newRow("3. Undefined identifier") << "a c +" << "UndefinedId";
+    QTest::newRow("4. Missing operand") << "a +" << "MissingOperand";
+    QTest::newRow("5. Missing operations") << "a b a" << "MissingOperations";
+    QTest::newRow("6. Unused element") << "a a +" << "NeverUsedElement";
+}
+
+void test_teResult::tryReadDocumentFromXMLContent()
+{
+    QFETCH(QString, xml);
+    QFETCH(QStringList, expectedErrors);
+
+    ExpressionDocument document;
+    TEResult<void> result = ExpressionXmlParser::tryReadDocumentFromXMLContent(xml, document, "request");
+
+    QStringList actualErrors;
+    for (const TEException& error : result.getErrors()) {
+        actualErrors.append(TEException::ErrorTypeNames.value(error.getErrorType()));
+    }
+    QCOMPARE(actualErrors, expectedErrors);
+    QCOMPARE(result.isOk(), expectedErrors.isEmpty());
+}
+
+void test_teResult::tryReadDocumentFromXMLContent_data()
+{
+    QTest::addColumn<QString>("xml");
+    QTest::addColumn<QStringList>("expectedErrors");
+
+    QString schema = "<variables><variable name=\"a\" type=\"int\"><description>value</description></variable></variables>"
+                     "<functions/><unions/><structures/><classes/><enums/>";
+
+    QTest::newRow("1. Valid document") << "<root><expression>a 1 +</expression>" + schema + "</root>" << QStringList{};
+    QTest::newRow("2. Syntax error") << "<root><expression>a 1 +</expression>" + schema << QStringList{"Parsing"};
+    QTest::newRow("3. Missing root") << "<document/>" << QStringList{"MissingRootElemnt"};
+    QTest::newRow("4. Missing expression") << "<root>" + schema + "</root>" << QStringList{"MissingRequiredChildElement", "EmptyElementValue"};
+}
@@ -0,0 +1,19 @@
+#ifndef TEST_TERESULT_H
+#define TEST_TERESULT_H
+
+#include <QObject>
+
+class test_teResult : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_teResult(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void tryGetExplanationInEn(); // TEResult<QString> Expression::tryGetExplanationInEn(QSet<QString>* usedElements)
+    void tryGetExplanationInEn_data();
+    void tryReadDocumentFromXMLContent(); // TEResult<void> ExpressionXmlParser::tryReadDocumentFromXMLContent(...)
+    void tryReadDocumentFromXMLContent_data();
+};
+
+#endif // TEST_TERESULT_H
@@ -0,0 +1,94 @@
+#include "test_tracelog.h"
+#include <QtTest/QTest>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <expression.h>
+#include <tracelog.h>
+
+test_traceLog::test_traceLog(QObject *parent)
+    : QObject{parent}
+{}
+
+// События длительности (ph = "X") из журнала
+static QList<QJsonObject> completeEvents() {
+    QJsonObject root = QJsonDocument::fromJson(TraceLog::toChromeTraceJson()).object();
+    QList<QJsonObject> events;
+    for (const QJsonValue& value : root.value("traceEvents").toArray()) {
+        if (value.toObject().value("ph").toString() == "X") events.append(value.toObject());
+    }
+    return events;
+}
+
+void test_traceLog::requestEvents()
+{
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")},
+         {"b", Variable("b", "int", "second value")}});
+
+    TraceLog::enable();
+    {
+        StatsRecorder recorder;
+        StatsScope scope(&recorder);
+        RequestTrace trace("input.xml", &recorder);
+        QVERIFY(Expression(schema, "a b +").tryGetExplanationInEn().isOk());
+    }
+
+    QStringList names;
+    QJsonObject request;
+    for (const QJsonObject& event : completeEvents()) {
+        names.append(event.value("name").toString());
+        if (event.value("name").toString() == "request") request = event;
+    }
+
+#ifndef TE_DISABLE_STATS
+    QVERIFY(names.contains("build_tree"));
+    QVERIFY(names.contains("render"));
+    QVERIFY(names.contains("dedupe"));
+#endif
+    // Событие запроса записывается последним и охватывает этапы
+    QCOMPARE(names.last(), QString("request"));
+    QCOMPARE(request.value("args").toObject().value("file").toString(), QString("input.xml"));
+#ifndef TE_DISABLE_STATS
+    QCOMPARE(request.value("args").toObject().value("tokens").toInteger(), qint64(3));
+#endif
+}
+
+void test_traceLog::ringBufferKeepsLatestEvents()
+{
+    TraceLog::enable(4);
+    for (int i = 0; i < 10; i++) {
+        TraceEvent event;
+        event.startNs = i * 1000;
+        event.durationNs = 500;
+        event.label = QString::number(i);
+        TraceLog::record(event);
+    }
+
+    QList<QJsonObject> events = completeEvents();
+    QCOMPARE(events.size(), 4);
+    QCOMPARE(events.first().value("args").toObject().value("file").toString(), QString("6"));
+    QCOMPARE(events.last().value("args").toObject().value("file").toString(), QString("9"));
+    QCOMPARE(events.last().value("ts").toDouble(), 9.0);
+}
+
+void test_traceLog::writeToFullDisk()
+{
+    // Запись в /dev/full завершается ошибкой ENOSPC, как на заполненном диске
+    if (!QFile::exists("/dev/full")) QSKIP("/dev/full is not available");
+    TraceLog::enable(4);
+    TraceEvent event;
+    event.durationNs = 500;
+    event.label = "input.xml";
+    TraceLog::record(event);
+
+    QString errorMessage;
+    QVERIFY(!TraceLog::writeChromeTrace("/dev/full", &errorMessage));
+    QVERIFY(errorMessage.startsWith("cannot write trace file \"/dev/full\""));
+}
+
+void test_traceLog::cleanup()
+{
+    TraceLog::disable();
+}
@@ -0,0 +1,19 @@
+#ifndef TEST_TRACELOG_H
+#define TEST_TRACELOG_H
+
+#include <QObject>
+
+class test_traceLog : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_traceLog(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void requestEvents(); // QByteArray TraceLog::toChromeTraceJson()
+    void ringBufferKeepsLatestEvents(); // void TraceLog::record(const TraceEvent& event)
+    void writeToFullDisk(); // static bool TraceLog::writeChromeTrace(const QString& path, QString* errorMessage)
+    void cleanup();
+};
+
+#endif // TEST_TRACELOG_H
@@ -0,0 +1,89 @@
+#include "test_treeprofiler.h"
+#include <QtTest/QTest>
+#include <QJsonObject>
+#include <expression.h>
+#include <treeprofiler.h>
+
+test_treeProfiler::test_treeProfiler(QObject *parent)
+    : QObject{parent}
+{}
+
+static QSharedPointer<const CompiledSchema> profileSchema() {
+    return CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")},
+         {"b", Variable("b", "int", "second value")}});
+}
+
+void test_treeProfiler::profiles()
+{
+    QFETCH(QString, expression);
+    QFETCH(QStringList, expectedNodes);
+    QFETCH(QList<int>, expectedDepths);
+
+    TreeProfiler profiler;
+    {
+        TreeProfileScope scope(&profiler);
+        QVERIFY(Expression(profileSchema(), expression).tryGetExplanationInEn().isOk());
+    }
+    QVERIFY(TreeProfiler::current() == nullptr);
+
+#ifndef TE_DISABLE_STATS
+    QStringList actualNodes;
+    QList<int> actualDepths;
+    for (const NodeProfile& profile : profiler.getProfiles()) {
+        actualNodes.append(profile.node);
+        actualDepths.append(profile.depth);
+        QVERIFY(profile.exclusiveNs >= 0);
+        QVERIFY(profile.inclusiveNs >= profile.exclusiveNs);
+        QVERIFY(profile.inclusiveTemplates >= profile.exclusiveTemplates);
+    }
+    QCOMPARE(actualNodes, expectedNodes);
+    QCOMPARE(actualDepths, expectedDepths);
+
+    // Объяснение операции строится подстановкой в шаблон
+    const NodeProfile& root = profiler.getProfiles().first();
+    QVERIFY(root.exclusiveTemplates > 0);
+    QVERIFY(root.bytes > 0);
+#else
+    Q_UNUSED(expectedNodes);
+    Q_UNUSED(expectedDepths);
+    QVERIFY(profiler.getProfiles().isEmpty());
+#endif
+}
+
+void test_treeProfiler::profiles_data()
+{
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<QStringList>("expectedNodes");
+    QTest::addColumn<QList<int>>("expectedDepths");
+
+    QTest::newRow("1. Binary operation")
+        << "a b +"
+        << QStringList{"+", "a", "b"}
+        << QList<int>{0, 1, 1};
+    QTest::newRow("2. Nested operations")
+        << "a b + b *"
+        << QStringList{"*", "+", "a", "b", "b"}
+        << QList<int>{0, 1, 2, 2, 1};
+}
+
+void test_treeProfiler::toJson()
+{
+    TreeProfiler profiler;
+    {
+        TreeProfileScope scope(&profiler);
+        QVERIFY(Expression(profileSchema(), "a b + b *").tryGetExplanationInEn().isOk());
+    }
+
+#ifndef TE_DISABLE_STATS
+    QJsonArray roots = profiler.toJson();
+    QCOMPARE(roots.size(), 1);
+    QJsonObject root = roots.first().toObject();
+    QCOMPARE(root.value("node").toString(), QString("*"));
+
+    QJsonArray children = root.value("children").toArray();
+    QCOMPARE(children.size(), 2);
+    QCOMPARE(children[0].toObject().value("children").toArray().size(), 2);
+    QCOMPARE(children[1].toObject().value("node").toString(), QString("b"));
+#endif
+}
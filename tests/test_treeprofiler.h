@@ -0,0 +1,18 @@
+#ifndef TEST_TREEPROFILER_H
+#define TEST_TREEPROFILER_H
+
+#include <QObject>
+
+class test_treeProfiler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_treeProfiler(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void profiles(); // const QList<NodeProfile>& TreeProfiler::getProfiles() const
+    void profiles_data();
+    void toJson(); // QJsonArray TreeProfiler::toJson() const
+};
+
+#endif // TEST_TREEPROFILER_H
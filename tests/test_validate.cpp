@@ -0,0 +1,61 @@
+#include "test_validate.h"
+#include <QtTest/QTest>
+#include <expressiondocument.h>
+#include <expressionxmlparser.h>
+
+test_validate::test_validate(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_validate::validate()
+{
+    QFETCH(QString, xml);
+    QFETCH(QStringList, expectedErrors);
+
+    ExpressionDocument document;
+    TEResult<void> read = ExpressionXmlParser::tryReadDocumentFromXMLContent(xml, document, "request");
+    QVERIFY(read.isOk());
+
+    // Ошибка записывается вместе с номером строки элемента <expression>
+    QStringList actualErrors;
+    for (const TEException& error : document.validate(2)) {
+        actualErrors.append(TEException::ErrorTypeNames.value(error.getErrorType()) + ":" + QString::number(error.getLine()));
+    }
+    QCOMPARE(actualErrors, expectedErrors);
+
+    // Для документа с одним выражением проверка находит ошибки тогда же, когда их находит объяснение
+    if (!document.isMultiExpression())
+        QCOMPARE(document.tryGetExplanation().isOk(), expectedErrors.isEmpty());
+}
+
+void test_validate::validate_data()
+{
+    QTest::addColumn<QString>("xml");
+    QTest::addColumn<QStringList>("expectedErrors");
+
+    QString schema = "<variables>\n"
+                     "<variable name=\"a\" type=\"int\"><description>first value</description></variable>\n"
+                     "<variable name=\"b\" type=\"int\"><description>second value</description></variable>\n"
+                     "</variables>\n"
+                     "<functions/><unions/><structures/><classes/><enums/>\n";
+
+    QTest::newRow("1. Valid expression")
+        << "<root>\n<expression>a b +</expression>\n" + schema + "</root>" << QStringList{};
+    QTest::newRow("2. Undefined identifier")
+        << "<root>\n<expression>a c +</expression>\n" + schema + "</root>" << QStringList{"UndefinedId:2"};
+    QTest::newRow("3. Unused element")
+        << "<root>\n<expression>a a +</expression>\n" + schema + "</root>" << QStringList{"NeverUsedElement:2"};
+    QTest::newRow("4. Every expression of a document is reported")
+        << "<root>\n<expressions>\n"
+           "<expression id=\"e1\">a +</expression>\n"
+           "<expression id=\"e2\">a b +</expression>\n"
+           "<expression id=\"e3\">a $b +</expression>\n"
+           "</expressions>\n" + schema + "</root>"
+        << QStringList{"MissingOperand:3", "InvalidSymbol:5"};
+    QTest::newRow("5. Schema used by document as a whole")
+        << "<root>\n<expressions>\n"
+           "<expression id=\"e1\">a 1 +</expression>\n"
+           "<expression id=\"e2\">b 2 *</expression>\n"
+           "</expressions>\n" + schema + "</root>"
+        << QStringList{};
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_VALIDATE_H
+#define TEST_VALIDATE_H
+
+#include <QObject>
+
+class test_validate : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_validate(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void validate(); // QList<TEException> ExpressionDocument::validate(int maxThreads)
+    void validate_data();
+};
+
+#endif // TEST_VALIDATE_H
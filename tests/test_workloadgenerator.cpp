@@ -0,0 +1,174 @@
+#include "test_workloadgenerator.h"
+#include <QtTest/QTest>
+#include <workloadgenerator.h>
+
+Q_DECLARE_METATYPE(GeneratorOptions)
+
+test_workloadGenerator::test_workloadGenerator(QObject *parent)
+    : QObject{parent}
+{}
+
+// Текстовое представление ошибок для сообщений сравнения
+static QStringList errorNames(const QList<TEException>& errors)
+{
+    QStringList names;
+    for (const TEException& error : errors) {
+        names.append(TEException::ErrorTypeNames.value(error.getErrorType()));
+    }
+    return names;
+}
+
+void test_workloadGenerator::generateDocument()
+{
+    QFETCH(GeneratorOptions, options);
+    QVERIFY(WorkloadGenerator::checkOptions(options).isEmpty());
+
+    WorkloadGenerator generator(options);
+    WorkloadGenerator sameSeed(options);
+    GeneratorOptions otherOptions = options;
+    otherOptions.seed++;
+    WorkloadGenerator otherSeed(otherOptions);
+
+    for (int i = 0; i < 3; i++) {
+        const QString xml = generator.generateDocument();
+        // Документ корректен целиком, включая использование каждого элемента схемы
+        QCOMPARE(errorNames(WorkloadGenerator::collectErrors(xml)), QStringList());
+        // Одинаковое начальное значение даёт одинаковые документы, другое — другие
+        QCOMPARE(sameSeed.generateDocument(), xml);
+        QVERIFY(otherSeed.generateDocument() != xml);
+    }
+}
+
+void test_workloadGenerator::generateDocument_data()
+{
+    QTest::addColumn<GeneratorOptions>("options");
+
+    GeneratorOptions defaults;
+    QTest::newRow("1. Default options") << defaults;
+
+    GeneratorOptions large;
+    large.seed = 42;
+    large.variables = 10;
+    large.functions = 5;
+    large.maxParams = 5;
+    large.unions = 2;
+    large.structures = 2;
+    large.classes = 2;
+    large.fields = 4;
+    large.methods = 3;
+    large.enums = 2;
+    large.values = 5;
+    large.operations = 20;
+    large.depth = 8;
+    large.expressions = 6;
+    QTest::newRow("2. Schema and expressions at program limits") << large;
+
+    GeneratorOptions constants;
+    constants.seed = 7;
+    constants.variables = 0;
+    constants.functions = 0;
+    constants.unions = 0;
+    constants.structures = 0;
+    constants.classes = 0;
+    constants.enums = 0;
+    constants.operations = 5;
+    constants.expressions = 2;
+    QTest::newRow("3. Empty schema") << constants;
+
+    GeneratorOptions single;
+    single.seed = 3;
+    single.variables = 1;
+    single.functions = 0;
+    single.unions = 0;
+    single.structures = 0;
+    single.classes = 0;
+    single.enums = 0;
+    single.operations = 3;
+    single.expressions = 1;
+    QTest::newRow("4. Single expression") << single;
+}
+
+void test_workloadGenerator::operatorCoverage()
+{
+    WorkloadGenerator generator{GeneratorOptions()};
+    for (int i = 0; i < 20; i++) {
+        generator.generateDocument();
+    }
+    QCOMPARE(generator.uncoveredOperators(), QStringList());
+}
+
+void test_workloadGenerator::generateInvalidDocuments()
+{
+    WorkloadGenerator generator{GeneratorOptions()};
+    const QList<InvalidDocument> documents = generator.generateInvalidDocuments();
+
+    QSet<ErrorType> generated;
+    for (const InvalidDocument& document : documents) {
+        const QString name = TEException::ErrorTypeNames.value(document.errorType);
+        const QStringList actualErrors = errorNames(WorkloadGenerator::collectErrors(document.xml));
+        QVERIFY2(actualErrors.contains(name), qPrintable(name + ": " + actualErrors.join(", ")));
+        generated.insert(document.errorType);
+    }
+    QCOMPARE(generated.size(), documents.size());
+
+    // Каждый тип ошибки либо порождается документом, либо явно отмечен как недостижимый
+    for (int type = int(ErrorType::InputFileNotFound); type <= int(ErrorType::Cancelled); type++) {
+        const ErrorType errorType = ErrorType(type);
+        QVERIFY2(generated.contains(errorType) != WorkloadGenerator::ungeneratableErrorTypes().contains(errorType),
+                 qPrintable(TEException::ErrorTypeNames.value(errorType)));
+    }
+
+    // Некорректные документы тоже детерминированы
+    WorkloadGenerator sameSeed{GeneratorOptions()};
+    const QList<InvalidDocument> repeated = sameSeed.generateInvalidDocuments();
+    QCOMPARE(repeated.size(), documents.size());
+    for (qsizetype i = 0; i < documents.size(); i++) {
+        QCOMPARE(repeated[i].xml, documents[i].xml);
+    }
+}
+
+void test_workloadGenerator::checkOptions()
+{
+    QFETCH(GeneratorOptions, options);
+    QFETCH(bool, valid);
+
+    QCOMPARE(WorkloadGenerator::checkOptions(options).isEmpty(), valid);
+}
+
+void test_workloadGenerator::checkOptions_data()
+{
+    QTest::addColumn<GeneratorOptions>("options");
+    QTest::addColumn<bool>("valid");
+
+    GeneratorOptions options;
+    QTest::newRow("1. Default options") << options << true;
+
+    options = GeneratorOptions();
+    options.variables = 17;
+    QTest::newRow("2. Variables with instances and enum variables over 20") << options << false;
+
+    options = GeneratorOptions();
+    options.variables = 16;
+    QTest::newRow("3. Variables with instances and enum variables at 20") << options << true;
+
+    options = GeneratorOptions();
+    options.fields = 15;
+    options.methods = 6;
+    QTest::newRow("4. Fields and methods over 20") << options << false;
+
+    options = GeneratorOptions();
+    options.maxParams = 6;
+    QTest::newRow("5. Parameters over 5") << options << false;
+
+    options = GeneratorOptions();
+    options.operations = 21;
+    QTest::newRow("6. Operations over 20") << options << false;
+
+    options = GeneratorOptions();
+    options.values = 0;
+    QTest::newRow("7. Enum without values") << options << false;
+
+    options = GeneratorOptions();
+    options.functions = -1;
+    QTest::newRow("8. Negative count") << options << false;
+}
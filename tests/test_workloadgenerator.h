@@ -0,0 +1,21 @@
+#ifndef TEST_WORKLOADGENERATOR_H
+#define TEST_WORKLOADGENERATOR_H
+
+#include <QObject>
+
+class test_workloadGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_workloadGenerator(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void generateDocument(); // QString WorkloadGenerator::generateDocument()
+    void generateDocument_data();
+    void operatorCoverage(); // QStringList WorkloadGenerator::uncoveredOperators() const
+    void generateInvalidDocuments(); // QList<InvalidDocument> WorkloadGenerator::generateInvalidDocuments()
+    void checkOptions(); // QString WorkloadGenerator::checkOptions(const GeneratorOptions& options)
+    void checkOptions_data();
+};
+
+#endif // TEST_WORKLOADGENERATOR_H
@@ -0,0 +1,56 @@
+#include "test_workstealingpool.h"
+#include <QtTest/QTest>
+#include <reorderbuffer.h>
+#include <workstealingpool.h>
+
+#include <QAtomicInt>
+#include <QThread>
+
+test_workStealingPool::test_workStealingPool(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_workStealingPool::run()
+{
+    QFETCH(int, taskCount);
+    QFETCH(int, threadCount);
+
+    // Результаты задач через буфер восстановления порядка
+    QStringList output;
+    ReorderBuffer buffer([&output](const QString& text) {
+        output.append(text);
+    });
+
+    QList<QAtomicInt> executions(taskCount);
+    WorkStealingPool pool(threadCount);
+    pool.run(taskCount, [&executions, &buffer, taskCount](int task) {
+        executions[task].fetchAndAddRelaxed(1);
+        // Ранние задачи выполняются дольше, чтобы результаты приходили не по порядку
+        if (task < 4) QThread::msleep(taskCount > 100 ? 5 : 1);
+        buffer.submit(task, QString::number(task));
+    });
+
+    // Каждая задача выполнена ровно один раз
+    for (int i = 0; i < taskCount; i++) {
+        QCOMPARE(executions[i].loadRelaxed(), 1);
+    }
+
+    // Результаты выданы в порядке индексов
+    QCOMPARE(output.size(), taskCount);
+    for (int i = 0; i < taskCount; i++) {
+        QCOMPARE(output[i], QString::number(i));
+    }
+    QCOMPARE(buffer.getPendingCount(), 0);
+}
+
+void test_workStealingPool::run_data()
+{
+    QTest::addColumn<int>("taskCount");
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1. No tasks") << 0 << 4;
+    QTest::newRow("2. Single task") << 1 << 4;
+    QTest::newRow("3. Single thread") << 100 << 1;
+    QTest::newRow("4. Fewer tasks than threads") << 3 << 8;
+    QTest::newRow("5. Many tasks, many threads") << 10000 << 16;
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_WORKSTEALINGPOOL_H
+#define TEST_WORKSTEALINGPOOL_H
+
+#include <QObject>
+
+class test_workStealingPool : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_workStealingPool(QObject *parent = nullptr);
+
+private slots: // должны быть приватными
+    void run(); // void WorkStealingPool::run(int taskCount, const std::function<void(int)>& task)
+    void run_data();
+};
+
+#endif // TEST_WORKSTEALINGPOOL_H
@@ -2,7 +2,6 @@ include(../textExplanationsOnEng/textExplanationsOnEng.pri)
 
 QT = core \
     testlib \
-    qml \
     xml
 
 SOURCES += \
@@ -15,7 +14,33 @@ SOURCES += \
     test_isidentifier.cpp \
     test_removeconsecutiveduplicates.cpp \
     test_toexplanation.cpp \
-    test_isreducibleunaryselfinverse.cpp
+    test_isreducibleunaryselfinverse.cpp \
+    test_stringpool.cpp \
+    test_compiledschema.cpp \
+    test_explainall.cpp \
+    test_workstealingpool.cpp \
+    test_explanationserver.cpp \
+    test_explanationcache.cpp \
+    test_diskcache.cpp \
+    test_cancellationtoken.cpp \
+    test_parserlimits.cpp \
+    test_teresult.cpp \
+    test_validate.cpp \
+    test_pipelinestats.cpp \
+    test_tracelog.cpp \
+    test_treeprofiler.cpp \
+    test_workloadgenerator.cpp \
+    ../generator/workloadgenerator.cpp \
+    test_pipelinebench.cpp \
+    ../pipelinebench/pipelinebench.cpp \
+    test_loadgenerator.cpp \
+    ../loadgen/latencyhistogram.cpp \
+    ../loadgen/loadgenerator.cpp \
+    test_soaktest.cpp \
+    ../soak/soaktest.cpp \
+    test_fuzzcost.cpp \
+    ../fuzz/fuzzcost.cpp \
+    ../fuzz/fuzztargets.cpp
 
 HEADERS += \
     test_expressiontonodes.h \
@@ -26,7 +51,56 @@ HEADERS += \
     test_isidentifier.h \
     test_removeconsecutiveduplicates.h \
     test_toexplanation.h \
-    test_isreducibleunaryselfinverse.h
+    test_isreducibleunaryselfinverse.h \
+    test_stringpool.h \
+    test_compiledschema.h \
+    test_explainall.h \
+    test_workstealingpool.h \
+    test_explanationserver.h \
+    test_explanationcache.h \
+    test_diskcache.h \
+    test_cancellationtoken.h \
+    test_parserlimits.h \
+    test_teresult.h \
+    test_validate.h \
+    test_pipelinestats.h \
+    test_tracelog.h \
+    test_treeprofiler.h \
+    test_workloadgenerator.h \
+    ../generator/workloadgenerator.h \
+    test_pipelinebench.h \
+    ../pipelinebench/pipelinebench.h \
+    test_loadgenerator.h \
+    ../loadgen/latencyhistogram.h \
+    ../loadgen/loadgenerator.h \
+    test_soaktest.h \
+    ../soak/soaktest.h \
+    test_fuzzcost.h \
+    ../fuzz/fuzzcost.h \
+    ../fuzz/fuzztargets.h
 
-QMAKE_CXXFLAGS += -fprofile-arcs -ftest-coverage -O0
-QMAKE_LFLAGS += -fprofile-arcs -ftest-coverage
+# Генератор документов проверяется вместе с программой
+INCLUDEPATH += ../generator
+
+# Вывод программы для корпуса замера пропускной способности сравнивается с эталонами
+INCLUDEPATH += ../pipelinebench
+DEFINES += PIPELINEBENCH_CORPUS_DIR=\\\"$$PWD/../pipelinebench/corpus\\\"
+
+# Генератор нагрузки проверяется на том же корпусе против сервера в процессе тестов
+INCLUDEPATH += ../loadgen
+
+# Входные файлы длительной проверки памяти строятся из того же корпуса
+INCLUDEPATH += ../soak
+
+# Входные данные, найденные фаззерами сложности, проверяются теми же функциями, что и в фаззерах
+INCLUDEPATH += ../fuzz
+DEFINES += FUZZ_REGRESSIONS_DIR=\\\"$$PWD/../fuzz/regressions\\\"
+
+# Сборка под ThreadSanitizer: qmake CONFIG+=tsan (без покрытия — счётчики gcov не атомарны)
+tsan {
+    QMAKE_CXXFLAGS += -fsanitize=thread -g -O1
+    QMAKE_LFLAGS += -fsanitize=thread
+} else {
+    QMAKE_CXXFLAGS += -fprofile-arcs -ftest-coverage -O0
+    QMAKE_LFLAGS += -fprofile-arcs -ftest-coverage
+}
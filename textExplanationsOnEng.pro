@@ -1,6 +1,12 @@
 TEMPLATE = subdirs
 
 SUBDIRS += \
+    benchmarks \
+    generator \
+    loadgen \
+    pipelinebench \
+    soak \
+    startupbench \
     tests \
     textExplanationsOnEng
 
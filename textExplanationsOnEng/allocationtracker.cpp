@@ -0,0 +1,273 @@
+#include "allocationtracker.h"
+#include "pipelinestats.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+// Сборка под санитайзером: его распределитель памяти нельзя заменить, но он вызывает установленные обработчики
+#if !defined(TE_SANITIZER) && (defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__))
+#define TE_SANITIZER
+#endif
+#if !defined(TE_SANITIZER) && defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define TE_SANITIZER
+#endif
+#endif
+
+#if defined(TE_SANITIZER)
+// Интерфейс распределителя санитайзеров (sanitizer/allocator_interface.h есть не во всех поставках компилятора)
+extern "C" int __sanitizer_install_malloc_and_free_hooks(void (*mallocHook)(const volatile void*, std::size_t),
+                                                          void (*freeHook)(const volatile void*));
+extern "C" std::size_t __sanitizer_get_allocated_size(const volatile void* pointer);
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(Q_OS_WIN)
+#include <malloc.h>
+#endif
+
+static std::atomic<bool> enabled(false);
+
+// Счётчики потока: только тривиальные типы, чтобы не выделять память при первом обращении
+thread_local qint64 threadAllocations = 0;
+thread_local qint64 threadAllocatedBytes = 0;
+thread_local qint64 threadLive = 0;
+thread_local qint64 threadPeak = 0;
+
+void AllocationTracker::enable()
+{
+    enabled.store(true, std::memory_order_release);
+}
+
+void AllocationTracker::disable()
+{
+    enabled.store(false, std::memory_order_release);
+}
+
+bool AllocationTracker::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+AllocationValues AllocationTracker::threadTotals()
+{
+    AllocationValues values;
+    values.count = threadAllocations;
+    values.bytes = threadAllocatedBytes;
+    values.peakLiveBytes = threadPeak;
+    return values;
+}
+
+qint64 AllocationTracker::threadLiveBytes()
+{
+    return threadLive;
+}
+
+void AllocationTracker::resetThreadPeak()
+{
+    threadPeak = threadLive;
+}
+
+void AllocationTracker::onAllocate(qint64 size)
+{
+    threadAllocations++;
+    threadAllocatedBytes += size;
+    threadLive += size;
+    if (threadLive > threadPeak) threadPeak = threadLive;
+    if (StatsRecorder* recorder = StatsRecorder::current()) recorder->addAllocation(size);
+}
+
+void AllocationTracker::onFree(qint64 size)
+{
+    threadLive -= size;
+    if (StatsRecorder* recorder = StatsRecorder::current()) recorder->addFree(size);
+}
+
+#ifndef TE_DISABLE_STATS
+
+#if defined(TE_SANITIZER)
+
+// Обработчики вызываются распределителем санитайзера для каждого malloc, realloc и free, в том числе из Qt
+static void onSanitizerMalloc(const volatile void* pointer, std::size_t size) {
+    Q_UNUSED(pointer);
+    if (enabled.load(std::memory_order_relaxed)) AllocationTracker::onAllocate(qint64(size));
+}
+
+static void onSanitizerFree(const volatile void* pointer) {
+    if (enabled.load(std::memory_order_relaxed))
+        AllocationTracker::onFree(qint64(__sanitizer_get_allocated_size(pointer)));
+}
+
+[[maybe_unused]] static const int sanitizerHooksInstalled = __sanitizer_install_malloc_and_free_hooks(onSanitizerMalloc, onSanitizerFree);
+
+#elif defined(__GLIBC__)
+
+// Функции распределителя glibc, которые вызывают замещённые malloc, free и другие
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void __libc_free(void* pointer);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void* __libc_valloc(std::size_t size);
+void* __libc_pvalloc(std::size_t size);
+}
+
+// Учёт выделенного блока
+static void* tracked(void* pointer) {
+    if (pointer && enabled.load(std::memory_order_relaxed)) AllocationTracker::onAllocate(qint64(malloc_usable_size(pointer)));
+    return pointer;
+}
+
+// Учёт освобождаемого блока
+static void untrack(void* pointer) {
+    if (pointer && enabled.load(std::memory_order_relaxed)) AllocationTracker::onFree(qint64(malloc_usable_size(pointer)));
+}
+
+// Замещение функций распределителя в программе заменяет их и для всех библиотек, в том числе для буферов
+// QString, QList и QHash (QArrayData) и для стандартного operator new
+extern "C" {
+
+void* malloc(std::size_t size) noexcept
+{
+    return tracked(__libc_malloc(size));
+}
+
+void free(void* pointer) noexcept
+{
+    untrack(pointer);
+    __libc_free(pointer);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    return tracked(__libc_calloc(count, size));
+}
+
+void* realloc(void* pointer, std::size_t size) noexcept
+{
+    // Перевыделение учитывается как освобождение старого блока и выделение нового
+    if (!pointer || !enabled.load(std::memory_order_relaxed)) return tracked(__libc_realloc(pointer, size));
+    const qint64 oldSize = qint64(malloc_usable_size(pointer));
+    void* result = __libc_realloc(pointer, size);
+    if (result || size == 0) AllocationTracker::onFree(oldSize);
+    return tracked(result);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    return tracked(__libc_memalign(alignment, size));
+}
+
+void* valloc(std::size_t size) noexcept
+{
+    return tracked(__libc_valloc(size));
+}
+
+void* pvalloc(std::size_t size) noexcept
+{
+    return tracked(__libc_pvalloc(size));
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    return tracked(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void** result, std::size_t alignment, std::size_t size) noexcept
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* pointer = __libc_memalign(alignment, size);
+    if (!pointer && size != 0) return ENOMEM;
+    *result = tracked(pointer);
+    return 0;
+}
+
+}
+
+#else
+
+// Размер блока по данным распределителя памяти (0 — неизвестен)
+static qint64 blockSize(void* pointer) {
+#if defined(Q_OS_WIN)
+    return qint64(_msize(pointer));
+#else
+    Q_UNUSED(pointer);
+    return 0;
+#endif
+}
+
+// Выделение с тем же поведением при нехватке памяти, что и у стандартного operator new
+static void* allocate(std::size_t size) {
+    if (size == 0) size = 1;
+    void* pointer;
+    while (!(pointer = std::malloc(size))) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) return nullptr;
+        handler();
+    }
+    if (enabled.load(std::memory_order_relaxed)) AllocationTracker::onAllocate(blockSize(pointer));
+    return pointer;
+}
+
+static void release(void* pointer) {
+    if (!pointer) return;
+    if (enabled.load(std::memory_order_relaxed)) AllocationTracker::onFree(blockSize(pointer));
+    std::free(pointer);
+}
+void* operator new(std::size_t size)
+{
+    if (void* pointer = allocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* pointer = allocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    release(pointer);
+}
+
+#endif
+
+#endif
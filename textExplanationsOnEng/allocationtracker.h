@@ -0,0 +1,82 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса AllocationTracker — учёта выделений памяти программы
+ */
+
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief Выделения памяти за интервал
+ */
+struct AllocationValues {
+    qint64 count = 0;           /*!< Количество выделений */
+    qint64 bytes = 0;           /*!< Выделено байтов */
+    qint64 peakLiveBytes = 0;   /*!< Пик занятой памяти относительно начала интервала */
+};
+
+/*!
+ * \brief Учёт выделений памяти программы
+ *
+ * Пока учёт включён, каждое выделение и освобождение учитывается в счётчиках текущего потока
+ * и в накопителе статистики потока (StatsRecorder): количество и объём выделений, занятая память
+ * и её пик. StageTimer приписывает выделения этапам. Способ перехвата зависит от платформы (allocationtracker.cpp):
+ * - glibc: программа замещает malloc, calloc, realloc, free и функции выровненного выделения, поэтому
+ *   учитываются и буферы QString, QList и QHash (QArrayData выделяет их через malloc/realloc),
+ *   и operator new; перевыделение учитывается как освобождение и новое выделение;
+ * - сборка под санитайзером (TE_SANITIZER, определяется автоматически для ASan, TSan и MSan):
+ *   обработчики __sanitizer_install_malloc_and_free_hooks видят те же выделения;
+ * - остальные платформы: заменены только глобальные operator new/delete, выделения контейнеров Qt не учитываются.
+ * Размер блока берётся у распределителя памяти (malloc_usable_size, _msize); где это невозможно,
+ * занятая память не учитывается. Выключенный учёт стоит одной атомарной проверки на выделение;
+ * при сборке с TE_DISABLE_STATS функции распределителя не замещаются.
+ */
+class AllocationTracker
+{
+public:
+    /*!
+     * \brief Включение учёта
+     */
+    static void enable();
+
+    /*!
+     * \brief Выключение учёта
+     */
+    static void disable();
+
+    /*!
+     * \brief Проверка, включён ли учёт
+     */
+    static bool isEnabled();
+
+    /*!
+     * \brief Счётчики текущего потока с начала его работы; peakLiveBytes — пик с последнего resetThreadPeak
+     */
+    static AllocationValues threadTotals();
+
+    /*!
+     * \brief Получение памяти, занятой текущим потоком (выделено минус освобождено)
+     */
+    static qint64 threadLiveBytes();
+
+    /*!
+     * \brief Начало отсчёта пика занятой памяти текущего потока с текущего значения
+     */
+    static void resetThreadPeak();
+
+    /*!
+     * \brief Учёт выделения (вызывается из замещённых функций распределителя)
+     * \param[in] size Размер выделенного блока
+     */
+    static void onAllocate(qint64 size);
+
+    /*!
+     * \brief Учёт освобождения (вызывается из замещённых функций распределителя)
+     * \param[in] size Размер освобождаемого блока
+     */
+    static void onFree(qint64 size);
+};
+
+#endif // ALLOCATIONTRACKER_H
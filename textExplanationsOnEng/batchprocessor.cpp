@@ -0,0 +1,294 @@
+#include "batchprocessor.h"
+#include "expressiondocument.h"
+#include "expressionxmlparser.h"
+#include "pipelinestats.h"
+#include "reorderbuffer.h"
+#include "tracelog.h"
+#include "teexception.h"
+#include "teresult.h"
+#include "workstealingpool.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <atomic>
+
+// Проверить доступ к файлу
+static TEResult<void> checkFileAccess(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{filePath});
+    }
+    file.close();
+    return {};
+}
+
+// Функция для записи текста в файл
+static TEResult<void> writeToFile(const QString& filePath, const QString& content) {
+    StageTimer timer(PipelineStage::Write);
+    QFile file(filePath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream out(&file);
+        out << content;
+        out.flush();
+        countStat(PipelineCounter::BytesOut, file.pos());
+        file.close();
+        return {};
+    }
+    return TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{filePath});
+}
+
+// Ошибки не содержат путей к файлам и не вызваны сроком обработки, поэтому их можно повторить для файла с тем же содержимым
+static bool isCacheable(const QList<TEException>& errors) {
+    for (const TEException& error : errors) {
+        if (!error.getFilename().isEmpty() || error.getErrorType() == ErrorType::OutputFileCannotBeCreated
+            || error.getErrorType() == ErrorType::Cancelled)
+            return false;
+    }
+    return true;
+}
+
+// Выходной файл для входного файла из каталога или шаблона
+static QString outputFileFor(const QFileInfo& input, const QString& outputDir) {
+    QDir dir(outputDir.isEmpty() ? input.path() : outputDir);
+    return dir.filePath(input.fileName() + ".out.txt");
+}
+
+QList<BatchItem> BatchProcessor::collectItems(const QString &source, const QString &outputDir)
+{
+    QList<BatchItem> items;
+    QFileInfo sourceInfo(source);
+    static const QRegularExpression wildcard("[*?\\[]");
+
+    if (sourceInfo.fileName().contains(wildcard) || sourceInfo.isDir()) {
+        // Каталог или шаблон имени: файлы в алфавитном порядке, без результатов прошлых запусков
+        QDir dir(sourceInfo.isDir() ? source : sourceInfo.path());
+        if (!dir.exists())
+            throw TEException(ErrorType::InputFileNotFound, QList<QString>{dir.path()});
+        QStringList nameFilters;
+        if (!sourceInfo.isDir())
+            nameFilters.append(sourceInfo.fileName());
+
+        const QFileInfoList entries = dir.entryInfoList(nameFilters, QDir::Files, QDir::Name);
+        for (const QFileInfo& entry : entries) {
+            if (entry.fileName().endsWith(".out.txt")) continue;
+            items.append(BatchItem{entry.filePath(), outputFileFor(entry, outputDir), entry.size()});
+        }
+    }
+    else {
+        // Файл-список: входной и выходной файлы в каждой строке
+        QFile manifest(source);
+        if (!manifest.open(QIODevice::ReadOnly | QIODevice::Text))
+            throw TEException(ErrorType::InputFileNotFound, QList<QString>{source});
+
+        QTextStream in(&manifest);
+        while (!in.atEnd()) {
+            QString line = in.readLine().trimmed();
+            if (line.isEmpty() || line.startsWith('#')) continue;
+
+            // Табуляция позволяет указывать пути с пробелами
+            qsizetype separator = line.indexOf('\t');
+            if (separator < 0) separator = line.indexOf(' ');
+            BatchItem item;
+            item.inputFile = separator < 0 ? line : line.left(separator).trimmed();
+            item.outputFile = separator < 0 ? QString() : line.mid(separator + 1).trimmed();
+            item.size = QFileInfo(item.inputFile).size();
+            items.append(item);
+        }
+    }
+
+    return items;
+}
+
+QList<BatchItem> BatchProcessor::collectInputFiles(const QStringList &sources)
+{
+    QList<BatchItem> items;
+    static const QRegularExpression wildcard("[*?\\[]");
+    for (const QString& source : sources) {
+        QFileInfo sourceInfo(source);
+        if (sourceInfo.fileName().contains(wildcard) || sourceInfo.isDir()) {
+            for (BatchItem& item : collectItems(source)) {
+                item.outputFile.clear();
+                items.append(item);
+            }
+        }
+        else {
+            // Отсутствующий файл попадает в список — о нём сообщит разбор
+            items.append(BatchItem{source, QString(), sourceInfo.size()});
+        }
+    }
+    return items;
+}
+
+QStringList BatchProcessor::collectCorpusFiles(const QString &dir)
+{
+    QStringList paths;
+    QDirIterator it(dir, QStringList{"*.xml"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) paths.append(it.next());
+    // Порядок обхода каталога зависит от файловой системы
+    paths.sort();
+    return paths;
+}
+
+QString BatchProcessor::processFile(const QString &inputFile, const QString &outputFile, int documentThreads, ExplanationCache *cache,
+                                   DiskCache *diskCache, const CancellationToken *cancellation)
+{
+    // Проверить доступ к выходному файлу
+    TEResult<void> access = checkFileAccess(outputFile);
+    if (!access.isOk()) return access.getErrors().first().what();
+
+    // Результат для неизменённого входного файла берётся из постоянного кэша
+    QByteArray content;
+    QByteArray key;
+    // Слишком большой файл не читается: об ошибке сообщит разбор
+    if (diskCache && QFileInfo(inputFile).size() <= ExpressionXmlParser::getLimits().maxInputBytes) {
+        QFile input(inputFile);
+        if (input.open(QIODevice::ReadOnly)) {
+            content = input.readAll();
+            countStat(PipelineCounter::BytesIn, content.size());
+            key = DiskCache::makeKey(content);
+        }
+    }
+    DiskCacheRecord record;
+    if (!key.isEmpty() && diskCache->find(key, record)) {
+        QString output = record.text;
+        if (record.successful) {
+            TEResult<void> written = writeToFile(outputFile, record.text);
+            if (!written.isOk()) output += written.getErrors().first().what();
+        }
+        return output;
+    }
+
+    // Считать входной файл
+    ExpressionDocument document;
+    TEResult<void> read = key.isEmpty()
+        ? ExpressionXmlParser::tryReadDocumentFromXML(inputFile, document, cancellation)
+        : ExpressionXmlParser::tryReadDocumentFromXMLContent(QString::fromUtf8(content), document, inputFile, cancellation);
+    if (!read.isOk()) {
+        QString text;
+        for (const TEException& error : read.getErrors()) {
+            text += error.what() + "\n";
+        }
+        if (!key.isEmpty() && isCacheable(read.getErrors()))
+            diskCache->insert(key, DiskCacheRecord{false, text});
+        return text;
+    }
+    document.setExplanationCache(cache);
+    document.setCancellationToken(cancellation);
+
+    // Получить объяснение документа
+    TEResult<QString> explanation = document.tryGetExplanation(documentThreads);
+    if (!explanation.isOk()) {
+        const TEException& error = explanation.getErrors().first();
+        if (!key.isEmpty() && isCacheable({error}))
+            diskCache->insert(key, DiskCacheRecord{false, error.what()});
+        return error.what();
+    }
+    if (!key.isEmpty())
+        diskCache->insert(key, DiskCacheRecord{true, explanation.value()});
+
+    // Вывести объяснение в консоль
+    QString output = explanation.value();
+    // Записать объяснение в выходной файл
+    TEResult<void> written = writeToFile(outputFile, output);
+    if (!written.isOk()) output += written.getErrors().first().what();
+    return output;
+}
+
+QList<TEException> BatchProcessor::checkFile(const QString &inputFile, int documentThreads, const CancellationToken *cancellation)
+{
+    ExpressionDocument document;
+    TEResult<void> read = ExpressionXmlParser::tryReadDocumentFromXML(inputFile, document, cancellation);
+    if (!read.isOk()) return read.getErrors();
+    document.setCancellationToken(cancellation);
+    return document.validate(documentThreads);
+}
+
+void BatchProcessor::run(QTextStream &cout, const QList<BatchItem> &items, int jobs, ExplanationCache *cache,
+                         DiskCache *diskCache, qint64 timeoutMs, StatsAggregate *stats)
+{
+    ExplanationCache batchCache;
+    if (!cache) cache = &batchCache;
+
+    // Крупные файлы запускаются первыми, чтобы не оказаться в хвосте пакета
+    QList<int> schedule(items.size());
+    for (int i = 0; i < schedule.size(); i++) schedule[i] = i;
+    std::stable_sort(schedule.begin(), schedule.end(), [&items](int a, int b) {
+        return items[a].size > items[b].size;
+    });
+
+    // Путь к каталогу программы кэшируется при первом обращении — получить его до запуска потоков
+    QCoreApplication::applicationDirPath();
+
+    ReorderBuffer output([&cout](const QString& text) {
+        cout << text;
+        cout.flush();
+    });
+
+    // Потоки уже заняты файлами пакета — документ с несколькими выражениями обрабатывается в одном потоке
+    WorkStealingPool pool(jobs);
+    const int documentThreads = pool.getThreadCount() > 1 ? 1 : 0;
+    pool.run(schedule.size(), [&items, &schedule, &output, documentThreads, cache, diskCache, timeoutMs, stats](int task) {
+        const int index = schedule[task];
+        const BatchItem& item = items[index];
+        StatsRecorder recorder;
+        StatsScope scope(stats || TraceLog::isEnabled() ? &recorder : nullptr);
+        RequestTrace trace(item.inputFile, &recorder);
+        // Срок отсчитывается от начала обработки файла, а не от начала пакета
+        CancellationToken cancellation(timeoutMs > 0 ? timeoutMs : -1);
+        QString text = processFile(item.inputFile, item.outputFile, documentThreads, cache, diskCache, &cancellation);
+        if (stats) stats->add(recorder.sample());
+        if (!text.endsWith('\n')) text += "\n";
+        output.submit(index, "==> " + item.inputFile + " <==\n" + text);
+    });
+}
+
+int BatchProcessor::runCheck(QTextStream &cout, const QList<BatchItem> &items, int jobs, qint64 timeoutMs, StatsAggregate *stats)
+{
+    QList<int> schedule(items.size());
+    for (int i = 0; i < schedule.size(); i++) schedule[i] = i;
+    std::stable_sort(schedule.begin(), schedule.end(), [&items](int a, int b) {
+        return items[a].size > items[b].size;
+    });
+
+    // Путь к каталогу программы нужен разбору — получить его до запуска потоков
+    QCoreApplication::applicationDirPath();
+
+    ReorderBuffer output([&cout](const QString& text) {
+        cout << text;
+        cout.flush();
+    });
+
+    std::atomic<int> failedFiles(0);
+    WorkStealingPool pool(jobs);
+    const int documentThreads = pool.getThreadCount() > 1 ? 1 : 0;
+    pool.run(schedule.size(), [&items, &schedule, &output, &failedFiles, documentThreads, timeoutMs, stats](int task) {
+        const int index = schedule[task];
+        const BatchItem& item = items[index];
+        StatsRecorder recorder;
+        StatsScope scope(stats || TraceLog::isEnabled() ? &recorder : nullptr);
+        RequestTrace trace(item.inputFile, &recorder);
+        CancellationToken cancellation(timeoutMs > 0 ? timeoutMs : -1);
+        const QList<TEException> errors = checkFile(item.inputFile, documentThreads, &cancellation);
+        if (stats) stats->add(recorder.sample());
+
+        // Корректный файл ничего не выводит, но занимает своё место в порядке вывода
+        QString text;
+        if (!errors.isEmpty()) {
+            failedFiles++;
+            text = "==> " + item.inputFile + " <==\n";
+            for (const TEException& error : errors) {
+                text += error.what() + "\n";
+            }
+        }
+        output.submit(index, text);
+    });
+
+    cout << "Checked " << items.size() << " file(s), " << failedFiles.load() << " with errors\n";
+    return failedFiles.load();
+}
@@ -0,0 +1,121 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса BatchProcessor — пакетной обработки входных файлов
+ */
+
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include "cancellationtoken.h"
+#include "diskcache.h"
+#include "explanationcache.h"
+#include "pipelinestats.h"
+#include "teexception.h"
+
+#include <QList>
+#include <QString>
+#include <QTextStream>
+
+/*!
+ * \brief Пара входного и выходного файлов пакета
+ */
+struct BatchItem {
+    QString inputFile;  /*!< Путь к входному файлу */
+    QString outputFile; /*!< Путь к выходному файлу */
+    qint64 size = 0;    /*!< Размер входного файла в байтах */
+};
+
+/*!
+ * \brief Класс пакетной обработки: объяснение множества входных файлов за один запуск программы
+ */
+class BatchProcessor
+{
+public:
+    /*!
+     * \brief Сбор списка файлов пакета
+     *
+     * Источник может быть файлом-списком (в каждой строке входной и выходной файлы, разделённые табуляцией
+     * или пробелом; пустые строки и строки, начинающиеся с '#', пропускаются), каталогом или шаблоном имени
+     * (например, "inputs/*.xml"). Для каталога и шаблона выходной файл получает имя "<имя входного файла>.out.txt".
+     * \param[in] source Файл-список, каталог или шаблон имени
+     * \param[in] outputDir Каталог выходных файлов для каталога и шаблона (пустой — рядом с входными файлами)
+     * \return Список файлов пакета
+     * \throw TEException Файл-список или каталог недоступен
+     */
+    static QList<BatchItem> collectItems(const QString& source, const QString& outputDir = QString());
+
+    /*!
+     * \brief Сбор списка входных файлов для проверки
+     *
+     * Каждый источник — входной файл, каталог или шаблон имени. Выходные файлы не назначаются.
+     * \param[in] sources Входные файлы, каталоги или шаблоны имени
+     * \return Список файлов в порядке источников
+     * \throw TEException Каталог недоступен
+     */
+    static QList<BatchItem> collectInputFiles(const QStringList& sources);
+
+    /*!
+     * \brief Сбор корпуса: все файлы *.xml каталога и его подкаталогов в порядке путей
+     *
+     * Используется замерами и нагрузочными тестами, чтобы прогоны на разных файловых системах подавали файлы одинаково.
+     * \param[in] dir Каталог корпуса
+     * \return Пути файлов корпуса; пустой список, если каталог недоступен
+     */
+    static QStringList collectCorpusFiles(const QString& dir);
+
+    /*!
+     * \brief Обработка одного входного файла так же, как при запуске программы для одного файла
+     * \param[in] inputFile Путь к входному файлу
+     * \param[in] outputFile Путь к выходному файлу
+     * \param[in] documentThreads Количество потоков для документа с несколькими выражениями (0 — по числу ядер)
+     * \param[in] cache Кэш результатов объяснения (nullptr — без кэша)
+     * \param[in] diskCache Постоянный кэш результатов обработки файлов (nullptr — без кэша)
+     * \param[in] cancellation Признак отмены обработки файла (nullptr — без отмены)
+     * \return Текст, который выводится в консоль: объяснение или сообщения об ошибках
+     */
+    static QString processFile(const QString& inputFile, const QString& outputFile, int documentThreads = 0,
+                               ExplanationCache* cache = nullptr, DiskCache* diskCache = nullptr,
+                               const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Проверка одного входного файла без построения объяснений и записи результатов
+     * \param[in] inputFile Путь к входному файлу
+     * \param[in] documentThreads Количество потоков для документа с несколькими выражениями (0 — по числу ядер)
+     * \param[in] cancellation Признак отмены проверки файла (nullptr — без отмены)
+     * \return Ошибки разбора и проверки выражений (пустой список — файл корректен)
+     */
+    static QList<TEException> checkFile(const QString& inputFile, int documentThreads = 0,
+                                        const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Обработка пакета на пуле потоков с перехватом задач
+     *
+     * Крупные файлы запускаются первыми, а результаты выводятся в порядке списка файлов.
+     * Повторяющиеся выражения над одной схемой объясняются один раз за пакет.
+     * \param[out] cout Поток вывода результатов
+     * \param[in] items Список файлов пакета
+     * \param[in] jobs Количество потоков (0 — по числу ядер)
+     * \param[in] cache Кэш результатов объяснения (nullptr — кэш на время пакета)
+     * \param[in] diskCache Постоянный кэш результатов обработки файлов (nullptr — без кэша)
+     * \param[in] timeoutMs Срок обработки одного файла в миллисекундах (0 — без срока)
+     * \param[out] stats Сводная статистика, в которую добавляется статистика каждого файла (nullptr — не собирать)
+     */
+    static void run(QTextStream& cout, const QList<BatchItem>& items, int jobs = 0, ExplanationCache* cache = nullptr,
+                    DiskCache* diskCache = nullptr, qint64 timeoutMs = 0, StatsAggregate* stats = nullptr);
+
+    /*!
+     * \brief Проверка пакета на пуле потоков с перехватом задач
+     *
+     * Выводятся только ошибки — в порядке списка файлов, — и итоговая строка с числом проверенных файлов.
+     * \param[out] cout Поток вывода ошибок
+     * \param[in] items Список файлов пакета
+     * \param[in] jobs Количество потоков (0 — по числу ядер)
+     * \param[in] timeoutMs Срок проверки одного файла в миллисекундах (0 — без срока)
+     * \param[out] stats Сводная статистика, в которую добавляется статистика каждого файла (nullptr — не собирать)
+     * \return Количество файлов с ошибками
+     */
+    static int runCheck(QTextStream& cout, const QList<BatchItem>& items, int jobs = 0, qint64 timeoutMs = 0,
+                        StatsAggregate* stats = nullptr);
+};
+
+#endif // BATCHPROCESSOR_H
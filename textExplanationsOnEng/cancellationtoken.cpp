@@ -0,0 +1,16 @@
+#include "cancellationtoken.h"
+
+CancellationToken::CancellationToken(qint64 timeoutMs)
+    : cancelled(false)
+    , deadline(timeoutMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(timeoutMs))
+{}
+
+void CancellationToken::cancel()
+{
+    cancelled = true;
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return cancelled || deadline.hasExpired();
+}
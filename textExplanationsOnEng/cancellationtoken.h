@@ -0,0 +1,47 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса CancellationToken — признака отмены обработки запроса
+ */
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QDeadlineTimer>
+
+#include <atomic>
+
+/*!
+ * \brief Признак отмены обработки запроса: явная отмена или истёкший срок
+ *
+ * Проверяется при разборе XML, построении дерева выражения (на каждой лексеме)
+ * и построении объяснения (на каждом узле). Проверка дешёвая: флаг и сравнение с текущим временем.
+ * Методы потокобезопасны.
+ */
+class CancellationToken
+{
+public:
+    /*!
+     * \brief Конструктор признака отмены
+     * \param[in] timeoutMs Срок обработки в миллисекундах от момента создания (отрицательный — без срока)
+     */
+    explicit CancellationToken(qint64 timeoutMs = -1);
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    /*!
+     * \brief Отмена обработки
+     */
+    void cancel();
+
+    /*!
+     * \brief Проверка, отменена ли обработка или истёк ли срок
+     */
+    bool isCancelled() const;
+
+private:
+    std::atomic<bool> cancelled; ///< Обработка отменена явно
+    QDeadlineTimer deadline; ///< Срок обработки
+};
+
+#endif // CANCELLATIONTOKEN_H
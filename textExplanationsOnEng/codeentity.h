@@ -76,6 +76,9 @@ extern const QHash<OperationType, QString> OperationTypeNames;
 
 /*!
  * \brief Структура, представляющая переменную
+ *
+ * При чтении схемы из XML строковые поля сущностей не владеют данными, а указывают
+ * внутрь пула строк схемы (StringPool), поэтому копирование сущностей не выделяет память.
  */
 struct Variable {
     QString name;           /*!< Имя переменной */
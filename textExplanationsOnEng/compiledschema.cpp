@@ -0,0 +1,304 @@
+#include "compiledschema.h"
+
+#include <QCryptographicHash>
+#include <QtEndian>
+
+#include <algorithm>
+
+// Приблизительные накладные расходы на один элемент хэш-таблицы и одну строку
+static const qsizetype entryOverhead = 64;
+
+// Сериализатор схемы для хэширования: строки записываются с длиной, чтобы границы полей были однозначны
+class SchemaHasher
+{
+public:
+    SchemaHasher() : hash(QCryptographicHash::Sha256), stringBytes(0), entryCount(0) {}
+
+    void addString(const QString& string) {
+        QByteArray utf8 = string.toUtf8();
+        addNumber(utf8.size());
+        hash.addData(utf8);
+        stringBytes += string.size() * qsizetype(sizeof(QChar));
+    }
+
+    // Числа записываются в little-endian, чтобы хэш совпадал на любых платформах
+    void addNumber(qint64 number) {
+        char buffer[sizeof(number)];
+        qToLittleEndian(number, buffer);
+        hash.addData(QByteArrayView(buffer, sizeof(buffer)));
+    }
+
+    // Раздел схемы: метка и количество элементов
+    void beginSection(const char* tag, qsizetype count) {
+        addString(QString::fromLatin1(tag));
+        addNumber(count);
+        entryCount += count;
+    }
+
+    void addVariable(const Variable& variable) {
+        addString(variable.name);
+        addString(variable.type);
+        addString(variable.description);
+    }
+
+    void addFunction(const Function& function) {
+        addString(function.name);
+        addString(function.type);
+        addNumber(function.paramsCount);
+        addString(function.description);
+    }
+
+    void addCustomType(const CustomTypeWithFields& customType);
+
+    QCryptographicHash hash;
+    qsizetype stringBytes;
+    qsizetype entryCount;
+};
+
+// Ключи словаря в порядке возрастания — порядок сущностей в документе на хэш не влияет
+template <typename T>
+static QList<QString> sortedKeys(const QHash<QString, T>& hash) {
+    QList<QString> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+void SchemaHasher::addCustomType(const CustomTypeWithFields &customType)
+{
+    addString(customType.name);
+    beginSection("variables", customType.variables.size());
+    for (const QString& key : sortedKeys(customType.variables)) {
+        addVariable(customType.variables.value(key));
+    }
+    beginSection("functions", customType.functions.size());
+    for (const QString& key : sortedKeys(customType.functions)) {
+        addFunction(customType.functions.value(key));
+    }
+}
+
+CompiledSchema::CompiledSchema(const QHash<QString, Variable> &vars, const QHash<QString, Function> &funcs, const QHash<QString, Union> &unns, const QHash<QString, Structure> &strucs, const QHash<QString, Class> &cls, const QHash<QString, Enum> &enms, const QSharedPointer<const StringPool> &stringPool)
+    : variables(vars)
+    , functions(funcs)
+    , unions(unns)
+    , structures(strucs)
+    , classes(cls)
+    , enums(enms)
+    , stringPool(stringPool)
+{
+    // Имена пользовательских типов
+    for (auto it = unions.cbegin(); it != unions.cend(); ++it) {
+        customDataTypes.insert(it.value().name);
+    }
+    for (auto it = structures.cbegin(); it != structures.cend(); ++it) {
+        customDataTypes.insert(it.value().name);
+    }
+    for (auto it = classes.cbegin(); it != classes.cend(); ++it) {
+        customDataTypes.insert(it.value().name);
+    }
+    for (auto it = enums.cbegin(); it != enums.cend(); ++it) {
+        customDataTypes.insert(it.value().name);
+    }
+
+    // переменные
+    for (auto i = variables.cbegin(); i != variables.cend(); i++) {
+        allNames.insert(i.value().name);
+    }
+    // функции
+    for (auto i = functions.cbegin(); i != functions.cend(); i++) {
+        allNames.insert(i.value().name);
+    }
+    for (auto i = unions.cbegin(); i != unions.cend(); i++) {
+        addCustomTypeFields(allNames, i.value());
+    }
+    for (auto i = structures.cbegin(); i != structures.cend(); i++) {
+        addCustomTypeFields(allNames, i.value());
+    }
+    for (auto i = classes.cbegin(); i != classes.cend(); i++) {
+        addCustomTypeFields(allNames, i.value());
+    }
+    // перечисления
+    for (auto i = enums.cbegin(); i != enums.cend(); i++) {
+        allNames.insert(i.value().name);
+        for (auto enumI = i.value().values.cbegin(); enumI != i.value().values.cend(); enumI++) {
+            allNames.insert(i.value().name + "." + enumI.key());
+        }
+    }
+
+    computeContentHash();
+}
+
+void CompiledSchema::computeContentHash()
+{
+    SchemaHasher hasher;
+
+    hasher.beginSection("variables", variables.size());
+    for (const QString& key : sortedKeys(variables)) {
+        hasher.addVariable(variables.value(key));
+    }
+    hasher.beginSection("functions", functions.size());
+    for (const QString& key : sortedKeys(functions)) {
+        hasher.addFunction(functions.value(key));
+    }
+    hasher.beginSection("unions", unions.size());
+    for (const QString& key : sortedKeys(unions)) {
+        hasher.addCustomType(unions.value(key));
+    }
+    hasher.beginSection("structures", structures.size());
+    for (const QString& key : sortedKeys(structures)) {
+        hasher.addCustomType(structures.value(key));
+    }
+    hasher.beginSection("classes", classes.size());
+    for (const QString& key : sortedKeys(classes)) {
+        hasher.addCustomType(classes.value(key));
+    }
+    hasher.beginSection("enums", enums.size());
+    for (const QString& key : sortedKeys(enums)) {
+        const Enum& enm = enums.value(key);
+        hasher.addString(enm.name);
+        hasher.beginSection("values", enm.values.size());
+        for (const QString& valueKey : sortedKeys(enm.values)) {
+            hasher.addString(valueKey);
+            hasher.addString(enm.values.value(valueKey));
+        }
+    }
+
+    contentHash = hasher.hash.result();
+    // Строки из пула занимают место один раз — в чанках пула
+    qsizetype stringBytes = stringPool ? stringPool->size() * qsizetype(sizeof(QChar)) : hasher.stringBytes;
+    memoryUsage = qsizetype(sizeof(CompiledSchema)) + stringBytes
+                  + (hasher.entryCount + allNames.size()) * entryOverhead;
+}
+
+QSharedPointer<const CompiledSchema> CompiledSchema::create(const QHash<QString, Variable> &vars, const QHash<QString, Function> &funcs, const QHash<QString, Union> &unns, const QHash<QString, Structure> &strucs, const QHash<QString, Class> &cls, const QHash<QString, Enum> &enms, const QSharedPointer<const StringPool> &stringPool)
+{
+    return QSharedPointer<const CompiledSchema>(new CompiledSchema(vars, funcs, unns, strucs, cls, enms, stringPool));
+}
+
+QSharedPointer<const CompiledSchema> CompiledSchema::empty()
+{
+    static const QSharedPointer<const CompiledSchema> emptySchema = create();
+    return emptySchema;
+}
+
+void CompiledSchema::addCustomTypeFields(QSet<QString> &names, const CustomTypeWithFields &customType)
+{
+    names.insert(customType.name);
+    for (auto i = customType.variables.cbegin(); i != customType.variables.cend(); i++) {
+        names.insert(customType.name + "." + i.value().name);
+    }
+    for (auto i = customType.functions.cbegin(); i != customType.functions.cend(); i++) {
+        names.insert(customType.name + "." + i.value().name);
+    }
+}
+
+const QHash<QString, Variable> &CompiledSchema::getVariables() const
+{
+    return variables;
+}
+
+const QHash<QString, Function> &CompiledSchema::getFunctions() const
+{
+    return functions;
+}
+
+const QHash<QString, Union> &CompiledSchema::getUnions() const
+{
+    return unions;
+}
+
+const QHash<QString, Structure> &CompiledSchema::getStructures() const
+{
+    return structures;
+}
+
+const QHash<QString, Class> &CompiledSchema::getClasses() const
+{
+    return classes;
+}
+
+const QHash<QString, Enum> &CompiledSchema::getEnums() const
+{
+    return enums;
+}
+
+const QSharedPointer<const StringPool> &CompiledSchema::getStringPool() const
+{
+    return stringPool;
+}
+
+const Variable &CompiledSchema::getVarByName(const QString &name) const
+{
+    static const Variable notFound;
+    auto it = variables.constFind(name);
+    return it != variables.cend() ? it.value() : notFound;
+}
+
+const Function &CompiledSchema::getFuncByName(const QString &name) const
+{
+    static const Function notFound;
+    auto it = functions.constFind(name);
+    return it != functions.cend() ? it.value() : notFound;
+}
+
+const Union &CompiledSchema::getUnionByName(const QString &name) const
+{
+    static const Union notFound;
+    auto it = unions.constFind(name);
+    return it != unions.cend() ? it.value() : notFound;
+}
+
+const Structure &CompiledSchema::getStructByName(const QString &name) const
+{
+    static const Structure notFound;
+    auto it = structures.constFind(name);
+    return it != structures.cend() ? it.value() : notFound;
+}
+
+const Class &CompiledSchema::getClassByName(const QString &name) const
+{
+    static const Class notFound;
+    auto it = classes.constFind(name);
+    return it != classes.cend() ? it.value() : notFound;
+}
+
+const Enum &CompiledSchema::getEnumByName(const QString &name) const
+{
+    static const Enum notFound;
+    auto it = enums.constFind(name);
+    return it != enums.cend() ? it.value() : notFound;
+}
+
+const CustomTypeWithFields &CompiledSchema::getCustomTypeByName(const QString &typeName) const
+{
+    static const CustomTypeWithFields notFound;
+    auto classIt = classes.constFind(typeName);
+    if (classIt != classes.cend()) return classIt.value();
+
+    auto structIt = structures.constFind(typeName);
+    if (structIt != structures.cend()) return structIt.value();
+
+    auto unionIt = unions.constFind(typeName);
+    if (unionIt != unions.cend()) return unionIt.value();
+
+    return notFound;
+}
+
+const QSet<QString> &CompiledSchema::getCustomDataTypes() const
+{
+    return customDataTypes;
+}
+
+const QSet<QString> &CompiledSchema::getAllNames() const
+{
+    return allNames;
+}
+
+const QByteArray &CompiledSchema::getContentHash() const
+{
+    return contentHash;
+}
+
+qsizetype CompiledSchema::getMemoryUsage() const
+{
+    return memoryUsage;
+}
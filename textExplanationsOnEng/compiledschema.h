@@ -0,0 +1,180 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса CompiledSchema — неизменяемой схемы сущностей выражения
+ */
+
+#ifndef COMPILEDSCHEMA_H
+#define COMPILEDSCHEMA_H
+
+#include "codeentity.h"
+#include "stringpool.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+
+/*!
+ * \brief Неизменяемая схема: переменные, функции и пользовательские типы, на которые ссылается выражение
+ *
+ * Схема строится один раз и далее только читается, поэтому один объект может одновременно
+ * использоваться любым количеством потоков без блокировок. Схема передаётся по QSharedPointer
+ * и живёт, пока на неё ссылается хотя бы одно выражение.
+ */
+class CompiledSchema
+{
+public:
+    /*!
+     * \brief Построение схемы
+     * \param[in] vars Словарь переменных
+     * \param[in] funcs Словарь функций
+     * \param[in] unns Словарь объединений
+     * \param[in] strucs Словарь структур
+     * \param[in] cls Словарь классов
+     * \param[in] enms Словарь перечислений
+     * \param[in] stringPool Пул строк, в который указывают строки сущностей (если есть)
+     * \return Указатель на построенную схему
+     */
+    static QSharedPointer<const CompiledSchema> create(
+        const QHash<QString, Variable>& vars = {},
+        const QHash<QString, Function>& funcs = {},
+        const QHash<QString, Union>& unns = {},
+        const QHash<QString, Structure>& strucs = {},
+        const QHash<QString, Class>& cls = {},
+        const QHash<QString, Enum>& enms = {},
+        const QSharedPointer<const StringPool>& stringPool = {});
+
+    /*!
+     * \brief Получение пустой схемы (общий экземпляр)
+     */
+    static QSharedPointer<const CompiledSchema> empty();
+
+    /*!
+     * \brief Получение словаря переменных
+     */
+    const QHash<QString, Variable>& getVariables() const;
+
+    /*!
+     * \brief Получение словаря функций
+     */
+    const QHash<QString, Function>& getFunctions() const;
+
+    /*!
+     * \brief Получение словаря объединений
+     */
+    const QHash<QString, Union>& getUnions() const;
+
+    /*!
+     * \brief Получение словаря структур
+     */
+    const QHash<QString, Structure>& getStructures() const;
+
+    /*!
+     * \brief Получение словаря классов
+     */
+    const QHash<QString, Class>& getClasses() const;
+
+    /*!
+     * \brief Получение словаря перечислений
+     */
+    const QHash<QString, Enum>& getEnums() const;
+
+    /*!
+     * \brief Получение пула строк схемы
+     */
+    const QSharedPointer<const StringPool>& getStringPool() const;
+
+    /*!
+     * \brief Получение переменной по имени
+     */
+    const Variable& getVarByName(const QString& name) const;
+
+    /*!
+     * \brief Получение функции по имени
+     */
+    const Function& getFuncByName(const QString& name) const;
+
+    /*!
+     * \brief Получение объединения по имени
+     */
+    const Union& getUnionByName(const QString& name) const;
+
+    /*!
+     * \brief Получение структуры по имени
+     */
+    const Structure& getStructByName(const QString& name) const;
+
+    /*!
+     * \brief Получение класса по имени
+     */
+    const Class& getClassByName(const QString& name) const;
+
+    /*!
+     * \brief Получение перечисления по имени
+     */
+    const Enum& getEnumByName(const QString& name) const;
+
+    /*!
+     * \brief Получение пользовательского типа (класса, структуры или объединения) по имени
+     */
+    const CustomTypeWithFields& getCustomTypeByName(const QString& typeName) const;
+
+    /*!
+     * \brief Получение имён всех пользовательских типов данных (вычисляется при построении схемы)
+     */
+    const QSet<QString>& getCustomDataTypes() const;
+
+    /*!
+     * \brief Получение всех имён переменных, функций, полей и значений перечислений (вычисляется при построении схемы)
+     */
+    const QSet<QString>& getAllNames() const;
+
+    /*!
+     * \brief Получение хэша содержимого схемы (SHA-256, вычисляется при построении схемы)
+     *
+     * Хэш не зависит от порядка сущностей, поэтому одинаковые схемы из разных документов имеют одинаковый хэш.
+     */
+    const QByteArray& getContentHash() const;
+
+    /*!
+     * \brief Получение приблизительного объёма памяти, занимаемого схемой, в байтах
+     */
+    qsizetype getMemoryUsage() const;
+
+private:
+    /*!
+     * \brief Конструктор схемы; используется только из create()
+     */
+    CompiledSchema(const QHash<QString, Variable>& vars,
+                   const QHash<QString, Function>& funcs,
+                   const QHash<QString, Union>& unns,
+                   const QHash<QString, Structure>& strucs,
+                   const QHash<QString, Class>& cls,
+                   const QHash<QString, Enum>& enms,
+                   const QSharedPointer<const StringPool>& stringPool);
+
+    /*!
+     * \brief Добавление имени пользовательского типа и имён его полей
+     */
+    static void addCustomTypeFields(QSet<QString>& names, const CustomTypeWithFields& customType);
+
+    /*!
+     * \brief Вычисление хэша содержимого и объёма памяти схемы
+     */
+    void computeContentHash();
+
+    QHash<QString, Variable> variables; ///< Список переменных
+    QHash<QString, Function> functions; ///< Список функций
+    QHash<QString, Union> unions; ///< Пользовательские типы: объединения
+    QHash<QString, Structure> structures; ///< Пользовательские типы: структуры
+    QHash<QString, Class> classes; ///< Пользовательские типы: классы
+    QHash<QString, Enum> enums; ///< Пользовательские типы: перечисления
+    QSharedPointer<const StringPool> stringPool; ///< Пул строк, в который указывают строки сущностей
+    QSet<QString> customDataTypes; ///< Имена пользовательских типов данных
+    QSet<QString> allNames; ///< Все имена схемы
+    QByteArray contentHash; ///< Хэш содержимого схемы
+    qsizetype memoryUsage; ///< Приблизительный объём памяти схемы
+};
+
+#endif // COMPILEDSCHEMA_H
@@ -0,0 +1,396 @@
+#include "diskcache.h"
+#include "expressiontranslator.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+static const quint32 indexMagic = 0x58494554;   // "TEIX"
+static const quint32 recordMagic = 0x43524554;  // "TERC"
+static const quint32 formatVersion = 1;
+static const quint32 initialCapacity = 4096;
+static const qint64 minSegmentSize = 1024 * 1024;
+static const int keySize = 32;
+
+// Запись сегмента: магическое число, длина текста, ключ, флаг успеха, текст (UTF-8), контрольная сумма
+static const qsizetype recordHeaderSize = 4 + 4 + keySize + 1;
+static const qsizetype recordTrailerSize = 8;
+
+/*!
+ * \brief Заголовок файла индекса
+ */
+struct DiskCache::IndexHeader {
+    quint32 magic;          /*!< Магическое число индекса */
+    quint32 formatVersion;  /*!< Версия формата */
+    quint64 versionStamp;   /*!< Метка версии программы */
+    quint32 capacity;       /*!< Количество ячеек */
+    quint32 count;          /*!< Количество занятых ячеек */
+    quint32 firstSegment;   /*!< Номер самого старого сегмента */
+    quint32 activeSegment;  /*!< Номер текущего сегмента */
+    quint64 activeSize;     /*!< Размер полностью записанной части текущего сегмента */
+};
+
+/*!
+ * \brief Ячейка индекса
+ */
+struct DiskCache::IndexSlot {
+    uchar key[keySize];     /*!< Ключ */
+    quint32 segment;        /*!< Номер сегмента (0 — ячейка свободна) */
+    quint32 length;         /*!< Длина записи */
+    quint64 offset;         /*!< Смещение записи в сегменте */
+};
+
+// Контрольная сумма FNV-1a
+static quint64 checksum(const char* data, qsizetype size) {
+    quint64 hash = 14695981039346656037ULL;
+    for (qsizetype i = 0; i < size; i++) {
+        hash ^= uchar(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+static void appendNumber(QByteArray& data, T value) {
+    char buffer[sizeof(T)];
+    qToLittleEndian(value, buffer);
+    data.append(buffer, sizeof(T));
+}
+
+static QByteArray encodeRecord(const QByteArray& key, const DiskCacheRecord& record) {
+    QByteArray text = record.text.toUtf8();
+    QByteArray data;
+    data.reserve(recordHeaderSize + text.size() + recordTrailerSize);
+    appendNumber<quint32>(data, recordMagic);
+    appendNumber<quint32>(data, quint32(text.size()));
+    data.append(key);
+    data.append(char(record.successful ? 1 : 0));
+    data.append(text);
+    appendNumber<quint64>(data, checksum(data.constData(), data.size()));
+    return data;
+}
+
+static bool decodeRecord(const QByteArray& data, const QByteArray& key, DiskCacheRecord& record) {
+    if (data.size() < recordHeaderSize + recordTrailerSize) return false;
+
+    const char* bytes = data.constData();
+    quint32 textSize = qFromLittleEndian<quint32>(bytes + 4);
+    qsizetype checksumOffset = data.size() - recordTrailerSize;
+    if (qFromLittleEndian<quint32>(bytes) != recordMagic
+        || recordHeaderSize + qsizetype(textSize) != checksumOffset
+        || memcmp(bytes + 8, key.constData(), keySize) != 0
+        || qFromLittleEndian<quint64>(bytes + checksumOffset) != checksum(bytes, checksumOffset)) {
+        return false;
+    }
+
+    record.successful = bytes[8 + keySize] != 0;
+    record.text = QString::fromUtf8(bytes + recordHeaderSize, textSize);
+    return true;
+}
+
+DiskCache::DiskCache(const QString &directory, qint64 maxSize, quint64 versionStamp)
+    : directory(directory)
+    , maxSize(maxSize)
+    , segmentSize(qMax(minSegmentSize, maxSize / 8))
+    , versionStamp(versionStamp)
+    , index(nullptr)
+    , totalSize(0)
+    , hitCount(0)
+    , missCount(0)
+{}
+
+DiskCache::~DiskCache()
+{
+    if (index) indexFile.unmap(index);
+}
+
+bool DiskCache::open(QString *errorMessage)
+{
+    QMutexLocker locker(&mutex);
+
+    QDir dir(directory);
+    if (!dir.mkpath(".")) {
+        if (errorMessage) *errorMessage = "cannot create cache directory \"" + directory + "\"";
+        return false;
+    }
+
+    // Сегменты и индекс изменяются без межпроцессной синхронизации — каталог принадлежит одному процессу
+    lockFile.reset(new QLockFile(dir.filePath("lock")));
+    if (!lockFile->tryLock(0)) {
+        if (errorMessage) *errorMessage = "cache directory \"" + directory + "\" is used by another process";
+        return false;
+    }
+
+    indexFile.setFileName(dir.filePath("index"));
+    if (!indexFile.open(QIODevice::ReadWrite)) {
+        if (errorMessage) *errorMessage = "cannot open cache index in \"" + directory + "\"";
+        return false;
+    }
+
+    // Индекс другой версии или повреждённый заголовок — начать с пустого кэша
+    IndexHeader stored = {};
+    bool valid = indexFile.read(reinterpret_cast<char*>(&stored), sizeof(stored)) == qint64(sizeof(stored))
+                 && stored.magic == indexMagic
+                 && stored.formatVersion == formatVersion
+                 && stored.versionStamp == versionStamp
+                 && stored.capacity > 0
+                 && stored.firstSegment >= 1 && stored.firstSegment <= stored.activeSegment
+                 && indexFile.size() == qint64(sizeof(IndexHeader) + stored.capacity * sizeof(IndexSlot));
+
+    bool opened = valid ? mapIndex() && openActiveSegment() : false;
+    if (!opened && !(reset(initialCapacity) && openActiveSegment())) {
+        if (errorMessage) *errorMessage = "cannot initialize cache in \"" + directory + "\"";
+        return false;
+    }
+
+    totalSize = 0;
+    for (quint32 segment = header()->firstSegment; segment <= header()->activeSegment; segment++) {
+        totalSize += QFileInfo(segmentPath(segment)).size();
+    }
+    return true;
+}
+
+QByteArray DiskCache::makeKey(const QByteArray &documentContent)
+{
+    QByteArray normalized = documentContent;
+    normalized.replace("\r\n", "\n");
+    return QCryptographicHash::hash(normalized, QCryptographicHash::Sha256);
+}
+
+quint64 DiskCache::currentVersionStamp()
+{
+    static const quint64 stamp = []() {
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+        hash.addData(QByteArray::number(formatVersion));
+
+        QList<OperationType> operations = ExpressionTranslator::Templates.keys();
+        std::sort(operations.begin(), operations.end());
+        for (OperationType operation : std::as_const(operations)) {
+            hash.addData(QByteArray::number(int(operation)) + ':'
+                         + ExpressionTranslator::Templates.value(operation).toUtf8() + '\n');
+        }
+        return qFromLittleEndian<quint64>(hash.result().constData());
+    }();
+    return stamp;
+}
+
+bool DiskCache::find(const QByteArray &key, DiskCacheRecord &record)
+{
+    QMutexLocker locker(&mutex);
+
+    IndexSlot* slot = index && key.size() == keySize ? findSlot(key) : nullptr;
+    QByteArray data;
+    if (!slot || slot->segment == 0 || !readRecord(*slot, data) || !decodeRecord(data, key, record)) {
+        missCount++;
+        return false;
+    }
+    hitCount++;
+
+    // Самый старый сегмент удаляется первым — сохранить используемую запись в текущем сегменте
+    if (slot->segment == header()->firstSegment && header()->firstSegment != header()->activeSegment)
+        append(key, data);
+    return true;
+}
+
+void DiskCache::insert(const QByteArray &key, const DiskCacheRecord &record)
+{
+    QMutexLocker locker(&mutex);
+    if (!index || key.size() != keySize) return;
+
+    if (append(key, encodeRecord(key, record)))
+        compact();
+}
+
+qint64 DiskCache::count()
+{
+    QMutexLocker locker(&mutex);
+    return index ? header()->count : 0;
+}
+
+qint64 DiskCache::getSize()
+{
+    QMutexLocker locker(&mutex);
+    return totalSize;
+}
+
+qint64 DiskCache::getHitCount()
+{
+    QMutexLocker locker(&mutex);
+    return hitCount;
+}
+
+qint64 DiskCache::getMissCount()
+{
+    QMutexLocker locker(&mutex);
+    return missCount;
+}
+
+bool DiskCache::reset(quint32 capacity)
+{
+    if (index) {
+        indexFile.unmap(index);
+        index = nullptr;
+    }
+    activeSegment.close();
+
+    QDir dir(directory);
+    const QStringList segments = dir.entryList(QStringList{"segment-*.dat"}, QDir::Files);
+    for (const QString& segment : segments) {
+        dir.remove(segment);
+    }
+
+    // Индекс заполняется нулями — все ячейки свободны
+    if (!indexFile.resize(0) || !indexFile.resize(sizeof(IndexHeader) + capacity * sizeof(IndexSlot)) || !mapIndex())
+        return false;
+
+    IndexHeader* h = header();
+    h->magic = indexMagic;
+    h->formatVersion = formatVersion;
+    h->versionStamp = versionStamp;
+    h->capacity = capacity;
+    h->count = 0;
+    h->firstSegment = 1;
+    h->activeSegment = 1;
+    h->activeSize = 0;
+    totalSize = 0;
+    return true;
+}
+
+bool DiskCache::mapIndex()
+{
+    index = indexFile.map(0, indexFile.size());
+    return index != nullptr;
+}
+
+bool DiskCache::rebuildIndex(quint32 capacity, quint32 droppedSegment)
+{
+    IndexHeader saved = *header();
+    QList<IndexSlot> live;
+    const IndexSlot* slots = reinterpret_cast<const IndexSlot*>(index + sizeof(IndexHeader));
+    for (quint32 i = 0; i < saved.capacity; i++) {
+        if (slots[i].segment != 0 && slots[i].segment != droppedSegment) live.append(slots[i]);
+    }
+
+    indexFile.unmap(index);
+    index = nullptr;
+    if (!indexFile.resize(sizeof(IndexHeader)) || !indexFile.resize(sizeof(IndexHeader) + capacity * sizeof(IndexSlot)) || !mapIndex())
+        return false;
+
+    *header() = saved;
+    header()->capacity = capacity;
+    header()->count = 0;
+    for (const IndexSlot& slot : std::as_const(live)) {
+        *findSlot(QByteArray::fromRawData(reinterpret_cast<const char*>(slot.key), keySize)) = slot;
+        header()->count++;
+    }
+    return true;
+}
+
+DiskCache::IndexSlot *DiskCache::findSlot(const QByteArray &key) const
+{
+    const quint32 capacity = header()->capacity;
+    IndexSlot* slots = reinterpret_cast<IndexSlot*>(index + sizeof(IndexHeader));
+    quint64 start = qFromLittleEndian<quint64>(key.constData()) % capacity;
+
+    // Линейное пробирование до ячейки с этим ключом или первой свободной
+    for (quint32 probe = 0; probe < capacity; probe++) {
+        IndexSlot* slot = &slots[(start + probe) % capacity];
+        if (slot->segment == 0 || memcmp(slot->key, key.constData(), keySize) == 0) return slot;
+    }
+    return nullptr;
+}
+
+bool DiskCache::openActiveSegment()
+{
+    activeSegment.close();
+    activeSegment.setFileName(segmentPath(header()->activeSegment));
+    if (!activeSegment.open(QIODevice::ReadWrite)) return false;
+
+    // Сегмент короче записанного в индексе — кэш повреждён
+    qint64 committed = qint64(header()->activeSize);
+    if (activeSegment.size() < committed) return false;
+
+    // Недописанный при сбое хвост отбрасывается
+    if (activeSegment.size() > committed && !activeSegment.resize(committed)) return false;
+    return activeSegment.seek(committed);
+}
+
+bool DiskCache::append(const QByteArray &key, const QByteArray &recordData)
+{
+    if (header()->activeSize > 0 && qint64(header()->activeSize) + recordData.size() > segmentSize) {
+        header()->activeSegment++;
+        header()->activeSize = 0;
+        if (!openActiveSegment()) return false;
+    }
+
+    qint64 committed = qint64(header()->activeSize);
+    if (activeSegment.write(recordData) != recordData.size() || !activeSegment.flush()) {
+        activeSegment.resize(committed);
+        activeSegment.seek(committed);
+        return false;
+    }
+
+    IndexSlot* slot = findSlot(key);
+    if (!slot) return false;
+    if (slot->segment == 0) header()->count++;
+    memcpy(slot->key, key.constData(), keySize);
+    slot->segment = header()->activeSegment;
+    slot->offset = quint64(committed);
+    slot->length = quint32(recordData.size());
+
+    // Запись считается сохранённой только после обновления размера сегмента
+    header()->activeSize = quint64(committed + recordData.size());
+    totalSize += recordData.size();
+
+    // Заполненность индекса не больше 70%
+    if (quint64(header()->count) * 10 > quint64(header()->capacity) * 7)
+        rebuildIndex(header()->capacity * 2, 0);
+    return true;
+}
+
+bool DiskCache::readRecord(const IndexSlot &slot, QByteArray &recordData)
+{
+    QFile segmentFile;
+    QFile* file = &activeSegment;
+    if (slot.segment != header()->activeSegment) {
+        segmentFile.setFileName(segmentPath(slot.segment));
+        if (!segmentFile.open(QIODevice::ReadOnly)) return false;
+        file = &segmentFile;
+    }
+    else if (slot.offset + slot.length > header()->activeSize) {
+        return false;
+    }
+
+    bool read = file->seek(qint64(slot.offset));
+    if (read) recordData = file->read(slot.length);
+
+    // Текущий сегмент дописывается с конца
+    if (file == &activeSegment) activeSegment.seek(qint64(header()->activeSize));
+    return read && recordData.size() == qsizetype(slot.length);
+}
+
+void DiskCache::compact()
+{
+    while (totalSize > maxSize && header()->firstSegment < header()->activeSegment) {
+        quint32 dropped = header()->firstSegment;
+        // Сначала убрать ссылки на сегмент из индекса, затем удалить сам сегмент
+        if (!rebuildIndex(header()->capacity, dropped)) return;
+        header()->firstSegment++;
+        totalSize -= QFileInfo(segmentPath(dropped)).size();
+        QFile::remove(segmentPath(dropped));
+    }
+}
+
+QString DiskCache::segmentPath(quint32 segment) const
+{
+    return QDir(directory).filePath(QString("segment-%1.dat").arg(segment, 8, 10, QChar('0')));
+}
+
+DiskCache::IndexHeader *DiskCache::header() const
+{
+    return reinterpret_cast<IndexHeader*>(index);
+}
@@ -0,0 +1,178 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса DiskCache — постоянного кэша результатов на диске
+ */
+
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QLockFile>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QString>
+
+/*!
+ * \brief Результат обработки входного документа, сохранённый в кэше
+ */
+struct DiskCacheRecord {
+    bool successful = false;    /*!< Объяснение получено без ошибок (его нужно записать в выходной файл) */
+    QString text;               /*!< Текст, который выводится в консоль: объяснение или сообщения об ошибках */
+};
+
+/*!
+ * \brief Постоянный кэш результатов обработки документов с адресацией по содержимому
+ *
+ * Ключ — хэш SHA-256 нормализованного текста входного документа. Записи дописываются в конец
+ * файлов-сегментов и защищены контрольной суммой; индекс — отображённая в память хэш-таблица
+ * с открытой адресацией. Недописанный при сбое хвост сегмента отбрасывается при открытии,
+ * повреждённая запись считается промахом. При превышении размера удаляется самый старый сегмент;
+ * записи, прочитанные из него, предварительно переносятся в текущий сегмент.
+ * Кэш сбрасывается, если изменилась метка версии (шаблоны ExpressionTranslator::Templates).
+ * Каталог кэша используется одним процессом; методы потокобезопасны.
+ */
+class DiskCache
+{
+public:
+    static const qint64 defaultMaxSize = 512LL * 1024 * 1024; ///< Размер кэша по умолчанию, байт
+
+    /*!
+     * \brief Конструктор кэша
+     * \param[in] directory Каталог кэша
+     * \param[in] maxSize Максимальный суммарный размер сегментов в байтах
+     * \param[in] versionStamp Метка версии; кэш с другой меткой сбрасывается
+     */
+    explicit DiskCache(const QString& directory, qint64 maxSize = defaultMaxSize,
+                       quint64 versionStamp = currentVersionStamp());
+
+    ~DiskCache();
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    /*!
+     * \brief Открытие кэша: создание каталога, проверка метки версии, отбрасывание недописанного хвоста
+     * \param[out] errorMessage Описание ошибки, если кэш открыть не удалось
+     * \return true, если кэш открыт
+     */
+    bool open(QString* errorMessage = nullptr);
+
+    /*!
+     * \brief Построение ключа по тексту входного документа
+     *
+     * Текст нормализуется: переводы строк "\r\n" приводятся к "\n" (номера строк при этом не меняются).
+     * \param[in] documentContent Текст документа
+     * \return Ключ (32 байта)
+     */
+    static QByteArray makeKey(const QByteArray& documentContent);
+
+    /*!
+     * \brief Метка версии текущей программы: хэш формата кэша и шаблонов объяснения
+     */
+    static quint64 currentVersionStamp();
+
+    /*!
+     * \brief Поиск результата
+     * \param[in] key Ключ
+     * \param[out] record Найденный результат
+     * \return true, если результат найден и не повреждён
+     */
+    bool find(const QByteArray& key, DiskCacheRecord& record);
+
+    /*!
+     * \brief Добавление результата
+     * \param[in] key Ключ
+     * \param[in] record Результат
+     */
+    void insert(const QByteArray& key, const DiskCacheRecord& record);
+
+    /*!
+     * \brief Получение количества записей
+     */
+    qint64 count();
+
+    /*!
+     * \brief Получение суммарного размера сегментов в байтах
+     */
+    qint64 getSize();
+
+    /*!
+     * \brief Получение количества попаданий
+     */
+    qint64 getHitCount();
+
+    /*!
+     * \brief Получение количества промахов
+     */
+    qint64 getMissCount();
+
+private:
+    struct IndexHeader;
+    struct IndexSlot;
+
+    /*!
+     * \brief Сброс кэша: удаление сегментов и создание пустого индекса
+     */
+    bool reset(quint32 capacity);
+
+    /*!
+     * \brief Отображение индекса в память
+     */
+    bool mapIndex();
+
+    /*!
+     * \brief Перестроение индекса с новой ёмкостью без записей указанного сегмента (0 — сохранить все)
+     */
+    bool rebuildIndex(quint32 capacity, quint32 droppedSegment);
+
+    /*!
+     * \brief Поиск ячейки индекса: занятой с этим ключом или первой свободной
+     */
+    IndexSlot* findSlot(const QByteArray& key) const;
+
+    /*!
+     * \brief Открытие текущего сегмента для дописывания
+     */
+    bool openActiveSegment();
+
+    /*!
+     * \brief Дописывание записи в текущий сегмент и обновление индекса
+     */
+    bool append(const QByteArray& key, const QByteArray& recordData);
+
+    /*!
+     * \brief Чтение и проверка записи
+     */
+    bool readRecord(const IndexSlot& slot, QByteArray& recordData);
+
+    /*!
+     * \brief Удаление старых сегментов до укладывания в размер
+     */
+    void compact();
+
+    /*!
+     * \brief Путь к файлу сегмента
+     */
+    QString segmentPath(quint32 segment) const;
+
+    /*!
+     * \brief Получение заголовка индекса
+     */
+    IndexHeader* header() const;
+
+    QString directory; ///< Каталог кэша
+    qint64 maxSize; ///< Максимальный суммарный размер сегментов
+    qint64 segmentSize; ///< Размер сегмента, после которого начинается новый
+    quint64 versionStamp; ///< Метка версии
+    QMutex mutex; ///< Защита состояния кэша
+    QScopedPointer<QLockFile> lockFile; ///< Блокировка каталога от других процессов
+    QFile indexFile; ///< Файл индекса
+    uchar* index; ///< Отображённый в память индекс
+    QFile activeSegment; ///< Текущий сегмент
+    qint64 totalSize; ///< Суммарный размер сегментов
+    qint64 hitCount; ///< Количество попаданий
+    qint64 missCount; ///< Количество промахов
+};
+
+#endif // DISKCACHE_H
@@ -0,0 +1,148 @@
+#include "explanationcache.h"
+#include "expression.h"
+
+// Приблизительные накладные расходы на одну запись и одну строку
+static const qsizetype entryOverhead = 128;
+static const qsizetype stringOverhead = 32;
+
+ExplanationCache::ExplanationCache(qsizetype byteBudget, int shardCount)
+    : hitCount(0)
+    , missCount(0)
+    , evictionCount(0)
+{
+    shardCount = qMax(1, shardCount);
+    for (int i = 0; i < shardCount; i++) {
+        shards.append(new Shard);
+    }
+    shardBudget = byteBudget / shardCount;
+}
+
+ExplanationCache::~ExplanationCache()
+{
+    qDeleteAll(shards);
+}
+
+QString ExplanationCache::makeKey(const QByteArray &schemaHash, const QString &expression, bool checkUnusedElements)
+{
+    // Выражение только из пробелов объясняется иначе, чем пустое, поэтому оно не нормализуется
+    QStringList tokens = Expression::splitExpression(expression);
+    QString normalized = tokens.isEmpty() ? expression : tokens.join(' ');
+
+    return QString::fromLatin1(schemaHash.toHex()) + (checkUnusedElements ? ":u:" : ":-:") + normalized;
+}
+
+bool ExplanationCache::find(const QString &key, CachedExplanation &value)
+{
+    Shard* shard = shardFor(key);
+    QMutexLocker locker(&shard->mutex);
+
+    auto it = shard->entries.find(key);
+    if (it == shard->entries.end()) {
+        missCount++;
+        return false;
+    }
+
+    shard->usageOrder.splice(shard->usageOrder.begin(), shard->usageOrder, it->usage);
+    value = it->value;
+    hitCount++;
+    return true;
+}
+
+void ExplanationCache::insert(const QString &key, const CachedExplanation &value)
+{
+    qsizetype size = estimateSize(key, value);
+    // Запись больше сегмента вытеснила бы всё остальное — не кэшировать
+    if (size > shardBudget) return;
+
+    Shard* shard = shardFor(key);
+    QMutexLocker locker(&shard->mutex);
+
+    // Результат мог быть добавлен другим потоком, пока этот его вычислял
+    if (shard->entries.contains(key)) return;
+
+    shard->usageOrder.push_front(key);
+    shard->entries.insert(key, Entry{value, size, shard->usageOrder.begin()});
+    shard->memoryUsage += size;
+
+    while (shard->memoryUsage > shardBudget) {
+        auto last = shard->entries.find(shard->usageOrder.back());
+        shard->memoryUsage -= last->size;
+        shard->entries.erase(last);
+        shard->usageOrder.pop_back();
+        evictionCount++;
+    }
+}
+
+CachedExplanation ExplanationCache::findOrCompute(const QString &key, const std::function<CachedExplanation ()> &compute)
+{
+    CachedExplanation value;
+    if (find(key, value)) return value;
+
+    // Результат добавляется в кэш до того, как ожидающие потоки получат его
+    CachedExplanation shared = inFlight.run(key, [this, &key, &compute]() {
+        CachedExplanation computed = compute();
+        if (!isCancelled(computed)) insert(key, computed);
+        return computed;
+    });
+
+    // Вычисление прервано по сроку другого запроса — у этого запроса свой срок
+    return isCancelled(shared) ? compute() : shared;
+}
+
+qint64 ExplanationCache::getHitCount() const
+{
+    return hitCount;
+}
+
+qint64 ExplanationCache::getMissCount() const
+{
+    return missCount;
+}
+
+qint64 ExplanationCache::getEvictionCount() const
+{
+    return evictionCount;
+}
+
+qint64 ExplanationCache::getCoalescedCount() const
+{
+    return inFlight.getCoalescedCount();
+}
+
+qsizetype ExplanationCache::getMemoryUsage()
+{
+    qsizetype memoryUsage = 0;
+    for (Shard* shard : std::as_const(shards)) {
+        QMutexLocker locker(&shard->mutex);
+        memoryUsage += shard->memoryUsage;
+    }
+    return memoryUsage;
+}
+
+ExplanationCache::Shard *ExplanationCache::shardFor(const QString &key) const
+{
+    return shards[qHash(key) % size_t(shards.size())];
+}
+
+bool ExplanationCache::isCancelled(const CachedExplanation &value)
+{
+    for (const TEException& error : value.errors) {
+        if (error.getErrorType() == ErrorType::Cancelled) return true;
+    }
+    return false;
+}
+
+qsizetype ExplanationCache::estimateSize(const QString &key, const CachedExplanation &value)
+{
+    qsizetype size = entryOverhead + (key.size() + value.explanation.size()) * qsizetype(sizeof(QChar));
+    for (const QString& element : value.usedElements) {
+        size += stringOverhead + element.size() * qsizetype(sizeof(QChar));
+    }
+    for (const TEException& error : value.errors) {
+        size += stringOverhead;
+        for (const QString& arg : error.getArgs()) {
+            size += stringOverhead + arg.size() * qsizetype(sizeof(QChar));
+        }
+    }
+    return size;
+}
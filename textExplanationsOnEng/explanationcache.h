@@ -0,0 +1,166 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ExplanationCache — кэша результатов объяснения выражений
+ */
+
+#ifndef EXPLANATIONCACHE_H
+#define EXPLANATIONCACHE_H
+
+#include "singleflight.h"
+#include "teexception.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <list>
+
+/*!
+ * \brief Результат объяснения одного выражения над схемой, пригодный для повторного использования
+ */
+struct CachedExplanation {
+    QString explanation;            /*!< Объяснение (если нет ошибок) */
+    QList<TEException> errors;      /*!< Ошибки построения дерева выражения (без номера строки) */
+    QSet<QString> usedElements;     /*!< Элементы схемы, использованные выражением */
+};
+
+/*!
+ * \brief Кэш результатов объяснения с ключом (хэш схемы, нормализованное выражение)
+ *
+ * Кэш разделён на сегменты со своими блокировками, чтобы потоки, обращающиеся к разным ключам,
+ * не ждали друг друга. Каждый сегмент ограничен своей долей бюджета памяти и вытесняет
+ * давно не использовавшиеся записи. Кэшируются и объяснения, и ошибки: и те и другие
+ * полностью определяются схемой и текстом выражения. Одновременные промахи по одному ключу
+ * объединяются: результат вычисляет первый поток, остальные ждут его. Методы потокобезопасны.
+ */
+class ExplanationCache
+{
+public:
+    static const qsizetype defaultByteBudget = 64 * 1024 * 1024; ///< Бюджет памяти по умолчанию, байт
+    static const int defaultShardCount = 16; ///< Количество сегментов по умолчанию
+
+    /*!
+     * \brief Конструктор кэша
+     * \param[in] byteBudget Бюджет памяти в байтах
+     * \param[in] shardCount Количество сегментов
+     */
+    explicit ExplanationCache(qsizetype byteBudget = defaultByteBudget, int shardCount = defaultShardCount);
+
+    ~ExplanationCache();
+
+    ExplanationCache(const ExplanationCache&) = delete;
+    ExplanationCache& operator=(const ExplanationCache&) = delete;
+
+    /*!
+     * \brief Построение ключа кэша
+     *
+     * Выражение нормализуется: лексемы разделяются одним пробелом, поэтому выражения,
+     * отличающиеся только пробелами, имеют один ключ.
+     * \param[in] schemaHash Хэш содержимого схемы
+     * \param[in] expression Выражение в постфиксной записи
+     * \param[in] checkUnusedElements Проверялось ли использование всех элементов схемы
+     * \return Ключ
+     */
+    static QString makeKey(const QByteArray& schemaHash, const QString& expression, bool checkUnusedElements);
+
+    /*!
+     * \brief Поиск результата
+     * \param[in] key Ключ
+     * \param[out] value Найденный результат
+     * \return true, если результат найден
+     */
+    bool find(const QString& key, CachedExplanation& value);
+
+    /*!
+     * \brief Добавление результата
+     * \param[in] key Ключ
+     * \param[in] value Результат
+     */
+    void insert(const QString& key, const CachedExplanation& value);
+
+    /*!
+     * \brief Поиск результата или его вычисление и добавление при промахе
+     *
+     * Если результат по этому ключу уже вычисляется другим потоком, вычисление не повторяется:
+     * вызов ждёт его окончания и возвращает тот же результат. Прерванное вычисление (ErrorType::Cancelled)
+     * не кэшируется, а ожидавший его вызов вычисляет результат сам.
+     * \param[in] key Ключ
+     * \param[in] compute Вычисление результата
+     * \return Результат
+     */
+    CachedExplanation findOrCompute(const QString& key, const std::function<CachedExplanation()>& compute);
+
+    /*!
+     * \brief Получение количества попаданий
+     */
+    qint64 getHitCount() const;
+
+    /*!
+     * \brief Получение количества промахов
+     */
+    qint64 getMissCount() const;
+
+    /*!
+     * \brief Получение количества вытесненных записей
+     */
+    qint64 getEvictionCount() const;
+
+    /*!
+     * \brief Получение количества промахов, дождавшихся вычисления другого потока
+     */
+    qint64 getCoalescedCount() const;
+
+    /*!
+     * \brief Получение объёма памяти записей в байтах
+     */
+    qsizetype getMemoryUsage();
+
+private:
+    /*!
+     * \brief Запись кэша
+     */
+    struct Entry {
+        CachedExplanation value;                /*!< Результат */
+        qsizetype size;                         /*!< Приблизительный объём памяти записи */
+        std::list<QString>::iterator usage;     /*!< Позиция в очереди использования */
+    };
+
+    /*!
+     * \brief Сегмент кэша
+     */
+    struct Shard {
+        QMutex mutex;                   /*!< Защита сегмента */
+        QHash<QString, Entry> entries;  /*!< Записи по ключам */
+        std::list<QString> usageOrder;  /*!< Ключи от недавно использованных к давно не использовавшимся */
+        qsizetype memoryUsage = 0;      /*!< Объём памяти записей сегмента */
+    };
+
+    /*!
+     * \brief Получение сегмента по ключу
+     */
+    Shard* shardFor(const QString& key) const;
+
+    /*!
+     * \brief Приблизительный объём памяти записи
+     */
+    static qsizetype estimateSize(const QString& key, const CachedExplanation& value);
+
+    /*!
+     * \brief Проверка, прервано ли вычисление результата; такой результат не кэшируется
+     */
+    static bool isCancelled(const CachedExplanation& value);
+
+    QList<Shard*> shards; ///< Сегменты
+    qsizetype shardBudget; ///< Бюджет памяти одного сегмента
+    std::atomic<qint64> hitCount; ///< Количество попаданий
+    std::atomic<qint64> missCount; ///< Количество промахов
+    std::atomic<qint64> evictionCount; ///< Количество вытесненных записей
+    SingleFlight<CachedExplanation> inFlight; ///< Вычисляемые в данный момент результаты
+};
+
+#endif // EXPLANATIONCACHE_H
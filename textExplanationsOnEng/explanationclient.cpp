@@ -0,0 +1,64 @@
+#include "explanationclient.h"
+
+#ifdef Q_OS_UNIX
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+ExplanationClient::ExplanationClient()
+    : fd(-1)
+{}
+
+ExplanationClient::~ExplanationClient()
+{
+    close();
+}
+
+bool ExplanationClient::connectTo(const QString &socketPath)
+{
+#ifdef Q_OS_UNIX
+    close();
+    QByteArray path = socketPath.toLocal8Bit();
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= qsizetype(sizeof(address.sun_path))) return false;
+    memcpy(address.sun_path, path.constData(), path.size());
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(socketPath);
+    return false;
+#endif
+}
+
+bool ExplanationClient::send(const ServerRequest &request)
+{
+    return fd >= 0 && ServerProtocol::writeFrame(fd, ServerProtocol::encodeRequest(request));
+}
+
+bool ExplanationClient::receive(ServerResponse &response)
+{
+    QByteArray payload;
+    return fd >= 0 && ServerProtocol::readFrame(fd, payload) && ServerProtocol::decodeResponse(payload, response);
+}
+
+bool ExplanationClient::request(const ServerRequest &request, ServerResponse &response)
+{
+    return send(request) && receive(response);
+}
+
+void ExplanationClient::close()
+{
+#ifdef Q_OS_UNIX
+    if (fd >= 0) ::close(fd);
+#endif
+    fd = -1;
+}
@@ -0,0 +1,58 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ExplanationClient — клиента сервера объяснений
+ */
+
+#ifndef EXPLANATIONCLIENT_H
+#define EXPLANATIONCLIENT_H
+
+#include "serverprotocol.h"
+
+#include <QString>
+
+/*!
+ * \brief Клиент сервера объяснений: одно соединение, запросы по очереди
+ *
+ * Используется тестами сервера и генератором нагрузки. Доступен только на Unix-системах.
+ */
+class ExplanationClient
+{
+public:
+    ExplanationClient();
+    ~ExplanationClient();
+
+    ExplanationClient(const ExplanationClient&) = delete;
+    ExplanationClient& operator=(const ExplanationClient&) = delete;
+
+    /*!
+     * \brief Подключение к серверу
+     * \param[in] socketPath Путь к сокету сервера
+     * \return true, если соединение установлено
+     */
+    bool connectTo(const QString& socketPath);
+
+    /*!
+     * \brief Отправка запроса без ожидания ответа
+     */
+    bool send(const ServerRequest& request);
+
+    /*!
+     * \brief Получение ответа на отправленный запрос
+     */
+    bool receive(ServerResponse& response);
+
+    /*!
+     * \brief Отправка запроса и получение ответа
+     */
+    bool request(const ServerRequest& request, ServerResponse& response);
+
+    /*!
+     * \brief Закрытие соединения
+     */
+    void close();
+
+private:
+    int fd; ///< Дескриптор соединения
+};
+
+#endif // EXPLANATIONCLIENT_H
@@ -0,0 +1,410 @@
+#include "explanationserver.h"
+#include "expression.h"
+#include "expressiondocument.h"
+#include "expressionxmlparser.h"
+#include "teexception.h"
+#include "tracelog.h"
+
+#include <QCryptographicHash>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+int ExplanationServer::signalStopFd = -1;
+
+ExplanationServer::ExplanationServer(const QString &socketPath, int threadCount, qsizetype registryBudget)
+    : socketPath(socketPath)
+    , requestTimeoutMs(0)
+    , stats(nullptr)
+    , listenFd(-1)
+    , stopPipe{-1, -1}
+    , wakePipe{-1, -1}
+    , registry(registryBudget)
+{
+    if (threadCount > 0) threadPool.setMaxThreadCount(threadCount);
+}
+
+// Ответ с ошибками разбора или объяснения
+static ServerResponse errorResponse(const QList<TEException>& errors) {
+    ServerResponse response;
+    response.status = ResponseStatus::Errors;
+    for (const TEException& error : errors) {
+        response.texts.append(error.what());
+    }
+    return response;
+}
+
+// Ответ о нарушении протокола
+static ServerResponse badRequest(const QString& message) {
+    ServerResponse response;
+    response.status = ResponseStatus::BadRequest;
+    response.texts.append(message);
+    return response;
+}
+
+QList<ServerResponse> ExplanationServer::handleRequest(const ServerRequest &request)
+{
+    switch (request.type) {
+    case RequestType::Document:
+        if (request.fields.size() != 1) break;
+        return {explainDocument(request.fields[0])};
+    case RequestType::Schema:
+        if (request.fields.size() != 1) break;
+        return {registerSchema(request.fields[0])};
+    case RequestType::Expressions:
+        if (request.fields.size() < 2) break;
+        return explainExpressions(request.fields[0], request.fields.mid(1));
+    }
+    return {badRequest("unknown request type or wrong number of fields")};
+}
+
+void ExplanationServer::setRequestTimeout(qint64 timeoutMs)
+{
+    requestTimeoutMs = timeoutMs;
+}
+
+void ExplanationServer::setStatsAggregate(StatsAggregate *newStats)
+{
+    stats = newStats;
+}
+
+SchemaRegistry &ExplanationServer::getSchemaRegistry()
+{
+    return registry;
+}
+
+ExplanationCache &ExplanationServer::getExplanationCache()
+{
+    return cache;
+}
+
+qint64 ExplanationServer::getCoalescedDocumentCount() const
+{
+    return documentsInFlight.getCoalescedCount();
+}
+
+// Проверка, прервано ли объяснение по сроку
+static bool isCancelled(const TEResult<QString>& result) {
+    for (const TEException& error : result.getErrors()) {
+        if (error.getErrorType() == ErrorType::Cancelled) return true;
+    }
+    return false;
+}
+
+ServerResponse ExplanationServer::explainDocument(const QString &xmlContent)
+{
+    QString key = QString::fromLatin1(QCryptographicHash::hash(xmlContent.toUtf8(), QCryptographicHash::Sha256).toHex());
+    // Срок отсчитывается от получения запроса, в том числе для запроса, ожидающего чужого объяснения
+    CancellationToken cancellation(requestTimeoutMs > 0 ? requestTimeoutMs : -1);
+    const std::function<TEResult<QString>()> compute = [this, &xmlContent, &cancellation]() -> TEResult<QString> {
+        ExpressionDocument document;
+        TEResult<void> read = ExpressionXmlParser::tryReadDocumentFromXMLContent(xmlContent, document, "request", &cancellation);
+        if (!read.isOk()) return read.getErrors();
+        document.setExplanationCache(&cache);
+        document.setCancellationToken(&cancellation);
+        // Потоки сервера заняты другими запросами — документ обрабатывается в одном потоке
+        TEResult<QString> explanation = document.tryGetExplanation(1);
+        if (!explanation.isOk()) return explanation.getErrors().first();
+        return explanation;
+    };
+
+    TEResult<QString> explanation = documentsInFlight.run(key, compute);
+    // Объяснение прервано по сроку другого запроса — у этого запроса свой срок
+    while (isCancelled(explanation) && !cancellation.isCancelled()) {
+        explanation = documentsInFlight.run(key, compute);
+    }
+    if (!explanation.isOk()) return errorResponse(explanation.getErrors());
+    ServerResponse response;
+    response.texts.append(explanation.value());
+    return response;
+}
+
+ServerResponse ExplanationServer::registerSchema(const QString &xmlContent)
+{
+    CancellationToken cancellation(requestTimeoutMs > 0 ? requestTimeoutMs : -1);
+    TEResult<QSharedPointer<const CompiledSchema>> schema = ExpressionXmlParser::tryReadSchemaFromXMLContent(xmlContent, "request", &cancellation);
+    if (!schema.isOk()) return errorResponse(schema.getErrors());
+    ServerResponse response;
+    response.texts.append(registry.add(schema.value()));
+    return response;
+}
+
+QList<ServerResponse> ExplanationServer::explainExpressions(const QString &handle, const QStringList &expressions)
+{
+    QSharedPointer<const CompiledSchema> schema = registry.find(handle);
+
+    // Клиент должен зарегистрировать схему заново; ответ приходит на каждое выражение
+    if (!schema) {
+        ServerResponse unknown;
+        unknown.status = ResponseStatus::UnknownHandle;
+        unknown.texts.append(handle);
+        return QList<ServerResponse>(expressions.size(), unknown);
+    }
+
+    // Схема общая для многих выражений, поэтому использование всех её элементов не проверяется
+    CancellationToken cancellation(requestTimeoutMs > 0 ? requestTimeoutMs : -1);
+    ExpressionDocument document(schema);
+    document.setExplanationCache(&cache);
+    document.setCancellationToken(&cancellation);
+    QList<ServerResponse> responses;
+    for (const QString& expression : expressions) {
+        ExpressionEntry entry;
+        entry.expression = expression;
+        ExplanationResult result = document.explain(entry, false);
+        if (result.isSuccessful()) {
+            ServerResponse response;
+            response.texts.append(result.explanation);
+            responses.append(response);
+        }
+        else {
+            responses.append(errorResponse(result.errors));
+        }
+    }
+    return responses;
+}
+
+void ExplanationServer::warmUp()
+{
+    QSharedPointer<const CompiledSchema> schema = CompiledSchema::create(
+        {{"a", Variable("a", "int", "first value")},
+         {"b", Variable("b", "int", "second value")}});
+    Expression(schema, "a b + 1 -").tryGetExplanationInEn();
+}
+
+#ifdef Q_OS_UNIX
+
+ExplanationServer::~ExplanationServer()
+{
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(socketPath.toLocal8Bit().constData());
+    }
+    if (signalStopFd == stopPipe[1]) signalStopFd = -1;
+    if (stopPipe[0] >= 0) ::close(stopPipe[0]);
+    if (stopPipe[1] >= 0) ::close(stopPipe[1]);
+    if (wakePipe[0] >= 0) ::close(wakePipe[0]);
+    if (wakePipe[1] >= 0) ::close(wakePipe[1]);
+}
+
+bool ExplanationServer::listen(QString *errorMessage)
+{
+    QByteArray path = socketPath.toLocal8Bit();
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.isEmpty() || path.size() >= qsizetype(sizeof(address.sun_path))) {
+        if (errorMessage) *errorMessage = "invalid socket path \"" + socketPath + "\"";
+        return false;
+    }
+    memcpy(address.sun_path, path.constData(), path.size());
+
+    // Запись в канал остановки не должна блокировать обработчик сигнала, а в канал возврата — поток пула
+    if (::pipe(stopPipe) != 0 || ::pipe(wakePipe) != 0) {
+        if (errorMessage) *errorMessage = QString("cannot create stop pipe: ") + strerror(errno);
+        return false;
+    }
+    ::fcntl(stopPipe[1], F_SETFL, O_NONBLOCK);
+    ::fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+    ::fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    // Сокет, оставшийся от прошлого запуска, мешает bind
+    ::unlink(path.constData());
+    if (listenFd < 0
+        || ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(listenFd, SOMAXCONN) != 0) {
+        if (errorMessage) *errorMessage = "cannot listen on \"" + socketPath + "\": " + strerror(errno);
+        if (listenFd >= 0) ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    // Статические таблицы инициализируются до первого запроса
+    warmUp();
+    return true;
+}
+
+void ExplanationServer::exec()
+{
+    if (listenFd < 0) return;
+
+    QList<int> idle;        // Соединения, ожидающие запроса
+    int busyCount = 0;      // Соединения, запрос которых обрабатывается в пуле
+    bool stopping = false;
+    while (true) {
+        {
+            QMutexLocker locker(&finishedMutex);
+            for (int clientFd : std::as_const(finishedConnections)) {
+                if (clientFd >= 0) idle.append(clientFd);
+                busyCount--;
+            }
+            finishedConnections.clear();
+        }
+
+        // После остановки ожидаются только обрабатываемые запросы; остальные соединения проверяются без ожидания
+        QList<pollfd> fds{pollfd{wakePipe[0], POLLIN, 0}};
+        if (!stopping) fds << pollfd{stopPipe[0], POLLIN, 0} << pollfd{listenFd, POLLIN, 0};
+        const qsizetype firstClient = fds.size();
+        for (int clientFd : std::as_const(idle)) {
+            fds.append(pollfd{clientFd, POLLIN, 0});
+        }
+        if (::poll(fds.data(), nfds_t(fds.size()), stopping && busyCount == 0 ? 0 : -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[0].revents) {
+            char buffer[64];
+            while (::read(wakePipe[0], buffer, sizeof(buffer)) > 0) {}
+        }
+        if (!stopping && fds[1].revents) {
+            // Новые соединения больше не принимаются
+            stopping = true;
+            ::close(listenFd);
+            ::unlink(socketPath.toLocal8Bit().constData());
+            listenFd = -1;
+        }
+        else if (!stopping && (fds[2].revents & POLLIN)) {
+            int clientFd = ::accept(listenFd, nullptr, nullptr);
+            if (clientFd >= 0) {
+                // Кадр, начатый клиентом, должен прийти целиком за разумное время
+                timeval timeout = {readTimeoutSeconds, 0};
+                ::setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                idle.append(clientFd);
+            }
+        }
+
+        // Уже отправленный клиентом запрос обрабатывается и после остановки сервера
+        bool received = false;
+        for (qsizetype i = fds.size() - 1; i >= firstClient; i--) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            const int clientFd = fds[i].fd;
+            idle.removeAt(i - firstClient);
+            busyCount++;
+            received = true;
+            threadPool.start([this, clientFd]() {
+                finishRequest(serveRequest(clientFd) ? clientFd : -1);
+            });
+        }
+        if (stopping && busyCount == 0 && !received) break;
+    }
+
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(socketPath.toLocal8Bit().constData());
+        listenFd = -1;
+    }
+    threadPool.waitForDone();
+    for (int clientFd : std::as_const(idle)) {
+        ::close(clientFd);
+    }
+    QMutexLocker locker(&finishedMutex);
+    for (int clientFd : std::as_const(finishedConnections)) {
+        if (clientFd >= 0) ::close(clientFd);
+    }
+    finishedConnections.clear();
+}
+
+void ExplanationServer::stop()
+{
+    if (stopPipe[1] >= 0) {
+        char byte = 1;
+        ssize_t written = ::write(stopPipe[1], &byte, 1);
+        Q_UNUSED(written);
+    }
+}
+
+void ExplanationServer::stopOnTerminationSignals()
+{
+    signalStopFd = stopPipe[1];
+
+    struct sigaction action = {};
+    action.sa_handler = handleTerminationSignal;
+    sigemptyset(&action.sa_mask);
+    ::sigaction(SIGTERM, &action, nullptr);
+    ::sigaction(SIGINT, &action, nullptr);
+    // Клиент, закрывший соединение до ответа, не должен завершать сервер
+    ::signal(SIGPIPE, SIG_IGN);
+}
+
+void ExplanationServer::handleTerminationSignal(int signal)
+{
+    Q_UNUSED(signal);
+    if (signalStopFd >= 0) {
+        char byte = 1;
+        ssize_t written = ::write(signalStopFd, &byte, 1);
+        Q_UNUSED(written);
+    }
+}
+
+bool ExplanationServer::serveRequest(int clientFd)
+{
+    QByteArray payload;
+    if (!ServerProtocol::readFrame(clientFd, payload)) {
+        ::close(clientFd);
+        return false;
+    }
+
+    // Время запроса отсчитывается от получения кадра целиком
+    StatsRecorder recorder;
+    StatsScope scope(stats || TraceLog::isEnabled() ? &recorder : nullptr);
+    RequestTrace trace("connection " + QString::number(clientFd), &recorder);
+    countStat(PipelineCounter::BytesIn, payload.size());
+
+    ServerRequest request;
+    QList<ServerResponse> responses;
+    if (ServerProtocol::decodeRequest(payload, request))
+        responses = handleRequest(request);
+    else
+        responses.append(badRequest("malformed request"));
+
+    bool written = true;
+    for (const ServerResponse& response : std::as_const(responses)) {
+        QByteArray frame = ServerProtocol::encodeResponse(response);
+        countStat(PipelineCounter::BytesOut, frame.size());
+        written = written && ServerProtocol::writeFrame(clientFd, frame);
+    }
+    if (stats) stats->add(recorder.sample());
+    if (!written) ::close(clientFd);
+    return written;
+}
+
+void ExplanationServer::finishRequest(int clientFd)
+{
+    QMutexLocker locker(&finishedMutex);
+    finishedConnections.append(clientFd);
+    char byte = 1;
+    ssize_t written = ::write(wakePipe[1], &byte, 1);
+    Q_UNUSED(written);
+}
+
+#else
+
+ExplanationServer::~ExplanationServer() {}
+
+bool ExplanationServer::listen(QString *errorMessage)
+{
+    if (errorMessage) *errorMessage = "server mode is available on Unix systems only";
+    return false;
+}
+
+void ExplanationServer::exec() {}
+
+void ExplanationServer::stop() {}
+
+void ExplanationServer::stopOnTerminationSignals() {}
+
+void ExplanationServer::handleTerminationSignal(int) {}
+
+bool ExplanationServer::serveRequest(int) { return false; }
+
+void ExplanationServer::finishRequest(int) {}
+
+#endif
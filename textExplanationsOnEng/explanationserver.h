@@ -0,0 +1,168 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ExplanationServer — сервера объяснений на Unix-сокете
+ */
+
+#ifndef EXPLANATIONSERVER_H
+#define EXPLANATIONSERVER_H
+
+#include "explanationcache.h"
+#include "pipelinestats.h"
+#include "schemaregistry.h"
+#include "serverprotocol.h"
+#include "singleflight.h"
+#include "teresult.h"
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+
+/*!
+ * \brief Постоянно работающий сервер объяснений на Unix domain socket
+ *
+ * Сервер принимает соединения и ожидает запросов всех соединений в вызывающем потоке, а каждый
+ * полученный запрос обрабатывает в пуле потоков. Пока запрос соединения обрабатывается, следующие
+ * запросы этого соединения не читаются, поэтому ответы приходят в порядке запросов; простаивающее
+ * соединение не занимает поток пула. После stop() (в том числе по SIGTERM) новые соединения
+ * не принимаются, уже полученные запросы дообрабатываются, после чего exec() возвращает управление.
+ * Зарегистрированные клиентами схемы хранятся в реестре и используются запросами выражений;
+ * результаты объяснения кэшируются для всех соединений. Одинаковые документы, пришедшие
+ * одновременно по разным соединениям, объясняются один раз; объяснение, прерванное по сроку
+ * первого запроса, не передаётся остальным — они объясняют документ заново в свой срок.
+ * Доступен только на Unix-системах.
+ */
+class ExplanationServer
+{
+public:
+    /*!
+     * \brief Конструктор сервера
+     * \param[in] socketPath Путь к сокету
+     * \param[in] threadCount Количество одновременно обрабатываемых запросов (0 — по числу ядер)
+     * \param[in] registryBudget Бюджет памяти реестра схем в байтах
+     */
+    explicit ExplanationServer(const QString& socketPath, int threadCount = 0,
+                               qsizetype registryBudget = SchemaRegistry::defaultMemoryBudget);
+
+    ~ExplanationServer();
+
+    ExplanationServer(const ExplanationServer&) = delete;
+    ExplanationServer& operator=(const ExplanationServer&) = delete;
+
+    /*!
+     * \brief Создание сокета и начало приёма соединений
+     * \param[out] errorMessage Описание ошибки, если сокет создать не удалось
+     * \return true, если сокет создан
+     */
+    bool listen(QString* errorMessage = nullptr);
+
+    /*!
+     * \brief Приём соединений до вызова stop(), затем ожидание завершения обрабатываемых запросов
+     */
+    void exec();
+
+    /*!
+     * \brief Остановка сервера; безопасна для вызова из любого потока и из обработчика сигнала
+     */
+    void stop();
+
+    /*!
+     * \brief Остановка сервера по сигналам SIGTERM и SIGINT
+     */
+    void stopOnTerminationSignals();
+
+    /*!
+     * \brief Установка срока обработки одного запроса
+     *
+     * Запрос, не обработанный в срок, получает ошибку ErrorType::Cancelled (для запроса Expressions —
+     * каждое не объяснённое в срок выражение).
+     * \param[in] timeoutMs Срок в миллисекундах (0 — без срока)
+     */
+    void setRequestTimeout(qint64 timeoutMs);
+
+    /*!
+     * \brief Установка сводной статистики, в которую добавляется статистика каждого запроса
+     * \param[in] newStats Сводная статистика (nullptr — не собирать); принадлежит вызывающей стороне
+     */
+    void setStatsAggregate(StatsAggregate* newStats);
+
+    /*!
+     * \brief Обработка одного запроса
+     * \param[in] request Запрос
+     * \return Ответы: один, а для запроса Expressions — по одному на выражение
+     */
+    QList<ServerResponse> handleRequest(const ServerRequest& request);
+
+    /*!
+     * \brief Получение реестра схем
+     */
+    SchemaRegistry& getSchemaRegistry();
+
+    /*!
+     * \brief Получение кэша результатов объяснения
+     */
+    ExplanationCache& getExplanationCache();
+
+    /*!
+     * \brief Получение количества запросов документов, получивших результат одновременного одинакового запроса
+     */
+    qint64 getCoalescedDocumentCount() const;
+
+private:
+    /*!
+     * \brief Объяснение XML-документа
+     */
+    ServerResponse explainDocument(const QString& xmlContent);
+
+    /*!
+     * \brief Регистрация схемы из XML-документа
+     */
+    ServerResponse registerSchema(const QString& xmlContent);
+
+    /*!
+     * \brief Объяснение выражений над зарегистрированной схемой
+     */
+    QList<ServerResponse> explainExpressions(const QString& handle, const QStringList& expressions);
+
+    /*!
+     * \brief Чтение и обработка одного запроса соединения
+     * \param[in] clientFd Дескриптор соединения, в котором есть данные для чтения
+     * \return false, если соединение закрыто клиентом или ответ не отправлен
+     */
+    bool serveRequest(int clientFd);
+
+    /*!
+     * \brief Возврат соединения в ожидание запросов после обработки запроса
+     * \param[in] clientFd Дескриптор соединения (-1 — соединение закрыто)
+     */
+    void finishRequest(int clientFd);
+
+    /*!
+     * \brief Прогрев статических таблиц разбора и перевода пробным объяснением
+     */
+    static void warmUp();
+
+    /*!
+     * \brief Обработчик сигналов завершения
+     */
+    static void handleTerminationSignal(int signal);
+
+    static const int readTimeoutSeconds = 30; ///< Максимальное ожидание окончания начатого кадра
+
+    static int signalStopFd; ///< Конец канала остановки, в который пишет обработчик сигнала
+
+    QString socketPath; ///< Путь к сокету
+    qint64 requestTimeoutMs; ///< Срок обработки одного запроса (0 — без срока)
+    StatsAggregate* stats; ///< Сводная статистика запросов
+    int listenFd; ///< Дескриптор принимающего сокета
+    int stopPipe[2]; ///< Канал остановки: запись в stopPipe[1] будит exec()
+    int wakePipe[2]; ///< Канал возврата соединений: запись в wakePipe[1] будит exec()
+    QMutex finishedMutex; ///< Защита finishedConnections
+    QList<int> finishedConnections; ///< Соединения, запрос которых обработан (-1 — закрытое соединение)
+    QThreadPool threadPool; ///< Потоки обработки запросов
+    SchemaRegistry registry; ///< Зарегистрированные схемы
+    ExplanationCache cache; ///< Результаты объяснения
+    SingleFlight<TEResult<QString>> documentsInFlight; ///< Объясняемые в данный момент документы
+};
+
+#endif // EXPLANATIONSERVER_H
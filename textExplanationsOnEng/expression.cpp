@@ -1,6 +1,8 @@
 #include "expression.h"
 #include "expressionxmlparser.h"
 #include "expressiontranslator.h"
+#include "pipelinestats.h"
+#include "treeprofiler.h"
 
 void Expression::setExpression(const QString &newExpression)
 {
@@ -12,108 +14,132 @@ const QString* Expression::getExpression() const
     return &expression;
 }
 
+const QSharedPointer<const CompiledSchema>& Expression::getSchema() const
+{
+    return schema;
+}
+
+void Expression::setSchema(const QSharedPointer<const CompiledSchema> &newSchema)
+{
+    schema = newSchema ? newSchema : CompiledSchema::empty();
+}
+
+const CancellationToken *Expression::getCancellationToken() const
+{
+    return cancellation;
+}
+
+void Expression::setCancellationToken(const CancellationToken *newCancellation)
+{
+    cancellation = newCancellation;
+}
+
 const QHash<QString, Variable>* Expression::getVariables() const
 {
-    return &variables;
+    return &schema->getVariables();
 }
 
 void Expression::setVariables(const QHash<QString, Variable> &newVariables)
 {
-    variables = newVariables;
+    schema = CompiledSchema::create(newVariables, schema->getFunctions(), schema->getUnions(), schema->getStructures(), schema->getClasses(), schema->getEnums(), schema->getStringPool());
 }
 
-const Variable Expression::getVarByName(const QString &name) const
+const Variable& Expression::getVarByName(const QString &name) const
 {
-    return getVariables()->value(name);
+    return schema->getVarByName(name);
 }
 
 const QHash<QString, Function>* Expression::getFunctions() const
 {
-    return &functions;
+    return &schema->getFunctions();
 }
 
 void Expression::setFunctions(const QHash<QString, Function> &newFunctions)
 {
-    functions = newFunctions;
+    schema = CompiledSchema::create(schema->getVariables(), newFunctions, schema->getUnions(), schema->getStructures(), schema->getClasses(), schema->getEnums(), schema->getStringPool());
 }
 
-const Function Expression::getFuncByName(const QString &name) const
+const Function& Expression::getFuncByName(const QString &name) const
 {
-    return getFunctions()->value(name);
+    return schema->getFuncByName(name);
 }
 
 const QHash<QString, Union>* Expression::getUnions() const
 {
-    return &unions;
+    return &schema->getUnions();
 }
 
 void Expression::setUnions(const QHash<QString, Union> &newUnions)
 {
-    unions = newUnions;
+    schema = CompiledSchema::create(schema->getVariables(), schema->getFunctions(), newUnions, schema->getStructures(), schema->getClasses(), schema->getEnums(), schema->getStringPool());
 }
 
-const Union Expression::getUnionByName(const QString &name) const
+const Union& Expression::getUnionByName(const QString &name) const
 {
-    return getUnions()->value(name);
+    return schema->getUnionByName(name);
 }
 
 const QHash<QString, Structure>* Expression::getStructures() const
 {
-    return &structures;
+    return &schema->getStructures();
 }
 
 void Expression::setStructures(const QHash<QString, Structure> &newStructures)
 {
-    structures = newStructures;
+    schema = CompiledSchema::create(schema->getVariables(), schema->getFunctions(), schema->getUnions(), newStructures, schema->getClasses(), schema->getEnums(), schema->getStringPool());
 }
 
-const Structure Expression::getStructByName(const QString &name) const
+const Structure& Expression::getStructByName(const QString &name) const
 {
-    return getStructures()->value(name);
+    return schema->getStructByName(name);
 }
 
 const QHash<QString, Class>* Expression::getClasses() const
 {
-    return &classes;
+    return &schema->getClasses();
 }
 
 void Expression::setClasses(const QHash<QString, Class> &newClasses)
 {
-    classes = newClasses;
+    schema = CompiledSchema::create(schema->getVariables(), schema->getFunctions(), schema->getUnions(), schema->getStructures(), newClasses, schema->getEnums(), schema->getStringPool());
 }
 
-const Class Expression::getClassByName(const QString &name) const
+const Class& Expression::getClassByName(const QString &name) const
 {
-    return getClasses()->value(name);
+    return schema->getClassByName(name);
 }
 
 const QHash<QString, Enum>* Expression::getEnums() const
 {
-    return &enums;
+    return &schema->getEnums();
 }
 
 void Expression::setEnums(const QHash<QString, Enum> &newEnums)
 {
-    enums = newEnums;
+    schema = CompiledSchema::create(schema->getVariables(), schema->getFunctions(), schema->getUnions(), schema->getStructures(), schema->getClasses(), newEnums, schema->getStringPool());
 }
 
-const Enum Expression::getEnumByName(const QString &name) const
+const Enum& Expression::getEnumByName(const QString &name) const
 {
-    return getEnums()->value(name);
+    return schema->getEnumByName(name);
 }
 
-const Variable Expression::getVariableByNameFromCustomData(QString varName, QString dataName) const
+const Variable& Expression::getVariableByNameFromCustomData(const QString& varName, const QString& dataName) const
 {
+    static const Variable notFound;
     // Получить пользовательский тип данных по его имени
-    CustomTypeWithFields customType = getCustomTypeByName(dataName);
-    return customType.variables.value(varName);
+    const CustomTypeWithFields& customType = getCustomTypeByName(dataName);
+    auto it = customType.variables.constFind(varName);
+    return it != customType.variables.cend() ? it.value() : notFound;
 }
 
-const Function Expression::getFunctionByNameFromCustomData(QString funcName, QString dataName) const
+const Function& Expression::getFunctionByNameFromCustomData(const QString& funcName, const QString& dataName) const
 {
+    static const Function notFound;
     // Получить пользовательский тип данных по его имени
-    CustomTypeWithFields customType = getCustomTypeByName(dataName);
-    return customType.functions.value(funcName);
+    const CustomTypeWithFields& customType = getCustomTypeByName(dataName);
+    auto it = customType.functions.constFind(funcName);
+    return it != customType.functions.cend() ? it.value() : notFound;
 }
 
 bool Expression::isEnumValue(const QString &value, const QString &enumName) const
@@ -123,19 +149,9 @@ bool Expression::isEnumValue(const QString &value, const QString &enumName) cons
     return ok;
 }
 
-const CustomTypeWithFields Expression::getCustomTypeByName(const QString &typeName) const
+const CustomTypeWithFields& Expression::getCustomTypeByName(const QString &typeName) const
 {
-    CustomTypeWithFields type;
-    if (classes.contains(typeName)) {
-        type = classes.value(typeName);
-    }
-    else if (structures.contains(typeName)) {
-        type = structures.value(typeName);
-    }
-    else if (unions.contains(typeName)) {
-        type = unions.value(typeName);
-    }
-    return type;
+    return schema->getCustomTypeByName(typeName);
 }
 
 Expression Expression::fromFile(const QString &path)
@@ -145,24 +161,9 @@ Expression Expression::fromFile(const QString &path)
     return expr;
 }
 
-QSet<QString> Expression::getCustomDataTypes() const
+const QSet<QString>& Expression::getCustomDataTypes() const
 {
-    QSet<QString> customDataTypes;
-
-    for (auto it = unions.cbegin(); it != unions.cend(); ++it) {
-        customDataTypes.insert(it.value().name);
-    }
-    for (auto it = structures.cbegin(); it != structures.cend(); ++it) {
-        customDataTypes.insert(it.value().name);
-    }
-    for (auto it = classes.cbegin(); it != classes.cend(); ++it) {
-        customDataTypes.insert(it.value().name);
-    }
-    for (auto it = enums.cbegin(); it != enums.cend(); ++it) {
-        customDataTypes.insert(it.value().name);
-    }
-
-    return customDataTypes;
+    return schema->getCustomDataTypes();
 }
 
 
@@ -171,42 +172,42 @@ QString Expression::ToQstring()
     QString result = "Expression:   "  + this->expression;
 
     result += "\nVariables:";
-    QHashIterator itV(this->variables);
+    QHashIterator itV(schema->getVariables());
     while(itV.hasNext()) {
         Variable val = itV.next().value();
         result += "\n" + val.toQString("    ");
     }
 
     result += "\nFunctions:";
-    QHashIterator itF(this->functions);
+    QHashIterator itF(schema->getFunctions());
     while(itF.hasNext()) {
         Function func = itF.next().value();
         result += "\n" + func.toQString("    ");
     }
 
     result += "\nUnions:";
-    QHashIterator itU(this->unions);
+    QHashIterator itU(schema->getUnions());
     while(itU.hasNext()) {
         Union _union = itU.next().value();
         result += "\n" + _union.toQString("    ");
     }
 
     result += "\nStructures:";
-    QHashIterator itS(this->structures);
+    QHashIterator itS(schema->getStructures());
     while(itS.hasNext()) {
         Structure structure = itS.next().value();
         result += "\n" + structure.toQString("    ");
     }
 
     result += "\nClasses:";
-    QHashIterator itC(this->classes);
+    QHashIterator itC(schema->getClasses());
     while(itC.hasNext()) {
         Class _class = itC.next().value();
         result += "\n" + _class.toQString("    ");
     }
 
     result += "\nEnums:";
-    QHashIterator itE(this->enums);
+    QHashIterator itE(schema->getEnums());
     while(itE.hasNext()) {
         Enum _enum = itE.next().value();
         result += "\n" + _enum.toQString("    ");
@@ -215,20 +216,48 @@ QString Expression::ToQstring()
     return result;
 }
 
+// Подстановка аргументов в шаблон объяснения; ошибка подстановки добавляется в список ошибок
+static QString translate(const QString& description, const QList<QString>& arguments, QList<TEException>& errors)
+{
+    if (!errors.isEmpty()) return "";
+    TEResult<QString> explanation = ExpressionTranslator::tryGetExplanation(description, arguments);
+    if (!explanation.isOk()) {
+        errors.append(explanation.getErrors());
+        return "";
+    }
+    return explanation.value();
+}
+
 QString Expression::ToExplanation(const ExpressionNode *node, QString &intermediateDescription, const QString& className, OperationType parentOperType) const
 {
+    QList<TEException> errors;
+    QString description = explainNode(node, intermediateDescription, className, parentOperType, errors);
+    if (!errors.isEmpty()) throw errors.first();
+    return description;
+}
+
+QString Expression::explainNode(const ExpressionNode *node, QString &intermediateDescription, const QString& className, OperationType parentOperType, QList<TEException>& errors) const
+{
+    // Объяснение прекращается после первой ошибки
+    if (!errors.isEmpty()) return "";
+    if (cancellation && cancellation->isCancelled()) {
+        errors.append(TEException(ErrorType::Cancelled));
+        return "";
+    }
+
     QString description = "";
     QString descOfRightNode = "";
     QString descOfLeftNode = "";
+    NodeProfileTimer profileTimer(node);
 
     if(node->getNodeType() == EntityType::Operation) {
-        description = handleOperationNode(node, intermediateDescription, className, parentOperType, descOfLeftNode, descOfRightNode);
+        description = handleOperationNode(node, intermediateDescription, className, parentOperType, descOfLeftNode, descOfRightNode, errors);
     }
     else if(node->getNodeType() == EntityType::Const) {
         description = handleConstNode(node);
     }
     else if(node->getNodeType() == EntityType::Function) {
-        description = handleFunctionNode(node, intermediateDescription, className);
+        description = handleFunctionNode(node, intermediateDescription, className, errors);
     }
     else if(node->getNodeType() == EntityType::Variable) {
         description = handleVariableNode(node, className, parentOperType);
@@ -237,65 +266,66 @@ QString Expression::ToExplanation(const ExpressionNode *node, QString &intermedi
         description = "";
     }
     else {
-        throw TEException(ErrorType::UnidentifedType, QList<QString>{node->getDataType()});
+        errors.append(TEException(ErrorType::UnidentifedType, QList<QString>{node->getDataType()}));
+        return "";
     }
 
     if(!intermediateDescription.isEmpty() && parentOperType == OperationType::None) {
-        description = ExpressionTranslator::getExplanation(intermediateDescription, QList<QString>{"", description});
+        description = translate(intermediateDescription, QList<QString>{"", description}, errors);
     }
 
-    return description;
+    return profileTimer.finish(description);
 }
 
-QString Expression::handleOperationNode(const ExpressionNode *node, QString &intermediateDescription, const QString& className, OperationType parentOperType, QString &descOfLeftNode, QString &descOfRightNode) const
+QString Expression::handleOperationNode(const ExpressionNode *node, QString &intermediateDescription, const QString& className, OperationType parentOperType, QString &descOfLeftNode, QString &descOfRightNode, QList<TEException> &errors) const
 {
     QString description = "";
 
     if(node->isReducibleUnarySelfInverse())
     {
-        description = ToExplanation(node->getLeftNode()->getLeftNode(), intermediateDescription, "", node->getOperType());
+        description = explainNode(node->getLeftNode()->getLeftNode(), intermediateDescription, "", node->getOperType(), errors);
     }
     else if(node->getOperType() == OperationType::Not && node->getLeftNode()->isComparisonOperation())
     {
-        description = ToExplanation(node->getLeftNode(), intermediateDescription, "", node->getOperType());
+        description = explainNode(node->getLeftNode(), intermediateDescription, "", node->getOperType(), errors);
     }
     else if(node->isIncrementOrDecrement())
     {
-        description = ToExplanation(node->getLeftNode(), intermediateDescription, "", node->getOperType());
+        description = explainNode(node->getLeftNode(), intermediateDescription, "", node->getOperType(), errors);
         if(intermediateDescription == "")
         {
             if (parentOperType != OperationType::None){
-                intermediateDescription = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(node->getOperType()), QList<QString>{description, "{2}"});
+                intermediateDescription = translate(ExpressionTranslator::Templates.value(node->getOperType()), QList<QString>{description, "{2}"}, errors);
             }
             else {
                 if(node->getOperType() == OperationType::PostfixIncrement || node->getOperType() == OperationType::PrefixIncrement)
-                    intermediateDescription = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::SingleIncrement), QList<QString>{description});
+                    intermediateDescription = translate(ExpressionTranslator::Templates.value(OperationType::SingleIncrement), QList<QString>{description}, errors);
                 else if(node->getOperType() == OperationType::PostfixDecrement || node->getOperType() == OperationType::PrefixDecrement)
-                    intermediateDescription = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::SingleDecrement), QList<QString>{description});
+                    intermediateDescription = translate(ExpressionTranslator::Templates.value(OperationType::SingleDecrement), QList<QString>{description}, errors);
             }
         }
         else {
-            QString nestedDescription = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(node->getOperType()), QList<QString>{description, "{2}"});
-            intermediateDescription = ExpressionTranslator::getExplanation(intermediateDescription, QList<QString>{"", nestedDescription});
+            QString nestedDescription = translate(ExpressionTranslator::Templates.value(node->getOperType()), QList<QString>{description, "{2}"}, errors);
+            intermediateDescription = translate(intermediateDescription, QList<QString>{"", nestedDescription}, errors);
         }
     }
     else
     {
-        descOfLeftNode = ToExplanation(node->getLeftNode(), intermediateDescription, "" , node->getOperType());
+        descOfLeftNode = explainNode(node->getLeftNode(), intermediateDescription, "" , node->getOperType(), errors);
 
         if(node->getOperType() == OperationType::FieldAccess)
-            descOfRightNode = ToExplanation(node->getRightNode(), intermediateDescription, node->getLeftNode()->getDataType(), node->getOperType());
+            descOfRightNode = explainNode(node->getRightNode(), intermediateDescription, node->getLeftNode()->getDataType(), node->getOperType(), errors);
         else if(node->getOperType() == OperationType::StaticMemberAccess)
-            descOfRightNode = ToExplanation(node->getRightNode(), intermediateDescription, node->getLeftNode()->getValue(), node->getOperType());
+            descOfRightNode = explainNode(node->getRightNode(), intermediateDescription, node->getLeftNode()->getValue(), node->getOperType(), errors);
         else if(node->getRightNode() != nullptr)
-            descOfRightNode = ToExplanation(node->getRightNode(), intermediateDescription, "", node->getOperType());
+            descOfRightNode = explainNode(node->getRightNode(), intermediateDescription, "", node->getOperType(), errors);
 
         if(description.isEmpty()){
             if(parentOperType == node->getOperType()){
                 if(node->getOperType() == OperationType::Subtraction && node->getLeftNode()->getOperType() != OperationType::Subtraction && node->getRightNode()->getOperType() != OperationType::Subtraction)
-                    description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::SubtractionSequence), QList<QString>{descOfLeftNode, descOfRightNode});
+                    description = translate(ExpressionTranslator::Templates.value(OperationType::SubtractionSequence), QList<QString>{descOfLeftNode, descOfRightNode}, errors);
                 else if(node->getOperType() == OperationType::Division && node->getLeftNode()->getOperType() != OperationType::Division && node->getRightNode()->getOperType() != OperationType::Division)
-                    description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::DivisionSequence), QList<QString>{descOfLeftNode, descOfRightNode});
+                    description = translate(ExpressionTranslator::Templates.value(OperationType::DivisionSequence), QList<QString>{descOfLeftNode, descOfRightNode}, errors);
                 else
                     description = descOfLeftNode + ", " + descOfRightNode;
             }
@@ -303,15 +333,15 @@ QString Expression::handleOperationNode(const ExpressionNode *node, QString &int
                      (node->getOperType() == OperationType::Division && node->getLeftNode()->getOperType() == OperationType::Division))
                 description = descOfLeftNode + ", " + descOfRightNode;
             else if(node->getOperType() == OperationType::Dereference && node->getLeftNode()->getNodeType() == EntityType::Operation)
-                description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::PointerIndexAccess), QList<QString>{descOfLeftNode, descOfRightNode});
+                description = translate(ExpressionTranslator::Templates.value(OperationType::PointerIndexAccess), QList<QString>{descOfLeftNode, descOfRightNode}, errors);
             else if(node->isComparisonOperation() && parentOperType == OperationType::Not)
-                description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(InverseComparisonOperationsMap.value(node->getOperType())), QList<QString>{descOfLeftNode, descOfRightNode});
+                description = translate(ExpressionTranslator::Templates.value(InverseComparisonOperationsMap.value(node->getOperType())), QList<QString>{descOfLeftNode, descOfRightNode}, errors);
             else
             {
                 if(node->getLeftNode()->getDataType() == "string" && node->getLeftNode()->getDataType() == node->getRightNode()->getDataType() && node->getOperType() == OperationType::Addition)
-                    description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::Concatenation), QList<QString>{descOfLeftNode, descOfRightNode});
+                    description = translate(ExpressionTranslator::Templates.value(OperationType::Concatenation), QList<QString>{descOfLeftNode, descOfRightNode}, errors);
                 else
-                    description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(node->getOperType()), QList<QString>{descOfLeftNode, descOfRightNode});
+                    description = translate(ExpressionTranslator::Templates.value(node->getOperType()), QList<QString>{descOfLeftNode, descOfRightNode}, errors);
             }
         }
     }
@@ -324,7 +354,7 @@ QString Expression::handleConstNode(const ExpressionNode *node) const
     return node->getValue();
 }
 
-QString Expression::handleFunctionNode(const ExpressionNode *node, QString &intermediateDescription, const QString& className) const
+QString Expression::handleFunctionNode(const ExpressionNode *node, QString &intermediateDescription, const QString& className, QList<TEException> &errors) const
 {
     QString description;
     if(!className.isEmpty()){
@@ -334,7 +364,7 @@ QString Expression::handleFunctionNode(const ExpressionNode *node, QString &inte
         description = this->getFuncByName(node->getValue()).description;
     }
     if(node->getFunctionArgs()->count()){
-        description = ExpressionTranslator::getExplanation(description, argsToDescr(node->getFunctionArgs(), intermediateDescription, "", OperationType::FunctionCall));
+        description = translate(description, argsToDescr(node->getFunctionArgs(), intermediateDescription, "", OperationType::FunctionCall, errors), errors);
     }
     return description;
 }
@@ -357,22 +387,47 @@ QString Expression::handleVariableNode(const ExpressionNode *node, const QString
 }
 
 
-QString Expression::getExplanationInEn()
+QString Expression::getExplanationInEn(QSet<QString>* usedElements)
+{
+    TEResult<QString> explanation = tryGetExplanationInEn(usedElements);
+    explanation.throwFirstIfFailed();
+    return explanation.value();
+}
+
+TEResult<QString> Expression::tryGetExplanationInEn(QSet<QString>* usedElements)
 {
     //...Считать что объяснение пустое
     QString explanation = "";
     if(!this->getExpression()->isEmpty() || !this->getAllNames().isEmpty()){
         // Преобразовать выражение в дерево
-        const ExpressionNode* explanationTree = this->expressionToNodes();
-        // Получить объяснение выражения
-        QString hui = "";
-        explanation = this->ToExplanation(explanationTree, hui);
+        TEResult<ExpressionNode*> explanationTree = this->tryExpressionToNodes(usedElements);
+        if (!explanationTree.isOk()) return explanationTree.getErrors();
+        // Получить объяснение выражения; дерево освобождается и при ошибке
+        QList<TEException> errors;
+        QString intermediateDescription = "";
+        {
+            StageTimer timer(PipelineStage::Render);
+            explanation = this->explainNode(explanationTree.value(), intermediateDescription, "", OperationType::None, errors);
+        }
+        delete explanationTree.value();
+        if (!errors.isEmpty()) return errors;
     }
     // Удалить дубликаты слов в полученном выражении
+    StageTimer timer(PipelineStage::Dedupe);
     explanation = removeConsecutiveDuplicates(explanation);
     return explanation;
 }
 
+TEResult<void> Expression::tryValidate(QSet<QString>* usedElements)
+{
+    // Пустое выражение без элементов схемы корректно — так же, как в tryGetExplanationInEn
+    if(this->getExpression()->isEmpty() && this->getAllNames().isEmpty()) return {};
+    TEResult<ExpressionNode*> tree = this->tryExpressionToNodes(usedElements);
+    if (!tree.isOk()) return tree.getErrors();
+    delete tree.value();
+    return {};
+}
+
 QStringList Expression::splitExpression(const QString &str) {
     QStringList tokens;
     QString currentToken;
@@ -417,53 +472,89 @@ QString Expression::sanitizeDataType(const QString& dataType) {
     return dataType;
 }
 
-ExpressionNode* Expression::expressionToNodes() {
-    QSet<QString> customDataTypes = getCustomDataTypes();
+ExpressionNode* Expression::expressionToNodes(QSet<QString>* usedElements) {
+    TEResult<ExpressionNode*> tree = tryExpressionToNodes(usedElements);
+    tree.throwFirstIfFailed();
+    return tree.value();
+}
+
+// Освободить узлы, оставшиеся в стеке после ошибки
+static void deleteStack(QStack<ExpressionNode*>& nodeStack)
+{
+    qDeleteAll(nodeStack);
+    nodeStack.clear();
+}
+
+TEResult<ExpressionNode*> Expression::tryExpressionToNodes(QSet<QString>* usedElements) {
+    StageTimer timer(PipelineStage::BuildTree);
+    const QSet<QString>& customDataTypes = getCustomDataTypes();
     // Разделяем выражение на лексемы
     QStringList tokens = splitExpression(*this->getExpression());
+    countStat(PipelineCounter::Tokens, tokens.size());
     //...Считаем, что стек узлов пустой
     QStack<ExpressionNode*> nodeStack;
     //...Считаем что количество операций = 0
     int operationCounter = 0;
     //...Считаем что ни один элемент не использован
-    QSet<QString> usedElements;
+    QSet<QString> localUsedElements;
+    QSet<QString>& used = usedElements ? *usedElements : localUsedElements;
 
     // Иначе если выражение было пустым, то дерева нет
     if(expression.isEmpty()) return new ExpressionNode();
+    // Выражение из одних пробельных символов не содержит лексем — ошибка, как для пустого элемента <expression>
+    if(tokens.isEmpty()) return TEException(ErrorType::EmptyElementValue, QList<QString>{"expression"});
 
     QStringList::const_iterator i;
     // Для каждой лексемы и пока количество операций не превышает 20
     for (i = tokens.constBegin(); i != tokens.constEnd() && operationCounter <= 20; i++) {
+        // Отменённое построение освобождает уже построенные поддеревья
+        if (cancellation && cancellation->isCancelled()) {
+            deleteStack(nodeStack);
+            return TEException(ErrorType::Cancelled);
+        }
         // Получить тип лексемы
-        EntityType nodeType = getEntityTypeByStr(*i);
+        TEResult<EntityType> nodeType = tryGetEntityTypeByStr(*i);
+        if (!nodeType.isOk()) {
+            deleteStack(nodeStack);
+            return nodeType.getErrors();
+        }
 
-        if (nodeType == EntityType::Operation) {
-            processOperation(*i, nodeStack, operationCounter, tokens, i);
+        TEResult<void> processed;
+        if (nodeType.value() == EntityType::Operation) {
+            processed = processOperation(*i, nodeStack, operationCounter, tokens, i);
         }
-        else if (nodeType == EntityType::Const) {
+        else if (nodeType.value() == EntityType::Const) {
             processConst(*i, nodeStack);
         }
-        else if (nodeType == EntityType::Variable) {
-            processVariable(*i, nodeStack, usedElements, customDataTypes, tokens, i);
+        else if (nodeType.value() == EntityType::Variable) {
+            processed = processVariable(*i, nodeStack, used, customDataTypes, tokens, i);
         }
-        else if (nodeType == EntityType::Enum) {
-            processEnum(*i, nodeStack, usedElements);
+        else if (nodeType.value() == EntityType::Enum) {
+            processEnum(*i, nodeStack, used);
         }
-        else if (nodeType == EntityType::Function) {
-            processFunction(*i, nodeStack, customDataTypes, usedElements, tokens, i);
+        else if (nodeType.value() == EntityType::Function) {
+            processed = processFunction(*i, nodeStack, customDataTypes, used, tokens, i);
         }
-        else if (nodeType == EntityType::Undefined || nodeType == EntityType::CustomTypeWithFields) {
-            throw TEException(ErrorType::UndefinedId, QList<QString>{*i});
+        else if (nodeType.value() == EntityType::Undefined || nodeType.value() == EntityType::CustomTypeWithFields) {
+            processed = TEException(ErrorType::UndefinedId, QList<QString>{*i});
         }
-    }
 
-    finalizeNodeProcessing(nodeStack, *this->getExpression(), operationCounter, usedElements);
+        if (!processed.isOk()) {
+            deleteStack(nodeStack);
+            return processed.getErrors();
+        }
+    }
 
+    TEResult<void> finalized = finalizeNodeProcessing(nodeStack, *this->getExpression(), operationCounter, used, usedElements == nullptr);
+    if (!finalized.isOk()) {
+        deleteStack(nodeStack);
+        return finalized.getErrors();
+    }
 
     return nodeStack.pop();
 }
 
-void Expression::processOperation(const QString& token, QStack<ExpressionNode*>& nodeStack, int& operationCounter, const QStringList& tokens, QStringList::const_iterator i) {
+TEResult<void> Expression::processOperation(const QString& token, QStack<ExpressionNode*>& nodeStack, int& operationCounter, const QStringList& tokens, QStringList::const_iterator i) {
     // Увеличить счетчик операций
     operationCounter++;
     OperationType operType = getOperationTypeByStr(token);
@@ -479,7 +570,7 @@ void Expression::processOperation(const QString& token, QStack<ExpressionNode*>&
         OperationType newOperType = getOperationTypeByStr(*(i + 1));
         if ((newOperType == OperationType::PostfixIncrement || newOperType == OperationType::PrefixIncrement ||
              newOperType == OperationType::PostfixDecrement || newOperType == OperationType::PrefixDecrement))
-            throw TEException(ErrorType::MultipleIncrementDecrement, QList<QString>{nodeStack.top()->getValue()});
+            return TEException(ErrorType::MultipleIncrementDecrement, QList<QString>{nodeStack.top()->getValue()});
     }
 
     if (nodeStack.size() >= 2 && OperationMap.value(token).arity == OperationArity::Binary) {
@@ -492,12 +583,13 @@ void Expression::processOperation(const QString& token, QStack<ExpressionNode*>&
         if (operType == OperationType::Subtraction) operType = OperationType::UnaryMinus;
     }
     else if (nodeStack.size() < 2) {
-        throw TEException(ErrorType::MissingOperand, QList<QString>{token});
+        return TEException(ErrorType::MissingOperand, QList<QString>{token});
     }
     else if (nodeStack.size() > 2) {
-        throw TEException(ErrorType::MissingOperations, QList<QString>{nodeStack.pop()->getValue()});
+        return TEException(ErrorType::MissingOperations, QList<QString>{nodeStack.top()->getValue()});
     }
     nodeStack.push(new ExpressionNode(EntityType::Operation, token, left, right, "", operType));
+    return {};
 }
 
 void Expression::processConst(const QString& token, QStack<ExpressionNode*>& nodeStack) {
@@ -507,9 +599,9 @@ void Expression::processConst(const QString& token, QStack<ExpressionNode*>& nod
         nodeStack.push(new ExpressionNode(EntityType::Const, token, nullptr, nullptr));
 }
 
-void Expression::processVariable(const QString& token, QStack<ExpressionNode*>& nodeStack, QSet<QString>& usedElements, const QSet<QString>& customDataTypes, const QStringList& tokens, QStringList::const_iterator i) {
+TEResult<void> Expression::processVariable(const QString& token, QStack<ExpressionNode*>& nodeStack, QSet<QString>& usedElements, const QSet<QString>& customDataTypes, const QStringList& tokens, QStringList::const_iterator i) {
     QString className;
-    QString dataType = getVariables()->value(token).type;
+    QString dataType = getVarByName(token).type;
     // если тип данных не определен
     if (dataType == "") {
         dataType = handleVariableTypeInference(token, nodeStack, tokens, i, className);
@@ -525,10 +617,11 @@ void Expression::processVariable(const QString& token, QStack<ExpressionNode*>&
             }
             else usedElements.insert(token);
         }
-        else if (dataType == "void") throw TEException(ErrorType::VariableWithVoidType, QList<QString>{token});
-        else throw TEException(ErrorType::UnidentifedType, QList<QString>{dataType});
+        else if (dataType == "void") return TEException(ErrorType::VariableWithVoidType, QList<QString>{token});
+        else return TEException(ErrorType::UnidentifedType, QList<QString>{dataType});
     }
-    else throw TEException(ErrorType::UndefinedId, QList<QString>{token});
+    else return TEException(ErrorType::UndefinedId, QList<QString>{token});
+    return {};
 }
 
 void Expression::processEnum(const QString& token, QStack<ExpressionNode*>& nodeStack, QSet<QString>& usedElements) {
@@ -536,13 +629,14 @@ void Expression::processEnum(const QString& token, QStack<ExpressionNode*>& node
     usedElements.insert(token);
 }
 
-void Expression::processFunction(const QString& token, QStack<ExpressionNode*>& nodeStack, const QSet<QString>& customDataTypes, QSet<QString>& usedElements, const QStringList& tokens, QStringList::const_iterator i) {
+TEResult<void> Expression::processFunction(const QString& token, QStack<ExpressionNode*>& nodeStack, const QSet<QString>& customDataTypes, QSet<QString>& usedElements, const QStringList& tokens, QStringList::const_iterator i) {
     int argCountStart = token.indexOf('(');
     int argCountEnd = token.indexOf(')');
     int argCount = token.mid(argCountStart + 1, argCountEnd - argCountStart - 1).toInt();
     QString funcName = token.left(argCountStart);
     QString className;
-    QString funcDataType = sanitizeDataType(getFunctions()->value(funcName).type);
+    const Function& function = getFuncByName(funcName);
+    QString funcDataType = sanitizeDataType(function.type);
 
     if (funcDataType == "") {
         if (!nodeStack.empty()) {
@@ -559,17 +653,16 @@ void Expression::processFunction(const QString& token, QStack<ExpressionNode*>&
 
     if (funcDataType != "") {
         funcDataType = sanitizeDataType(funcDataType);
-        if (argCount != getFunctions()->value(funcName).paramsCount)
-            throw TEException(ErrorType::ParamsCountFunctionMissmatch, QList<QString>{token});
-        QList<ExpressionNode*>* functionArgs = new QList<ExpressionNode*>();
+        if (argCount != function.paramsCount)
+            return TEException(ErrorType::ParamsCountFunctionMissmatch, QList<QString>{token});
         if (nodeStack.size() < argCount)
-            throw TEException(ErrorType::MissingOperand, QList<QString>{token});
-        else {
+            return TEException(ErrorType::MissingOperand, QList<QString>{token});
+        if (customDataTypes.contains(funcDataType) || DataTypes.contains(funcDataType) || funcDataType == "void") {
+            // Аргументы снимаются со стека только для узла, который будет построен
+            QList<ExpressionNode*>* functionArgs = new QList<ExpressionNode*>();
             for (int j = 0; j < argCount; j++) {
                 functionArgs->prepend(nodeStack.pop());
             }
-        }
-        if (customDataTypes.contains(funcDataType) || DataTypes.contains(funcDataType) || funcDataType == "void") {
             if (customDataTypes.contains(funcDataType)) usedElements.insert(funcDataType);
             ExpressionNode* functionNode = new ExpressionNode(EntityType::Function, funcName, nullptr, nullptr, funcDataType, OperationType::None, functionArgs);
             nodeStack.push(functionNode);
@@ -579,9 +672,10 @@ void Expression::processFunction(const QString& token, QStack<ExpressionNode*>&
             }
             else usedElements.insert(funcName);
         }
-        else throw TEException(ErrorType::UnidentifedType, QList<QString>{funcDataType});
+        else return TEException(ErrorType::UnidentifedType, QList<QString>{funcDataType});
     }
-    else throw TEException(ErrorType::UndefinedId, QList<QString>{funcName});
+    else return TEException(ErrorType::UndefinedId, QList<QString>{funcName});
+    return {};
 }
 
 QString Expression::handleVariableTypeInference(const QString& token, QStack<ExpressionNode*>& nodeStack, const QStringList& tokens, QStringList::const_iterator i, QString& className) {
@@ -603,69 +697,52 @@ QString Expression::handleVariableTypeInference(const QString& token, QStack<Exp
     return dataType;
 }
 
-void Expression::finalizeNodeProcessing(QStack<ExpressionNode*>& nodeStack, const QString& expression, int operationCounter, const QSet<QString>& usedElements) {
-    if (nodeStack.size() > 1) throw TEException(ErrorType::MissingOperations, QList<QString>{nodeStack.pop()->getValue()});
-    else if (expression.isEmpty()) return; // Возвращаем nullptr или new ExpressionNode() - по твоей логике
+TEResult<void> Expression::finalizeNodeProcessing(QStack<ExpressionNode*>& nodeStack, const QString& expression, int operationCounter, const QSet<QString>& usedElements, bool checkUnusedElements) {
+    if (nodeStack.size() > 1) return TEException(ErrorType::MissingOperations, QList<QString>{nodeStack.top()->getValue()});
+    // Без корня дерева вызывающий код не может забрать узел из стека
+    else if (nodeStack.isEmpty()) return TEException(ErrorType::EmptyElementValue, QList<QString>{"expression"});
+    else if (expression.isEmpty()) return {}; // Возвращаем nullptr или new ExpressionNode() - по твоей логике
 
-    else if (operationCounter > 20) throw TEException(ErrorType::InputDataExprSizeExceeded, QList<QString>{QString::number(operationCounter)});
+    else if (operationCounter > 20) return TEException(ErrorType::InputDataExprSizeExceeded, QList<QString>{QString::number(operationCounter)});
 
-    QSet<QString> allElements = this->getAllNames();
+    if (!checkUnusedElements) return {};
+
+    const QSet<QString>& allElements = this->getAllNames();
     QSet<QString> unusedElements = allElements - usedElements;
 
     if (!unusedElements.isEmpty())
-        throw TEException(ErrorType::NeverUsedElement, QList<QString>{unusedElements.values().join(", ")});
+        return TEException(ErrorType::NeverUsedElement, QList<QString>{unusedElements.values().join(", ")});
+    return {};
 }
 
-void Expression::getCustomTypeFields(QSet<QString>& names, const CustomTypeWithFields& customType) {
-    names.insert(customType.name);
-    for (auto i = customType.variables.cbegin(); i != customType.variables.cend(); i++) {
-        names.insert(customType.name + "." + i.value().name);
-    }
-    for (auto i = customType.functions.cbegin(); i != customType.functions.cend(); i++) {
-        names.insert(customType.name + "." + i.value().name);
-    }
+const QSet<QString>& Expression::getAllNames() const
+{
+    return schema->getAllNames();
 }
 
-QSet<QString> Expression::getAllNames() {
-    QSet<QString> names;
-    // переменные
-    for (auto i = variables.cbegin(); i != variables.cend(); i++) {
-        names.insert(i.value().name);
-    }
-    // функции
-    for (auto i = functions.cbegin(); i != functions.cend(); i++) {
-        names.insert(i.value().name);
-    }
-    for (auto i = unions.cbegin(); i != unions.cend(); i++) {
-        getCustomTypeFields(names, i.value());
-    }
-    for (auto i = structures.cbegin(); i != structures.cend(); i++) {
-        getCustomTypeFields(names, i.value());
-    }
-    for (auto i = classes.cbegin(); i != classes.cend(); i++) {
-        getCustomTypeFields(names, i.value());
-    }
-    // перечисления
-    for (auto i = enums.cbegin(); i != enums.cend(); i++) {
-        names.insert(i.value().name);
-        for (auto enumI = i.value().values.cbegin(); enumI != i.value().values.cend(); enumI++) {
-            names.insert(i.value().name + "." + enumI.key());
-        }
-    }
-    return names;
+EntityType Expression::getEntityTypeByStr(const QString &str)
+{
+    TEResult<EntityType> type = tryGetEntityTypeByStr(str);
+    type.throwFirstIfFailed();
+    return type.value();
 }
 
-EntityType Expression::getEntityTypeByStr(const QString &str)
+TEResult<EntityType> Expression::tryGetEntityTypeByStr(const QString &str)
 {
-    //...Считаем, что тип неопределен
-    EntityType type = EntityType::Undefined;
-    if(isConst(str)) type = EntityType::Const;
-    else if(isFunction(str)) type = EntityType::Function;
-    else if(isCustomTypeWithFields(str)) type = EntityType::CustomTypeWithFields;
-    else if(isEnum(str)) type = EntityType::Enum;
-    else if(getOperationTypeByStr(str) != OperationType::None) type = EntityType::Operation;
-    else if(isVariable(str)) type = EntityType::Variable;
-    return type;
+    if(isConst(str)) return EntityType::Const;
+
+    TEResult<bool> function = tryIsFunction(str);
+    if(!function.isOk()) return function.getErrors();
+    if(function.value()) return EntityType::Function;
+
+    if(isCustomTypeWithFields(str)) return EntityType::CustomTypeWithFields;
+    if(isEnum(str)) return EntityType::Enum;
+    if(getOperationTypeByStr(str) != OperationType::None) return EntityType::Operation;
+
+    TEResult<bool> variable = tryIsIdentifier(str);
+    if(!variable.isOk()) return variable.getErrors();
+    //...Иначе тип неопределен
+    return variable.value() ? EntityType::Variable : EntityType::Undefined;
 }
 
 bool Expression::isConst(const QString &str)
@@ -691,6 +768,13 @@ bool Expression::isVariable(const QString &str)
 }
 
 bool Expression::isFunction(const QString &str)
+{
+    TEResult<bool> function = tryIsFunction(str);
+    function.throwFirstIfFailed();
+    return function.value();
+}
+
+TEResult<bool> Expression::tryIsFunction(const QString &str)
 {
     bool ok = false;
     if(str.contains('(') && str.endsWith(')')){
@@ -698,7 +782,9 @@ bool Expression::isFunction(const QString &str)
         QString contentInParentheses = str.mid(str.indexOf('(') + 1, str.length() - str.indexOf('(') - 2).trimmed();
         bool isNumber = false;
         contentInParentheses.toDouble(&isNumber);
-        if(isIdentifier(identifier) && isNumber) ok = true;
+        TEResult<bool> validIdentifier = tryIsIdentifier(identifier);
+        if(!validIdentifier.isOk()) return validIdentifier.getErrors();
+        if(validIdentifier.value() && isNumber) ok = true;
     }
     return ok;
 }
@@ -723,21 +809,26 @@ bool Expression::isEnum(const QString &str)
 
 bool Expression::isIdentifier(const QString &str)
 {
-    bool isInd = true;
+    TEResult<bool> identifier = tryIsIdentifier(str);
+    identifier.throwFirstIfFailed();
+    return identifier.value();
+}
+
+TEResult<bool> Expression::tryIsIdentifier(const QString &str)
+{
+    // Пустая строка не является идентификатором
+    if (str.isEmpty()) return false;
     // Первый символ - латинская буква или _
-    if (str.isEmpty()) isInd = false;
-    else{
-        if (!(isLatinLetter(str[0]) || str[0] == '_')) {
-            throw TEException(ErrorType::InvalidSymbol, QList<QString>{str[0]});
-        }
-        // Остальные символы - латинские буквы, цифры или _
-        for(int i = 0; i < str.length() && isInd == true; i++) {
-            if (!(isLatinLetter(str[i]) || str[i].isDigit() || str[i] == '_')) {
-                throw TEException(ErrorType::InvalidSymbol, QList<QString>{str[i]});
-            }
+    if (!(isLatinLetter(str[0]) || str[0] == '_')) {
+        return TEException(ErrorType::InvalidSymbol, QList<QString>{str[0]});
+    }
+    // Остальные символы - латинские буквы, цифры или _
+    for(int i = 0; i < str.length(); i++) {
+        if (!(isLatinLetter(str[i]) || str[i].isDigit() || str[i] == '_')) {
+            return TEException(ErrorType::InvalidSymbol, QList<QString>{str[i]});
         }
     }
-    return isInd;
+    return true;
 }
 
 bool Expression::isLatinLetter(const QChar c)
@@ -746,12 +837,12 @@ bool Expression::isLatinLetter(const QChar c)
     return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
 }
 
-QList<QString> Expression::argsToDescr(const QList<ExpressionNode *> *functionArgs, QString& intermediateDescription, QString customDataType, OperationType parentOperType) const
+QList<QString> Expression::argsToDescr(const QList<ExpressionNode *> *functionArgs, QString& intermediateDescription, const QString& customDataType, OperationType parentOperType, QList<TEException>& errors) const
 {
     QList<QString> descriptions;
     QList<ExpressionNode *>::const_iterator i;
     for(i = functionArgs->constBegin(); i != functionArgs->constEnd(); i++){
-        descriptions.append(ToExplanation(*i, intermediateDescription, customDataType, parentOperType));
+        descriptions.append(explainNode(*i, intermediateDescription, customDataType, parentOperType, errors));
     }
     return descriptions;
 }
@@ -5,15 +5,23 @@
 
 #ifndef EXPRESSION_H
 #define EXPRESSION_H
+#include "cancellationtoken.h"
 #include "expressionnode.h"
 #include "teexception.h"
+#include "teresult.h"
+#include "compiledschema.h"
 
 #include <QHash>
+#include <QSharedPointer>
 #include <QString>
 #include <QStack>
 
 /*!
  * \brief Класс, представляющий выражение и связанные с ним переменные, функции и пользовательские типы
+ *
+ * Объект лёгкий: хранит строку выражения и разделяемый указатель на неизменяемую схему (CompiledSchema).
+ * Для объяснения нескольких выражений по одной схеме, в том числе из разных потоков, достаточно
+ * создать по объекту Expression на каждое выражение с общей схемой.
  */
 class Expression
 {
@@ -39,12 +47,17 @@ public:
         const QHash<QString, Enum>& enms = {}
         )
         : expression(expr)
-        , variables(vars)
-        , functions(funcs)
-        , unions(unns)
-        , structures(strucs)
-        , classes(cls)
-        , enums(enms)
+        , schema(CompiledSchema::create(vars, funcs, unns, strucs, cls, enms))
+    {}
+
+    /*!
+     * \brief Конструктор Expression по готовой схеме
+     * \param[in] schema Неизменяемая схема, общая для нескольких выражений
+     * \param[in] expr Строковое выражение
+     */
+    explicit Expression(const QSharedPointer<const CompiledSchema>& schema, const QString& expr = "")
+        : expression(expr)
+        , schema(schema ? schema : CompiledSchema::empty())
     {}
 
     /*!
@@ -58,7 +71,7 @@ public:
      * \brief Получение всех пользовательских типов данных
      * \return Множество имён пользовательских типов
      */
-    QSet<QString> getCustomDataTypes() const;
+    const QSet<QString>& getCustomDataTypes() const;
 
     /*!
      * \brief Преобразование выражения в строку
@@ -73,34 +86,89 @@ public:
      * \param[in] className Имя класса (если применимо)
      * \param[in] parentOperType Тип родительской операции
      * \return Объяснение выражения
+     * \throw TEException Ошибка построения объяснения
      */
     QString ToExplanation(const ExpressionNode* node, QString& intermediateDescription, const QString& className = "", OperationType parentOperType = OperationType::None) const;
 
+    /*!
+     * \brief Построение текстового объяснения узла без исключений
+     *
+     * После первой ошибки объяснение прекращается: остальные узлы не обходятся.
+     * \param[in] node Узел выражения
+     * \param[out] intermediateDescription Промежуточное объяснение
+     * \param[in] className Имя класса (если применимо)
+     * \param[in] parentOperType Тип родительской операции
+     * \param[out] errors Список ошибок (не больше одной)
+     * \return Объяснение выражения
+     */
+    QString explainNode(const ExpressionNode* node, QString& intermediateDescription, const QString& className, OperationType parentOperType, QList<TEException>& errors) const;
+
     /*!
      * \brief Получение англоязычного объяснения выражения
+     * \param[out] usedElements Если задан — сюда записываются использованные элементы схемы,
+     *                          а проверка неиспользуемых элементов не выполняется
      * \return Строка объяснения
+     * \throw TEException Ошибка в выражении
+     */
+    QString getExplanationInEn(QSet<QString>* usedElements = nullptr);
+
+    /*!
+     * \brief Получение англоязычного объяснения выражения без исключений
+     * \param[out] usedElements Если задан — сюда записываются использованные элементы схемы,
+     *                          а проверка неиспользуемых элементов не выполняется
+     * \return Строка объяснения или ошибка в выражении
+     */
+    TEResult<QString> tryGetExplanationInEn(QSet<QString>* usedElements = nullptr);
+
+    /*!
+     * \brief Проверка выражения без построения объяснения
+     *
+     * Выполняет те же проверки, что и tryExpressionToNodes (символы, идентификаторы, операнды,
+     * использование элементов схемы), но не обходит дерево для получения текста.
+     * \param[out] usedElements Если задан — сюда записываются использованные элементы схемы,
+     *                          а проверка неиспользуемых элементов не выполняется
+     * \return Успех или ошибка в выражении
      */
-    QString getExplanationInEn();
+    TEResult<void> tryValidate(QSet<QString>* usedElements = nullptr);
 
     /*!
      * \brief Преобразование строки выражения в дерево ExpressionNode
-     * \return Корень дерева
+     * \param[out] usedElements Если задан — сюда записываются использованные элементы схемы,
+     *                          а проверка неиспользуемых элементов не выполняется
+     * \return Корень дерева; принадлежит вызывающей стороне и освобождается вместе с поддеревьями через delete
+     * \throw TEException Ошибка в выражении
+     */
+    ExpressionNode* expressionToNodes(QSet<QString>* usedElements = nullptr);
+
+    /*!
+     * \brief Преобразование строки выражения в дерево ExpressionNode без исключений
+     * \param[out] usedElements Если задан — сюда записываются использованные элементы схемы,
+     *                          а проверка неиспользуемых элементов не выполняется
+     * \return Корень дерева или ошибка в выражении; при ошибке построенные узлы освобождаются
      */
-    ExpressionNode* expressionToNodes();
+    TEResult<ExpressionNode*> tryExpressionToNodes(QSet<QString>* usedElements = nullptr);
 
     /*!
      * \brief Получение всех имён переменных, функций и т.д.
      * \return Множество имён
      */
-    QSet<QString> getAllNames();
+    const QSet<QString>& getAllNames() const;
 
     /*!
      * \brief Получение типа сущности по строке
      * \param[in] str Имя
      * \return Тип сущности
+     * \throw TEException Недопустимый символ в имени
      */
     EntityType getEntityTypeByStr(const QString& str);
 
+    /*!
+     * \brief Получение типа сущности по строке без исключений
+     * \param[in] str Имя
+     * \return Тип сущности или ошибка ErrorType::InvalidSymbol
+     */
+    TEResult<EntityType> tryGetEntityTypeByStr(const QString& str);
+
     /*!
      * \brief Проверка, является ли имя константой
      */
@@ -113,9 +181,16 @@ public:
 
     /*!
      * \brief Проверка, является ли имя функцией
+     * \throw TEException Недопустимый символ в имени функции
      */
     static bool isFunction(const QString& str);
 
+    /*!
+     * \brief Проверка, является ли имя функцией, без исключений
+     * \return Результат проверки или ошибка ErrorType::InvalidSymbol
+     */
+    static TEResult<bool> tryIsFunction(const QString& str);
+
     /*!
      * \brief Проверка, является ли имя пользовательским типом
      */
@@ -128,9 +203,16 @@ public:
 
     /*!
      * \brief Проверка, является ли строка допустимым идентификатором
+     * \throw TEException Недопустимый символ в идентификаторе
      */
     static bool isIdentifier(const QString& str);
 
+    /*!
+     * \brief Проверка, является ли строка допустимым идентификатором, без исключений
+     * \return Результат проверки (false для пустой строки) или ошибка ErrorType::InvalidSymbol
+     */
+    static TEResult<bool> tryIsIdentifier(const QString& str);
+
     /*!
      * \brief Проверка, является ли символ латинской буквой
      */
@@ -142,9 +224,10 @@ public:
      * \param[out] intermediateDescription Промежуточное описание
      * \param[in] customDataType Тип, если это метод класса/структуры
      * \param[in] parentOperType Родительская операция
+     * \param[out] errors Список ошибок
      * \return Список аргументов в виде строк
      */
-    QList<QString> argsToDescr(const QList<ExpressionNode*>* functionArgs, QString& intermediateDescription, QString customDataType = "", OperationType parentOperType = OperationType::None) const;
+    QList<QString> argsToDescr(const QList<ExpressionNode*>* functionArgs, QString& intermediateDescription, const QString& customDataType, OperationType parentOperType, QList<TEException>& errors) const;
 
     /*!
      * \brief Получение OperationType по строке
@@ -170,6 +253,27 @@ public:
      */
     const QString* getExpression() const;
 
+    /*!
+     * \brief Получение схемы выражения
+     */
+    const QSharedPointer<const CompiledSchema>& getSchema() const;
+
+    /*!
+     * \brief Установка схемы выражения
+     */
+    void setSchema(const QSharedPointer<const CompiledSchema>& newSchema);
+
+    /*!
+     * \brief Получение признака отмены построения дерева и объяснения
+     */
+    const CancellationToken* getCancellationToken() const;
+
+    /*!
+     * \brief Установка признака отмены построения дерева и объяснения
+     * \param[in] newCancellation Признак отмены (nullptr — без отмены); должен существовать, пока объясняется выражение
+     */
+    void setCancellationToken(const CancellationToken* newCancellation);
+
     /*!
      * \brief Получение указателя на словарь переменных
      */
@@ -183,7 +287,7 @@ public:
     /*!
      * \brief Получение переменной по имени
      */
-    const Variable getVarByName(const QString& name) const;
+    const Variable& getVarByName(const QString& name) const;
 
     /*!
      * \brief Получение указателя на словарь функций
@@ -198,7 +302,7 @@ public:
     /*!
      * \brief Получение функции по имени
      */
-    const Function getFuncByName(const QString& name) const;
+    const Function& getFuncByName(const QString& name) const;
 
     /*!
      * \brief Получение указателя на словарь объединений
@@ -213,7 +317,7 @@ public:
     /*!
      * \brief Получение объединения по имени
      */
-    const Union getUnionByName(const QString& name) const;
+    const Union& getUnionByName(const QString& name) const;
 
     /*!
      * \brief Получение указателя на словарь структур
@@ -228,7 +332,7 @@ public:
     /*!
      * \brief Получение структуры по имени
      */
-    const Structure getStructByName(const QString& name) const;
+    const Structure& getStructByName(const QString& name) const;
 
     /*!
      * \brief Получение указателя на словарь классов
@@ -243,7 +347,7 @@ public:
     /*!
      * \brief Получение класса по имени
      */
-    const Class getClassByName(const QString& name) const;
+    const Class& getClassByName(const QString& name) const;
 
     /*!
      * \brief Получение указателя на словарь перечислений
@@ -258,17 +362,17 @@ public:
     /*!
      * \brief Получение перечисления по имени
      */
-    const Enum getEnumByName(const QString& name) const;
+    const Enum& getEnumByName(const QString& name) const;
 
     /*!
      * \brief Получение переменной по имени из пользовательского типа
      */
-    const Variable getVariableByNameFromCustomData(QString varName, QString dataName) const;
+    const Variable& getVariableByNameFromCustomData(const QString& varName, const QString& dataName) const;
 
     /*!
      * \brief Получение функции по имени из пользовательского типа
      */
-    const Function getFunctionByNameFromCustomData(QString funcName, QString dataName) const;
+    const Function& getFunctionByNameFromCustomData(const QString& funcName, const QString& dataName) const;
 
     /*!
      * \brief Проверка, является ли значение элементом перечисления
@@ -278,12 +382,7 @@ public:
     /*!
      * \brief Получение пользовательского типа по имени
      */
-    const CustomTypeWithFields getCustomTypeByName(const QString& typeName) const;
-
-    /*!
-     * \brief Получение всех имён переменных и функций пользовательского типа
-     */
-    void getCustomTypeFields(QSet<QString>& names, const CustomTypeWithFields& customType);
+    const CustomTypeWithFields& getCustomTypeByName(const QString& typeName) const;
 
     /*!
      * \brief Разделение выражения на компоненты
@@ -306,8 +405,9 @@ public:
  * \param[in,out] operationCounter Счётчик операций в выражении.
  * \param[in] tokens Полный список токенов выражения.
  * \param[in] i Итератор текущей позиции в списке токенов.
+ * \return Успех или ошибка в операции.
  */
-    void processOperation(const QString &token, QStack<ExpressionNode *> &nodeStack, int &operationCounter, const QStringList &tokens, QStringList::const_iterator i);
+    TEResult<void> processOperation(const QString &token, QStack<ExpressionNode *> &nodeStack, int &operationCounter, const QStringList &tokens, QStringList::const_iterator i);
 
     /*!
  * \brief Обрабатывает константу и добавляет соответствующий узел в стек.
@@ -324,8 +424,9 @@ public:
  * \param[in] customDataTypes Набор пользовательских типов данных.
  * \param[in] tokens Полный список токенов выражения.
  * \param[in] i Итератор текущей позиции в списке токенов.
+ * \return Успех или ошибка в переменной.
  */
-    void processVariable(const QString &token, QStack<ExpressionNode *> &nodeStack, QSet<QString> &usedElements, const QSet<QString> &customDataTypes, const QStringList &tokens, QStringList::const_iterator i);
+    TEResult<void> processVariable(const QString &token, QStack<ExpressionNode *> &nodeStack, QSet<QString> &usedElements, const QSet<QString> &customDataTypes, const QStringList &tokens, QStringList::const_iterator i);
 
     /*!
  * \brief Обрабатывает перечисление (enum) и добавляет соответствующий узел в стек.
@@ -343,8 +444,9 @@ public:
  * \param[in,out] usedElements Набор используемых элементов.
  * \param[in] tokens Полный список токенов выражения.
  * \param[in] i Итератор текущей позиции в списке токенов.
+ * \return Успех или ошибка в функции.
  */
-    void processFunction(const QString &token, QStack<ExpressionNode *> &nodeStack, const QSet<QString> &customDataTypes, QSet<QString> &usedElements, const QStringList &tokens, QStringList::const_iterator i);
+    TEResult<void> processFunction(const QString &token, QStack<ExpressionNode *> &nodeStack, const QSet<QString> &customDataTypes, QSet<QString> &usedElements, const QStringList &tokens, QStringList::const_iterator i);
 
     /*!
  * \brief Определяет тип переменной на основе контекста.
@@ -363,8 +465,10 @@ public:
  * \param[in] expression Исходное строковое выражение.
  * \param[in] operationCounter Счётчик операций в выражении.
  * \param[in] usedElements Набор используемых элементов.
+ * \param[in] checkUnusedElements Проверять ли, что использованы все элементы схемы.
+ * \return Успех или ошибка в выражении в целом (в том числе пустой стек: дерево не построено).
  */
-    void finalizeNodeProcessing(QStack<ExpressionNode *> &nodeStack, const QString &expression, int operationCounter, const QSet<QString> &usedElements);
+    TEResult<void> finalizeNodeProcessing(QStack<ExpressionNode *> &nodeStack, const QString &expression, int operationCounter, const QSet<QString> &usedElements, bool checkUnusedElements = true);
 
     /*!
      * \brief Обрабатывает узел типа переменной.
@@ -380,9 +484,10 @@ public:
      * \param[in] node Узел выражения, представляющий функцию.
      * \param[in,out] intermediateDescription Промежуточное описание функции.
      * \param[in] className Название класса, если функция принадлежит классу.
+     * \param[out] errors Список ошибок.
      * \return Описание узла в виде строки.
      */
-    QString handleFunctionNode(const ExpressionNode *node, QString &intermediateDescription, const QString &className) const;
+    QString handleFunctionNode(const ExpressionNode *node, QString &intermediateDescription, const QString &className, QList<TEException> &errors) const;
 
     /*!
      * \brief Обрабатывает узел типа константы.
@@ -399,17 +504,14 @@ public:
      * \param[in] parentOperType Тип родительской операции.
      * \param[in,out] descOfLeftNode Описание левого поддерева.
      * \param[in,out] descOfRightNode Описание правого поддерева.
+     * \param[out] errors Список ошибок.
      * \return Описание узла в виде строки.
      */
-    QString handleOperationNode(const ExpressionNode *node, QString &intermediateDescription, const QString &className, OperationType parentOperType, QString &descOfLeftNode, QString &descOfRightNode) const;
+    QString handleOperationNode(const ExpressionNode *node, QString &intermediateDescription, const QString &className, OperationType parentOperType, QString &descOfLeftNode, QString &descOfRightNode, QList<TEException> &errors) const;
 private:
     QString expression; ///< Исходное строковое выражение
-    QHash<QString, Variable> variables; ///< Список переменных
-    QHash<QString, Function> functions; ///< Список функций
-    QHash<QString, Union> unions; ///< Пользовательские типы: объединения
-    QHash<QString, Structure> structures; ///< Пользовательские типы: структуры
-    QHash<QString, Class> classes; ///< Пользовательские типы: классы
-    QHash<QString, Enum> enums; ///< Пользовательские типы: перечисления
+    QSharedPointer<const CompiledSchema> schema; ///< Неизменяемая схема, общая для выражений
+    const CancellationToken* cancellation = nullptr; ///< Признак отмены (nullptr — без отмены)
 };
 
 #endif // EXPRESSION_H
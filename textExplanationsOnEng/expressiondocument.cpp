@@ -0,0 +1,236 @@
+#include "expressiondocument.h"
+#include "expression.h"
+#include "expressionxmlparser.h"
+#include "pipelinestats.h"
+
+#include <QThread>
+#include <QThreadPool>
+
+bool ExplanationResult::isSuccessful() const
+{
+    return errors.isEmpty();
+}
+
+ExpressionDocument::ExpressionDocument(const QSharedPointer<const CompiledSchema> &schema, const QList<ExpressionEntry> &expressions, bool multiExpression)
+    : schema(schema ? schema : CompiledSchema::empty())
+    , expressions(expressions)
+    , multiExpression(multiExpression)
+    , cache(nullptr)
+    , cancellation(nullptr)
+    , validateOnly(false)
+{}
+
+ExpressionDocument ExpressionDocument::fromFile(const QString &path, const CancellationToken *cancellation)
+{
+    ExpressionDocument document;
+    ExpressionXmlParser::readDocumentFromXML(path, document, cancellation);
+    document.setCancellationToken(cancellation);
+    return document;
+}
+
+ExplanationResult ExpressionDocument::explain(const ExpressionEntry &entry, bool checkUnusedElements) const
+{
+    ExplanationResult result;
+    result.id = entry.id;
+
+    // Выражение не прошло разбор — объяснять нечего
+    if (!entry.errors.isEmpty()) {
+        result.errors = entry.errors;
+        return result;
+    }
+
+    CachedExplanation outcome = explainExpression(entry.expression, checkUnusedElements);
+    result.explanation = outcome.explanation;
+    result.usedElements = outcome.usedElements;
+    for (const TEException& error : std::as_const(outcome.errors)) {
+        // Ошибки дерева выражения не знают строки — привязать их к элементу <expression>
+        if (error.getLine() <= 0 && entry.line > 0)
+            result.errors.append(TEException(error.getErrorType(), entry.line, error.getArgs()));
+        else
+            result.errors.append(error);
+    }
+    return result;
+}
+
+CachedExplanation ExpressionDocument::explainExpression(const QString &expression, bool checkUnusedElements) const
+{
+    auto compute = [this, &expression, checkUnusedElements]() {
+        CachedExplanation outcome;
+        Expression tree(schema, expression);
+        tree.setCancellationToken(cancellation);
+        QSet<QString>* usedElements = checkUnusedElements ? nullptr : &outcome.usedElements;
+        if (validateOnly) {
+            TEResult<void> validation = tree.tryValidate(usedElements);
+            outcome.errors = validation.getErrors();
+            return outcome;
+        }
+        TEResult<QString> explanation = tree.tryGetExplanationInEn(usedElements);
+        if (explanation.isOk())
+            outcome.explanation = explanation.value();
+        else
+            outcome.errors = explanation.getErrors();
+        return outcome;
+    };
+
+    // В кэше хранятся только объяснения — результат проверки туда не попадает
+    if (!cache || validateOnly) return compute();
+    return cache->findOrCompute(ExplanationCache::makeKey(schema->getContentHash(), expression, checkUnusedElements), compute);
+}
+
+QString ExpressionDocument::getExplanation(int maxThreads) const
+{
+    TEResult<QString> explanation = tryGetExplanation(maxThreads);
+    explanation.throwFirstIfFailed();
+    return explanation.value();
+}
+
+TEResult<QString> ExpressionDocument::tryGetExplanation(int maxThreads) const
+{
+    if (!multiExpression) {
+        // Получить объяснение выражения
+        CachedExplanation outcome = explainExpression(expressions.value(0).expression, true);
+        if (!outcome.errors.isEmpty()) return outcome.errors;
+        return outcome.explanation;
+    }
+
+    // Получить объяснения всех выражений документа, разобранных над общей схемой
+    QList<TEException> documentErrors;
+    QList<ExplanationResult> results = explainAll(documentErrors, maxThreads);
+    // Прерванный документ не выводится частично
+    if (cancellation && cancellation->isCancelled()) return TEException(ErrorType::Cancelled);
+    return formatResults(results, documentErrors);
+}
+
+QList<ExplanationResult> ExpressionDocument::explainAll(QList<TEException> &documentErrors, int maxThreads) const
+{
+    QList<ExplanationResult> results(expressions.size());
+    // В формате с несколькими выражениями использование элементов схемы проверяется по документу в целом
+    const bool checkUnusedElements = !multiExpression;
+
+    if (maxThreads <= 0) maxThreads = QThread::idealThreadCount();
+
+    if (expressions.size() <= 1 || maxThreads == 1) {
+        for (qsizetype i = 0; i < expressions.size(); i++) {
+            results[i] = explain(expressions[i], checkUnusedElements);
+        }
+    }
+    else {
+        // Каждая задача пишет только в свою ячейку результатов, поэтому синхронизация не нужна
+        ExplanationResult* output = results.data();
+        // Статистика выражений попадает в накопитель вызывающего потока
+        StatsRecorder* recorder = StatsRecorder::current();
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(maxThreads);
+        for (qsizetype i = 0; i < expressions.size(); i++) {
+            threadPool.start([this, output, i, checkUnusedElements, recorder]() {
+                StatsScope scope(recorder);
+                output[i] = explain(expressions[i], checkUnusedElements);
+            });
+        }
+        threadPool.waitForDone();
+    }
+
+    if (multiExpression) {
+        QSet<QString> usedElements;
+        bool allSuccessful = true;
+        for (const ExplanationResult& result : std::as_const(results)) {
+            allSuccessful = allSuccessful && result.isSuccessful();
+            usedElements.unite(result.usedElements);
+        }
+
+        // Если какое-то выражение не разобрано, использованные им элементы неизвестны
+        if (allSuccessful) {
+            QSet<QString> unusedElements = schema->getAllNames() - usedElements;
+            if (!unusedElements.isEmpty())
+                documentErrors.append(TEException(ErrorType::NeverUsedElement, QList<QString>{unusedElements.values().join(", ")}));
+        }
+    }
+
+    return results;
+}
+
+QList<TEException> ExpressionDocument::validate(int maxThreads) const
+{
+    ExpressionDocument checked(*this);
+    checked.validateOnly = true;
+
+    QList<TEException> documentErrors;
+    const QList<ExplanationResult> results = checked.explainAll(documentErrors, maxThreads);
+
+    QList<TEException> errors;
+    for (const ExplanationResult& result : results) {
+        errors.append(result.errors);
+    }
+    errors.append(documentErrors);
+    return errors;
+}
+
+QString ExpressionDocument::formatResults(const QList<ExplanationResult> &results, const QList<TEException> &documentErrors)
+{
+    QString output;
+    for (const ExplanationResult& result : results) {
+        output += "[" + result.id + "]\n";
+        if (result.isSuccessful()) {
+            output += result.explanation + "\n";
+        }
+        else {
+            for (const TEException& error : result.errors) {
+                output += error.what() + "\n";
+            }
+        }
+    }
+    for (const TEException& error : documentErrors) {
+        output += error.what() + "\n";
+    }
+    return output;
+}
+
+const QSharedPointer<const CompiledSchema> &ExpressionDocument::getSchema() const
+{
+    return schema;
+}
+
+void ExpressionDocument::setSchema(const QSharedPointer<const CompiledSchema> &newSchema)
+{
+    schema = newSchema ? newSchema : CompiledSchema::empty();
+}
+
+const QList<ExpressionEntry> &ExpressionDocument::getExpressions() const
+{
+    return expressions;
+}
+
+void ExpressionDocument::setExpressions(const QList<ExpressionEntry> &newExpressions)
+{
+    expressions = newExpressions;
+}
+
+bool ExpressionDocument::isMultiExpression() const
+{
+    return multiExpression;
+}
+
+void ExpressionDocument::setMultiExpression(bool newMultiExpression)
+{
+    multiExpression = newMultiExpression;
+}
+
+ExplanationCache *ExpressionDocument::getExplanationCache() const
+{
+    return cache;
+}
+
+void ExpressionDocument::setExplanationCache(ExplanationCache *newCache)
+{
+    cache = newCache;
+}
+
+const CancellationToken *ExpressionDocument::getCancellationToken() const
+{
+    return cancellation;
+}
+
+void ExpressionDocument::setCancellationToken(const CancellationToken *newCancellation)
+{
+    cancellation = newCancellation;
+}
@@ -0,0 +1,194 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ExpressionDocument — документа с общей схемой и несколькими выражениями
+ */
+
+#ifndef EXPRESSIONDOCUMENT_H
+#define EXPRESSIONDOCUMENT_H
+
+#include "cancellationtoken.h"
+#include "compiledschema.h"
+#include "explanationcache.h"
+#include "teexception.h"
+#include "teresult.h"
+
+#include <QList>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+
+/*!
+ * \brief Выражение документа
+ */
+struct ExpressionEntry {
+    QString id;                 /*!< Идентификатор выражения (атрибут id; пуст для документа с одним <expression>) */
+    QString expression;         /*!< Строковое выражение */
+    int line = 0;               /*!< Номер строки элемента <expression> */
+    QList<TEException> errors;  /*!< Ошибки разбора элемента <expression> */
+};
+
+/*!
+ * \brief Результат объяснения одного выражения документа
+ */
+struct ExplanationResult {
+    QString id;                     /*!< Идентификатор выражения */
+    QString explanation;            /*!< Объяснение (если ошибок нет) */
+    QList<TEException> errors;      /*!< Ошибки, возникшие при обработке выражения */
+    QSet<QString> usedElements;     /*!< Элементы схемы, использованные выражением */
+
+    /*!
+     * \brief Проверка, получено ли объяснение без ошибок
+     */
+    bool isSuccessful() const;
+};
+
+/*!
+ * \brief Документ: схема, разобранная один раз, и одно или несколько выражений над ней
+ *
+ * Формат с несколькими выражениями: вместо <expression> корневой элемент содержит
+ * <expressions> с дочерними элементами <expression id="...">.
+ */
+class ExpressionDocument
+{
+public:
+    /*!
+     * \brief Конструктор документа
+     * \param[in] schema Схема документа
+     * \param[in] expressions Выражения документа
+     * \param[in] multiExpression Документ записан в формате с несколькими выражениями
+     */
+    explicit ExpressionDocument(const QSharedPointer<const CompiledSchema>& schema = {},
+                                const QList<ExpressionEntry>& expressions = {},
+                                bool multiExpression = false);
+
+    /*!
+     * \brief Создание документа из XML-файла
+     * \param[in] path Путь к XML-файлу
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены); документ получает его для объяснения
+     * \return Объект ExpressionDocument
+     * \throw QList<TEException> Список ошибок уровня документа
+     */
+    static ExpressionDocument fromFile(const QString& path, const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Объяснение документа в том виде, в котором его выводит программа
+     *
+     * Для документа с одним выражением — объяснение этого выражения, для документа
+     * с несколькими выражениями — результаты всех выражений, отформатированные formatResults.
+     * \param[in] maxThreads Максимальное количество потоков для документа с несколькими выражениями (0 — по числу ядер)
+     * \return Текст объяснения
+     * \throw TEException Ошибка в единственном выражении документа или отмена объяснения (ErrorType::Cancelled)
+     */
+    QString getExplanation(int maxThreads = 0) const;
+
+    /*!
+     * \brief Объяснение документа в том виде, в котором его выводит программа, без исключений
+     * \param[in] maxThreads Максимальное количество потоков для документа с несколькими выражениями (0 — по числу ядер)
+     * \return Текст объяснения, ошибка в единственном выражении документа или отмена объяснения
+     */
+    TEResult<QString> tryGetExplanation(int maxThreads = 0) const;
+
+    /*!
+     * \brief Объяснение всех выражений документа параллельно над общей схемой
+     * \param[out] documentErrors Ошибки уровня документа (элементы схемы, не использованные ни одним выражением)
+     * \param[in] maxThreads Максимальное количество потоков (0 — по числу ядер)
+     * \return Результаты в порядке следования выражений в документе
+     */
+    QList<ExplanationResult> explainAll(QList<TEException>& documentErrors, int maxThreads = 0) const;
+
+    /*!
+     * \brief Проверка всех выражений документа без построения объяснений
+     *
+     * Выполняет разбор выражений и проверку их структуры над схемой документа, как explainAll,
+     * но не получает текст объяснений и не использует кэш. Ошибки выражений привязаны к строкам элементов <expression>.
+     * \param[in] maxThreads Максимальное количество потоков (0 — по числу ядер)
+     * \return Ошибки выражений в порядке документа, затем ошибки уровня документа; пустой список — документ корректен
+     */
+    QList<TEException> validate(int maxThreads = 0) const;
+
+    /*!
+     * \brief Объяснение одного выражения над схемой документа
+     * \param[in] entry Выражение документа
+     * \param[in] checkUnusedElements Проверять ли использование всех элементов схемы этим выражением
+     * \return Результат объяснения
+     */
+    ExplanationResult explain(const ExpressionEntry& entry, bool checkUnusedElements) const;
+
+    /*!
+     * \brief Форматирование результатов: блок «[id]» и объяснение или ошибки под ним
+     * \param[in] results Результаты объяснения
+     * \param[in] documentErrors Ошибки уровня документа
+     * \return Текст для вывода
+     */
+    static QString formatResults(const QList<ExplanationResult>& results, const QList<TEException>& documentErrors);
+
+    /*!
+     * \brief Получение схемы документа
+     */
+    const QSharedPointer<const CompiledSchema>& getSchema() const;
+
+    /*!
+     * \brief Установка схемы документа
+     */
+    void setSchema(const QSharedPointer<const CompiledSchema>& newSchema);
+
+    /*!
+     * \brief Получение выражений документа
+     */
+    const QList<ExpressionEntry>& getExpressions() const;
+
+    /*!
+     * \brief Установка выражений документа
+     */
+    void setExpressions(const QList<ExpressionEntry>& newExpressions);
+
+    /*!
+     * \brief Проверка, записан ли документ в формате с несколькими выражениями
+     */
+    bool isMultiExpression() const;
+
+    /*!
+     * \brief Установка формата документа
+     */
+    void setMultiExpression(bool newMultiExpression);
+
+    /*!
+     * \brief Получение кэша результатов объяснения
+     */
+    ExplanationCache* getExplanationCache() const;
+
+    /*!
+     * \brief Установка кэша результатов объяснения (nullptr — без кэша); кэш принадлежит вызывающей стороне
+     */
+    void setExplanationCache(ExplanationCache* newCache);
+
+    /*!
+     * \brief Получение признака отмены объяснения
+     */
+    const CancellationToken* getCancellationToken() const;
+
+    /*!
+     * \brief Установка признака отмены объяснения (nullptr — без отмены); признак принадлежит вызывающей стороне
+     *
+     * Выражения, объяснение которых прервано, получают ошибку ErrorType::Cancelled.
+     */
+    void setCancellationToken(const CancellationToken* newCancellation);
+
+private:
+    /*!
+     * \brief Объяснение выражения над схемой документа с использованием кэша, если он задан
+     * \param[in] expression Выражение
+     * \param[in] checkUnusedElements Проверять ли использование всех элементов схемы
+     * \return Объяснение или ошибки построения дерева выражения
+     */
+    CachedExplanation explainExpression(const QString& expression, bool checkUnusedElements) const;
+
+    QSharedPointer<const CompiledSchema> schema; ///< Схема, общая для всех выражений документа
+    QList<ExpressionEntry> expressions; ///< Выражения документа
+    bool multiExpression; ///< Документ записан в формате <expressions>
+    ExplanationCache* cache; ///< Кэш результатов объяснения
+    const CancellationToken* cancellation; ///< Признак отмены объяснения
+    bool validateOnly; ///< Только проверять выражения, не получая объяснений
+};
+
+#endif // EXPRESSIONDOCUMENT_H
@@ -1,4 +1,7 @@
 #include "expressionnode.h"
+#include "pipelinestats.h"
+
+#include <QtAlgorithms>
 
 // Конструктор по умолчанию
 ExpressionNode::ExpressionNode()
@@ -9,7 +12,10 @@ ExpressionNode::ExpressionNode()
     nodeType(EntityType::Undefined),
     operType(OperationType::None),
     dataType(""),
-    FunctionArgs(nullptr) {}
+    FunctionArgs(nullptr)
+{
+    countStat(PipelineCounter::Nodes);
+}
 
 ExpressionNode::ExpressionNode(EntityType nodeType, const QString &value, ExpressionNode *left, ExpressionNode *right, const QString &dataType, OperationType operType, QList<ExpressionNode *> *functionArgs)
     : value(value),
@@ -18,7 +24,20 @@ ExpressionNode::ExpressionNode(EntityType nodeType, const QString &value, Expres
     nodeType(nodeType),
     operType(operType),
     dataType(dataType),
-    FunctionArgs(functionArgs) {}
+    FunctionArgs(functionArgs)
+{
+    countStat(PipelineCounter::Nodes);
+}
+
+ExpressionNode::~ExpressionNode()
+{
+    delete left;
+    delete right;
+    if (FunctionArgs) {
+        qDeleteAll(*FunctionArgs);
+        delete FunctionArgs;
+    }
+}
 
 QString ExpressionNode::toString() const {
     QString result;
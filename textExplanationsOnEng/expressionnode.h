@@ -40,6 +40,14 @@ public:
                    OperationType operType = OperationType::None,
                    QList<ExpressionNode*>* functionArgs = {});
 
+    /*!
+     * \brief Деструктор узла: освобождает потомков и аргументы функции вместе со списком аргументов
+     */
+    ~ExpressionNode();
+
+    ExpressionNode(const ExpressionNode&) = delete;
+    ExpressionNode& operator=(const ExpressionNode&) = delete;
+
     /*!
      * \brief Получение строкового представления узла (рекурсивное)
      * \return Строка, представляющая поддерево с текущим узлом
@@ -152,12 +160,12 @@ public:
 
 private:
     QString value; ///< Содержимое узла (имя переменной, значение и т.д.)
-    ExpressionNode* right; ///< Правый потомок
-    ExpressionNode* left; ///< Левый потомок
+    ExpressionNode* right; ///< Правый потомок (принадлежит узлу)
+    ExpressionNode* left; ///< Левый потомок (принадлежит узлу)
     EntityType nodeType; ///< Тип узла
     OperationType operType; ///< Тип операции (если применимо)
     QString dataType; ///< Тип данных
-    QList<ExpressionNode*>* FunctionArgs; ///< Аргументы функции (если узел — функция)
+    QList<ExpressionNode*>* FunctionArgs; ///< Аргументы функции (если узел — функция; принадлежат узлу)
 };
 
 #endif // EXPRESSIONNODE_H
@@ -1,4 +1,5 @@
 #include "expressiontranslator.h"
+#include "pipelinestats.h"
 #include "teexception.h"
 
 const QHash<OperationType, QString> ExpressionTranslator::Templates = {
@@ -52,6 +53,14 @@ ExpressionTranslator::ExpressionTranslator()
 
 QString ExpressionTranslator::getExplanation(const QString& description, const QList<QString>& arguments)
 {
+    TEResult<QString> explanation = tryGetExplanation(description, arguments);
+    explanation.throwFirstIfFailed();
+    return explanation.value();
+}
+
+TEResult<QString> ExpressionTranslator::tryGetExplanation(const QString& description, const QList<QString>& arguments)
+{
+    countStat(PipelineCounter::TemplateApplications);
     QString pattern = description;
 
     QRegularExpression numberedPlaceholderRegex(R"(\{\s*(\d+)\s*\})");
@@ -68,8 +77,8 @@ QString ExpressionTranslator::getExplanation(const QString& description, const Q
             // Заменить плейсхолдер в результирующей строке на соответствующий аргумент
             pattern.replace(match.captured(0), replacement);
         }
-        // Иначе вызвать ошибку
-        else throw TEException(ErrorType::MissingReplacementArguments, QList<QString>{pattern});
+        // Иначе вернуть ошибку
+        else return TEException(ErrorType::MissingReplacementArguments, QList<QString>{pattern});
     }
     return pattern;
 }
@@ -7,6 +7,7 @@
 #define EXPRESSIONTRANSLATOR_H
 
 #include "codeentity.h"
+#include "teresult.h"
 #include <QString>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
@@ -41,6 +42,14 @@ public:
      * \throw TEException исключение при обработке
      */
     static QString getExplanation(const QString &description, const QList<QString> &arguments);
+
+    /*!
+     * \brief Генерация пояснительного текста по описанию и аргументам без исключений
+     * \param[in] description Описание шаблона операции
+     * \param[in] arguments Список аргументов, подставляемых в шаблон
+     * \return Строка с подставленными значениями или ошибка ErrorType::MissingReplacementArguments
+     */
+    static TEResult<QString> tryGetExplanation(const QString &description, const QList<QString> &arguments);
 };
 
 #endif // EXPRESSIONTRANSLATOR_H
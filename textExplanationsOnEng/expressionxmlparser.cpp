@@ -1,22 +1,103 @@
 #include "expressionxmlparser.h"
+#include "pipelinestats.h"
 #include "teexception.h"
 #include <QCoreApplication>
 #include <QDir>
+#include <QFileInfo>
+#include <QXmlStreamReader>
 
 const QList<QString> ExpressionXmlParser::supportedDataTypesForVar = { "int", "float", "double", "char", "bool", "string" };
 
-void ExpressionXmlParser::readDataFromXML(const QString& inputFilePath, Expression &expression) {
+ParserLimits ExpressionXmlParser::limits;
 
+bool ExpressionXmlParser::inputCopyEnabled = true;
+
+void ExpressionXmlParser::readDataFromXML(const QString& inputFilePath, Expression &expression, const CancellationToken *cancellation) {
+    tryReadDataFromXML(inputFilePath, expression, cancellation).throwIfFailed();
+}
+
+void ExpressionXmlParser::readDocumentFromXML(const QString &inputFilePath, ExpressionDocument &document, const CancellationToken *cancellation)
+{
+    tryReadDocumentFromXML(inputFilePath, document, cancellation).throwIfFailed();
+}
+
+void ExpressionXmlParser::readDocumentFromXMLContent(const QString &xmlContent, ExpressionDocument &document, const QString &sourceName,
+                                                     const CancellationToken *cancellation)
+{
+    tryReadDocumentFromXMLContent(xmlContent, document, sourceName, cancellation).throwIfFailed();
+}
+
+QSharedPointer<const CompiledSchema> ExpressionXmlParser::readSchemaFromXMLContent(const QString &xmlContent, const QString &sourceName,
+                                                                                   const CancellationToken *cancellation)
+{
+    TEResult<QSharedPointer<const CompiledSchema>> schema = tryReadSchemaFromXMLContent(xmlContent, sourceName, cancellation);
+    schema.throwIfFailed();
+    return schema.value();
+}
+
+TEResult<void> ExpressionXmlParser::tryReadDataFromXML(const QString &inputFilePath, Expression &expression, const CancellationToken *cancellation)
+{
     QList<TEException> errors;
+    ExpressionDocument document;
+
+    if (!isInterrupted(cancellation, errors)) {
+        QDomDocument doc = readXML(inputFilePath, errors);
+        if (errors.isEmpty() && !isInterrupted(cancellation, errors))
+            parseQDomDocument(doc, document, errors, true, cancellation);
+    }
+
+    // Формат с несколькими выражениями в объект Expression не помещается
+    if(document.isMultiExpression())
+        errors.append(TEException(ErrorType::UnexpectedElement, QList<QString>{"expressions", "expression"}));
+
+    if(errors.count() > 0) return errors;
+
+    expression = Expression(document.getSchema(), document.getExpressions().value(0).expression);
+    return {};
+}
 
-    try {
+TEResult<void> ExpressionXmlParser::tryReadDocumentFromXML(const QString &inputFilePath, ExpressionDocument &document, const CancellationToken *cancellation)
+{
+    QList<TEException> errors;
 
+    if (!isInterrupted(cancellation, errors)) {
         QDomDocument doc = readXML(inputFilePath, errors);
-        parseQDomDocument(doc, expression, errors);
+        if (errors.isEmpty() && !isInterrupted(cancellation, errors))
+            parseQDomDocument(doc, document, errors, true, cancellation);
     }
-    catch(...) {}
 
-    if(errors.count() > 0) throw errors;
+    return errors;
+}
+
+TEResult<void> ExpressionXmlParser::tryReadDocumentFromXMLContent(const QString &xmlContent, ExpressionDocument &document, const QString &sourceName,
+                                                                  const CancellationToken *cancellation)
+{
+    QList<TEException> errors;
+
+    if (!isInterrupted(cancellation, errors)) {
+        QDomDocument doc = parseXMLContent(xmlContent, sourceName, errors);
+        if (errors.isEmpty() && !isInterrupted(cancellation, errors))
+            parseQDomDocument(doc, document, errors, true, cancellation);
+    }
+
+    return errors;
+}
+
+TEResult<QSharedPointer<const CompiledSchema>> ExpressionXmlParser::tryReadSchemaFromXMLContent(const QString &xmlContent, const QString &sourceName,
+                                                                                                const CancellationToken *cancellation)
+{
+    QList<TEException> errors;
+    ExpressionDocument document;
+
+    if (!isInterrupted(cancellation, errors)) {
+        QDomDocument doc = parseXMLContent(xmlContent, sourceName, errors);
+        if (errors.isEmpty() && !isInterrupted(cancellation, errors))
+            parseQDomDocument(doc, document, errors, false, cancellation);
+    }
+
+    if(errors.count() > 0) return errors;
+
+    return document.getSchema();
 }
 
 QDomDocument ExpressionXmlParser::readXML(const QString& inputFilePath, QList<TEException>& errors) {
@@ -24,43 +105,158 @@ QDomDocument ExpressionXmlParser::readXML(const QString& inputFilePath, QList<TE
     if(inputFilePath.isEmpty())
         errors.append(TEException(ErrorType::InputFileNotFound, inputFilePath));
 
-    QTemporaryFile* tmpFilePath = createTempCopy(inputFilePath, errors);
+    // Размер проверяется до чтения: слишком большой файл не копируется и не читается
+    QFileInfo inputInfo(inputFilePath);
+    if (inputInfo.isFile() && inputInfo.size() > limits.maxInputBytes) {
+        errors.append(TEException(ErrorType::InputFileTooLarge, inputFilePath, QList<QString>{QString::number(inputInfo.size()), QString::number(limits.maxInputBytes)}));
+        return QDomDocument();
+    }
 
-    tmpFilePath->open();
-    QString xmlContent = tmpFilePath->readAll();
-    xmlContent = fixXmlFlags(xmlContent);
+    QByteArray bytes;
+    if (inputCopyEnabled) {
+        // Временная копия удаляется при выходе из блока на любом пути
+        std::unique_ptr<QTemporaryFile> tmpFile = createTempCopy(inputFilePath, errors);
+        if (!tmpFile) return QDomDocument();
+
+        StageTimer timer(PipelineStage::FileCopy);
+        tmpFile->open();
+        bytes = tmpFile->readAll();
+    }
+    else {
+        StageTimer timer(PipelineStage::FileCopy);
+        QFile inputFile(inputFilePath);
+        if (!inputFile.open(QIODevice::ReadOnly)) {
+            errors.append(TEException(ErrorType::InputFileNotFound, inputFilePath));
+            return QDomDocument();
+        }
+        bytes = inputFile.readAll();
+    }
+    countStat(PipelineCounter::BytesIn, bytes.size());
+    QString xmlContent = QString::fromUtf8(bytes);
+
+    return parseXMLContent(xmlContent, inputFilePath, errors);
+}
+
+QDomDocument ExpressionXmlParser::parseXMLContent(const QString &xmlContent, const QString &sourceName, QList<TEException> &errors)
+{
+    // Для текста в памяти ограничение применяется к количеству символов (не больше количества байтов UTF-8)
+    if (xmlContent.size() > limits.maxInputBytes) {
+        errors.append(TEException(ErrorType::InputFileTooLarge, sourceName, QList<QString>{QString::number(xmlContent.size()), QString::number(limits.maxInputBytes)}));
+        return QDomDocument();
+    }
+
+    QString fixedContent;
+    {
+        StageTimer timer(PipelineStage::FixXmlFlags);
+        fixedContent = fixXmlFlags(xmlContent);
+    }
+    {
+        StageTimer timer(PipelineStage::PreLex);
+        if (!checkStructureLimits(fixedContent, errors)) return QDomDocument();
+    }
 
     QDomDocument doc;
     QString errorMsg;
     int errorLine, errorColumn;
 
-    //std::cout << xmlContent.toStdString();
-    if (!doc.setContent(xmlContent, &errorMsg, &errorLine, &errorColumn)) {
-        delete tmpFilePath;
-        errors.append(TEException(ErrorType::Parsing, inputFilePath, errorLine));
-        throw NULL;
+    //std::cout << fixedContent.toStdString();
+    StageTimer timer(PipelineStage::BuildDom);
+    if (!doc.setContent(fixedContent, &errorMsg, &errorLine, &errorColumn)) {
+        errors.append(TEException(ErrorType::Parsing, sourceName, errorLine));
+        return QDomDocument();
     }
 
-    delete tmpFilePath;
     return doc;
 }
 
-QTemporaryFile *ExpressionXmlParser::createTempCopy(const QString &sourceFilePath, QList<TEException>& errors) {
+bool ExpressionXmlParser::isInterrupted(const CancellationToken *cancellation, QList<TEException> &errors)
+{
+    // Прерывание необратимо: ошибки, добавленные после него, отбрасываются
+    if (!errors.isEmpty() && errors.first().getErrorType() == ErrorType::Cancelled) {
+        errors.resize(1);
+        return true;
+    }
+
+    if (cancellation && cancellation->isCancelled()) {
+        // Ошибки, найденные до отмены, неполны — сообщается только об отмене
+        errors = QList<TEException>{TEException(ErrorType::Cancelled)};
+        return true;
+    }
+
+    if (errors.size() > limits.maxErrors) {
+        if (errors[limits.maxErrors].getErrorType() != ErrorType::ErrorLimitExceeded) {
+            errors.resize(limits.maxErrors);
+            errors.append(TEException(ErrorType::ErrorLimitExceeded, QList<QString>{QString::number(limits.maxErrors)}));
+        }
+        errors.resize(limits.maxErrors + 1);
+        return true;
+    }
+
+    return false;
+}
+
+bool ExpressionXmlParser::checkStructureLimits(const QString &xmlContent, QList<TEException> &errors)
+{
+    // Синтаксические ошибки здесь не проверяются — о них сообщает разбор в DOM
+    QXmlStreamReader reader(xmlContent);
+    int depth = 0;
+    while (!reader.atEnd() && !reader.hasError()) {
+        QXmlStreamReader::TokenType token = reader.readNext();
+        if (token == QXmlStreamReader::EndElement) {
+            depth--;
+        }
+        else if (token == QXmlStreamReader::StartElement) {
+            int line = int(reader.lineNumber());
+            QString name = reader.name().toString();
+            if (++depth > limits.maxNestingDepth) {
+                errors.append(TEException(ErrorType::NestingDepthExceeded, line, QList<QString>{name, QString::number(limits.maxNestingDepth)}));
+                return false;
+            }
+            qsizetype attributesCount = reader.attributes().size();
+            if (attributesCount > limits.maxAttributesPerElement) {
+                errors.append(TEException(ErrorType::AttributesCountExceeded, line, QList<QString>{name, QString::number(attributesCount), QString::number(limits.maxAttributesPerElement)}));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+const ParserLimits &ExpressionXmlParser::getLimits()
+{
+    return limits;
+}
+
+void ExpressionXmlParser::setLimits(const ParserLimits &newLimits)
+{
+    limits = newLimits;
+}
+
+bool ExpressionXmlParser::isInputCopyEnabled()
+{
+    return inputCopyEnabled;
+}
+
+void ExpressionXmlParser::setInputCopyEnabled(bool enabled)
+{
+    inputCopyEnabled = enabled;
+}
+
+std::unique_ptr<QTemporaryFile> ExpressionXmlParser::createTempCopy(const QString &sourceFilePath, QList<TEException>& errors) {
+    StageTimer timer(PipelineStage::FileCopy);
 
-    QTemporaryFile* tempFile = new QTemporaryFile(QDir(QCoreApplication::applicationDirPath()).filePath("temp_XXXXXX"));
-    //tempFile->setAutoRemove(true);
+    std::unique_ptr<QTemporaryFile> tempFile(new QTemporaryFile(QDir(QCoreApplication::applicationDirPath()).filePath("temp_XXXXXX")));
 
     if (!tempFile->open()) {
-        delete tempFile;
         errors.append(TEException(ErrorType::InputCopyFileCannotBeCreated, QList<QString>{sourceFilePath, QCoreApplication::applicationDirPath()}));
-        throw NULL;
+        return nullptr;
     }
 
     // Открываем исходный файл для чтения
     QFile sourceFile(sourceFilePath);
     if (!sourceFile.open(QIODevice::ReadOnly)){
         errors.append(TEException(ErrorType::InputFileNotFound, sourceFilePath));
-        throw NULL;
+        return nullptr;
     }
 
     tempFile->write(sourceFile.readAll());
@@ -91,27 +287,38 @@ QString ExpressionXmlParser::fixXmlFlags(const QString& xmlString) {
 }
 
 QString ExpressionXmlParser::fixXmlExpression(const QString& xmlString) {
-    QString result = xmlString;
+    const QString openTag = "<expression";
+    const QString closeTag = "</expression>";
+
+    QString result;
+    result.reserve(xmlString.size());
+
+    // Обработка всех элементов <expression> и <expression id="..."> (но не <expressions>) за один проход
+    qsizetype copiedUpTo = 0;
+    qsizetype tagStart = xmlString.indexOf(openTag);
+    while (tagStart != -1) {
+        qsizetype afterName = tagStart + openTag.length();
+        QChar next = afterName < xmlString.size() ? xmlString[afterName] : QChar();
+        if (next != '>' && !next.isSpace()) {
+            tagStart = xmlString.indexOf(openTag, afterName);
+            continue;
+        }
 
-    // Находим начало и конец тега <expression>
-    int expressionStart = result.indexOf("<expression>");
-    int expressionEnd = result.indexOf("</expression>");
+        // Находим конец открывающего тега и закрывающий тег
+        qsizetype contentStart = xmlString.indexOf('>', afterName);
+        if (contentStart == -1) break;
+        contentStart++;
+        qsizetype contentEnd = xmlString.indexOf(closeTag, contentStart);
+        if (contentEnd == -1) break;
 
-    // Если тег <expression> найден
-    if (expressionStart != -1 && expressionEnd != -1) {
-        // Вычисляем позиции содержимого
-        int contentStart = expressionStart + QString("<expression>").length();
-        int contentLength = expressionEnd - contentStart;
+        // Копируем всё до содержимого и заменяем специальные символы в содержимом
+        result += QStringView(xmlString).mid(copiedUpTo, contentStart - copiedUpTo);
+        result += escapeXmlText(xmlString.mid(contentStart, contentEnd - contentStart));
+        copiedUpTo = contentEnd;
 
-        // Извлекаем содержимое
-        QString content = result.mid(contentStart, contentLength);
-
-        // Заменяем специальные символы
-        QString escapedContent = escapeXmlText(content);
-
-        // Заменяем оригинальное содержимое на обработанное
-        result.replace(contentStart, contentLength, escapedContent);
+        tagStart = xmlString.indexOf(openTag, contentEnd + closeTag.length());
     }
+    result += QStringView(xmlString).mid(copiedUpTo);
 
     return result;
 }
@@ -145,23 +352,63 @@ QString ExpressionXmlParser::fixXmlDescriptions(const QString& xmlString) {
     return result;
 }
 
-void ExpressionXmlParser::parseQDomDocument(const QDomDocument& doc, Expression &expression, QList<TEException>& errors) {
+void ExpressionXmlParser::parseQDomDocument(const QDomDocument& doc, ExpressionDocument &document, QList<TEException>& errors, bool requireExpression,
+                                            const CancellationToken* cancellation) {
+    StageTimer timer(PipelineStage::Validate);
 
     QDomElement root = doc.documentElement();
     if (root.isNull() || root.tagName() != "root") {
         errors.append(TEException(ErrorType::MissingRootElemnt));
-        throw NULL;
+        return;
     }
 
-    validateElement(root, QList<QString>{}, QHash<QString, int>{{"expression", 1}, {"variables", 1}, {"functions", 1}, {"unions", 1}, {"structures", 1}, {"classes", 1}, {"enums", 1}}, errors);
+    // Строки схемы размещаются в едином пуле, который удерживается схемой
+    QSharedPointer<StringPool> pool = QSharedPointer<StringPool>::create();
+
+    validateElement(root, QList<QString>{}, QHash<QString, int>{{"expression", 1}, {"expressions", 1}, {"variables", 1}, {"functions", 1}, {"unions", 1}, {"structures", 1}, {"classes", 1}, {"enums", 1}}, errors, false);
+
+    // Корень содержит либо одно <expression>, либо список <expressions>
+    QList<ExpressionEntry> entries;
+    QDomElement _expressions = root.firstChildElement("expressions");
+    if (_expressions.isNull()) {
+        QList<QString> requiredElements{"variables", "functions", "unions", "structures", "classes", "enums"};
+        if (requireExpression) requiredElements.prepend("expression");
+        validateRequiredChildElements(root, requiredElements, errors);
+
+        // Документ только со схемой выражения не содержит
+        QDomElement _expression = root.firstChildElement("expression");
+        if (requireExpression || !_expression.isNull()) {
+            ExpressionEntry entry;
+            entry.line = _expression.lineNumber();
+            entry.expression = parseExpression(_expression, errors);
+            entries.append(entry);
+        }
+    }
+    else {
+        validateRequiredChildElements(root, QList<QString>{"variables", "functions", "unions", "structures", "classes", "enums"}, errors);
 
-    expression.setExpression(parseExpression(root.firstChildElement("expression"), errors));
-    expression.setVariables(parseVariables(root.firstChildElement("variables"), errors));
-    expression.setFunctions(parseFunctions(root.firstChildElement("functions"), errors));
-    expression.setUnions(parseUnions(root.firstChildElement("unions"), errors));
-    expression.setStructures(parseStructures(root.firstChildElement("structures"), errors));
-    expression.setClasses(parseClasses(root.firstChildElement("classes"), errors));
-    expression.setEnums(parseEnums(root.firstChildElement("enums"), errors));
+        QDomElement _expression = root.firstChildElement("expression");
+        if (!_expression.isNull())
+            errors.append(TEException(ErrorType::UnexpectedElement, _expression.lineNumber(), QList<QString>{"expression", "expressions"}));
+
+        entries = parseExpressions(_expressions, errors, cancellation);
+    }
+
+    if (isInterrupted(cancellation, errors)) return;
+    QHash<QString, Variable> variables = parseVariables(root.firstChildElement("variables"), errors, *pool);
+    QHash<QString, Function> functions = parseFunctions(root.firstChildElement("functions"), errors, *pool);
+    if (isInterrupted(cancellation, errors)) return;
+    QHash<QString, Union> unions = parseUnions(root.firstChildElement("unions"), errors, *pool);
+    QHash<QString, Structure> structures = parseStructures(root.firstChildElement("structures"), errors, *pool);
+    if (isInterrupted(cancellation, errors)) return;
+    QHash<QString, Class> classes = parseClasses(root.firstChildElement("classes"), errors, *pool);
+    QHash<QString, Enum> enums = parseEnums(root.firstChildElement("enums"), errors, *pool);
+    if (isInterrupted(cancellation, errors)) return;
+
+    // Схема строится один раз из всех считанных сущностей
+    document.setSchema(CompiledSchema::create(variables, functions, unions, structures, classes, enums, pool));
+    document.setExpressions(entries);
+    document.setMultiExpression(!_expressions.isNull());
 }
 
 QString ExpressionXmlParser::parseExpression(const QDomElement &_expression, QList<TEException>& errors)
@@ -177,7 +424,38 @@ QString ExpressionXmlParser::parseExpression(const QDomElement &_expression, QLi
     return res;
 }
 
-QHash<QString, Variable> ExpressionXmlParser::parseVariables(const QDomElement &_variables, QList<TEException>& errors)
+QList<ExpressionEntry> ExpressionXmlParser::parseExpressions(const QDomElement &_expressions, QList<TEException> &errors, const CancellationToken *cancellation)
+{
+    validateElement(_expressions, QList<QString>{}, QHash<QString, int>{{"expression", expressionsMaxCount}}, errors, true);
+
+    QList<ExpressionEntry> result;
+    QSet<QString> ids;
+
+    QDomElement _expression = _expressions.firstChildElement("expression");
+    while (!_expression.isNull() && !isInterrupted(cancellation, errors)) {
+        validateElement(_expression, QList<QString>{"id"}, QHash<QString, int>{}, errors, true);
+
+        ExpressionEntry entry;
+        entry.id = _expression.attribute("id");
+        entry.line = _expression.lineNumber();
+
+        // Идентификатор — ключ результата, поэтому он должен быть непустым и уникальным
+        if (_expression.hasAttribute("id") && entry.id.isEmpty())
+            errors.append(TEException(ErrorType::EmptyAttributeName, entry.line, QList<QString>{"id"}));
+        else if (!entry.id.isEmpty() && ids.contains(entry.id))
+            errors.append(TEException(ErrorType::NonUniqueName, entry.line, QList<QString>{entry.id, "expression"}));
+        ids.insert(entry.id);
+
+        // Ошибки значения выражения относятся только к этому выражению
+        entry.expression = parseExpression(_expression, entry.errors);
+        result.append(entry);
+
+        _expression = _expression.nextSiblingElement("expression");
+    }
+    return result;
+}
+
+QHash<QString, Variable> ExpressionXmlParser::parseVariables(const QDomElement &_variables, QList<TEException>& errors, StringPool& pool)
 {
     validateElement(_variables, QList<QString>{}, QHash<QString, int>{{"variable", childElementsMaxCount}}, errors, false);
 
@@ -185,16 +463,16 @@ QHash<QString, Variable> ExpressionXmlParser::parseVariables(const QDomElement &
     if(_variables.childNodes().isEmpty()) return result;
 
     QDomNode childNode = _variables.firstChild();
-    while (!childNode.isNull()) {
+    while (!childNode.isNull() && !isInterrupted(nullptr, errors)) {
 
-        Variable child = parseVariable(childNode.toElement(), errors);
+        Variable child = parseVariable(childNode.toElement(), errors, pool);
         result.insert(child.name, child);
         childNode = childNode.nextSibling();
     }
     return result;
 }
 
-Variable ExpressionXmlParser::parseVariable(const QDomElement &_variable, QList<TEException>& errors)
+Variable ExpressionXmlParser::parseVariable(const QDomElement &_variable, QList<TEException>& errors, StringPool& pool)
 {
 
     validateElement(_variable, QList<QString>{"name", "type"}, QHash<QString, int>{{"description", 1}}, errors, true);
@@ -204,10 +482,10 @@ Variable ExpressionXmlParser::parseVariable(const QDomElement &_variable, QList<
     QDomElement descr = _variable.firstChildElement("description");
 
     QString desc = parseDescription(_variable.firstChildElement("description"), errors);
-    return Variable(name, type, desc);
+    return Variable(pool.intern(name), pool.intern(type), pool.intern(desc));
 }
 
-QHash<QString, Function> ExpressionXmlParser::parseFunctions(const QDomElement &_functions, QList<TEException>& errors)
+QHash<QString, Function> ExpressionXmlParser::parseFunctions(const QDomElement &_functions, QList<TEException>& errors, StringPool& pool)
 {
     validateElement(_functions, QList<QString>{}, QHash<QString, int>{{"function", childElementsMaxCount}}, errors, false);
 
@@ -215,9 +493,9 @@ QHash<QString, Function> ExpressionXmlParser::parseFunctions(const QDomElement &
     if(_functions.childNodes().isEmpty()) return result;
 
     QDomNode childNode = _functions.firstChild();
-    while (!childNode.isNull()) {
+    while (!childNode.isNull() && !isInterrupted(nullptr, errors)) {
 
-        Function child = parseFunction(childNode.toElement(), errors);
+        Function child = parseFunction(childNode.toElement(), errors, pool);
         result.insert(child.name, child);
 
         childNode = childNode.nextSibling();
@@ -225,7 +503,7 @@ QHash<QString, Function> ExpressionXmlParser::parseFunctions(const QDomElement &
     return result;
 }
 
-Function ExpressionXmlParser::parseFunction(const QDomElement &_function, QList<TEException>& errors)
+Function ExpressionXmlParser::parseFunction(const QDomElement &_function, QList<TEException>& errors, StringPool& pool)
 {
     validateElement(_function, QList<QString>{"name", "type", "paramsCount"}, QHash<QString, int>{{"description", 1}}, errors, true);
 
@@ -234,10 +512,10 @@ Function ExpressionXmlParser::parseFunction(const QDomElement &_function, QList<
     int paramsCount = parseParamsCount(_function, errors);
     QString desc = parseDescription(_function.firstChildElement("description"), errors);
 
-    return Function(name, type, paramsCount, desc);
+    return Function(pool.intern(name), pool.intern(type), paramsCount, pool.intern(desc));
 }
 
-QHash<QString, Union> ExpressionXmlParser::parseUnions(const QDomElement &_unions, QList<TEException>& errors)
+QHash<QString, Union> ExpressionXmlParser::parseUnions(const QDomElement &_unions, QList<TEException>& errors, StringPool& pool)
 {
     validateElement(_unions, QList<QString>{}, QHash<QString, int>{{"union", childElementsMaxCount}}, errors, false);
 
@@ -245,8 +523,8 @@ QHash<QString, Union> ExpressionXmlParser::parseUnions(const QDomElement &_union
     if(_unions.childNodes().isEmpty()) return result;
 
     QDomNode childNode = _unions.firstChild();
-    while (!childNode.isNull()) {
-        Union child = parseUnion(childNode.toElement(), errors);
+    while (!childNode.isNull() && !isInterrupted(nullptr, errors)) {
+        Union child = parseUnion(childNode.toElement(), errors, pool);
         result.insert(child.name, child);
 
         childNode = childNode.nextSibling();
@@ -254,22 +532,22 @@ QHash<QString, Union> ExpressionXmlParser::parseUnions(const QDomElement &_union
     return result;
 }
 
-Union ExpressionXmlParser::parseUnion(const QDomElement &_union, QList<TEException>& errors)
+Union ExpressionXmlParser::parseUnion(const QDomElement &_union, QList<TEException>& errors, StringPool& pool)
 {
     validateElement(_union, QList<QString>{"name"}, QHash<QString, int>{{"variables", 1}, {"functions", 1}}, errors, true);
 
     QString name = parseName(_union, errors);
-    QHash<QString, Variable> variables = parseVariables(_union.firstChildElement("variables"), errors);
-    QHash<QString, Function> functions = parseFunctions(_union.firstChildElement("functions"), errors);
+    QHash<QString, Variable> variables = parseVariables(_union.firstChildElement("variables"), errors, pool);
+    QHash<QString, Function> functions = parseFunctions(_union.firstChildElement("functions"), errors, pool);
 
     int elementsCount = variables.count() + functions.count();
     if(elementsCount > childElementsMaxCount)
         errors.append(TEException(ErrorType::InputElementsExceeded, _union.lineNumber(), QList<QString>{"union", QString::number(elementsCount), QString::number(childElementsMaxCount)}));
 
-    return Union(name, variables, functions);
+    return Union(pool.intern(name), variables, functions);
 }
 
-QHash<QString, Structure> ExpressionXmlParser::parseStructures(const QDomElement &_structures, QList<TEException>& errors)
+QHash<QString, Structure> ExpressionXmlParser::parseStructures(const QDomElement &_structures, QList<TEException>& errors, StringPool& pool)
 {
 
     validateElement(_structures, QList<QString>{}, QHash<QString, int>{{"structure", childElementsMaxCount}}, errors, false);
@@ -278,9 +556,9 @@ QHash<QString, Structure> ExpressionXmlParser::parseStructures(const QDomElement
     if(_structures.childNodes().isEmpty()) return result;
 
     QDomNode childNode = _structures.firstChild();
-    while (!childNode.isNull()) {
+    while (!childNode.isNull() && !isInterrupted(nullptr, errors)) {
 
-        Structure child = parseStructure(childNode.toElement(), errors);
+        Structure child = parseStructure(childNode.toElement(), errors, pool);
         result.insert(child.name, child);
 
         childNode = childNode.nextSibling();
@@ -288,22 +566,22 @@ QHash<QString, Structure> ExpressionXmlParser::parseStructures(const QDomElement
     return result;
 }
 
-Structure ExpressionXmlParser::parseStructure(const QDomElement &_structure, QList<TEException>& errors)
+Structure ExpressionXmlParser::parseStructure(const QDomElement &_structure, QList<TEException>& errors, StringPool& pool)
 {
     validateElement(_structure, QList<QString>{"name"}, QHash<QString, int>{{"variables", 1}, {"functions", 1}}, errors, true);
 
     QString name = parseName(_structure, errors);
-    QHash<QString, Variable> variables = parseVariables(_structure.firstChildElement("variables"), errors);
-    QHash<QString, Function> functions = parseFunctions(_structure.firstChildElement("functions"), errors);
+    QHash<QString, Variable> variables = parseVariables(_structure.firstChildElement("variables"), errors, pool);
+    QHash<QString, Function> functions = parseFunctions(_structure.firstChildElement("functions"), errors, pool);
 
     int elementsCount = variables.count() + functions.count();
     if(elementsCount > childElementsMaxCount)
         errors.append(TEException(ErrorType::InputElementsExceeded, _structure.lineNumber(), QList<QString>{"structure", QString::number(elementsCount), QString::number(childElementsMaxCount)}));
 
-    return Structure(name, variables, functions);
+    return Structure(pool.intern(name), variables, functions);
 }
 
-QHash<QString, Class> ExpressionXmlParser::parseClasses(const QDomElement &_classes, QList<TEException>& errors)
+QHash<QString, Class> ExpressionXmlParser::parseClasses(const QDomElement &_classes, QList<TEException>& errors, StringPool& pool)
 {
 
     validateElement(_classes, QList<QString>{}, QHash<QString, int>{{"class", childElementsMaxCount}}, errors, false);
@@ -312,9 +590,9 @@ QHash<QString, Class> ExpressionXmlParser::parseClasses(const QDomElement &_clas
     if(_classes.childNodes().isEmpty()) return result;
 
     QDomNode childNode = _classes.firstChild();
-    while (!childNode.isNull()) {
+    while (!childNode.isNull() && !isInterrupted(nullptr, errors)) {
 
-        Class child = parseClass(childNode.toElement(), errors);
+        Class child = parseClass(childNode.toElement(), errors, pool);
         result.insert(child.name, child);
 
         childNode = childNode.nextSibling();
@@ -322,22 +600,22 @@ QHash<QString, Class> ExpressionXmlParser::parseClasses(const QDomElement &_clas
     return result;
 }
 
-Class ExpressionXmlParser::parseClass(const QDomElement &_class, QList<TEException>& errors)
+Class ExpressionXmlParser::parseClass(const QDomElement &_class, QList<TEException>& errors, StringPool& pool)
 {
     validateElement(_class, QList<QString>{"name"}, QHash<QString, int>{{"variables", 1}, {"functions", 1}}, errors, true);
 
     QString name = parseName(_class, errors);
-    QHash<QString, Variable> variables = parseVariables(_class.firstChildElement("variables"), errors);
-    QHash<QString, Function> functions = parseFunctions(_class.firstChildElement("functions"), errors);
+    QHash<QString, Variable> variables = parseVariables(_class.firstChildElement("variables"), errors, pool);
+    QHash<QString, Function> functions = parseFunctions(_class.firstChildElement("functions"), errors, pool);
 
     int elementsCount = variables.count() + functions.count();
     if(elementsCount > childElementsMaxCount)
         errors.append(TEException(ErrorType::InputElementsExceeded, _class.lineNumber(), QList<QString>{"claass", QString::number(elementsCount), QString::number(childElementsMaxCount)}));
 
-    return Class(name, variables, functions);
+    return Class(pool.intern(name), variables, functions);
 }
 
-QHash<QString, Enum> ExpressionXmlParser::parseEnums(const QDomElement &_enums, QList<TEException>& errors)
+QHash<QString, Enum> ExpressionXmlParser::parseEnums(const QDomElement &_enums, QList<TEException>& errors, StringPool& pool)
 {
 
     validateElement(_enums, QList<QString>{}, QHash<QString, int>{{"enum", 20}}, errors, false);
@@ -346,9 +624,9 @@ QHash<QString, Enum> ExpressionXmlParser::parseEnums(const QDomElement &_enums,
     if(_enums.childNodes().isEmpty()) return result;
 
     QDomNode childNode = _enums.firstChild();
-    while (!childNode.isNull()) {
+    while (!childNode.isNull() && !isInterrupted(nullptr, errors)) {
 
-        Enum child = parseEnum(childNode.toElement(), errors);
+        Enum child = parseEnum(childNode.toElement(), errors, pool);
         result.insert(child.name, child);
 
         childNode = childNode.nextSibling();
@@ -356,17 +634,17 @@ QHash<QString, Enum> ExpressionXmlParser::parseEnums(const QDomElement &_enums,
     return result;
 }
 
-Enum ExpressionXmlParser::parseEnum(const QDomElement &_enum, QList<TEException>& errors)
+Enum ExpressionXmlParser::parseEnum(const QDomElement &_enum, QList<TEException>& errors, StringPool& pool)
 {
     validateElement(_enum, QList<QString>{"name"}, QHash<QString, int>{{"value", 20}}, errors, true);
 
     QString name = parseName(_enum, errors);
-    QHash<QString, QString> values = parseEnumValues(_enum, errors);
+    QHash<QString, QString> values = parseEnumValues(_enum, errors, pool);
 
-    return Enum(name, values);
+    return Enum(pool.intern(name), values);
 }
 
-QHash<QString, QString> ExpressionXmlParser::parseEnumValues(const QDomElement &_values, QList<TEException>& errors)
+QHash<QString, QString> ExpressionXmlParser::parseEnumValues(const QDomElement &_values, QList<TEException>& errors, StringPool& pool)
 {
     QHash<QString, QString> result;
     // Перебираем все элементы <value> внутри <enum>
@@ -379,7 +657,7 @@ QHash<QString, QString> ExpressionXmlParser::parseEnumValues(const QDomElement &
         QString valueName = valueElement.attribute("name");
         QString description = parseDescription(valueElement.firstChildElement("description"), errors);
 
-        result.insert(valueName, description);
+        result.insert(pool.intern(valueName), pool.intern(description));
     }
     return result;
 }
@@ -487,6 +765,12 @@ void ExpressionXmlParser::validateAttributes(const QDomElement& curElement, cons
 
 void ExpressionXmlParser::validateChildElements(const QDomElement& curElement, const QHash<QString, int>& elements, QList<TEException>& errors) {
 
+    // Подсчитываем потомков по именам за один проход, чтобы не обходить список для каждого потомка
+    QHash<QString, int> childCounts;
+    for (QDomElement child = curElement.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+        childCounts[child.tagName()]++;
+    }
+
     QDomNode childNode = curElement.firstChild();
     while (!childNode.isNull()) {
         if (childNode.isElement()) {
@@ -497,11 +781,13 @@ void ExpressionXmlParser::validateChildElements(const QDomElement& curElement, c
                 errors.append(TEException(ErrorType::UnexpectedElement, childElement.lineNumber(), QList<QString>{childName, elements.keys().join("; ")}));
             }
             else {
-                int count = countDirectChildren(curElement, childName);
+                int count = childCounts.value(childName);
                 int value = elements.value(childName);
                 if(count > value)
                     errors.append(TEException(ErrorType::DuplicateElement, childElement.lineNumber(), QList<QString>{childName}));
             }
+            // Элемент с множеством лишних потомков не должен порождать неограниченный список ошибок
+            if (isInterrupted(nullptr, errors)) return;
         }
         childNode = childNode.nextSibling();
     }
@@ -6,13 +6,33 @@
 #ifndef EXPRESSIONXMLPARSER_H
 #define EXPRESSIONXMLPARSER_H
 
+#include "cancellationtoken.h"
 #include "expression.h"
+#include "expressiondocument.h"
+#include "teresult.h"
 #include <QDomDocument>
 #include <QString>
 #include <QTemporaryFile>
 
+#include <memory>
+
+/*!
+ * \brief Ограничения объёма работы при разборе входного документа
+ *
+ * Защищают от ошибочных и враждебных входных данных: при достижении ограничения разбор
+ * сразу прекращается с соответствующей ошибкой.
+ */
+struct ParserLimits {
+    qint64 maxInputBytes = 64LL * 1024 * 1024;  /*!< Максимальный размер документа в байтах (проверяется до чтения файла) */
+    int maxNestingDepth = 16;                   /*!< Максимальная глубина вложенности элементов */
+    int maxAttributesPerElement = 8;            /*!< Максимальное количество атрибутов одного элемента */
+    int maxErrors = 100;                        /*!< Максимальное количество ошибок уровня документа */
+};
+
 /*!
  * \brief Класс для парсинга XML-файла в структуру Expression
+ *
+ * Методы с префиксом try возвращают ошибки в TEResult, остальные — выбрасывают их списком QList<TEException>.
  */
 class ExpressionXmlParser
 {
@@ -21,11 +41,114 @@ public:
      * \brief Обработка XML-файла и преобразование его в структуру Expression
      * \param[in] inputFilePath Путь к XML-файлу
      * \param[out] expression Объект Expression, заполняемый данными из XML
-     * \throw QList<TEException> Список ошибок, возникших при парсинге
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \throw QList<TEException> Список ошибок, возникших при парсинге; при отмене — только ErrorType::Cancelled
+     */
+    static void readDataFromXML(const QString& inputFilePath, Expression& expression, const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Обработка XML-файла с одним (<expression>) или несколькими (<expressions>) выражениями
+     * \param[in] inputFilePath Путь к XML-файлу
+     * \param[out] document Документ, заполняемый данными из XML
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \throw QList<TEException> Список ошибок уровня документа; ошибки отдельных
+     *        выражений формата <expressions> сохраняются в ExpressionEntry::errors
+     */
+    static void readDocumentFromXML(const QString& inputFilePath, ExpressionDocument& document, const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Обработка XML-документа, уже находящегося в памяти (например, полученного по сети)
+     * \param[in] xmlContent Текст XML-документа
+     * \param[out] document Документ, заполняемый данными из XML
+     * \param[in] sourceName Имя источника для сообщений об ошибках разбора
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \throw QList<TEException> Список ошибок уровня документа
+     */
+    static void readDocumentFromXMLContent(const QString& xmlContent, ExpressionDocument& document, const QString& sourceName = QString(),
+                                           const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Обработка XML-документа, содержащего только схему (для регистрации схемы на сервере)
+     *
+     * Элементы <expression> и <expressions> необязательны; если они есть, они проверяются, но не сохраняются.
+     * \param[in] xmlContent Текст XML-документа
+     * \param[in] sourceName Имя источника для сообщений об ошибках разбора
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \return Схема документа
+     * \throw QList<TEException> Список ошибок
+     */
+    static QSharedPointer<const CompiledSchema> readSchemaFromXMLContent(const QString& xmlContent, const QString& sourceName = QString(),
+                                                                         const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Обработка XML-файла и преобразование его в структуру Expression без исключений
+     * \param[in] inputFilePath Путь к XML-файлу
+     * \param[out] expression Объект Expression, заполняемый данными из XML
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \return Успех или список ошибок, возникших при парсинге
+     */
+    static TEResult<void> tryReadDataFromXML(const QString& inputFilePath, Expression& expression, const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Обработка XML-файла с одним или несколькими выражениями без исключений
+     * \param[in] inputFilePath Путь к XML-файлу
+     * \param[out] document Документ, заполняемый данными из XML
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \return Успех или список ошибок уровня документа
+     */
+    static TEResult<void> tryReadDocumentFromXML(const QString& inputFilePath, ExpressionDocument& document, const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Обработка XML-документа, уже находящегося в памяти, без исключений
+     * \param[in] xmlContent Текст XML-документа
+     * \param[out] document Документ, заполняемый данными из XML
+     * \param[in] sourceName Имя источника для сообщений об ошибках разбора
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \return Успех или список ошибок уровня документа
+     */
+    static TEResult<void> tryReadDocumentFromXMLContent(const QString& xmlContent, ExpressionDocument& document, const QString& sourceName = QString(),
+                                                        const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Обработка XML-документа, содержащего только схему, без исключений
+     * \param[in] xmlContent Текст XML-документа
+     * \param[in] sourceName Имя источника для сообщений об ошибках разбора
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \return Схема документа или список ошибок
      */
-    static void readDataFromXML(const QString& inputFilePath, Expression& expression);
+    static TEResult<QSharedPointer<const CompiledSchema>> tryReadSchemaFromXMLContent(const QString& xmlContent, const QString& sourceName = QString(),
+                                                                                      const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Получение ограничений разбора
+     */
+    static const ParserLimits& getLimits();
+
+    /*!
+     * \brief Установка ограничений разбора для всех последующих вызовов
+     *
+     * Вызывается до начала разбора (например, при запуске программы), а не во время работы потоков.
+     * \param[in] newLimits Ограничения
+     */
+    static void setLimits(const ParserLimits& newLimits);
+
+    /*!
+     * \brief Получение признака чтения входного файла через временную копию
+     */
+    static bool isInputCopyEnabled();
+
+    /*!
+     * \brief Включение или отключение чтения входного файла через временную копию в каталоге программы
+     *
+     * Без копии файл читается напрямую, и каталог программы (QCoreApplication) для разбора не нужен.
+     * Вызывается до начала разбора, а не во время работы потоков.
+     * \param[in] enabled Читать через временную копию (по умолчанию — да)
+     */
+    static void setInputCopyEnabled(bool enabled);
 
 private:
+    friend class bench_xmlParser; ///< Замеры отдельных этапов разбора (benchmarks)
+
     //////////////////////////////////////////////////
     /// Методы для работы с файлами
     //////////////////////////////////////////////////
@@ -34,19 +157,26 @@ private:
      * \brief Считывание XML-документа из файла
      * \param[in] filePath Путь к XML-файлу
      * \param[out] errors Список ошибок
-     * \return Объект QDomDocument, считанный из файла
-     * \throw NULL исключение при обработке
+     * \return Объект QDomDocument, считанный из файла (пустой, если в errors добавлена ошибка)
      */
     static QDomDocument readXML(const QString& filePath, QList<TEException>& errors);
 
+    /*!
+     * \brief Разбор текста XML-документа
+     * \param[in] xmlContent Текст XML-документа
+     * \param[in] sourceName Имя источника для сообщений об ошибках
+     * \param[out] errors Список ошибок
+     * \return Объект QDomDocument (пустой, если в errors добавлена ошибка)
+     */
+    static QDomDocument parseXMLContent(const QString& xmlContent, const QString& sourceName, QList<TEException>& errors);
+
     /*!
      * \brief Создание временной копии исходного XML-файла
      * \param[in] sourceFilePath Путь к исходному файлу
      * \param[out] errors Список ошибок
-     * \return Указатель на временный файл
-     * \throw TEException исключение при обработке
+     * \return Временный файл (удаляется вместе с объектом) или nullptr, если в errors добавлена ошибка
      */
-    static QTemporaryFile* createTempCopy(const QString& sourceFilePath, QList<TEException>& errors);
+    static std::unique_ptr<QTemporaryFile> createTempCopy(const QString& sourceFilePath, QList<TEException>& errors);
 
     //////////////////////////////////////////////////
     /// Методы для исправления XML формата
@@ -87,11 +217,13 @@ private:
     /*!
      * \brief Основной метод для разбора XML-документа
      * \param[in] doc XML-документ
-     * \param[out] expression Структура Expression
+     * \param[out] document Документ: схема и выражения
      * \param[out] errors Список ошибок
-     * \throw TEException исключение при обработке
+     * \param[in] requireExpression Обязателен ли элемент <expression> или <expressions>
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
      */
-    static void parseQDomDocument(const QDomDocument& doc, Expression& expression, QList<TEException>& errors);
+    static void parseQDomDocument(const QDomDocument& doc, ExpressionDocument& document, QList<TEException>& errors, bool requireExpression = true,
+                                  const CancellationToken* cancellation = nullptr);
 
     /*!
      * \brief Извлечение выражения из XML-элемента
@@ -101,109 +233,151 @@ private:
      */
     static QString parseExpression(const QDomElement& _expression, QList<TEException>& errors);
 
+    /*!
+     * \brief Парсинг списка выражений <expressions>
+     * \param[in] _expressions Элемент <expressions>
+     * \param[out] errors Список ошибок уровня документа (структура, атрибуты id)
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \return Выражения; ошибки значения каждого выражения сохраняются в ExpressionEntry::errors
+     */
+    static QList<ExpressionEntry> parseExpressions(const QDomElement& _expressions, QList<TEException>& errors, const CancellationToken* cancellation = nullptr);
+
+    /*!
+     * \brief Проверка, нужно ли прервать разбор: он отменён или собрано слишком много ошибок
+     *
+     * При отмене список ошибок заменяется ошибкой ErrorType::Cancelled, при превышении
+     * ParserLimits::maxErrors — сокращается до допустимого и дополняется ошибкой ErrorType::ErrorLimitExceeded.
+     * Прерывание необратимо: повторные вызовы отбрасывают ошибки, добавленные после него.
+     * \param[in] cancellation Признак отмены разбора (nullptr — без отмены)
+     * \param[in,out] errors Список ошибок
+     * \return true, если разбор нужно прервать
+     */
+    static bool isInterrupted(const CancellationToken* cancellation, QList<TEException>& errors);
+
+    /*!
+     * \brief Потоковая проверка глубины вложенности и количества атрибутов до построения DOM
+     * \param[in] xmlContent Текст XML-документа
+     * \param[out] errors Список ошибок
+     * \return false, если ограничение превышено (ошибка добавлена в errors)
+     */
+    static bool checkStructureLimits(const QString& xmlContent, QList<TEException>& errors);
+
     /*!
      * \brief Парсинг списка переменных
      * \param[in] _variables Элемент <variables>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Хэш-таблица переменных
      */
-    static QHash<QString, Variable> parseVariables(const QDomElement& _variables, QList<TEException>& errors);
+    static QHash<QString, Variable> parseVariables(const QDomElement& _variables, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг одной переменной
      * \param[in] _variable Элемент <variable>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Объект переменной
      */
-    static Variable parseVariable(const QDomElement& _variable, QList<TEException>& errors);
+    static Variable parseVariable(const QDomElement& _variable, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг списка функций
      * \param[in] _functions Элемент <functions>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Хэш-таблица функций
      */
-    static QHash<QString, Function> parseFunctions(const QDomElement& _functions, QList<TEException>& errors);
+    static QHash<QString, Function> parseFunctions(const QDomElement& _functions, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг одной функции
      * \param[in] _function Элемент <function>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Объект функции
      */
-    static Function parseFunction(const QDomElement& _function, QList<TEException>& errors);
+    static Function parseFunction(const QDomElement& _function, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг списка объединений (union)
      * \param[in] _unions Элемент <unions>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Хэш-таблица объединений
      */
-    static QHash<QString, Union> parseUnions(const QDomElement& _unions, QList<TEException>& errors);
+    static QHash<QString, Union> parseUnions(const QDomElement& _unions, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг одного объединения
      * \param[in] _union Элемент <union>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Объект Union
      */
-    static Union parseUnion(const QDomElement& _union, QList<TEException>& errors);
+    static Union parseUnion(const QDomElement& _union, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг списка структур (struct)
      * \param[in] _structures Элемент <structures>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Хэш-таблица структур
      */
-    static QHash<QString, Structure> parseStructures(const QDomElement& _structures, QList<TEException>& errors);
+    static QHash<QString, Structure> parseStructures(const QDomElement& _structures, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг одной структуры
      * \param[in] _structure Элемент <structure>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Объект Structure
      */
-    static Structure parseStructure(const QDomElement& _structure, QList<TEException>& errors);
+    static Structure parseStructure(const QDomElement& _structure, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг списка классов
      * \param[in] _classes Элемент <classes>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Хэш-таблица классов
      */
-    static QHash<QString, Class> parseClasses(const QDomElement& _classes, QList<TEException>& errors);
+    static QHash<QString, Class> parseClasses(const QDomElement& _classes, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг одного класса
      * \param[in] _class Элемент <class>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Объект Class
      */
-    static Class parseClass(const QDomElement& _class, QList<TEException>& errors);
+    static Class parseClass(const QDomElement& _class, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг списка перечислений
      * \param[in] _enums Элемент <enums>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Хэш-таблица перечислений
      */
-    static QHash<QString, Enum> parseEnums(const QDomElement& _enums, QList<TEException>& errors);
+    static QHash<QString, Enum> parseEnums(const QDomElement& _enums, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг одного перечисления
      * \param[in] _enum Элемент <enum>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Объект Enum
      */
-    static Enum parseEnum(const QDomElement& _enum, QList<TEException>& errors);
+    static Enum parseEnum(const QDomElement& _enum, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Парсинг значений перечисления
      * \param[in] _values Элемент <values>
      * \param[out] errors Список ошибок
+     * \param[in,out] pool Пул строк схемы
      * \return Хэш-таблица значений
      */
-    static QHash<QString, QString> parseEnumValues(const QDomElement& _values, QList<TEException>& errors);
+    static QHash<QString, QString> parseEnumValues(const QDomElement& _values, QList<TEException>& errors, StringPool& pool);
 
     /*!
      * \brief Извлечение описания
@@ -300,6 +474,9 @@ private:
     /*! \brief Максимальная длина выражения */
     static constexpr int expressionMaxLength = 1024;
 
+    /*! \brief Максимальное количество выражений в <expressions> */
+    static constexpr int expressionsMaxCount = 100000;
+
     /*! \brief Максимальное количество дочерних элементов */
     static constexpr int childElementsMaxCount = 20;
 
@@ -308,6 +485,10 @@ private:
 
     /*! \brief Поддерживаемые типы данных для переменных */
     static const QList<QString> supportedDataTypesForVar;
+
+    static ParserLimits limits; ///< Ограничения разбора
+
+    static bool inputCopyEnabled; ///< Чтение входного файла через временную копию
 };
 
 #endif // EXPRESSIONXMLPARSER_H
@@ -4,13 +4,27 @@
 *
 * \mainpage Документация для программы "text explanations on english language (textExplanationsOnEng)"
 Программа предназначена для генерации текстового объяснения выражения на английском языке. Она принимает на вход XML-файл с описанием выражения и генерирует соответствующее объяснение в виде текстового файла.
-\n\nДля функционирования программы необходима операционная система Windows 7 или выше.
-\nТребуемые библиотеки: Qt6Core.dll, Qt6Xml.dll, libgcc_s_seh-1.dll, libstdc++-6.dll, libwinpthread-1.dll
+\n\nДля функционирования программы необходима операционная система Windows 7 или выше либо Linux.
+\nТребуемые библиотеки: Qt6Core.dll, Qt6Xml.dll, libgcc_s_seh-1.dll, libstdc++-6.dll, libwinpthread-1.dll (для Windows)
 \nПрограмма должна получать два аргумента командной строки: имя входного файла и имя выходного файла в формате 'txt'
+\nВходной файл может содержать одно выражение (<expression>) или несколько выражений над общей схемой (<expressions><expression id="...">); во втором случае объяснения выводятся по идентификаторам в порядке документа.
+\nПакетный режим (--batch) обрабатывает множество файлов за один запуск: файл-список пар "входной выходной", каталог или шаблон имени. Файлы обрабатываются параллельно (--jobs N), результаты выводятся в порядке списка и совпадают с результатами запуска для каждого файла в отдельности. Параметр --timeout ms ограничивает время обработки одного файла (или одного запроса в режиме сервера).
+\nС параметром --cache-dir результаты пакетной обработки сохраняются на диске: входной файл, содержимое которого не изменилось с прошлого запуска, не разбирается повторно — объяснение берётся из кэша и записывается в выходной файл.
+\nРежим проверки (--check) выполняет разбор входных файлов и проверку выражений над схемой без построения объяснений и записи выходных файлов: выводятся только ошибки с номерами строк. Параметр --check можно повторять; файлы проверяются параллельно (--jobs N), код возврата 1 означает, что хотя бы один файл содержит ошибки.
+\nПараметр --stats (в любом режиме) выводит в поток ошибок время этапов обработки (копирование файла, экранирование, построение DOM, проверка, построение дерева, объяснение, удаление повторов, запись) и счётчики; для пакета и сервера — суммарно и с перцентилями по файлам или запросам. --stats=json выводит то же в формате JSON. Сборка с DEFINES+=TE_DISABLE_STATS удаляет замеры полностью. С параметром --perf-counters (только Linux) этапам дополнительно приписываются аппаратные счётчики процессора (такты, инструкции, промахи кэша, ошибки предсказания переходов); если ядро запрещает perf_event_open (например, в контейнере), статистика выводится с пометкой "unavailable". С параметром --track-allocations учитываются выделения памяти (malloc/realloc/free, в том числе буферы строк и контейнеров Qt, и operator new): количество и объём выделений и пик занятой памяти по этапам и по файлам или запросам; в режиме профиля — выделения каждого узла дерева.
+\nПараметр --trace file (пакетный режим, проверка и сервер) сохраняет журнал этапов и запросов в формате Chrome trace event: файл открывается в Perfetto (ui.perfetto.dev) или chrome://tracing. События запросов содержат входной файл и количество лексем.
+\nРежим профиля (--profile-tree input-file) объясняет выражения входного файла и для каждого узла дерева выражения выводит время построения его объяснения (включительно и собственное), количество подстановок в шаблоны (включительно/собственных) и размер объяснения в байтах — деревом с отступами или, с --profile-tree=json, в формате JSON. Выходной файл не создаётся.
+\nРежим сервера (--serve, только Unix) принимает запросы с XML-документами через Unix domain socket; формат сообщений описан в serverprotocol.h.
 
 \nПример команды запуска программы:
 * \code
 .\textExplanationsOnEng.exe input.txt output.txt
+./textExplanationsOnEng --batch manifest.txt --jobs 8
+./textExplanationsOnEng --batch "inputs/*.xml" --cache-dir .explanations-cache
+./textExplanationsOnEng --check "inputs/*.xml" --check extra.xml
+./textExplanationsOnEng --batch manifest.txt --stats=json
+./textExplanationsOnEng --batch "inputs/*.xml" --trace batch-trace.json
+./textExplanationsOnEng --profile-tree slow-input.xml
 * \endcode
 
 * \author Chechetko Nikita
@@ -19,18 +33,29 @@
 */
 
 
+#include "allocationtracker.h"
+#include "batchprocessor.h"
+#include "explanationserver.h"
 #include "expression.h"
+#include "expressiondocument.h"
+#include "expressionxmlparser.h"
+#include "perfcounters.h"
+#include "pipelinestats.h"
 #include "qdir.h"
 #include "teexception.h"
+#include "tracelog.h"
+#include "treeprofiler.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QStringConverter>
 #include <QTextStream>
 
 #include <QCoreApplication>
 #include <QFileInfo>
+#ifdef Q_OS_WIN
 #include <windows.h>
-#include <conio.h>
-#include <QTextStream>
-//#include <QQmlApplicationEngine>
+#endif
 
 
 /*!
@@ -46,13 +71,103 @@ void printHelpMessage(QTextStream& cout, const QString& filename);
  * \param[in] inputFile Путь к входному XML-файлу с выражением
  * \param[in] outputFile Путь к выходному файлу (если необходимо сохранить результат)
  */
-void printExplanation(QTextStream& cout, const QString& inputFile, const QString& outputFile);
+void printExplanation(QTextStream& cout, const QString& inputFile, const QString& outputFile, StatsAggregate* stats);
+
+/*!
+ * \brief Обрабатывает один входной файл без создания объекта приложения
+ *
+ * Инструменты запускают программу для каждого файла отдельно, и время запуска входит во время обработки файла.
+ * Для одного файла не нужны QCoreApplication, разбор параметров режимов и временная копия входного файла
+ * в каталоге программы; вывод совпадает с выводом printExplanation.
+ * \param[in] inputFile Путь к входному XML-файлу с выражением
+ * \param[in] outputFile Путь к выходному файлу
+ * \return Код возврата программы
+ */
+int explainSingleFile(const QString& inputFile, const QString& outputFile);
+
+/*!
+ * \brief Печатает профиль построения объяснения по узлам дерева для каждого выражения входного файла
+ * \param[out] cout Поток, в который выводится профиль
+ * \param[in] inputFile Путь к входному XML-файлу
+ * \param[in] json Выводить профиль в формате JSON
+ */
+void printTreeProfile(QTextStream& cout, const QString& inputFile, bool json);
+
+/*!
+ * \brief Формат вывода статистики обработки
+ */
+enum class StatsFormat {
+    None,   /*!< Статистика не собирается */
+    Table,  /*!< Таблица для человека (--stats) */
+    Json    /*!< JSON (--stats=json) */
+};
+
+/*!
+ * \brief Извлекает из аргументов параметр "--stats" или "--stats=json", допустимый в любом режиме
+ * \param[in,out] args Аргументы командной строки без имени программы; параметр удаляется
+ * \return Формат вывода статистики
+ */
+StatsFormat takeStatsOption(QStringList& args);
+
+/*!
+ * \brief Параметры пакетного режима и режима сервера
+ */
+struct CommandLineOptions {
+    QString source;         /*!< Файл-список, каталог или шаблон имени (--batch) */
+    QString outputDir;      /*!< Каталог выходных файлов (--out-dir) */
+    QString socketPath;     /*!< Путь к сокету сервера (--serve) */
+    QString cacheDir;       /*!< Каталог постоянного кэша пакетной обработки (--cache-dir) */
+    QString tracePath;      /*!< Файл журнала событий в формате Chrome trace (--trace) */
+    QStringList checkSources; /*!< Входные файлы, каталоги или шаблоны имени для проверки (--check) */
+    StatsAggregate* stats = nullptr; /*!< Сводная статистика (--stats; nullptr — не собирать) */
+    int jobs = 0;           /*!< Количество потоков (0 — по числу ядер) */
+    qint64 timeoutMs = 0;   /*!< Срок обработки одного файла или запроса в миллисекундах (0 — без срока) */
+};
+
+/*!
+ * \brief Разбор аргументов командной строки "--batch source | --check source... | --serve socket [--jobs N] [--timeout ms] [--out-dir dir] [--cache-dir dir] [--trace file]"
+ * \param[in] args Аргументы командной строки без имени программы
+ * \param[out] options Параметры запуска
+ * \return true, если аргументы корректны и задан ровно один из режимов
+ */
+bool parseCommandLineOptions(const QStringList& args, CommandLineOptions& options);
+
+/*!
+ * \brief Печатает пояснения всех файлов пакета
+ * \param[out] cout Поток, в который выводятся пояснения
+ * \param[in] options Параметры пакетной обработки
+ */
+void printBatchExplanations(QTextStream& cout, const CommandLineOptions& options);
+
+/*!
+ * \brief Проверяет входные файлы без построения объяснений и печатает найденные ошибки
+ * \param[out] cout Поток, в который выводятся ошибки
+ * \param[in] options Параметры проверки
+ * \return Код возврата программы: 0 — ошибок нет, 1 — хотя бы один файл содержит ошибки
+ */
+int checkFiles(QTextStream& cout, const CommandLineOptions& options);
+
+/*!
+ * \brief Запускает сервер объяснений и обслуживает запросы до сигнала SIGTERM
+ * \param[out] cout Поток для сообщений о запуске и остановке сервера
+ * \param[in] options Параметры сервера
+ */
+void serveExplanations(QTextStream& cout, const CommandLineOptions& options);
 
 
 
 int main(int argc, char *argv[])
 {
+#if !defined(TESTS) && !defined(Q_OS_WIN)
+    // Запуск "input output" без параметров не требует инициализации остальных режимов.
+    // Аргументы преобразуются так же, как в QCoreApplication::arguments() (в Windows они берутся из командной строки в UTF-16)
+    if (argc == 3 && argv[1][0] != '-' && argv[2][0] != '-')
+        return explainSingleFile(QString::fromLocal8Bit(argv[1]), QString::fromLocal8Bit(argv[2]));
+#endif
+
+#ifdef Q_OS_WIN
     SetConsoleOutputCP(CP_UTF8);
+#endif
     QTextStream cout(stdout);
     cout.setEncoding(QStringConverter::Utf8);
 
@@ -66,73 +181,253 @@ int main(int argc, char *argv[])
     QFileInfo fileInfo(fileName);
     fileName = fileInfo.fileName();
 
+    QStringList args = QCoreApplication::arguments().mid(1);
+    StatsFormat statsFormat = takeStatsOption(args);
+    StatsAggregate stats;
+    // Аппаратные счётчики выводятся в составе статистики
+    if (args.removeAll("--perf-counters") > 0) {
+        if (statsFormat == StatsFormat::None) statsFormat = StatsFormat::Table;
+        QString reason;
+        if (!PerfCounters::enable(&reason)) stats.setHardwareCountersUnavailable(reason);
+    }
+    // Выделения памяти выводятся в составе статистики
+    if (args.removeAll("--track-allocations") > 0) {
+        if (statsFormat == StatsFormat::None) statsFormat = StatsFormat::Table;
+        AllocationTracker::enable();
+    }
+
+    CommandLineOptions options;
+    options.stats = statsFormat != StatsFormat::None ? &stats : nullptr;
+    int exitCode = 0;
     // Если первый аргумент "-help"
-    if(QString(argv[1]) == "-help") {
+    if(args.value(0) == "-help") {
         // Напечатать справочную информацию
         printHelpMessage(cout, fileName);
     }
+    // Если первый аргумент "--batch", "--check" или "--serve" и аргументы режима корректны
+    else if((args.value(0) == "--batch" || args.value(0) == "--check" || args.value(0) == "--serve")
+             && parseCommandLineOptions(args, options)) {
+        if (!options.tracePath.isEmpty())
+            TraceLog::enable();
+        if (!options.socketPath.isEmpty())
+            serveExplanations(cout, options);
+        else if (!options.checkSources.isEmpty())
+            exitCode = checkFiles(cout, options);
+        else
+            printBatchExplanations(cout, options);
+        if (!options.tracePath.isEmpty()) {
+            QString errorMessage;
+            // Неполный журнал непригоден для просмотра — запуск завершается с ошибкой
+            if (!TraceLog::writeChromeTrace(options.tracePath, &errorMessage)) {
+                cout << "Error: " << errorMessage << "\n";
+                exitCode = 1;
+            }
+            TraceLog::disable();
+        }
+    }
+    // Если первый аргумент "--profile-tree" и указан входной файл
+    else if((args.value(0) == "--profile-tree" || args.value(0) == "--profile-tree=json") && args.size() == 2) {
+        printTreeProfile(cout, args[1], args[0] == "--profile-tree=json");
+    }
     // Если аргумента три и второй не начинается с "-"
-    else if(argc == 3 && !QString(argv[2]).startsWith("-")) {
-        printExplanation(cout, argv[1], argv[2]);
+    else if(args.size() == 2 && !args[1].startsWith("-")) {
+        printExplanation(cout, args[0], args[1], options.stats);
     }
     else {
         cout << ("Ошибка в синтаксисе команды. Подробнее: .\\" + fileName +  " -help");
     }
 
-    a.exit(0);
+    cout.flush();
+
+    // Статистика выводится в поток ошибок, чтобы не смешиваться с объяснениями
+    if (options.stats && stats.count() > 0) {
+        QTextStream cerr(stderr);
+        cerr.setEncoding(QStringConverter::Utf8);
+        cerr << (statsFormat == StatsFormat::Json ? stats.formatJson() : stats.formatTable());
+    }
+
+    a.exit(exitCode);
+    return exitCode;
+}
+
+void printExplanation(QTextStream& cout, const QString& inputFile, const QString& outputFile, StatsAggregate* stats) {
+    StatsRecorder recorder;
+    StatsScope scope(stats ? &recorder : nullptr);
+    cout << BatchProcessor::processFile(inputFile, outputFile);
+    if (stats) stats->add(recorder.sample());
+}
+
+int explainSingleFile(const QString& inputFile, const QString& outputFile) {
+    QTextStream cout(stdout);
+    cout.setEncoding(QStringConverter::Utf8);
+    // Без копии разбору не нужен каталог программы, а значит, и QCoreApplication
+    ExpressionXmlParser::setInputCopyEnabled(false);
+    cout << BatchProcessor::processFile(inputFile, outputFile);
+    cout.flush();
     return 0;
 }
 
-// Проверить доступ к файлу
-void checkFileAccess(const QString& filePath) {
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        throw TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{filePath});
+void printTreeProfile(QTextStream& cout, const QString& inputFile, bool json) {
+    ExpressionDocument document;
+    TEResult<void> read = ExpressionXmlParser::tryReadDocumentFromXML(inputFile, document);
+    if (!read.isOk()) {
+        for (const TEException& error : read.getErrors()) {
+            cout << error.what() << "\n";
+        }
+        return;
+    }
+
+    QJsonArray expressions;
+    for (const ExpressionEntry& entry : document.getExpressions()) {
+        TreeProfiler profiler;
+        QList<TEException> errors = entry.errors;
+        QString explanation;
+        if (errors.isEmpty()) {
+            // В документе с несколькими выражениями использование схемы проверяется по документу в целом
+            QSet<QString> usedElements;
+            TreeProfileScope scope(&profiler);
+            TEResult<QString> result = Expression(document.getSchema(), entry.expression)
+                                           .tryGetExplanationInEn(document.isMultiExpression() ? &usedElements : nullptr);
+            if (result.isOk())
+                explanation = result.value();
+            else
+                errors = result.getErrors();
+        }
+
+        QStringList messages;
+        for (const TEException& error : std::as_const(errors)) {
+            messages.append(error.what());
+        }
+
+        if (json) {
+            QJsonObject object{{"id", entry.id}, {"expression", entry.expression}, {"tree", profiler.toJson()}};
+            if (errors.isEmpty())
+                object.insert("explanation", explanation);
+            else
+                object.insert("errors", QJsonArray::fromStringList(messages));
+            expressions.append(object);
+            continue;
+        }
+
+        if (document.isMultiExpression()) cout << "[" << entry.id << "]\n";
+        cout << profiler.formatTree();
+        cout << (errors.isEmpty() ? explanation : messages.join("\n")) << "\n";
+    }
+
+    if (json) cout << QJsonDocument(expressions).toJson(QJsonDocument::Indented);
+}
+
+StatsFormat takeStatsOption(QStringList& args) {
+    StatsFormat format = StatsFormat::None;
+    if (args.removeAll("--stats") > 0) format = StatsFormat::Table;
+    if (args.removeAll("--stats=json") > 0) format = StatsFormat::Json;
+    return format;
+}
+
+bool parseCommandLineOptions(const QStringList& args, CommandLineOptions& options) {
+    // Каждый параметр имеет значение
+    for (qsizetype i = 0; i < args.size(); i++) {
+        if (i + 1 >= args.size()) return false;
+        bool isNumber = true;
+        if (args[i] == "--batch")
+            options.source = args[++i];
+        else if (args[i] == "--jobs")
+            options.jobs = args[++i].toInt(&isNumber);
+        else if (args[i] == "--timeout")
+            options.timeoutMs = args[++i].toLongLong(&isNumber);
+        else if (args[i] == "--out-dir")
+            options.outputDir = args[++i];
+        else if (args[i] == "--serve")
+            options.socketPath = args[++i];
+        else if (args[i] == "--cache-dir")
+            options.cacheDir = args[++i];
+        else if (args[i] == "--trace")
+            options.tracePath = args[++i];
+        else if (args[i] == "--check")
+            options.checkSources.append(args[++i]);
+        else
+            return false;
+        if (!isNumber || options.jobs < 0 || options.timeoutMs < 0) return false;
     }
-    file.close();
+    const int modes = int(!options.source.isEmpty()) + int(!options.socketPath.isEmpty()) + int(!options.checkSources.isEmpty());
+    return modes == 1;
 }
 
-// Функция для записи текста в файл
-void writeToFile(const QString& filePath, const QString& content) {
-    QFile file(filePath);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        out << content;
-        file.close();
-    } else {
-        throw TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{filePath});
+void printBatchExplanations(QTextStream& cout, const CommandLineOptions& options) {
+    // Недоступный кэш не мешает обработке — файлы обрабатываются без него
+    QScopedPointer<DiskCache> diskCache;
+    if (!options.cacheDir.isEmpty()) {
+        diskCache.reset(new DiskCache(options.cacheDir));
+        QString errorMessage;
+        if (!diskCache->open(&errorMessage)) {
+            cout << "Warning: " << errorMessage << "; continuing without cache\n";
+            diskCache.reset();
+        }
+    }
+
+    try {
+        BatchProcessor::run(cout, BatchProcessor::collectItems(options.source, options.outputDir), options.jobs,
+                            nullptr, diskCache.data(), options.timeoutMs, options.stats);
+    } catch (TEException& error) {
+        cout << error.what() << "\n";
     }
 }
 
-void printExplanation(QTextStream& cout, const QString& inputFile, const QString& outputFile) {
+int checkFiles(QTextStream& cout, const CommandLineOptions& options) {
     try {
-        // Проверить доступ к выходному файлу
-        checkFileAccess(outputFile);
-        // Считать входной файл
-        Expression exp = Expression::fromFile(inputFile);
-        // Получить объяснение выражения
-        QString explanation = exp.getExplanationInEn();
-        // Вывести объяснение в консоль
-        cout << explanation;
-        // Записать объяснение в выходной файл
-        writeToFile(outputFile, explanation);
-    } catch (QList<TEException>& errors) {
-        for (const TEException& error : errors) {
-            cout << error.what() << "\n";
-        }
+        int failedFiles = BatchProcessor::runCheck(cout, BatchProcessor::collectInputFiles(options.checkSources),
+                                                   options.jobs, options.timeoutMs, options.stats);
+        return failedFiles > 0 ? 1 : 0;
     } catch (TEException& error) {
-        cout << error.what();
+        cout << error.what() << "\n";
+        return 1;
     }
 }
 
+void serveExplanations(QTextStream& cout, const CommandLineOptions& options) {
+    ExplanationServer server(options.socketPath, options.jobs);
+    server.setRequestTimeout(options.timeoutMs);
+    server.setStatsAggregate(options.stats);
+    QString errorMessage;
+    if (!server.listen(&errorMessage)) {
+        cout << "Error: " << errorMessage << "\n";
+        return;
+    }
+    server.stopOnTerminationSignals();
+
+    cout << "Listening on " << options.socketPath << "\n";
+    cout.flush();
+    // Вернуться после SIGTERM, когда все полученные запросы обработаны
+    server.exec();
+    cout << "Server stopped\n";
+}
+
 void printHelpMessage(QTextStream& cout, const QString& filename)
 {
     cout << ".\\" + filename + " [-help | -test] [input-file] [output-file]\n";
+    cout << ".\\" + filename + " --batch source [--jobs N] [--timeout ms] [--out-dir output-dir] [--cache-dir cache-dir] [--trace trace-file]\n";
+    cout << ".\\" + filename + " --check source [--check source ...] [--jobs N] [--timeout ms] [--trace trace-file]\n";
+    cout << ".\\" + filename + " --profile-tree[=json] input-file\n";
+    cout << ".\\" + filename + " --serve socket-path [--jobs N] [--timeout ms] [--trace trace-file]\n";
+    cout << "Во всех режимах можно указать --stats или --stats=json, --perf-counters и --track-allocations.\n";
     cout << "-help      - Выводит сообщение-помощник. При вводе этой команды путь к файлам указывать не нужно.\n";
     cout << "input-file - путь к входному файлу. В случае, если в пути файла присутствуют пробелы, необходимо указать путь в кавычках. Например:\n";
     cout << "               \"C:\\\\input files\\input.txt\"\n";
     cout << "output-file - путь к выходному файлу. Если файла не существует - он будет создан. В случае, если в пути файла присутствуют пробелы, необходимо указать путь в кавычках. Например:\n";
     cout << "               \"C:\\\\output files\\output.txt\"\n";
+    cout << "--batch source - пакетная обработка. source - файл-список (в каждой строке входной и выходной файлы через табуляцию или пробел), каталог или шаблон имени, например \"inputs/*.xml\".\n";
+    cout << "               Для каталога и шаблона выходной файл создаётся рядом с входным (или в output-dir) с именем \"<входной файл>.out.txt\".\n";
+    cout << "--cache-dir cache-dir - каталог постоянного кэша пакетной обработки. Результаты для файлов, не изменившихся с прошлого запуска, берутся из кэша.\n";
+    cout << "--check source - проверка без построения объяснений. source - входной файл, каталог или шаблон имени; параметр можно повторять.\n";
+    cout << "               Выводятся только ошибки с номерами строк. Код возврата 1, если хотя бы один файл содержит ошибки.\n";
+    cout << "--serve socket-path - режим сервера (только Unix): запросы принимаются через Unix domain socket до сигнала SIGTERM.\n";
+    cout << "--jobs N   - количество потоков пакетной обработки или одновременно обрабатываемых запросов сервера. По умолчанию - по числу ядер процессора.\n";
+    cout << "--stats    - вывести в поток ошибок время этапов обработки и счётчики (для пакета и сервера - суммарно и с перцентилями). --stats=json - то же в формате JSON.\n";
+    cout << "--perf-counters - добавить в статистику аппаратные счётчики процессора по этапам (только Linux; при запрете perf_event_open - \"unavailable\").\n";
+    cout << "--track-allocations - добавить в статистику количество и объём выделений памяти и пик занятой памяти по этапам и по файлам или запросам.\n";
+    cout << "--profile-tree input-file - вывести для каждого узла дерева выражения время построения объяснения, подстановки в шаблоны и размер объяснения. --profile-tree=json - то же в формате JSON.\n";
+    cout << "--trace trace-file - сохранить журнал этапов обработки в формате Chrome trace event (открывается в Perfetto или chrome://tracing).\n";
+    cout << "--timeout ms - срок обработки одного файла пакета или одного запроса сервера в миллисекундах. Не уложившаяся в срок обработка прерывается с ошибкой. По умолчанию - без срока.\n";
     cout << "Пример запуска: \n";
     cout << "   .\\" + filename + " input.txt \"C:\\\\files\\New folder\\output.txt\"\n";
 }
@@ -0,0 +1,156 @@
+#include "perfcounters.h"
+
+#include <atomic>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static std::atomic<bool> enabled(false);
+
+QString PerfCounters::counterName(HardwareCounter counter)
+{
+    switch (counter) {
+    case HardwareCounter::Cycles: return "cycles";
+    case HardwareCounter::Instructions: return "instructions";
+    case HardwareCounter::CacheMisses: return "cache_misses";
+    case HardwareCounter::BranchMisses: return "branch_misses";
+    case HardwareCounter::Count: break;
+    }
+    return QString();
+}
+
+void PerfCounters::disable()
+{
+    enabled.store(false, std::memory_order_release);
+}
+
+bool PerfCounters::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+#ifdef Q_OS_LINUX
+
+/*!
+ * \brief Группа счётчиков одного потока
+ */
+struct ThreadCounters {
+    int fds[hardwareCounterCount];  /*!< Дескрипторы счётчиков; первый — лидер группы */
+    bool opened = false;            /*!< Группа открыта */
+    bool failed = false;            /*!< Открыть группу не удалось — повторно не пытаться */
+    int error = 0;                  /*!< Код ошибки открытия */
+
+    ThreadCounters()
+    {
+        for (int& fd : fds) fd = -1;
+    }
+
+    ~ThreadCounters()
+    {
+        close();
+    }
+
+    void close()
+    {
+        for (int& fd : fds) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+        opened = false;
+    }
+
+    bool open()
+    {
+        if (opened) return true;
+        if (failed) return false;
+
+        static const quint64 configs[hardwareCounterCount] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < hardwareCounterCount; i++) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[i];
+            attr.disabled = i == 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[i] = int(::syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+            if (fds[i] < 0) {
+                error = errno;
+                failed = true;
+                close();
+                return false;
+            }
+        }
+        ::ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        opened = true;
+        return true;
+    }
+
+    bool read(HardwareCounterValues& values)
+    {
+        if (!open()) return false;
+
+        // nr, time_enabled, time_running, значения счётчиков группы
+        quint64 buffer[3 + hardwareCounterCount];
+        if (::read(fds[0], buffer, sizeof(buffer)) != ssize_t(sizeof(buffer))) return false;
+
+        // Если ядро мультиплексировало счётчики, значения пересчитываются на полное время
+        const quint64 timeEnabled = buffer[1];
+        const quint64 timeRunning = buffer[2];
+        const double scale = timeRunning > 0 && timeRunning < timeEnabled ? double(timeEnabled) / double(timeRunning) : 1.0;
+        for (int i = 0; i < hardwareCounterCount; i++) {
+            values[i] = qint64(double(buffer[3 + i]) * scale);
+        }
+        return true;
+    }
+};
+
+thread_local ThreadCounters threadCounters;
+
+bool PerfCounters::enable(QString *errorMessage)
+{
+    HardwareCounterValues values;
+    if (!threadCounters.read(values)) {
+        if (errorMessage) {
+            *errorMessage = QString("perf_event_open failed: ") + strerror(threadCounters.error);
+            if (threadCounters.error == EACCES || threadCounters.error == EPERM)
+                *errorMessage += " (see /proc/sys/kernel/perf_event_paranoid)";
+        }
+        enabled.store(false, std::memory_order_release);
+        return false;
+    }
+    enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+bool PerfCounters::read(HardwareCounterValues &values)
+{
+    if (!isEnabled()) return false;
+    return threadCounters.read(values);
+}
+
+#else
+
+bool PerfCounters::enable(QString *errorMessage)
+{
+    if (errorMessage) *errorMessage = "hardware counters are available on Linux only";
+    return false;
+}
+
+bool PerfCounters::read(HardwareCounterValues &values)
+{
+    Q_UNUSED(values);
+    return false;
+}
+
+#endif
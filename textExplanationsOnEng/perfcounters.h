@@ -0,0 +1,72 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса PerfCounters — аппаратных счётчиков процессора (Linux perf_event_open)
+ */
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QString>
+
+#include <array>
+
+/*!
+ * \brief Аппаратный счётчик процессора
+ */
+enum class HardwareCounter {
+    Cycles,         /*!< Такты процессора */
+    Instructions,   /*!< Выполненные инструкции */
+    CacheMisses,    /*!< Промахи кэша последнего уровня */
+    BranchMisses,   /*!< Ошибки предсказания переходов */
+    Count           /*!< Количество счётчиков */
+};
+
+constexpr int hardwareCounterCount = int(HardwareCounter::Count);
+
+/*!
+ * \brief Значения аппаратных счётчиков
+ */
+using HardwareCounterValues = std::array<qint64, hardwareCounterCount>;
+
+/*!
+ * \brief Аппаратные счётчики процессора для текущего потока
+ *
+ * Каждый поток при первом чтении открывает собственную группу счётчиков perf_event_open
+ * (только пользовательский режим). Если ядро запрещает счётчики (perf_event_paranoid, seccomp
+ * в контейнере) или система не Linux, счётчики недоступны: enable возвращает false, а read — false,
+ * и статистика выводится без них. Значения масштабируются при мультиплексировании счётчиков ядром.
+ */
+class PerfCounters
+{
+public:
+    /*!
+     * \brief Включение счётчиков с пробным открытием в текущем потоке
+     * \param[out] errorMessage Причина недоступности счётчиков (если задано)
+     * \return true, если счётчики доступны и включены
+     */
+    static bool enable(QString* errorMessage = nullptr);
+
+    /*!
+     * \brief Выключение счётчиков; открытые группы потоков закрываются при завершении потоков
+     */
+    static void disable();
+
+    /*!
+     * \brief Проверка, включены ли счётчики
+     */
+    static bool isEnabled();
+
+    /*!
+     * \brief Чтение счётчиков текущего потока
+     * \param[out] values Значения счётчиков с начала работы потока
+     * \return true, если счётчики включены и доступны в текущем потоке
+     */
+    static bool read(HardwareCounterValues& values);
+
+    /*!
+     * \brief Получение имени счётчика (для таблицы и JSON)
+     */
+    static QString counterName(HardwareCounter counter);
+};
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,369 @@
+#include "pipelinestats.h"
+#include "tracelog.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+thread_local StatsRecorder* StatsRecorder::currentRecorder = nullptr;
+
+StatsRecorder::StatsRecorder()
+{
+    for (std::atomic<qint64>& value : stageNs) value.store(0, std::memory_order_relaxed);
+    for (std::atomic<qint64>& value : counters) value.store(0, std::memory_order_relaxed);
+    for (std::atomic<qint64>& value : hardware) value.store(0, std::memory_order_relaxed);
+    for (std::atomic<qint64>& value : allocations) value.store(0, std::memory_order_relaxed);
+    liveBytes.store(0, std::memory_order_relaxed);
+    peakLiveBytes.store(0, std::memory_order_relaxed);
+    elapsed.start();
+}
+
+// Атомарное увеличение максимума
+static void storeMax(std::atomic<qint64>& maximum, qint64 value) {
+    qint64 current = maximum.load(std::memory_order_relaxed);
+    while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void StatsRecorder::addStageTime(PipelineStage stage, qint64 ns)
+{
+    stageNs[int(stage)].fetch_add(ns, std::memory_order_relaxed);
+}
+
+void StatsRecorder::addCounter(PipelineCounter counter, qint64 value)
+{
+    counters[int(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void StatsRecorder::addHardwareCounters(PipelineStage stage, const HardwareCounterValues &values)
+{
+    for (int i = 0; i < hardwareCounterCount; i++) {
+        hardware[int(stage) * hardwareCounterCount + i].fetch_add(values[i], std::memory_order_relaxed);
+    }
+}
+
+void StatsRecorder::addStageAllocations(PipelineStage stage, const AllocationValues &values)
+{
+    allocations[int(stage) * 3].fetch_add(values.count, std::memory_order_relaxed);
+    allocations[int(stage) * 3 + 1].fetch_add(values.bytes, std::memory_order_relaxed);
+    storeMax(allocations[int(stage) * 3 + 2], values.peakLiveBytes);
+}
+
+void StatsRecorder::addAllocation(qint64 size)
+{
+    counters[int(PipelineCounter::Allocations)].fetch_add(1, std::memory_order_relaxed);
+    counters[int(PipelineCounter::AllocatedBytes)].fetch_add(size, std::memory_order_relaxed);
+    storeMax(peakLiveBytes, liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+void StatsRecorder::addFree(qint64 size)
+{
+    liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+qint64 StatsRecorder::counter(PipelineCounter counter) const
+{
+    return counters[int(counter)].load(std::memory_order_relaxed);
+}
+
+StatsSample StatsRecorder::sample() const
+{
+    StatsSample result;
+    result.totalNs = elapsed.nsecsElapsed();
+    for (int i = 0; i < pipelineStageCount; i++) result.stageNs[i] = stageNs[i].load(std::memory_order_relaxed);
+    for (int i = 0; i < pipelineCounterCount; i++) result.counters[i] = counters[i].load(std::memory_order_relaxed);
+    for (int stage = 0; stage < pipelineStageCount; stage++) {
+        for (int i = 0; i < hardwareCounterCount; i++) {
+            result.hardware[stage][i] = hardware[stage * hardwareCounterCount + i].load(std::memory_order_relaxed);
+        }
+        result.allocations[stage].count = allocations[stage * 3].load(std::memory_order_relaxed);
+        result.allocations[stage].bytes = allocations[stage * 3 + 1].load(std::memory_order_relaxed);
+        result.allocations[stage].peakLiveBytes = allocations[stage * 3 + 2].load(std::memory_order_relaxed);
+    }
+    result.peakLiveBytes = peakLiveBytes.load(std::memory_order_relaxed);
+    return result;
+}
+
+void StageTimer::start()
+{
+    if (PerfCounters::isEnabled()) hardwareStarted = PerfCounters::read(hardwareStart);
+    if (AllocationTracker::isEnabled()) {
+        allocationsStarted = true;
+        allocationsStart = AllocationTracker::threadTotals();
+        liveStart = AllocationTracker::threadLiveBytes();
+        AllocationTracker::resetThreadPeak();
+    }
+    elapsed.start();
+}
+
+void StageTimer::finish()
+{
+    const qint64 ns = elapsed.nsecsElapsed();
+    recorder->addStageTime(stage, ns);
+    HardwareCounterValues hardwareEnd;
+    if (hardwareStarted && PerfCounters::read(hardwareEnd)) {
+        for (int i = 0; i < hardwareCounterCount; i++) hardwareEnd[i] -= hardwareStart[i];
+        recorder->addHardwareCounters(stage, hardwareEnd);
+    }
+    if (allocationsStarted) {
+        // Пик вложенного этапа сбрасывает пик потока, поэтому пик охватывающего этапа может быть занижен
+        const AllocationValues allocationsEnd = AllocationTracker::threadTotals();
+        AllocationValues values;
+        values.count = allocationsEnd.count - allocationsStart.count;
+        values.bytes = allocationsEnd.bytes - allocationsStart.bytes;
+        values.peakLiveBytes = qMax<qint64>(0, allocationsEnd.peakLiveBytes - liveStart);
+        recorder->addStageAllocations(stage, values);
+    }
+    if (TraceLog::isEnabled()) {
+        TraceEvent event;
+        event.stage = int(stage);
+        event.startNs = TraceLog::nowNs() - ns;
+        event.durationNs = ns;
+        TraceLog::record(event);
+    }
+}
+
+void StatsAggregate::add(const StatsSample &sample)
+{
+    QMutexLocker locker(&mutex);
+    samples.append(sample);
+}
+
+void StatsAggregate::setHardwareCountersUnavailable(const QString &reason)
+{
+    QMutexLocker locker(&mutex);
+    hardwareUnavailable = reason;
+}
+
+qsizetype StatsAggregate::count() const
+{
+    QMutexLocker locker(&mutex);
+    return samples.size();
+}
+
+QString StatsAggregate::stageName(PipelineStage stage)
+{
+    switch (stage) {
+    case PipelineStage::FileCopy: return "file_copy";
+    case PipelineStage::FixXmlFlags: return "fix_xml_flags";
+    case PipelineStage::PreLex: return "pre_lex";
+    case PipelineStage::BuildDom: return "build_dom";
+    case PipelineStage::Validate: return "validate";
+    case PipelineStage::BuildTree: return "build_tree";
+    case PipelineStage::Render: return "render";
+    case PipelineStage::Dedupe: return "dedupe";
+    case PipelineStage::Write: return "write";
+    case PipelineStage::Count: break;
+    }
+    return QString();
+}
+
+QString StatsAggregate::counterName(PipelineCounter counter)
+{
+    switch (counter) {
+    case PipelineCounter::BytesIn: return "bytes_in";
+    case PipelineCounter::Tokens: return "tokens";
+    case PipelineCounter::Nodes: return "nodes";
+    case PipelineCounter::TemplateApplications: return "template_applications";
+    case PipelineCounter::BytesOut: return "bytes_out";
+    case PipelineCounter::Allocations: return "allocations";
+    case PipelineCounter::AllocatedBytes: return "allocated_bytes";
+    case PipelineCounter::Count: break;
+    }
+    return QString();
+}
+
+qint64 StatsAggregate::percentile(const QList<qint64> &sorted, int percent)
+{
+    if (sorted.isEmpty()) return 0;
+    // Ближайший ранг: ceil(size * percent / 100) в целых числах
+    qsizetype rank = (sorted.size() * percent + 99) / 100;
+    return sorted[qBound<qsizetype>(0, rank - 1, sorted.size() - 1)];
+}
+
+/*!
+ * \brief Распределение времени одного этапа по файлам или запросам
+ */
+struct StageDistribution {
+    qint64 totalNs = 0; /*!< Суммарное время */
+    qint64 meanNs = 0;  /*!< Среднее время */
+    qint64 p50Ns = 0;   /*!< Медиана */
+    qint64 p95Ns = 0;   /*!< 95-й перцентиль */
+    qint64 p99Ns = 0;   /*!< 99-й перцентиль */
+    qint64 maxNs = 0;   /*!< Максимальное время */
+};
+
+static StageDistribution distribution(QList<qint64> values) {
+    StageDistribution result;
+    if (values.isEmpty()) return result;
+    std::sort(values.begin(), values.end());
+    for (qint64 value : std::as_const(values)) result.totalNs += value;
+    result.meanNs = result.totalNs / values.size();
+    result.p50Ns = StatsAggregate::percentile(values, 50);
+    result.p95Ns = StatsAggregate::percentile(values, 95);
+    result.p99Ns = StatsAggregate::percentile(values, 99);
+    result.maxNs = values.last();
+    return result;
+}
+
+// Распределения всех этапов; последний элемент — полное время обработки
+static QList<StageDistribution> distributions(const QList<StatsSample>& samples) {
+    QList<StageDistribution> result;
+    for (int stage = 0; stage <= pipelineStageCount; stage++) {
+        QList<qint64> values;
+        values.reserve(samples.size());
+        for (const StatsSample& sample : samples) {
+            values.append(stage < pipelineStageCount ? sample.stageNs[stage] : sample.totalNs);
+        }
+        result.append(distribution(values));
+    }
+    return result;
+}
+
+// Суммарные аппаратные счётчики этапов; пустой список, если счётчики не измерялись
+static QList<HardwareCounterValues> hardwareTotals(const QList<StatsSample>& samples) {
+    QList<HardwareCounterValues> totals(pipelineStageCount, HardwareCounterValues{});
+    bool measured = false;
+    for (const StatsSample& sample : samples) {
+        for (int stage = 0; stage < pipelineStageCount; stage++) {
+            for (int i = 0; i < hardwareCounterCount; i++) {
+                totals[stage][i] += sample.hardware[stage][i];
+                measured = measured || sample.hardware[stage][i] != 0;
+            }
+        }
+    }
+    return measured ? totals : QList<HardwareCounterValues>();
+}
+
+// Суммарные выделения этапов (пик — максимальный); пустой список, если память не учитывалась
+static QList<AllocationValues> allocationTotals(const QList<StatsSample>& samples) {
+    QList<AllocationValues> totals(pipelineStageCount, AllocationValues());
+    bool measured = false;
+    for (const StatsSample& sample : samples) {
+        for (int stage = 0; stage < pipelineStageCount; stage++) {
+            totals[stage].count += sample.allocations[stage].count;
+            totals[stage].bytes += sample.allocations[stage].bytes;
+            totals[stage].peakLiveBytes = qMax(totals[stage].peakLiveBytes, sample.allocations[stage].peakLiveBytes);
+            measured = measured || sample.allocations[stage].count != 0;
+        }
+    }
+    return measured ? totals : QList<AllocationValues>();
+}
+
+// Распределение пика занятой памяти по файлам или запросам
+static StageDistribution peakLiveDistribution(const QList<StatsSample>& samples) {
+    QList<qint64> values;
+    values.reserve(samples.size());
+    for (const StatsSample& sample : samples) values.append(sample.peakLiveBytes);
+    return distribution(values);
+}
+
+static QString milliseconds(qint64 ns) {
+    return QString::number(double(ns) / 1e6, 'f', 3);
+}
+
+QString StatsAggregate::formatTable() const
+{
+    QMutexLocker locker(&mutex);
+    const QList<StageDistribution> stages = distributions(samples);
+    const qint64 totalNs = stages.last().totalNs;
+
+    QString output = "Processed: " + QString::number(samples.size()) + "\n";
+    output += QString("%1 %2 %3 %4 %5 %6 %7 %8\n").arg(QString("stage"), -14).arg(QString("total ms"), 12).arg(QString("share"), 7)
+                  .arg(QString("mean ms"), 10).arg(QString("p50 ms"), 10).arg(QString("p95 ms"), 10).arg(QString("p99 ms"), 10).arg(QString("max ms"), 10);
+    for (int stage = 0; stage <= pipelineStageCount; stage++) {
+        const StageDistribution& row = stages[stage];
+        QString name = stage < pipelineStageCount ? stageName(PipelineStage(stage)) : "total";
+        QString share = totalNs > 0 ? QString::number(100.0 * row.totalNs / totalNs, 'f', 1) + "%" : "-";
+        output += QString("%1 %2 %3 %4 %5 %6 %7 %8\n").arg(name, -14).arg(milliseconds(row.totalNs), 12).arg(share, 7)
+                      .arg(milliseconds(row.meanNs), 10).arg(milliseconds(row.p50Ns), 10).arg(milliseconds(row.p95Ns), 10)
+                      .arg(milliseconds(row.p99Ns), 10).arg(milliseconds(row.maxNs), 10);
+    }
+
+    output += QString("%1 %2 %3\n").arg(QString("counter"), -22).arg(QString("total"), 14).arg(QString("mean"), 12);
+    for (int counter = 0; counter < pipelineCounterCount; counter++) {
+        qint64 total = 0;
+        for (const StatsSample& sample : samples) total += sample.counters[counter];
+        QString mean = samples.isEmpty() ? "-" : QString::number(double(total) / samples.size(), 'f', 1);
+        output += QString("%1 %2 %3\n").arg(counterName(PipelineCounter(counter)), -22).arg(total, 14).arg(mean, 12);
+    }
+
+    const QList<HardwareCounterValues> hardware = hardwareTotals(samples);
+    if (!hardware.isEmpty()) {
+        output += QString("%1 %2 %3 %4 %5 %6\n").arg(QString("stage"), -14).arg(QString("cycles"), 14).arg(QString("instructions"), 14)
+                      .arg(QString("IPC"), 6).arg(QString("cache misses"), 14).arg(QString("branch misses"), 14);
+        for (int stage = 0; stage < pipelineStageCount; stage++) {
+            const HardwareCounterValues& row = hardware[stage];
+            const qint64 cycles = row[int(HardwareCounter::Cycles)];
+            QString ipc = cycles > 0 ? QString::number(double(row[int(HardwareCounter::Instructions)]) / cycles, 'f', 2) : "-";
+            output += QString("%1 %2 %3 %4 %5 %6\n").arg(stageName(PipelineStage(stage)), -14).arg(cycles, 14)
+                          .arg(row[int(HardwareCounter::Instructions)], 14).arg(ipc, 6)
+                          .arg(row[int(HardwareCounter::CacheMisses)], 14).arg(row[int(HardwareCounter::BranchMisses)], 14);
+        }
+    }
+    else if (!hardwareUnavailable.isEmpty()) {
+        output += "hardware counters: unavailable (" + hardwareUnavailable + ")\n";
+    }
+
+    const QList<AllocationValues> allocations = allocationTotals(samples);
+    if (!allocations.isEmpty()) {
+        output += QString("%1 %2 %3 %4\n").arg(QString("stage"), -14).arg(QString("allocations"), 14)
+                      .arg(QString("bytes"), 14).arg(QString("max peak"), 14);
+        for (int stage = 0; stage < pipelineStageCount; stage++) {
+            const AllocationValues& row = allocations[stage];
+            output += QString("%1 %2 %3 %4\n").arg(stageName(PipelineStage(stage)), -14).arg(row.count, 14)
+                          .arg(row.bytes, 14).arg(row.peakLiveBytes, 14);
+        }
+        const StageDistribution peak = peakLiveDistribution(samples);
+        output += QString("peak live bytes: mean %1, p95 %2, max %3\n").arg(peak.meanNs).arg(peak.p95Ns).arg(peak.maxNs);
+    }
+    return output;
+}
+
+QString StatsAggregate::formatJson() const
+{
+    QMutexLocker locker(&mutex);
+    const QList<StageDistribution> stages = distributions(samples);
+    const QList<HardwareCounterValues> hardware = hardwareTotals(samples);
+    const QList<AllocationValues> allocations = allocationTotals(samples);
+
+    QJsonObject stagesObject;
+    for (int stage = 0; stage <= pipelineStageCount; stage++) {
+        const StageDistribution& row = stages[stage];
+        QJsonObject stageObject{
+            {"total_ns", row.totalNs}, {"mean_ns", row.meanNs}, {"p50_ns", row.p50Ns},
+            {"p95_ns", row.p95Ns}, {"p99_ns", row.p99Ns}, {"max_ns", row.maxNs}};
+        if (!hardware.isEmpty() && stage < pipelineStageCount) {
+            QJsonObject hardwareObject;
+            for (int i = 0; i < hardwareCounterCount; i++) {
+                hardwareObject.insert(PerfCounters::counterName(HardwareCounter(i)), hardware[stage][i]);
+            }
+            stageObject.insert("hardware", hardwareObject);
+        }
+        if (!allocations.isEmpty() && stage < pipelineStageCount) {
+            stageObject.insert("allocations", QJsonObject{
+                {"count", allocations[stage].count}, {"bytes", allocations[stage].bytes},
+                {"max_peak_live_bytes", allocations[stage].peakLiveBytes}});
+        }
+        stagesObject.insert(stage < pipelineStageCount ? stageName(PipelineStage(stage)) : "total", stageObject);
+    }
+
+    QJsonObject countersObject;
+    for (int counter = 0; counter < pipelineCounterCount; counter++) {
+        qint64 total = 0;
+        for (const StatsSample& sample : samples) total += sample.counters[counter];
+        countersObject.insert(counterName(PipelineCounter(counter)), total);
+    }
+
+    QJsonObject root{{"processed", samples.size()}, {"stages", stagesObject}, {"counters", countersObject}};
+    if (hardware.isEmpty() && !hardwareUnavailable.isEmpty())
+        root.insert("hardware_counters_unavailable", hardwareUnavailable);
+    if (!allocations.isEmpty()) {
+        const StageDistribution peak = peakLiveDistribution(samples);
+        root.insert("peak_live_bytes", QJsonObject{
+            {"mean", peak.meanNs}, {"p50", peak.p50Ns}, {"p95", peak.p95Ns}, {"p99", peak.p99Ns}, {"max", peak.maxNs}});
+    }
+    return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Indented));
+}
@@ -0,0 +1,325 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание средств сбора статистики обработки: времени этапов и счётчиков
+ */
+
+#ifndef PIPELINESTATS_H
+#define PIPELINESTATS_H
+
+#include "allocationtracker.h"
+#include "perfcounters.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include <array>
+#include <atomic>
+
+/*!
+ * \brief Этап обработки входного файла или запроса
+ */
+enum class PipelineStage {
+    FileCopy,       /*!< Копирование и чтение входного файла */
+    FixXmlFlags,    /*!< Экранирование выражения и описаний (fixXmlFlags) */
+    PreLex,         /*!< Предварительная проверка структуры XML (глубина, количество элементов) */
+    BuildDom,       /*!< Построение DOM-дерева */
+    Validate,       /*!< Проверка элементов документа и построение схемы */
+    BuildTree,      /*!< Построение дерева выражения (expressionToNodes) */
+    Render,         /*!< Построение объяснения по дереву (ToExplanation) */
+    Dedupe,         /*!< Удаление повторяющихся слов (removeConsecutiveDuplicates) */
+    Write,          /*!< Запись выходного файла */
+    Count           /*!< Количество этапов */
+};
+
+/*!
+ * \brief Счётчик обработки
+ */
+enum class PipelineCounter {
+    BytesIn,                /*!< Прочитано байтов входных данных */
+    Tokens,                 /*!< Лексем выражений */
+    Nodes,                  /*!< Создано узлов деревьев выражений */
+    TemplateApplications,   /*!< Подстановок аргументов в шаблоны объяснений */
+    BytesOut,               /*!< Записано байтов выходных данных */
+    Allocations,            /*!< Выделений памяти (AllocationTracker) */
+    AllocatedBytes,         /*!< Выделено байтов памяти (AllocationTracker) */
+    Count                   /*!< Количество счётчиков */
+};
+
+constexpr int pipelineStageCount = int(PipelineStage::Count);
+constexpr int pipelineCounterCount = int(PipelineCounter::Count);
+
+/*!
+ * \brief Статистика обработки одного файла или запроса
+ */
+struct StatsSample {
+    qint64 totalNs = 0;                                         /*!< Полное время обработки в наносекундах */
+    std::array<qint64, pipelineStageCount> stageNs{};           /*!< Время этапов в наносекундах */
+    std::array<qint64, pipelineCounterCount> counters{};        /*!< Значения счётчиков */
+    std::array<HardwareCounterValues, pipelineStageCount> hardware{}; /*!< Аппаратные счётчики этапов (PerfCounters) */
+    std::array<AllocationValues, pipelineStageCount> allocations{}; /*!< Выделения памяти этапов (AllocationTracker) */
+    qint64 peakLiveBytes = 0;                                   /*!< Пик памяти, занятой при обработке (AllocationTracker) */
+};
+
+/*!
+ * \brief Накопитель статистики одного файла или запроса
+ *
+ * Накопитель, установленный для потока (StatsScope), получает время этапов (StageTimer) и счётчики (countStat)
+ * всего кода, выполняемого в этом потоке. Если накопитель не установлен, замеры не выполняются:
+ * их стоимость — чтение одной thread_local переменной. При сборке с TE_DISABLE_STATS замеры удаляются полностью.
+ * Один накопитель можно установить в нескольких потоках: методы потокобезопасны.
+ */
+class StatsRecorder
+{
+public:
+    /*!
+     * \brief Конструктор накопителя; полное время отсчитывается от момента создания
+     */
+    StatsRecorder();
+
+    StatsRecorder(const StatsRecorder&) = delete;
+    StatsRecorder& operator=(const StatsRecorder&) = delete;
+
+    /*!
+     * \brief Накопитель, установленный для текущего потока (nullptr — статистика не собирается)
+     */
+    static StatsRecorder* current()
+    {
+#ifdef TE_DISABLE_STATS
+        return nullptr;
+#else
+        return currentRecorder;
+#endif
+    }
+
+    /*!
+     * \brief Добавление времени этапа
+     * \param[in] stage Этап
+     * \param[in] ns Время в наносекундах
+     */
+    void addStageTime(PipelineStage stage, qint64 ns);
+
+    /*!
+     * \brief Увеличение счётчика
+     * \param[in] counter Счётчик
+     * \param[in] value Приращение
+     */
+    void addCounter(PipelineCounter counter, qint64 value);
+
+    /*!
+     * \brief Добавление аппаратных счётчиков этапа
+     * \param[in] stage Этап
+     * \param[in] values Приращения счётчиков
+     */
+    void addHardwareCounters(PipelineStage stage, const HardwareCounterValues& values);
+
+    /*!
+     * \brief Добавление выделений памяти этапа; пик этапа — максимум по всем замерам
+     * \param[in] stage Этап
+     * \param[in] values Выделения за время этапа
+     */
+    void addStageAllocations(PipelineStage stage, const AllocationValues& values);
+
+    /*!
+     * \brief Учёт выделения памяти (вызывается AllocationTracker)
+     * \param[in] size Размер блока
+     */
+    void addAllocation(qint64 size);
+
+    /*!
+     * \brief Учёт освобождения памяти (вызывается AllocationTracker)
+     * \param[in] size Размер блока
+     */
+    void addFree(qint64 size);
+
+    /*!
+     * \brief Получение текущего значения счётчика
+     * \param[in] counter Счётчик
+     */
+    qint64 counter(PipelineCounter counter) const;
+
+    /*!
+     * \brief Получение накопленной статистики; полное время — от создания накопителя до вызова
+     */
+    StatsSample sample() const;
+
+private:
+    friend class StatsScope;
+
+    static thread_local StatsRecorder* currentRecorder; ///< Накопитель текущего потока
+
+    QElapsedTimer elapsed; ///< Полное время обработки
+    std::array<std::atomic<qint64>, pipelineStageCount> stageNs; ///< Время этапов
+    std::array<std::atomic<qint64>, pipelineCounterCount> counters; ///< Значения счётчиков
+    std::array<std::atomic<qint64>, pipelineStageCount * hardwareCounterCount> hardware; ///< Аппаратные счётчики этапов
+    std::array<std::atomic<qint64>, pipelineStageCount * 3> allocations; ///< Количество, объём и пик выделений этапов
+    std::atomic<qint64> liveBytes; ///< Память, занятая с создания накопителя
+    std::atomic<qint64> peakLiveBytes; ///< Пик занятой памяти
+};
+
+/*!
+ * \brief Установка накопителя статистики для текущего потока на время жизни объекта
+ */
+class StatsScope
+{
+public:
+    /*!
+     * \brief Установка накопителя
+     * \param[in] recorder Накопитель (nullptr — статистика в области не собирается)
+     */
+    explicit StatsScope(StatsRecorder* recorder)
+#ifndef TE_DISABLE_STATS
+        : previous(StatsRecorder::currentRecorder)
+    {
+        StatsRecorder::currentRecorder = recorder;
+    }
+#else
+    {
+        Q_UNUSED(recorder);
+    }
+#endif
+
+    /*!
+     * \brief Восстановление накопителя, установленного до создания объекта
+     */
+    ~StatsScope()
+    {
+#ifndef TE_DISABLE_STATS
+        StatsRecorder::currentRecorder = previous;
+#endif
+    }
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+private:
+#ifndef TE_DISABLE_STATS
+    StatsRecorder* previous; ///< Накопитель, установленный до создания объекта
+#endif
+};
+
+/*!
+ * \brief Замер времени этапа от создания до уничтожения объекта
+ *
+ * Если включён журнал событий (TraceLog), этап записывается и в него;
+ * если включены аппаратные счётчики (PerfCounters), этапу приписываются их приращения;
+ * если включён учёт памяти (AllocationTracker) — выделения памяти потока за время этапа.
+ */
+class StageTimer
+{
+public:
+    /*!
+     * \brief Начало замера
+     * \param[in] stage Этап
+     */
+    explicit StageTimer(PipelineStage stage)
+        : stage(stage)
+        , recorder(StatsRecorder::current())
+    {
+        if (recorder) start();
+    }
+
+    /*!
+     * \brief Окончание замера
+     */
+    ~StageTimer()
+    {
+        if (recorder) finish();
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    /*!
+     * \brief Начало замера времени, аппаратных счётчиков и выделений памяти
+     */
+    void start();
+
+    /*!
+     * \brief Запись времени этапа в накопитель и журнал событий
+     */
+    void finish();
+
+    PipelineStage stage; ///< Этап
+    StatsRecorder* recorder; ///< Накопитель текущего потока
+    QElapsedTimer elapsed; ///< Время этапа
+    bool hardwareStarted = false; ///< Аппаратные счётчики прочитаны в начале этапа
+    HardwareCounterValues hardwareStart; ///< Аппаратные счётчики в начале этапа
+    bool allocationsStarted = false; ///< Учёт памяти включён в начале этапа
+    AllocationValues allocationsStart; ///< Выделения потока в начале этапа
+    qint64 liveStart = 0; ///< Память, занятая потоком в начале этапа
+};
+
+/*!
+ * \brief Увеличение счётчика накопителя текущего потока
+ * \param[in] counter Счётчик
+ * \param[in] value Приращение
+ */
+inline void countStat(PipelineCounter counter, qint64 value = 1)
+{
+    if (StatsRecorder* recorder = StatsRecorder::current()) recorder->addCounter(counter, value);
+}
+
+/*!
+ * \brief Сводная статистика множества файлов или запросов
+ *
+ * Для каждого этапа выводятся суммарное и среднее время и перцентили времени одного файла или запроса,
+ * для каждого счётчика — сумма и среднее. Если учитывалась память, выводятся выделения этапов
+ * и распределение пика занятой памяти по файлам или запросам. Метод add потокобезопасен.
+ */
+class StatsAggregate
+{
+public:
+    /*!
+     * \brief Добавление статистики одного файла или запроса
+     */
+    void add(const StatsSample& sample);
+
+    /*!
+     * \brief Установка причины недоступности аппаратных счётчиков, запрошенных пользователем
+     * \param[in] reason Причина (пустая — счётчики не запрашивались или доступны)
+     */
+    void setHardwareCountersUnavailable(const QString& reason);
+
+    /*!
+     * \brief Получение количества добавленных файлов или запросов
+     */
+    qsizetype count() const;
+
+    /*!
+     * \brief Форматирование статистики таблицей для человека
+     */
+    QString formatTable() const;
+
+    /*!
+     * \brief Форматирование статистики в JSON
+     */
+    QString formatJson() const;
+
+    /*!
+     * \brief Получение имени этапа (для таблицы и JSON)
+     */
+    static QString stageName(PipelineStage stage);
+
+    /*!
+     * \brief Получение имени счётчика (для таблицы и JSON)
+     */
+    static QString counterName(PipelineCounter counter);
+
+    /*!
+     * \brief Получение перцентиля по методу ближайшего ранга
+     * \param[in] sorted Значения, упорядоченные по возрастанию
+     * \param[in] percent Перцентиль от 0 до 100 (50 — медиана)
+     * \return Наименьшее значение, которого не превышают percent процентов значений; 0 для пустого списка
+     */
+    static qint64 percentile(const QList<qint64>& sorted, int percent);
+
+private:
+    mutable QMutex mutex; ///< Защита списка статистики
+    QList<StatsSample> samples; ///< Статистика файлов или запросов в порядке добавления
+    QString hardwareUnavailable; ///< Причина недоступности запрошенных аппаратных счётчиков
+};
+
+#endif // PIPELINESTATS_H
@@ -0,0 +1,34 @@
+#include "reorderbuffer.h"
+
+ReorderBuffer::ReorderBuffer(const std::function<void(const QString&)>& sink)
+    : nextIndex(0)
+    , sink(sink)
+{}
+
+void ReorderBuffer::submit(int index, const QString& text)
+{
+    QMutexLocker locker(&mutex);
+
+    // Результат пришёл раньше очереди — отложить
+    if (index != nextIndex) {
+        pending.insert(index, text);
+        return;
+    }
+
+    // Выдать результат и все отложенные результаты, которые идут за ним подряд
+    sink(text);
+    nextIndex++;
+    auto it = pending.find(nextIndex);
+    while (it != pending.end()) {
+        sink(it.value());
+        pending.erase(it);
+        nextIndex++;
+        it = pending.find(nextIndex);
+    }
+}
+
+int ReorderBuffer::getPendingCount()
+{
+    QMutexLocker locker(&mutex);
+    return pending.size();
+}
@@ -0,0 +1,50 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ReorderBuffer — буфера восстановления порядка результатов
+ */
+
+#ifndef REORDERBUFFER_H
+#define REORDERBUFFER_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <functional>
+
+/*!
+ * \brief Буфер, выдающий результаты в порядке индексов независимо от порядка их готовности
+ *
+ * Результат с индексом i передаётся получателю сразу после результатов 0..i-1;
+ * результаты, пришедшие раньше очереди, ждут в буфере. Получатель вызывается под блокировкой
+ * буфера, поэтому может писать в общий поток без дополнительной синхронизации.
+ */
+class ReorderBuffer
+{
+public:
+    /*!
+     * \brief Конструктор буфера
+     * \param[in] sink Получатель результатов в порядке индексов
+     */
+    explicit ReorderBuffer(const std::function<void(const QString&)>& sink);
+
+    /*!
+     * \brief Передача готового результата
+     * \param[in] index Индекс результата (каждый индекс передаётся ровно один раз)
+     * \param[in] text Результат
+     */
+    void submit(int index, const QString& text);
+
+    /*!
+     * \brief Получение количества результатов, ожидающих своей очереди
+     */
+    int getPendingCount();
+
+private:
+    QMutex mutex; ///< Защита состояния буфера
+    QHash<int, QString> pending; ///< Результаты, пришедшие раньше очереди
+    int nextIndex; ///< Индекс следующего результата для выдачи
+    std::function<void(const QString&)> sink; ///< Получатель результатов
+};
+
+#endif // REORDERBUFFER_H
@@ -0,0 +1,67 @@
+#include "schemaregistry.h"
+
+SchemaRegistry::SchemaRegistry(qsizetype memoryBudget)
+    : memoryBudget(memoryBudget)
+    , memoryUsage(0)
+    , evictionCount(0)
+{}
+
+QString SchemaRegistry::add(const QSharedPointer<const CompiledSchema> &schema)
+{
+    QString handle = QString::fromLatin1(schema->getContentHash().toHex());
+    QMutexLocker locker(&mutex);
+
+    auto it = entries.find(handle);
+    if (it != entries.end()) {
+        // Схема уже зарегистрирована — только отметить использование
+        usageOrder.splice(usageOrder.begin(), usageOrder, it->usage);
+        return handle;
+    }
+
+    usageOrder.push_front(handle);
+    entries.insert(handle, Entry{schema, usageOrder.begin()});
+    memoryUsage += schema->getMemoryUsage();
+    evict();
+    return handle;
+}
+
+QSharedPointer<const CompiledSchema> SchemaRegistry::find(const QString &handle)
+{
+    QMutexLocker locker(&mutex);
+
+    auto it = entries.find(handle);
+    if (it == entries.end()) return {};
+
+    usageOrder.splice(usageOrder.begin(), usageOrder, it->usage);
+    return it->schema;
+}
+
+qsizetype SchemaRegistry::size()
+{
+    QMutexLocker locker(&mutex);
+    return entries.size();
+}
+
+qsizetype SchemaRegistry::getMemoryUsage()
+{
+    QMutexLocker locker(&mutex);
+    return memoryUsage;
+}
+
+qint64 SchemaRegistry::getEvictionCount()
+{
+    QMutexLocker locker(&mutex);
+    return evictionCount;
+}
+
+void SchemaRegistry::evict()
+{
+    // Последняя зарегистрированная схема (в начале очереди) остаётся всегда
+    while (memoryUsage > memoryBudget && usageOrder.size() > 1) {
+        QString handle = usageOrder.back();
+        usageOrder.pop_back();
+        memoryUsage -= entries.value(handle).schema->getMemoryUsage();
+        entries.remove(handle);
+        evictionCount++;
+    }
+}
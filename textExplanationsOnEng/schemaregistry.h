@@ -0,0 +1,89 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса SchemaRegistry — реестра зарегистрированных схем сервера
+ */
+
+#ifndef SCHEMAREGISTRY_H
+#define SCHEMAREGISTRY_H
+
+#include "compiledschema.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+#include <list>
+
+/*!
+ * \brief Реестр схем: схема регистрируется один раз, а затем запрашивается по дескриптору
+ *
+ * Дескриптор — шестнадцатеричная запись хэша содержимого схемы, поэтому повторная регистрация
+ * той же схемы возвращает тот же дескриптор. Объём памяти реестра ограничен: при превышении
+ * бюджета вытесняются давно не использовавшиеся схемы. Методы потокобезопасны.
+ */
+class SchemaRegistry
+{
+public:
+    static const qsizetype defaultMemoryBudget = 256 * 1024 * 1024; ///< Бюджет памяти по умолчанию, байт
+
+    /*!
+     * \brief Конструктор реестра
+     * \param[in] memoryBudget Бюджет памяти в байтах
+     */
+    explicit SchemaRegistry(qsizetype memoryBudget = defaultMemoryBudget);
+
+    /*!
+     * \brief Регистрация схемы
+     *
+     * Только что зарегистрированная схема не вытесняется, даже если одна превышает бюджет.
+     * \param[in] schema Схема
+     * \return Дескриптор схемы
+     */
+    QString add(const QSharedPointer<const CompiledSchema>& schema);
+
+    /*!
+     * \brief Поиск схемы по дескриптору
+     * \param[in] handle Дескриптор схемы
+     * \return Схема или пустой указатель, если дескриптор неизвестен (не регистрировался или вытеснен)
+     */
+    QSharedPointer<const CompiledSchema> find(const QString& handle);
+
+    /*!
+     * \brief Получение количества схем в реестре
+     */
+    qsizetype size();
+
+    /*!
+     * \brief Получение объёма памяти схем реестра в байтах
+     */
+    qsizetype getMemoryUsage();
+
+    /*!
+     * \brief Получение количества вытесненных схем
+     */
+    qint64 getEvictionCount();
+
+private:
+    /*!
+     * \brief Запись реестра
+     */
+    struct Entry {
+        QSharedPointer<const CompiledSchema> schema;  /*!< Схема */
+        std::list<QString>::iterator usage;           /*!< Позиция в очереди использования */
+    };
+
+    /*!
+     * \brief Вытеснение давно не использовавшихся схем до укладывания в бюджет
+     */
+    void evict();
+
+    QMutex mutex; ///< Защита состояния реестра
+    QHash<QString, Entry> entries; ///< Схемы по дескрипторам
+    std::list<QString> usageOrder; ///< Дескрипторы от недавно использованных к давно не использовавшимся
+    qsizetype memoryBudget; ///< Бюджет памяти
+    qsizetype memoryUsage; ///< Объём памяти схем
+    qint64 evictionCount; ///< Количество вытесненных схем
+};
+
+#endif // SCHEMAREGISTRY_H
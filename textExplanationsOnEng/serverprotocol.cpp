@@ -0,0 +1,145 @@
+#include "serverprotocol.h"
+
+#include <QtEndian>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Чтение 32-битного числа big-endian
+static bool readUInt32(const QByteArray& payload, qsizetype& offset, quint32& value) {
+    if (payload.size() - offset < 4) return false;
+    value = qFromBigEndian<quint32>(payload.constData() + offset);
+    offset += 4;
+    return true;
+}
+
+// Запись 32-битного числа big-endian
+static void appendUInt32(QByteArray& payload, quint32 value) {
+    char buffer[4];
+    qToBigEndian(value, buffer);
+    payload.append(buffer, 4);
+}
+
+QByteArray ServerProtocol::encodeRequest(const ServerRequest &request)
+{
+    QByteArray payload;
+    payload.append(char(request.type));
+    appendStrings(payload, request.fields);
+    return payload;
+}
+
+bool ServerProtocol::decodeRequest(const QByteArray &payload, ServerRequest &request)
+{
+    if (payload.isEmpty()) return false;
+    request.type = RequestType(quint8(payload[0]));
+    return readStrings(payload, 1, request.fields);
+}
+
+QByteArray ServerProtocol::encodeResponse(const ServerResponse &response)
+{
+    QByteArray payload;
+    payload.append(char(response.status));
+    appendStrings(payload, response.texts);
+    return payload;
+}
+
+bool ServerProtocol::decodeResponse(const QByteArray &payload, ServerResponse &response)
+{
+    if (payload.isEmpty()) return false;
+    response.status = ResponseStatus(quint8(payload[0]));
+    return readStrings(payload, 1, response.texts);
+}
+
+void ServerProtocol::appendStrings(QByteArray &payload, const QStringList &strings)
+{
+    appendUInt32(payload, quint32(strings.size()));
+    for (const QString& string : strings) {
+        QByteArray utf8 = string.toUtf8();
+        appendUInt32(payload, quint32(utf8.size()));
+        payload.append(utf8);
+    }
+}
+
+bool ServerProtocol::readStrings(const QByteArray &payload, qsizetype offset, QStringList &strings)
+{
+    quint32 count = 0;
+    if (!readUInt32(payload, offset, count)) return false;
+
+    strings.clear();
+    for (quint32 i = 0; i < count; i++) {
+        quint32 length = 0;
+        if (!readUInt32(payload, offset, length) || payload.size() - offset < qsizetype(length)) return false;
+        strings.append(QString::fromUtf8(payload.constData() + offset, length));
+        offset += length;
+    }
+    // Лишние байты после последней строки означают повреждённое тело
+    return offset == payload.size();
+}
+
+#ifdef Q_OS_UNIX
+
+// Чтение ровно size байт; false, если соединение закрыто раньше
+static bool readAll(int fd, char* data, qsizetype size) {
+    while (size > 0) {
+        ssize_t received = ::read(fd, data, size);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+// Запись ровно size байт
+static bool writeAll(int fd, const char* data, qsizetype size) {
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+bool ServerProtocol::readFrame(int fd, QByteArray &payload)
+{
+    char header[4];
+    if (!readAll(fd, header, 4)) return false;
+
+    quint32 size = qFromBigEndian<quint32>(header);
+    if (size > maxFrameSize) return false;
+
+    payload.resize(size);
+    return readAll(fd, payload.data(), size);
+}
+
+bool ServerProtocol::writeFrame(int fd, const QByteArray &payload)
+{
+    QByteArray frame;
+    frame.reserve(4 + payload.size());
+    appendUInt32(frame, quint32(payload.size()));
+    frame.append(payload);
+    return writeAll(fd, frame.constData(), frame.size());
+}
+
+#else
+
+bool ServerProtocol::readFrame(int, QByteArray &)
+{
+    return false;
+}
+
+bool ServerProtocol::writeFrame(int, const QByteArray &)
+{
+    return false;
+}
+
+#endif
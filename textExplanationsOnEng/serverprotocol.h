@@ -0,0 +1,109 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание протокола обмена с сервером объяснений
+ *
+ * Каждое сообщение передаётся кадром: длина тела (4 байта, big-endian) и тело.
+ * Тело запроса: тип запроса (1 байт), количество полей (4 байта) и поля.
+ * Тело ответа: статус (1 байт), количество строк (4 байта) и строки.
+ * Поле или строка — длина в байтах (4 байта) и текст в UTF-8.
+ *
+ * На каждый запрос приходит один ответ, кроме запроса Expressions: на него приходит
+ * по одному ответу на каждое выражение в порядке запроса.
+ */
+
+#ifndef SERVERPROTOCOL_H
+#define SERVERPROTOCOL_H
+
+#include <QByteArray>
+#include <QStringList>
+
+/*! \brief Тип запроса к серверу */
+enum class RequestType : quint8 {
+    Document = 'X',     //!< Поля: XML-документ; ответ — объяснение документа
+    Schema = 'S',       //!< Поля: XML-документ со схемой; ответ — дескриптор схемы
+    Expressions = 'E'   //!< Поля: дескриптор схемы и выражения в постфиксной записи; ответ — по одному на выражение
+};
+
+/*! \brief Статус ответа сервера */
+enum class ResponseStatus : quint8 {
+    Ok = 0,             //!< Строки: объяснение или дескриптор зарегистрированной схемы
+    Errors = 1,         //!< Строки: сообщения об ошибках (TEException)
+    BadRequest = 2,     //!< Строки: описание нарушения протокола
+    UnknownHandle = 3   //!< Строки: дескриптор; схему нужно зарегистрировать заново
+};
+
+/*!
+ * \brief Запрос к серверу
+ */
+struct ServerRequest {
+    RequestType type = RequestType::Document; /*!< Тип запроса */
+    QStringList fields;                       /*!< Поля запроса */
+};
+
+/*!
+ * \brief Ответ сервера
+ */
+struct ServerResponse {
+    ResponseStatus status = ResponseStatus::Ok; /*!< Статус ответа */
+    QStringList texts;                          /*!< Объяснение или сообщения об ошибках */
+};
+
+/*!
+ * \brief Кодирование и передача сообщений протокола сервера объяснений
+ */
+class ServerProtocol
+{
+public:
+    static const quint32 maxFrameSize = 64 * 1024 * 1024; ///< Максимальный размер тела кадра
+
+    /*!
+     * \brief Кодирование тела запроса
+     */
+    static QByteArray encodeRequest(const ServerRequest& request);
+
+    /*!
+     * \brief Декодирование тела запроса
+     * \return false, если тело повреждено
+     */
+    static bool decodeRequest(const QByteArray& payload, ServerRequest& request);
+
+    /*!
+     * \brief Кодирование тела ответа
+     */
+    static QByteArray encodeResponse(const ServerResponse& response);
+
+    /*!
+     * \brief Декодирование тела ответа
+     * \return false, если тело повреждено
+     */
+    static bool decodeResponse(const QByteArray& payload, ServerResponse& response);
+
+    /*!
+     * \brief Чтение кадра из сокета (блокирующее)
+     * \param[in] fd Дескриптор сокета
+     * \param[out] payload Тело кадра
+     * \return false, если соединение закрыто, произошла ошибка или кадр превышает maxFrameSize
+     */
+    static bool readFrame(int fd, QByteArray& payload);
+
+    /*!
+     * \brief Запись кадра в сокет (блокирующая)
+     * \param[in] fd Дескриптор сокета
+     * \param[in] payload Тело кадра
+     * \return false при ошибке записи
+     */
+    static bool writeFrame(int fd, const QByteArray& payload);
+
+private:
+    /*!
+     * \brief Кодирование списка строк: количество и строки с длинами
+     */
+    static void appendStrings(QByteArray& payload, const QStringList& strings);
+
+    /*!
+     * \brief Декодирование списка строк начиная с позиции offset
+     */
+    static bool readStrings(const QByteArray& payload, qsizetype offset, QStringList& strings);
+};
+
+#endif // SERVERPROTOCOL_H
@@ -0,0 +1,91 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание шаблона SingleFlight — объединения одновременных одинаковых вычислений
+ */
+
+#ifndef SINGLEFLIGHT_H
+#define SINGLEFLIGHT_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+
+/*!
+ * \brief Объединение одновременных вычислений с одинаковым ключом
+ *
+ * Первый вызов с ключом выполняет вычисление, а вызовы с тем же ключом, пришедшие до его
+ * окончания, ждут и получают тот же результат (или то же исключение). После окончания
+ * вычисления ключ освобождается: повторное вычисление должен предотвращать кэш результатов.
+ * Методы потокобезопасны.
+ * \tparam T Тип результата вычисления
+ */
+template <typename T>
+class SingleFlight
+{
+public:
+    SingleFlight() : coalescedCount(0) {}
+
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    /*!
+     * \brief Выполнение вычисления или ожидание уже выполняемого вычисления с тем же ключом
+     * \param[in] key Ключ вычисления
+     * \param[in] compute Вычисление
+     * \return Результат вычисления
+     */
+    T run(const QString& key, const std::function<T()>& compute)
+    {
+        std::promise<T> promise;
+        std::shared_future<T> future;
+        bool owner = false;
+        {
+            QMutexLocker locker(&mutex);
+            auto it = calls.constFind(key);
+            if (it != calls.constEnd()) {
+                future = it.value();
+                coalescedCount++;
+            }
+            else {
+                future = promise.get_future().share();
+                calls.insert(key, future);
+                owner = true;
+            }
+        }
+
+        // Вычисление выполняет другой поток — дождаться его результата
+        if (!owner) return future.get();
+
+        try {
+            promise.set_value(compute());
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+
+        {
+            QMutexLocker locker(&mutex);
+            calls.remove(key);
+        }
+        return future.get();
+    }
+
+    /*!
+     * \brief Получение количества вызовов, получивших результат чужого вычисления
+     */
+    qint64 getCoalescedCount() const
+    {
+        return coalescedCount;
+    }
+
+private:
+    QMutex mutex; ///< Защита списка выполняемых вычислений
+    QHash<QString, std::shared_future<T>> calls; ///< Выполняемые вычисления по ключам
+    std::atomic<qint64> coalescedCount; ///< Количество объединённых вызовов
+};
+
+#endif // SINGLEFLIGHT_H
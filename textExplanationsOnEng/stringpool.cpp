@@ -0,0 +1,52 @@
+#include "stringpool.h"
+
+StringPool::StringPool(qsizetype capacityHint)
+    : usedSize(0)
+{
+    addChunk(qMax(capacityHint, defaultChunkSize));
+}
+
+QString StringPool::intern(QStringView text)
+{
+    if (text.isEmpty()) return QString();
+
+    // Строка не помещается даже в пустой блок — выделить под неё отдельный блок,
+    // оставив текущий блок последним
+    if (text.size() > defaultChunkSize && text.size() > chunks.last().capacity()) {
+        QString dedicated;
+        dedicated.reserve(text.size());
+        dedicated.append(text);
+        chunks.insert(chunks.size() - 1, dedicated);
+        usedSize += text.size();
+        return QString::fromRawData(chunks.at(chunks.size() - 2).constData(), text.size());
+    }
+
+    // В текущем блоке не хватает места — начать новый
+    if (chunks.last().capacity() - chunks.last().size() < text.size()) {
+        addChunk(defaultChunkSize);
+    }
+
+    // Дозапись в пределах зарезервированной ёмкости не перемещает данные блока
+    QString& chunk = chunks.last();
+    const qsizetype offset = chunk.size();
+    chunk.append(text);
+    usedSize += text.size();
+    return QString::fromRawData(chunk.constData() + offset, text.size());
+}
+
+qsizetype StringPool::size() const
+{
+    return usedSize;
+}
+
+qsizetype StringPool::chunkCount() const
+{
+    return chunks.size();
+}
+
+void StringPool::addChunk(qsizetype capacity)
+{
+    QString chunk;
+    chunk.reserve(capacity);
+    chunks.append(chunk);
+}
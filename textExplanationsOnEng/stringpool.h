@@ -0,0 +1,63 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса StringPool — единого буфера строк схемы
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+/*!
+ * \brief Пул строк схемы: имена, типы и описания сущностей хранятся в нескольких больших блоках
+ *
+ * Строки, возвращаемые intern(), не владеют данными — это представления (QString::fromRawData)
+ * внутрь блоков пула. Блоки никогда не перевыделяются, поэтому представления остаются
+ * действительными, пока жив пул. Пул должен жить не меньше, чем сущности, которые на него ссылаются.
+ */
+class StringPool
+{
+public:
+    /*!
+     * \brief Конструктор пула
+     * \param[in] capacityHint Ожидаемый суммарный объём строк (в символах)
+     */
+    explicit StringPool(qsizetype capacityHint = 0);
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /*!
+     * \brief Копирование строки в пул
+     * \param[in] text Исходный текст
+     * \return Строка-представление, указывающая на данные внутри пула
+     */
+    QString intern(QStringView text);
+
+    /*!
+     * \brief Получение количества символов, размещённых в пуле
+     */
+    qsizetype size() const;
+
+    /*!
+     * \brief Получение количества выделенных блоков
+     */
+    qsizetype chunkCount() const;
+
+private:
+    /*!
+     * \brief Выделение нового блока
+     * \param[in] capacity Ёмкость блока (в символах)
+     */
+    void addChunk(qsizetype capacity);
+
+    /*! \brief Размер блока по умолчанию (в символах) */
+    static constexpr qsizetype defaultChunkSize = 4096;
+
+    QList<QString> chunks; ///< Блоки пула; последний блок — текущий для дозаписи
+    qsizetype usedSize;    ///< Количество символов, размещённых в пуле
+};
+
+#endif // STRINGPOOL_H
@@ -48,6 +48,11 @@ const QHash<ErrorType, QString> TEException::ErrorTypeNames = {
     {ErrorType::InvalidName, "InvalidName"},
     {ErrorType::UnidentifedType, "UnidentifedType"},
     {ErrorType::InvalidParamsCount, "InvalidParamsCount"},
+    {ErrorType::InputFileTooLarge, "InputFileTooLarge"},
+    {ErrorType::NestingDepthExceeded, "NestingDepthExceeded"},
+    {ErrorType::AttributesCountExceeded, "AttributesCountExceeded"},
+    {ErrorType::ErrorLimitExceeded, "ErrorLimitExceeded"},
+    {ErrorType::Cancelled, "Cancelled"},
 };
 
 QString TEException::what() const {
@@ -147,6 +152,21 @@ QString TEException::what() const {
     case ErrorType::VariableWithVoidType:
         message += "the variable \"{1}\" has an invalid data type \"void\". The \"void\" data type can only be used for functions.";
         break;
+    case ErrorType::InputFileTooLarge:
+        message += "the input document size ({1} bytes) exceeds the allowed size of {2} bytes.";
+        break;
+    case ErrorType::NestingDepthExceeded:
+        message += "the element <{1}> is nested deeper than the allowed {2} levels.";
+        break;
+    case ErrorType::AttributesCountExceeded:
+        message += "the element <{1}> has {2} attributes, the allowed number is {3}.";
+        break;
+    case ErrorType::ErrorLimitExceeded:
+        message += "processing stopped after {1} errors.";
+        break;
+    case ErrorType::Cancelled:
+        message += "processing was cancelled: the time limit for the request was exceeded.";
+        break;
     default:
         message += "unknown error";
         break;
@@ -169,6 +189,11 @@ int TEException::getLine() const
     return line;
 }
 
+QString TEException::getFilename() const
+{
+    return filename;
+}
+
 QList<QString> TEException::getArgs() const
 {
     return args;
@@ -55,7 +55,16 @@ enum class ErrorType {
     // Ошибки атрибута paramsCount
     InvalidParamsCount,             //!< Неверный формат paramsCount
     MissingReplacementArguments,    //!< Отсутствуют аргументы для замены в шаблоне
-    VariableWithVoidType            //!< Переменная имеет недопустимый тип void
+    VariableWithVoidType,           //!< Переменная имеет недопустимый тип void
+
+    // Ошибки ограничений разбора (ParserLimits)
+    InputFileTooLarge,              //!< Размер входного документа превышает допустимый
+    NestingDepthExceeded,           //!< Превышена допустимая глубина вложенности элементов
+    AttributesCountExceeded,        //!< Превышено допустимое количество атрибутов элемента
+    ErrorLimitExceeded,             //!< Превышено допустимое количество ошибок
+
+    // Ошибки обработки запроса
+    Cancelled                       //!< Обработка отменена или превышен срок обработки
 };
 
 /*! \brief Класс TEException инкапсулирует информацию об ошибке при обработке выражения */
@@ -112,6 +121,12 @@ public:
      */
     int getLine() const;
 
+    /*!
+     * \brief Получить имя файла, где возникла ошибка
+     * \return Имя файла (или пустая строка, если не указано)
+     */
+    QString getFilename() const;
+
     /*!
      * \brief Получить аргументы, подставляемые в шаблон ошибки
      * \return Список аргументов
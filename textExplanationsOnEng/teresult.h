@@ -0,0 +1,170 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание шаблона TEResult — результата обработки без исключений
+ */
+
+#ifndef TERESULT_H
+#define TERESULT_H
+
+#include "teexception.h"
+
+#include <QList>
+
+#include <optional>
+#include <utility>
+
+/*!
+ * \brief Результат обработки: значение или список ошибок
+ *
+ * Используется вместо исключений там, где ошибочные входные данные — обычный случай
+ * (разбор XML, построение дерева выражения, подстановка в шаблон объяснения).
+ * Ошибки хранят тип и аргументы; текст сообщения формируется только при выводе (TEException::what).
+ * Методы throwIfFailed и throwFirstIfFailed позволяют сохранить прежний интерфейс с исключениями.
+ * \tparam T Тип значения
+ */
+template <typename T>
+class TEResult
+{
+public:
+    /*!
+     * \brief Успешный результат
+     * \param[in] value Значение
+     */
+    TEResult(const T& value) : result(value) {}
+
+    /*!
+     * \brief Успешный результат
+     * \param[in] value Значение
+     */
+    TEResult(T&& value) : result(std::move(value)) {}
+
+    /*!
+     * \brief Результат с одной ошибкой
+     * \param[in] error Ошибка
+     */
+    TEResult(const TEException& error) : errors{error} {}
+
+    /*!
+     * \brief Результат со списком ошибок
+     * \param[in] errors Непустой список ошибок
+     */
+    TEResult(const QList<TEException>& errors) : errors(errors) {}
+
+    /*!
+     * \brief Проверка, получено ли значение
+     */
+    bool isOk() const
+    {
+        return errors.isEmpty();
+    }
+
+    /*!
+     * \brief Получение значения успешного результата
+     */
+    const T& value() const
+    {
+        return *result;
+    }
+
+    /*!
+     * \brief Получение значения успешного результата
+     */
+    T& value()
+    {
+        return *result;
+    }
+
+    /*!
+     * \brief Получение ошибок неуспешного результата
+     */
+    const QList<TEException>& getErrors() const
+    {
+        return errors;
+    }
+
+    /*!
+     * \brief Выброс списка ошибок, если результат неуспешный
+     * \throw QList<TEException> Список ошибок
+     */
+    void throwIfFailed() const
+    {
+        if (!errors.isEmpty()) throw errors;
+    }
+
+    /*!
+     * \brief Выброс первой ошибки, если результат неуспешный
+     * \throw TEException Первая ошибка
+     */
+    void throwFirstIfFailed() const
+    {
+        if (!errors.isEmpty()) throw errors.first();
+    }
+
+private:
+    std::optional<T> result; ///< Значение (есть только у успешного результата)
+    QList<TEException> errors; ///< Ошибки (есть только у неуспешного результата)
+};
+
+/*!
+ * \brief Результат обработки без значения: успех или список ошибок
+ */
+template <>
+class TEResult<void>
+{
+public:
+    /*!
+     * \brief Успешный результат
+     */
+    TEResult() {}
+
+    /*!
+     * \brief Результат с одной ошибкой
+     * \param[in] error Ошибка
+     */
+    TEResult(const TEException& error) : errors{error} {}
+
+    /*!
+     * \brief Результат со списком ошибок (пустой список — успех)
+     * \param[in] errors Список ошибок
+     */
+    TEResult(const QList<TEException>& errors) : errors(errors) {}
+
+    /*!
+     * \brief Проверка, выполнена ли обработка без ошибок
+     */
+    bool isOk() const
+    {
+        return errors.isEmpty();
+    }
+
+    /*!
+     * \brief Получение ошибок неуспешного результата
+     */
+    const QList<TEException>& getErrors() const
+    {
+        return errors;
+    }
+
+    /*!
+     * \brief Выброс списка ошибок, если результат неуспешный
+     * \throw QList<TEException> Список ошибок
+     */
+    void throwIfFailed() const
+    {
+        if (!errors.isEmpty()) throw errors;
+    }
+
+    /*!
+     * \brief Выброс первой ошибки, если результат неуспешный
+     * \throw TEException Первая ошибка
+     */
+    void throwFirstIfFailed() const
+    {
+        if (!errors.isEmpty()) throw errors.first();
+    }
+
+private:
+    QList<TEException> errors; ///< Ошибки
+};
+
+#endif // TERESULT_H
@@ -2,8 +2,7 @@ VPATH = $$PWD #Что бы файлы подключались относите
 INCLUDEPATH += $$PWD
 
 QT = core \
-     xml \
-     qml
+     xml
 
 CONFIG += c++17 console
 
@@ -11,13 +10,33 @@ CONFIG += c++17 console
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Сборка без замеров статистики обработки (--stats) и без замены функций распределителя памяти (--track-allocations): qmake DEFINES+=TE_DISABLE_STATS
+
 SOURCES += \
+        allocationtracker.cpp \
+        batchprocessor.cpp \
+        cancellationtoken.cpp \
         codeentity.cpp \
+        compiledschema.cpp \
+        diskcache.cpp \
+        explanationcache.cpp \
+        explanationclient.cpp \
+        explanationserver.cpp \
         expression.cpp \
+        expressiondocument.cpp \
         expressionnode.cpp \
         expressiontranslator.cpp \
         expressionxmlparser.cpp \
-        teexception.cpp
+        perfcounters.cpp \
+        pipelinestats.cpp \
+        reorderbuffer.cpp \
+        schemaregistry.cpp \
+        serverprotocol.cpp \
+        stringpool.cpp \
+        teexception.cpp \
+        tracelog.cpp \
+        treeprofiler.cpp \
+        workstealingpool.cpp
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -25,9 +44,29 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 HEADERS += \
+    allocationtracker.h \
+    batchprocessor.h \
+    cancellationtoken.h \
     codeentity.h \
+    compiledschema.h \
+    diskcache.h \
+    explanationcache.h \
+    explanationclient.h \
+    explanationserver.h \
     expression.h \
+    expressiondocument.h \
     expressionnode.h \
     expressiontranslator.h \
     expressionxmlparser.h \
-    teexception.h
+    perfcounters.h \
+    pipelinestats.h \
+    reorderbuffer.h \
+    schemaregistry.h \
+    serverprotocol.h \
+    singleflight.h \
+    stringpool.h \
+    teexception.h \
+    teresult.h \
+    tracelog.h \
+    treeprofiler.h \
+    workstealingpool.h
@@ -0,0 +1,147 @@
+#include "tracelog.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/*!
+ * \brief Кольцевой буфер событий одного потока
+ */
+struct TraceBuffer {
+    QList<TraceEvent> events;           /*!< События; запись по индексу written % events.size() */
+    std::atomic<quint64> written{0};    /*!< Количество записанных событий (пишет только поток-владелец) */
+    int threadId = 0;                   /*!< Номер потока в журнале */
+};
+
+static std::atomic<bool> enabled(false);
+static std::atomic<quint64> generation(0); // Номер включения: буферы прошлых включений не используются
+static int capacity = 0;
+static QElapsedTimer origin;
+static QMutex buffersMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+thread_local TraceBuffer* threadBuffer = nullptr;
+thread_local quint64 threadGeneration = 0;
+
+void TraceLog::enable(int eventsPerThread)
+{
+    QMutexLocker locker(&buffersMutex);
+    buffers.clear();
+    capacity = qMax(1, eventsPerThread);
+    origin.start();
+    generation.fetch_add(1, std::memory_order_release);
+    enabled.store(true, std::memory_order_release);
+}
+
+void TraceLog::disable()
+{
+    enabled.store(false, std::memory_order_release);
+    QMutexLocker locker(&buffersMutex);
+    generation.fetch_add(1, std::memory_order_release);
+    buffers.clear();
+}
+
+bool TraceLog::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+qint64 TraceLog::nowNs()
+{
+    return origin.nsecsElapsed();
+}
+
+void TraceLog::record(const TraceEvent &event)
+{
+    if (!isEnabled()) return;
+
+    // Буфер регистрируется один раз на поток и включение журнала
+    const quint64 currentGeneration = generation.load(std::memory_order_acquire);
+    if (!threadBuffer || threadGeneration != currentGeneration) {
+        QMutexLocker locker(&buffersMutex);
+        buffers.push_back(std::make_unique<TraceBuffer>());
+        threadBuffer = buffers.back().get();
+        threadBuffer->events.resize(capacity);
+        threadBuffer->threadId = int(buffers.size());
+        threadGeneration = currentGeneration;
+    }
+
+    const quint64 index = threadBuffer->written.load(std::memory_order_relaxed);
+    threadBuffer->events[qsizetype(index % quint64(threadBuffer->events.size()))] = event;
+    threadBuffer->written.store(index + 1, std::memory_order_release);
+}
+
+QByteArray TraceLog::toChromeTraceJson()
+{
+    QMutexLocker locker(&buffersMutex);
+    QJsonArray traceEvents;
+
+    for (const std::unique_ptr<TraceBuffer>& buffer : buffers) {
+        traceEvents.append(QJsonObject{
+            {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", buffer->threadId},
+            {"args", QJsonObject{{"name", "worker " + QString::number(buffer->threadId)}}}});
+
+        // После переполнения в буфере остаются последние события потока
+        const quint64 written = buffer->written.load(std::memory_order_acquire);
+        const quint64 size = quint64(buffer->events.size());
+        const quint64 first = written > size ? written - size : 0;
+        for (quint64 i = first; i < written; i++) {
+            const TraceEvent& event = buffer->events[qsizetype(i % size)];
+            QJsonObject object{
+                {"name", event.stage < 0 ? QString("request") : StatsAggregate::stageName(PipelineStage(event.stage))},
+                {"cat", event.stage < 0 ? "request" : "stage"},
+                {"ph", "X"},
+                {"ts", double(event.startNs) / 1000.0},
+                {"dur", double(event.durationNs) / 1000.0},
+                {"pid", 1},
+                {"tid", buffer->threadId}};
+            if (event.stage < 0)
+                object.insert("args", QJsonObject{{"file", event.label}, {"tokens", event.tokens}});
+            traceEvents.append(object);
+        }
+    }
+
+    QJsonObject root{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}};
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool TraceLog::writeChromeTrace(const QString &path, QString *errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) *errorMessage = "cannot write trace file \"" + path + "\": " + file.errorString();
+        return false;
+    }
+    const QByteArray json = toChromeTraceJson();
+    // Обрезанный файл (например, на заполненном диске) не открывается в Perfetto — это ошибка записи
+    if (file.write(json) != json.size() || !file.flush()) {
+        if (errorMessage) *errorMessage = "cannot write trace file \"" + path + "\": " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+RequestTrace::RequestTrace(const QString &label, const StatsRecorder *recorder)
+    : label(label)
+    , recorder(recorder)
+    , startNs(TraceLog::isEnabled() ? TraceLog::nowNs() : -1)
+{}
+
+RequestTrace::~RequestTrace()
+{
+    if (startNs < 0 || !TraceLog::isEnabled()) return;
+    TraceEvent event;
+    event.startNs = startNs;
+    event.durationNs = TraceLog::nowNs() - startNs;
+    event.label = label;
+    event.tokens = recorder ? recorder->counter(PipelineCounter::Tokens) : 0;
+    TraceLog::record(event);
+}
@@ -0,0 +1,112 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса TraceLog — журнала событий обработки в формате Chrome trace
+ */
+
+#ifndef TRACELOG_H
+#define TRACELOG_H
+
+#include "pipelinestats.h"
+
+#include <QString>
+
+/*!
+ * \brief Событие журнала: этап или запрос целиком
+ */
+struct TraceEvent {
+    int stage = -1;         /*!< Этап (PipelineStage) или -1 для запроса целиком */
+    qint64 startNs = 0;     /*!< Начало относительно включения журнала в наносекундах */
+    qint64 durationNs = 0;  /*!< Длительность в наносекундах */
+    QString label;          /*!< Входной файл или тип запроса (только для запроса) */
+    qint64 tokens = 0;      /*!< Количество лексем выражений запроса (только для запроса) */
+};
+
+/*!
+ * \brief Журнал событий обработки для поиска медленных файлов и запросов
+ *
+ * Каждый поток пишет события в собственный кольцевой буфер без блокировок: при переполнении
+ * перезаписываются самые старые события потока. Буфер регистрируется при первом событии потока
+ * и живёт до выключения журнала. События этапов пишет StageTimer, события запросов — RequestTrace;
+ * этапы замеряются только в потоке с установленным StatsRecorder.
+ * Журнал сохраняется в формате Chrome trace event (JSON), который открывается в Perfetto и chrome://tracing.
+ */
+class TraceLog
+{
+public:
+    /*!
+     * \brief Включение журнала; события, записанные ранее, удаляются
+     * \param[in] eventsPerThread Ёмкость кольцевого буфера одного потока
+     */
+    static void enable(int eventsPerThread = 65536);
+
+    /*!
+     * \brief Выключение журнала и удаление событий
+     *
+     * Вызывается, когда ни один поток не пишет события.
+     */
+    static void disable();
+
+    /*!
+     * \brief Проверка, включён ли журнал
+     */
+    static bool isEnabled();
+
+    /*!
+     * \brief Время относительно включения журнала в наносекундах
+     */
+    static qint64 nowNs();
+
+    /*!
+     * \brief Запись события в буфер текущего потока
+     * \param[in] event Событие
+     */
+    static void record(const TraceEvent& event);
+
+    /*!
+     * \brief Сохранение журнала в формате Chrome trace event
+     *
+     * Вызывается, когда ни один поток не пишет события.
+     * \param[in] path Путь к файлу
+     * \param[out] errorMessage Сообщение об ошибке (если задано)
+     * \return true, если файл записан целиком
+     */
+    static bool writeChromeTrace(const QString& path, QString* errorMessage = nullptr);
+
+    /*!
+     * \brief Форматирование журнала в JSON формата Chrome trace event
+     *
+     * Вызывается, когда ни один поток не пишет события.
+     */
+    static QByteArray toChromeTraceJson();
+};
+
+/*!
+ * \brief Событие запроса целиком: от создания до уничтожения объекта
+ *
+ * В аргументы события попадают входной файл и количество лексем, подсчитанное накопителем статистики.
+ */
+class RequestTrace
+{
+public:
+    /*!
+     * \brief Начало запроса
+     * \param[in] label Входной файл или тип запроса
+     * \param[in] recorder Накопитель статистики запроса (nullptr — количество лексем не известно)
+     */
+    RequestTrace(const QString& label, const StatsRecorder* recorder);
+
+    /*!
+     * \brief Окончание запроса и запись события
+     */
+    ~RequestTrace();
+
+    RequestTrace(const RequestTrace&) = delete;
+    RequestTrace& operator=(const RequestTrace&) = delete;
+
+private:
+    QString label; ///< Входной файл или тип запроса
+    const StatsRecorder* recorder; ///< Накопитель статистики запроса
+    qint64 startNs; ///< Начало запроса (-1 — журнал выключен)
+};
+
+#endif // TRACELOG_H
@@ -0,0 +1,125 @@
+#include "treeprofiler.h"
+
+#include <QJsonObject>
+
+thread_local TreeProfiler* TreeProfiler::currentProfiler = nullptr;
+
+TreeProfiler::TreeProfiler()
+{
+    clock.start();
+}
+
+// Метка узла без дочерних узлов: ExpressionNode::toString описывает всё поддерево
+static QString nodeLabel(const ExpressionNode* node) {
+    QString label = node->getValue().isEmpty() ? "Unknown" : node->getValue();
+    if (node->getNodeType() == EntityType::Function && node->getFunctionArgs())
+        label += "(" + QString::number(node->getFunctionArgs()->size()) + ")";
+    return label;
+}
+
+void TreeProfiler::enter(const ExpressionNode *node)
+{
+    const qint64 profilerStart = recorder.counter(PipelineCounter::Allocations);
+    NodeProfile profile;
+    profile.node = nodeLabel(node);
+    profile.depth = int(stack.size());
+    profiles.append(profile);
+
+    OpenCall call;
+    call.index = int(profiles.size() - 1);
+    call.startTemplates = recorder.counter(PipelineCounter::TemplateApplications);
+    call.startAllocations = recorder.counter(PipelineCounter::Allocations);
+    call.profilerAllocations = call.startAllocations - profilerStart;
+    // Время отсчитывается последним, чтобы не учитывать подготовку профиля
+    call.startNs = clock.nsecsElapsed();
+    stack.append(call);
+}
+
+void TreeProfiler::leave(const QString &description)
+{
+    const qint64 endNs = clock.nsecsElapsed();
+    const qint64 endAllocations = recorder.counter(PipelineCounter::Allocations);
+    const OpenCall call = stack.takeLast();
+
+    NodeProfile& profile = profiles[call.index];
+    profile.inclusiveNs = endNs - call.startNs;
+    profile.exclusiveNs = profile.inclusiveNs - call.childrenNs;
+    profile.inclusiveTemplates = recorder.counter(PipelineCounter::TemplateApplications) - call.startTemplates;
+    profile.exclusiveTemplates = profile.inclusiveTemplates - call.childrenTemplates;
+    profile.inclusiveAllocations = endAllocations - call.startAllocations;
+    profile.exclusiveAllocations = profile.inclusiveAllocations - call.childrenAllocations;
+    profile.bytes = description.toUtf8().size();
+
+    if (!stack.isEmpty()) {
+        stack.last().childrenNs += profile.inclusiveNs;
+        stack.last().childrenTemplates += profile.inclusiveTemplates;
+        // Выделения профилировщика до и после вызова узла не относятся к родительскому узлу
+        stack.last().childrenAllocations += recorder.counter(PipelineCounter::Allocations) - endAllocations
+                                            + profile.inclusiveAllocations + call.profilerAllocations;
+    }
+}
+
+const QList<NodeProfile> &TreeProfiler::getProfiles() const
+{
+    return profiles;
+}
+
+static QString milliseconds(qint64 ns) {
+    return QString::number(double(ns) / 1e6, 'f', 3);
+}
+
+QString TreeProfiler::formatTree() const
+{
+    QString output;
+    for (const NodeProfile& profile : profiles) {
+        output += QString(profile.depth * 2, ' ') + "-> " + profile.node
+                  + "  (inclusive " + milliseconds(profile.inclusiveNs) + " ms, exclusive " + milliseconds(profile.exclusiveNs) + " ms"
+                  + ", templates " + QString::number(profile.inclusiveTemplates) + "/" + QString::number(profile.exclusiveTemplates)
+                  + ", bytes " + QString::number(profile.bytes)
+                  + (AllocationTracker::isEnabled() ? ", allocations " + QString::number(profile.inclusiveAllocations) + "/"
+                                                          + QString::number(profile.exclusiveAllocations) : QString())
+                  + ")\n";
+    }
+    return output;
+}
+
+// Узел с дочерними узлами, следующими за ним в порядке обхода с большей глубиной
+static QJsonObject nodeToJson(const QList<NodeProfile>& profiles, qsizetype& index) {
+    const NodeProfile& profile = profiles[index++];
+    QJsonArray children;
+    while (index < profiles.size() && profiles[index].depth > profile.depth) {
+        children.append(nodeToJson(profiles, index));
+    }
+    return QJsonObject{
+        {"node", profile.node},
+        {"inclusive_ns", profile.inclusiveNs},
+        {"exclusive_ns", profile.exclusiveNs},
+        {"inclusive_templates", profile.inclusiveTemplates},
+        {"exclusive_templates", profile.exclusiveTemplates},
+        {"bytes", profile.bytes},
+        {"inclusive_allocations", profile.inclusiveAllocations},
+        {"exclusive_allocations", profile.exclusiveAllocations},
+        {"children", children}};
+}
+
+QJsonArray TreeProfiler::toJson() const
+{
+    QJsonArray roots;
+    qsizetype index = 0;
+    while (index < profiles.size()) {
+        roots.append(nodeToJson(profiles, index));
+    }
+    return roots;
+}
+
+TreeProfileScope::TreeProfileScope(TreeProfiler *profiler)
+    : previous(TreeProfiler::currentProfiler)
+    , stats(&profiler->recorder)
+{
+    TreeProfiler::currentProfiler = profiler;
+}
+
+TreeProfileScope::~TreeProfileScope()
+{
+    TreeProfiler::currentProfiler = previous;
+}
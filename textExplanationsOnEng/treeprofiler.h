@@ -0,0 +1,184 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса TreeProfiler — профиля построения объяснения по узлам дерева выражения
+ */
+
+#ifndef TREEPROFILER_H
+#define TREEPROFILER_H
+
+#include "expressionnode.h"
+#include "pipelinestats.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QList>
+#include <QString>
+
+/*!
+ * \brief Профиль объяснения одного узла дерева выражения
+ *
+ * Время, подстановки в шаблоны и выделения памяти «включительно» учитывают объяснение дочерних узлов, «собственные» — нет.
+ */
+struct NodeProfile {
+    QString node;                           /*!< Метка узла: значение или операция, для функции — имя и количество аргументов */
+    int depth = 0;                          /*!< Глубина вызова (0 — корень) */
+    qint64 inclusiveNs = 0;                 /*!< Время включительно в наносекундах */
+    qint64 exclusiveNs = 0;                 /*!< Собственное время в наносекундах */
+    qint64 inclusiveTemplates = 0;          /*!< Подстановок в шаблоны включительно */
+    qint64 exclusiveTemplates = 0;          /*!< Собственных подстановок в шаблоны */
+    qint64 bytes = 0;                       /*!< Размер объяснения узла в байтах UTF-8 */
+    qint64 inclusiveAllocations = 0;        /*!< Выделений памяти включительно (AllocationTracker) */
+    qint64 exclusiveAllocations = 0;        /*!< Собственных выделений памяти (AllocationTracker) */
+};
+
+/*!
+ * \brief Профиль построения объяснения по узлам дерева — аналог EXPLAIN ANALYZE для выражения
+ *
+ * Профилировщик, установленный для потока (TreeProfileScope), получает замер каждого вызова
+ * Expression::explainNode (NodeProfileTimer) в порядке обхода дерева. Узел описывается только собственной
+ * меткой — структуру дерева передают глубина и отступы, поэтому размер профиля линеен по числу узлов. Подстановки в шаблоны
+ * и выделения памяти (если включён AllocationTracker) считываются из накопителя статистики потока,
+ * поэтому профилировщик устанавливает и собственный накопитель. Выделения самого профилировщика узлам не приписываются.
+ * При сборке с TE_DISABLE_STATS замеры удаляются.
+ */
+class TreeProfiler
+{
+public:
+    TreeProfiler();
+
+    TreeProfiler(const TreeProfiler&) = delete;
+    TreeProfiler& operator=(const TreeProfiler&) = delete;
+
+    /*!
+     * \brief Профилировщик, установленный для текущего потока (nullptr — профиль не собирается)
+     */
+    static TreeProfiler* current()
+    {
+#ifdef TE_DISABLE_STATS
+        return nullptr;
+#else
+        return currentProfiler;
+#endif
+    }
+
+    /*!
+     * \brief Начало объяснения узла
+     * \param[in] node Узел
+     */
+    void enter(const ExpressionNode* node);
+
+    /*!
+     * \brief Окончание объяснения узла, начатого последним
+     * \param[in] description Объяснение узла (пустое, если объяснение прервано ошибкой)
+     */
+    void leave(const QString& description);
+
+    /*!
+     * \brief Получение профилей узлов в порядке обхода дерева
+     */
+    const QList<NodeProfile>& getProfiles() const;
+
+    /*!
+     * \brief Форматирование профиля деревом с отступами
+     */
+    QString formatTree() const;
+
+    /*!
+     * \brief Форматирование профиля в JSON: вложенные объекты узлов с полем "children"
+     */
+    QJsonArray toJson() const;
+
+private:
+    friend class TreeProfileScope;
+
+    static thread_local TreeProfiler* currentProfiler; ///< Профилировщик текущего потока
+
+    /*!
+     * \brief Незавершённый вызов объяснения узла
+     */
+    struct OpenCall {
+        int index;                  /*!< Индекс профиля узла */
+        qint64 startNs;             /*!< Начало вызова */
+        qint64 startTemplates;      /*!< Подстановок в шаблоны к началу вызова */
+        qint64 childrenNs = 0;      /*!< Время дочерних вызовов */
+        qint64 childrenTemplates = 0; /*!< Подстановок в шаблоны дочерних вызовов */
+        qint64 startAllocations;    /*!< Выделений памяти к началу вызова */
+        qint64 childrenAllocations = 0; /*!< Выделений памяти дочерних вызовов вместе с выделениями профилировщика */
+        qint64 profilerAllocations = 0; /*!< Выделений памяти профилировщиком при начале вызова */
+    };
+
+    QElapsedTimer clock; ///< Отсчёт времени профиля
+    StatsRecorder recorder; ///< Накопитель подстановок в шаблоны и выделений памяти
+    QList<NodeProfile> profiles; ///< Профили узлов в порядке обхода
+    QList<OpenCall> stack; ///< Незавершённые вызовы
+};
+
+/*!
+ * \brief Установка профилировщика (и его накопителя статистики) для текущего потока на время жизни объекта
+ */
+class TreeProfileScope
+{
+public:
+    /*!
+     * \brief Установка профилировщика
+     * \param[in] profiler Профилировщик
+     */
+    explicit TreeProfileScope(TreeProfiler* profiler);
+
+    /*!
+     * \brief Восстановление профилировщика, установленного до создания объекта
+     */
+    ~TreeProfileScope();
+
+    TreeProfileScope(const TreeProfileScope&) = delete;
+    TreeProfileScope& operator=(const TreeProfileScope&) = delete;
+
+private:
+    TreeProfiler* previous; ///< Профилировщик, установленный до создания объекта
+    StatsScope stats; ///< Установка накопителя профилировщика
+};
+
+/*!
+ * \brief Замер объяснения узла от создания до finish() или, если объяснение прервано, до уничтожения объекта
+ */
+class NodeProfileTimer
+{
+public:
+    /*!
+     * \brief Начало замера
+     * \param[in] node Узел
+     */
+    explicit NodeProfileTimer(const ExpressionNode* node)
+        : profiler(TreeProfiler::current())
+    {
+        if (profiler) profiler->enter(node);
+    }
+
+    /*!
+     * \brief Окончание замера объяснения, прерванного ошибкой
+     */
+    ~NodeProfileTimer()
+    {
+        if (profiler) profiler->leave(QString());
+    }
+
+    /*!
+     * \brief Окончание замера
+     * \param[in] description Объяснение узла
+     * \return То же объяснение
+     */
+    const QString& finish(const QString& description)
+    {
+        if (profiler) profiler->leave(description);
+        profiler = nullptr;
+        return description;
+    }
+
+    NodeProfileTimer(const NodeProfileTimer&) = delete;
+    NodeProfileTimer& operator=(const NodeProfileTimer&) = delete;
+
+private:
+    TreeProfiler* profiler; ///< Профилировщик текущего потока (nullptr после окончания замера)
+};
+
+#endif // TREEPROFILER_H
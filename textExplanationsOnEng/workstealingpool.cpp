@@ -0,0 +1,81 @@
+#include "workstealingpool.h"
+
+#include <QThread>
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : threadCount(threadCount > 0 ? threadCount : QThread::idealThreadCount())
+    , stealCount(0)
+{}
+
+void WorkStealingPool::run(int taskCount, const std::function<void(int)>& task)
+{
+    stealCount = 0;
+    int workers = qMax(1, qMin(threadCount, taskCount));
+
+    // Раздать задачи по очереди: каждый поток начинает с самых ранних задач
+    QList<WorkerQueue*> queues;
+    for (int w = 0; w < workers; w++) {
+        queues.append(new WorkerQueue);
+    }
+    for (int i = 0; i < taskCount; i++) {
+        queues[i % workers]->tasks.append(i);
+    }
+
+    // Вызывающий поток работает как поток 0
+    QList<QThread*> threads;
+    for (int w = 1; w < workers; w++) {
+        QThread* thread = QThread::create([this, w, &queues, &task]() {
+            workerLoop(w, queues, task);
+        });
+        thread->start();
+        threads.append(thread);
+    }
+    workerLoop(0, queues, task);
+
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+    qDeleteAll(queues);
+}
+
+int WorkStealingPool::getThreadCount() const
+{
+    return threadCount;
+}
+
+int WorkStealingPool::getStealCount() const
+{
+    return stealCount;
+}
+
+void WorkStealingPool::workerLoop(int worker, QList<WorkerQueue*>& queues, const std::function<void(int)>& task)
+{
+    int taskIndex = 0;
+    // Новые задачи во время работы не появляются, поэтому пустые очереди у всех означают конец работы
+    while (popLocal(queues[worker], taskIndex) || steal(worker, queues, taskIndex)) {
+        task(taskIndex);
+    }
+}
+
+bool WorkStealingPool::popLocal(WorkerQueue* queue, int& taskIndex)
+{
+    QMutexLocker locker(&queue->mutex);
+    if (queue->tasks.isEmpty()) return false;
+    taskIndex = queue->tasks.takeFirst();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, QList<WorkerQueue*>& queues, int& taskIndex)
+{
+    for (int offset = 1; offset < queues.size(); offset++) {
+        WorkerQueue* victim = queues[(thief + offset) % queues.size()];
+        QMutexLocker locker(&victim->mutex);
+        if (!victim->tasks.isEmpty()) {
+            taskIndex = victim->tasks.takeLast();
+            stealCount++;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,76 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса WorkStealingPool — пула потоков с перехватом задач
+ */
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <QList>
+#include <QMutex>
+
+#include <atomic>
+#include <functional>
+
+/*!
+ * \brief Пул потоков с перехватом задач (work stealing)
+ *
+ * Задачи раздаются потокам по очереди в порядке индексов, поэтому задачи с меньшими индексами
+ * начинаются раньше. Поток берёт задачи из начала своей очереди, а опустевший поток перехватывает
+ * задачи из конца очереди другого потока. Вызывающий поток участвует в работе как один из потоков пула.
+ */
+class WorkStealingPool
+{
+public:
+    /*!
+     * \brief Конструктор пула
+     * \param[in] threadCount Количество потоков (0 — по числу ядер)
+     */
+    explicit WorkStealingPool(int threadCount = 0);
+
+    /*!
+     * \brief Выполнение задач с индексами от 0 до taskCount - 1 и ожидание их завершения
+     * \param[in] taskCount Количество задач
+     * \param[in] task Функция задачи; получает индекс задачи и не должна выбрасывать исключения
+     */
+    void run(int taskCount, const std::function<void(int)>& task);
+
+    /*!
+     * \brief Получение количества потоков пула
+     */
+    int getThreadCount() const;
+
+    /*!
+     * \brief Получение количества перехваченных задач за последний запуск
+     */
+    int getStealCount() const;
+
+private:
+    /*!
+     * \brief Очередь задач одного потока
+     */
+    struct WorkerQueue {
+        QMutex mutex;       /*!< Защита очереди */
+        QList<int> tasks;   /*!< Индексы задач */
+    };
+
+    /*!
+     * \brief Цикл работы потока: свои задачи, затем перехват чужих
+     */
+    void workerLoop(int worker, QList<WorkerQueue*>& queues, const std::function<void(int)>& task);
+
+    /*!
+     * \brief Взятие задачи из начала своей очереди
+     */
+    static bool popLocal(WorkerQueue* queue, int& taskIndex);
+
+    /*!
+     * \brief Перехват задачи из конца очереди другого потока
+     */
+    bool steal(int thief, QList<WorkerQueue*>& queues, int& taskIndex);
+
+    int threadCount; ///< Количество потоков
+    std::atomic<int> stealCount; ///< Количество перехваченных задач
+};
+
+#endif // WORKSTEALINGPOOL_H